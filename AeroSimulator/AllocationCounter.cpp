@@ -0,0 +1,155 @@
+#include "AllocationCounter.h"
+#include "Debug.h"
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+std::atomic<long long> AllocationCounter::m_lAllocations{ 0 };
+std::atomic<long long> AllocationCounter::m_lBytes{ 0 };
+std::atomic<bool> AllocationCounter::m_bIsSteady{ false };
+std::atomic<int> AllocationCounter::m_dCheck{ ALLOCATION_CHECK_OFF };
+int AllocationCounter::m_dWarmup = ALLOCATION_WARMUP_FRAMES;
+long long AllocationCounter::m_lFrameAllocations = 0;
+long long AllocationCounter::m_lFrameBytes = 0;
+long long AllocationCounter::m_lLastAllocations = 0;
+long long AllocationCounter::m_lLastBytes = 0;
+long long AllocationCounter::m_lSteadyFrames = 0;
+long long AllocationCounter::m_lAllocatingFrames = 0;
+long long AllocationCounter::m_lSteadyAllocations = 0;
+
+bool AllocationCounter::IsAvailable(void)
+{
+#ifdef AERO_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationCounter::Count(size_t a_uBytes)
+{
+	m_lAllocations.fetch_add(1, std::memory_order_relaxed);
+	m_lBytes.fetch_add((long long)a_uBytes, std::memory_order_relaxed);
+	if (m_bIsSteady.load(std::memory_order_relaxed) && m_dCheck.load(std::memory_order_relaxed) == ALLOCATION_CHECK_ASSERT)
+	{
+		ASSERT(false);
+	}
+}
+
+void AllocationCounter::BeginFrame(void)
+{
+	long long lAllocations = m_lAllocations.load(std::memory_order_relaxed);
+	long long lBytes = m_lBytes.load(std::memory_order_relaxed);
+	m_lLastAllocations = lAllocations - m_lFrameAllocations;
+	m_lLastBytes = lBytes - m_lFrameBytes;
+
+	if (m_bIsSteady)
+	{
+		m_lSteadyFrames++;
+		m_lSteadyAllocations += m_lLastAllocations;
+		if (m_lLastAllocations > 0)
+		{
+			m_lAllocatingFrames++;
+			if (m_dCheck == ALLOCATION_CHECK_REPORT)
+			{
+				std::cout << "Steady frame " << m_lSteadyFrames << " allocated " << m_lLastAllocations
+					<< " times (" << m_lLastBytes << " bytes)" << std::endl;
+			}
+		}
+	}
+	else if (m_dWarmup > 0 && --m_dWarmup == 0)
+	{
+		m_bIsSteady = true;
+	}
+
+	// Read again so the report's own allocations are not blamed on the next frame.
+	m_lFrameAllocations = m_lAllocations.load(std::memory_order_relaxed);
+	m_lFrameBytes = m_lBytes.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::StartSteadyState(int a_dWarmupFrames)
+{
+	m_lSteadyFrames = 0;
+	m_lAllocatingFrames = 0;
+	m_lSteadyAllocations = 0;
+	m_lFrameAllocations = m_lAllocations.load(std::memory_order_relaxed);
+	m_lFrameBytes = m_lBytes.load(std::memory_order_relaxed);
+	m_dWarmup = a_dWarmupFrames;
+	m_bIsSteady = a_dWarmupFrames <= 0;
+}
+
+void AllocationCounter::EndSteadyState(void)
+{
+	BeginFrame();
+	m_bIsSteady = false;
+	m_dWarmup = -1;
+}
+
+bool AllocationCounter::IsSteady(void) { return m_bIsSteady; }
+void AllocationCounter::SetCheck(AllocationCheck a_eCheck) { m_dCheck = a_eCheck; }
+AllocationCheck AllocationCounter::GetCheck(void) { return (AllocationCheck)m_dCheck.load(); }
+long long AllocationCounter::GetLastAllocations(void) { return m_lLastAllocations; }
+long long AllocationCounter::GetLastBytes(void) { return m_lLastBytes; }
+long long AllocationCounter::GetSteadyFrames(void) { return m_lSteadyFrames; }
+long long AllocationCounter::GetAllocatingFrames(void) { return m_lAllocatingFrames; }
+long long AllocationCounter::GetSteadyAllocations(void) { return m_lSteadyAllocations; }
+long long AllocationCounter::GetTotalAllocations(void) { return m_lAllocations.load(std::memory_order_relaxed); }
+
+const char* AllocationCounter::GetCheckName(AllocationCheck a_eCheck)
+{
+	switch (a_eCheck)
+	{
+	case ALLOCATION_CHECK_OFF: return "off";
+	case ALLOCATION_CHECK_REPORT: return "report";
+	case ALLOCATION_CHECK_ASSERT: return "assert";
+	default: return "unknown";
+	}
+}
+
+bool AllocationCounter::ParseCheck(const std::string& a_sName, AllocationCheck& a_eCheck)
+{
+	for (int i = 0; i < ALLOCATION_CHECK_COUNT; i++)
+	{
+		if (a_sName == GetCheckName((AllocationCheck)i))
+		{
+			a_eCheck = (AllocationCheck)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+#ifdef AERO_COUNT_ALLOCATIONS
+// Replacing the global allocation functions.  The aligned forms are left to the
+// library, nothing in the engine is over-aligned.
+void* operator new(size_t a_uBytes)
+{
+	AllocationCounter::Count(a_uBytes);
+	void* pMemory = malloc(a_uBytes == 0 ? 1 : a_uBytes);
+	if (pMemory == nullptr) throw std::bad_alloc();
+	return pMemory;
+}
+
+void* operator new[](size_t a_uBytes)
+{
+	return operator new(a_uBytes);
+}
+
+void* operator new(size_t a_uBytes, const std::nothrow_t&) noexcept
+{
+	AllocationCounter::Count(a_uBytes);
+	return malloc(a_uBytes == 0 ? 1 : a_uBytes);
+}
+
+void* operator new[](size_t a_uBytes, const std::nothrow_t& a_nothrow) noexcept
+{
+	return operator new(a_uBytes, a_nothrow);
+}
+
+void operator delete(void* a_pMemory) noexcept { free(a_pMemory); }
+void operator delete[](void* a_pMemory) noexcept { free(a_pMemory); }
+void operator delete(void* a_pMemory, size_t) noexcept { free(a_pMemory); }
+void operator delete[](void* a_pMemory, size_t) noexcept { free(a_pMemory); }
+void operator delete(void* a_pMemory, const std::nothrow_t&) noexcept { free(a_pMemory); }
+void operator delete[](void* a_pMemory, const std::nothrow_t&) noexcept { free(a_pMemory); }
+#endif
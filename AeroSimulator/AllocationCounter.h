@@ -0,0 +1,134 @@
+#ifndef __ALLOCATIONCOUNTER_H_
+#define __ALLOCATIONCOUNTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+// Defining AERO_COUNT_ALLOCATIONS replaces the global operator new and delete, so every
+// heap allocation of the engine is counted.  The Debug configurations define it.  Without
+// it only ImGui's allocations are seen.
+
+// Frames a windowed run draws before its frames count as steady.
+#define ALLOCATION_WARMUP_FRAMES 120
+
+/// <summary>
+/// What happens when a steady frame allocates.
+/// </summary>
+enum AllocationCheck
+{
+	ALLOCATION_CHECK_OFF = 0,
+	ALLOCATION_CHECK_REPORT,	// Logs every steady frame that allocated.
+	ALLOCATION_CHECK_ASSERT,	// Breaks on the allocation itself, so the debugger shows who made it.
+	ALLOCATION_CHECK_COUNT
+};
+
+/// <summary>
+/// Counts heap allocations and checks that frames stop allocating once the engine
+/// has warmed up.  Frames run from one render thread frame start to the next and
+/// take in the allocations of every thread, since simulation and recording overlap
+/// with drawing.  Counting is atomic, so any thread may allocate.
+/// </summary>
+class AllocationCounter
+{
+private:
+	static std::atomic<long long> m_lAllocations;
+	static std::atomic<long long> m_lBytes;
+	static std::atomic<bool> m_bIsSteady;
+	static std::atomic<int> m_dCheck;
+
+	// Only touched by the thread starting frames.
+	static int m_dWarmup;		// Frames left before steady, or -1 while waiting on StartSteadyState.
+	static long long m_lFrameAllocations;	// Counts when the frame started.
+	static long long m_lFrameBytes;
+	static long long m_lLastAllocations;
+	static long long m_lLastBytes;
+	static long long m_lSteadyFrames;
+	static long long m_lAllocatingFrames;
+	static long long m_lSteadyAllocations;
+
+public:
+	/// <summary>
+	/// Gets whether this build counts every allocation, see AERO_COUNT_ALLOCATIONS.
+	/// </summary>
+	static bool IsAvailable(void);
+
+	/// <summary>
+	/// Counts an allocation.  Called by the replaced operator new and the ImGui allocator.
+	/// </summary>
+	static void Count(size_t a_uBytes);
+
+	/// <summary>
+	/// Finishes the frame before and starts counting the next one.  Called once per frame.
+	/// </summary>
+	static void BeginFrame(void);
+
+	/// <summary>
+	/// Treats frames as steady after a number of frames and clears the steady totals.
+	/// </summary>
+	/// <param name="a_dWarmupFrames">Frames still allowed to allocate, 0 makes the current frame steady.</param>
+	static void StartSteadyState(int a_dWarmupFrames);
+
+	/// <summary>
+	/// Finishes the current frame and stops checking, like before shutting down.
+	/// </summary>
+	static void EndSteadyState(void);
+
+	/// <summary>
+	/// Gets whether frames are being checked.
+	/// </summary>
+	static bool IsSteady(void);
+
+	/// <summary>
+	/// Sets what happens when a steady frame allocates.
+	/// </summary>
+	static void SetCheck(AllocationCheck a_eCheck);
+
+	/// <summary>
+	/// Gets what happens when a steady frame allocates.
+	/// </summary>
+	static AllocationCheck GetCheck(void);
+
+	/// <summary>
+	/// Gets the allocations of the last finished frame.
+	/// </summary>
+	static long long GetLastAllocations(void);
+
+	/// <summary>
+	/// Gets the bytes allocated in the last finished frame.
+	/// </summary>
+	static long long GetLastBytes(void);
+
+	/// <summary>
+	/// Gets the steady frames finished since StartSteadyState.
+	/// </summary>
+	static long long GetSteadyFrames(void);
+
+	/// <summary>
+	/// Gets the steady frames that allocated.
+	/// </summary>
+	static long long GetAllocatingFrames(void);
+
+	/// <summary>
+	/// Gets the allocations of every steady frame added up.
+	/// </summary>
+	static long long GetSteadyAllocations(void);
+
+	/// <summary>
+	/// Gets every allocation counted since startup.
+	/// </summary>
+	static long long GetTotalAllocations(void);
+
+	/// <summary>
+	/// Gets the name of a check for the GUI and the command line.
+	/// </summary>
+	static const char* GetCheckName(AllocationCheck a_eCheck);
+
+	/// <summary>
+	/// Parses a check name as returned by GetCheckName.
+	/// </summary>
+	/// <returns>False if the name is not a check.</returns>
+	static bool ParseCheck(const std::string& a_sName, AllocationCheck& a_eCheck);
+};
+
+#endif //__ALLOCATIONCOUNTER_H_
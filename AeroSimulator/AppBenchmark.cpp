@@ -0,0 +1,261 @@
+#include "Application.h"
+#include "Debug.h"
+#include "Colors.h"
+#include "TextureStreamer.h"
+#include "CPUProfiler.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "AllocationCounter.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Frames rendered before measuring, so shader variants and caches settle.
+#define BENCHMARK_WARMUP_FRAMES 30
+
+// Simulated time between frames, so every run animates the same.
+#define BENCHMARK_DELTA_TIME (1.0f / 60.0f)
+
+/// <summary>
+/// Gets a percentile of sorted samples using the nearest rank.
+/// </summary>
+static float GetPercentile(const std::vector<float>& a_lSorted, float a_fPercent)
+{
+	if (a_lSorted.empty()) return 0.0f;
+	int dRank = (int)(a_fPercent / 100.0f * a_lSorted.size() + 0.5f);
+	dRank = std::min(std::max(dRank, 1), (int)a_lSorted.size());
+	return a_lSorted[dRank - 1];
+}
+
+/// <summary>
+/// Escapes the characters JSON strings cannot hold.
+/// </summary>
+static std::string EscapeJSON(const char* a_sText)
+{
+	std::string sResult = "";
+	for (const char* c = a_sText; c != nullptr && *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\') sResult += '\\';
+		if ((unsigned char)*c >= 0x20) sResult += *c;
+	}
+	return sResult;
+}
+
+bool Application::RunBenchmark(int a_dFrames, std::string a_sOutputFile, bool a_bUseRenderThread)
+{
+	// Loading every texture up front so streaming does not skew the first frames.
+	TextureStreamer::GetInstance()->Flush();
+	m_pTime = sf::seconds(BENCHMARK_DELTA_TIME);
+	m_pTimestep->SetRate(m_fSimulationRate);
+	m_pTimestep->Reset();
+
+	// Frame times are the gaps between presents, so overlapped simulation shows up as throughput.
+	m_lPresentTimes.clear();
+	m_lPresentTimes.reserve(BENCHMARK_WARMUP_FRAMES + a_dFrames);
+	m_lRecordTimes.clear();
+	m_lRecordTimes.reserve(BENCHMARK_WARMUP_FRAMES + a_dFrames);
+	m_bRecordPresents = true;
+	m_pFrameStats->SetWindow(a_dFrames);
+	CPUProfiler::SetThreadName("Simulation");
+	if (a_bUseRenderThread)
+	{
+		StartRenderThread();
+	}
+
+	FramePacket packet = FramePacket();
+	for (int i = -BENCHMARK_WARMUP_FRAMES; i < a_dFrames; i++)
+	{
+		float fProgress = i < 0 ? 0.0f : (float)i / std::max(a_dFrames - 1, 1);
+		if (i == 0)
+		{
+			// GPU averages and frame statistics only cover the measured frames.
+			m_bResetStats = true;
+		}
+		PaceFrame();
+		FollowBenchmarkPath(fProgress);
+		this->Simulate(BENCHMARK_DELTA_TIME);
+
+		if (a_bUseRenderThread)
+		{
+			this->SubmitFrame();
+		}
+		else
+		{
+			BuildPacket(packet);
+			RenderFrame(packet);
+			Present(packet);
+		}
+	}
+
+	if (a_bUseRenderThread)
+	{
+		StopRenderThread();
+	}
+	m_bRecordPresents = false;
+
+	// Writing the report allocates, so it is left out of the steady frames.
+	AllocationCounter::EndSteadyState();
+
+	std::vector<float> lFrameTimes;
+	lFrameTimes.reserve(a_dFrames);
+	for (int i = std::max(BENCHMARK_WARMUP_FRAMES, 1); i < m_lPresentTimes.size(); i++)
+	{
+		lFrameTimes.push_back(std::chrono::duration<float, std::milli>(
+			m_lPresentTimes[i] - m_lPresentTimes[i - 1]).count());
+	}
+
+	// Summarizing the run.
+	std::vector<float> lSorted = lFrameTimes;
+	std::sort(lSorted.begin(), lSorted.end());
+	float fTotal = 0.0f;
+	for (int i = 0; i < lFrameTimes.size(); i++)
+	{
+		fTotal += lFrameTimes[i];
+	}
+	float fMean = lFrameTimes.empty() ? 0.0f : fTotal / lFrameTimes.size();
+	float fSquares = 0.0f;
+	for (int i = 0; i < lFrameTimes.size(); i++)
+	{
+		fSquares += (lFrameTimes[i] - fMean) * (lFrameTimes[i] - fMean);
+	}
+	float fDeviation = lFrameTimes.empty() ? 0.0f : sqrtf(fSquares / lFrameTimes.size());
+	PacingStats pacing = m_pFramePacer->GetStats();
+
+	// Recording time of the measured frames only.
+	float fRecordTotal = 0.0f;
+	int dRecorded = 0;
+	for (int i = BENCHMARK_WARMUP_FRAMES; i < m_lRecordTimes.size(); i++)
+	{
+		fRecordTotal += m_lRecordTimes[i];
+		dRecorded++;
+	}
+	float fRecordMean = dRecorded == 0 ? 0.0f : fRecordTotal / dRecorded;
+
+	std::ofstream writer(a_sOutputFile, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the benchmark report to " << a_sOutputFile << std::endl;
+		return false;
+	}
+
+	sf::Vector2u v2Size = GetFramebufferSize();
+	writer << "{\n";
+	writer << "\t\"backend\": \"" << (m_pHeadless != nullptr ? m_pHeadless->GetBackendName() : "Window") << "\",\n";
+	writer << "\t\"renderer\": \"" << EscapeJSON((const char*)glGetString(GL_RENDERER)) << "\",\n";
+	writer << "\t\"version\": \"" << EscapeJSON((const char*)glGetString(GL_VERSION)) << "\",\n";
+	writer << "\t\"width\": " << v2Size.x << ",\n";
+	writer << "\t\"height\": " << v2Size.y << ",\n";
+	writer << "\t\"entities\": " << m_lEntities.size() << ",\n";
+	writer << "\t\"render_thread\": " << (a_bUseRenderThread ? "true" : "false") << ",\n";
+	writer << "\t\"simulation_rate\": " << m_pTimestep->GetRate() << ",\n";
+	writer << "\t\"record_threads\": " << m_dRecordThreads << ",\n";
+	writer << "\t\"record_ms_mean\": " << fRecordMean << ",\n";
+	writer << "\t\"frames\": " << lFrameTimes.size() << ",\n";
+	writer << "\t\"warmup_frames\": " << BENCHMARK_WARMUP_FRAMES << ",\n";
+	writer << "\t\"mean_ms\": " << fMean << ",\n";
+	writer << "\t\"stddev_ms\": " << fDeviation << ",\n";
+	writer << "\t\"target_fps\": " << pacing.TargetRate << ",\n";
+	writer << "\t\"low_latency\": " << (pacing.IsLowLatency ? "true" : "false") << ",\n";
+	writer << "\t\"latency_ms\": " << pacing.LatencyMS << ",\n";
+	writer << "\t\"missed_frames\": " << pacing.MissedFrames << ",\n";
+	writer << "\t\"dynamic_resolution\": " << (m_pDynamicResolution->IsEnabled() ? "true" : "false") << ",\n";
+	writer << "\t\"render_scale\": " << m_pDynamicResolution->GetScale() << ",\n";
+	writer << "\t\"scene_gpu_ms\": " << m_pDynamicResolution->GetGPUTime() << ",\n";
+	writer << "\t\"memory\": {";
+	for (int i = 0; i <= MEMORY_TAG_COUNT; i++)
+	{
+		bool bIsTotal = i == MEMORY_TAG_COUNT;
+		MemoryUsage cpu = bIsTotal ? MemoryTracker::GetTotal(MEMORY_CPU) : MemoryTracker::GetUsage(MEMORY_CPU, (MemoryTag)i);
+		MemoryUsage gpu = bIsTotal ? MemoryTracker::GetTotal(MEMORY_GPU) : MemoryTracker::GetUsage(MEMORY_GPU, (MemoryTag)i);
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t\"" << (bIsTotal ? "total" : MemoryTracker::GetTagName((MemoryTag)i)) << "\": {"
+			<< " \"cpu_bytes\": " << cpu.Bytes << ", \"cpu_peak_bytes\": " << cpu.PeakBytes
+			<< ", \"gpu_bytes\": " << gpu.Bytes << ", \"gpu_peak_bytes\": " << gpu.PeakBytes << " }";
+	}
+	writer << "\n\t},\n";
+	const RenderCounters& renderTotals = RenderStats::GetTotals();
+	const RenderCounters& renderPeaks = RenderStats::GetPeaks();
+	double dRenderFrames = RenderStats::GetFrameCount() > 0 ? (double)RenderStats::GetFrameCount() : 1.0;
+	writer << "\t\"render_stats\": {";
+	for (int i = 0; i < RS_COUNTER_COUNT; i++)
+	{
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t\"" << RenderStats::GetCounterName((RenderCounter)i) << "\": {"
+			<< " \"mean\": " << renderTotals.Values[i] / dRenderFrames << ", \"max\": " << renderPeaks.Values[i] << " }";
+	}
+	writer << "\n\t},\n";
+	writer << "\t\"allocations_counted\": " << (AllocationCounter::IsAvailable() ? "true" : "false") << ",\n";
+	writer << "\t\"allocating_frames\": " << AllocationCounter::GetAllocatingFrames() << ",\n";
+	writer << "\t\"steady_allocations\": " << AllocationCounter::GetSteadyAllocations() << ",\n";
+	writer << "\t\"min_ms\": " << (lSorted.empty() ? 0.0f : lSorted.front()) << ",\n";
+	writer << "\t\"max_ms\": " << (lSorted.empty() ? 0.0f : lSorted.back()) << ",\n";
+	writer << "\t\"p50_ms\": " << GetPercentile(lSorted, 50.0f) << ",\n";
+	writer << "\t\"p95_ms\": " << GetPercentile(lSorted, 95.0f) << ",\n";
+	writer << "\t\"p99_ms\": " << GetPercentile(lSorted, 99.0f) << ",\n";
+	writer << "\t\"frame_times_ms\": [";
+	for (int i = 0; i < lFrameTimes.size(); i++)
+	{
+		writer << (i == 0 ? "" : ", ") << lFrameTimes[i];
+	}
+	writer << "]\n}\n";
+
+	// Per pass GPU averages and the CPU trace go next to the report.
+	size_t uDot = a_sOutputFile.find_last_of('.');
+	std::string sStem = uDot == std::string::npos ? a_sOutputFile : a_sOutputFile.substr(0, uDot);
+	if (m_pGPUProfiler->IsEnabled())
+	{
+		m_pGPUProfiler->Export(sStem + "_gpu.json");
+	}
+	if (CPUProfiler::IsEnabled())
+	{
+		CPUProfiler::GetInstance()->ExportTrace(sStem + "_trace.json");
+		if (CPUProfiler::IsCounting())
+		{
+			CPUProfiler::GetInstance()->ExportCounters(sStem + "_counters.json");
+		}
+	}
+	m_pFrameStats->ExportCSV(sStem + "_frames.csv");
+	m_pFrameStats->ExportJSON(sStem + "_frames.json");
+	m_pFrameStats->SetWindow(FRAME_STATS_WINDOW);
+
+	std::cout << "Benchmark: " << lFrameTimes.size() << " frames, mean " << fMean << " ms, p99 "
+		<< GetPercentile(lSorted, 99.0f) << " ms, recording " << fRecordMean << " ms on " << m_dRecordThreads
+		<< " threads.  Written to " << a_sOutputFile << std::endl;
+	if (AllocationCounter::IsAvailable())
+	{
+		std::cout << "Allocations: " << AllocationCounter::GetSteadyAllocations() << " in "
+			<< AllocationCounter::GetAllocatingFrames() << " of " << AllocationCounter::GetSteadyFrames() << " measured frames" << std::endl;
+	}
+	return true;
+}
+
+void Application::FollowBenchmarkPath(float a_fProgress)
+{
+	// Sliding along the row of entities while sweeping the view from side to side.
+	Transform& transform = m_pCamera->GetTransform();
+	transform.SetPosition(glm::vec3(-8.0f + a_fProgress * 26.0f, 0.5f, -6.0f));
+	transform.SetRotation(glm::vec3(0.1f, 0.6f * sinf(a_fProgress * 6.2831853f), 0.0f));
+	m_pCamera->UpdateView();
+}
+
+void Application::AddBenchmarkEntities(int a_dCount)
+{
+	// Reusing the meshes and material of the entities made in InitScene.
+	int dOriginals = (int)m_lEntities.size();
+	if (dOriginals == 0) return;
+
+	for (int i = 0; i < a_dCount; i++)
+	{
+		Entity* original = m_lEntities[i % dOriginals];
+		Entity* e = new Entity(original->GetMesh(), original->GetMaterial());
+
+		// Rows of entities in front of the camera's path.
+		Transform* t = e->GetTransform();
+		t->Scale(glm::vec3(0.25f, 0.25f, 0.25f));
+		t->MoveGlobal(glm::vec3(-8.0f + (i % 20) * 1.4f, sinf(i * 0.7f), 2.0f + (i / 20) * 1.4f));
+		t->SavePrevious();
+
+		e->SetProxyID(m_pSceneTree->CreateProxy(e->GetWorldBounds(), e));
+		m_lEntities.push_back(e);
+	}
+}
\ No newline at end of file
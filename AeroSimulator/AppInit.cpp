@@ -1,4 +1,6 @@
 #include "Application.h"
+#include "CPUProfiler.h"
+#include "AllocationCounter.h"
 #include "Debug.h"
 #include "Colors.h"
 
@@ -7,10 +9,18 @@ void Application::Run(void)
 	// Starting up the loop with the control variable.
 	m_bIsRunning = true;
 
+	CPUProfiler::SetThreadName("Simulation");
+
+	// Handing the GL context over to the render thread.  This thread only simulates from here on.
+	StartRenderThread();
+
 	// Setting the clock for calculating delta time between frames.
 	sf::Clock clock = sf::Clock();
 	while (m_bIsRunning)
 	{
+		// Waiting for the frame's start before any input is read.
+		PaceFrame();
+
 		// Getting the delta time.
 		m_pTime = clock.restart();
 
@@ -25,9 +35,6 @@ void Application::Run(void)
 			}
 			else if (event.type == sf::Event::Resized)
 			{
-				// Adjusting the viewport when the window is resized.
-				GLCall(glViewport(0, 0, event.size.width, event.size.height));
-
 				// Calling the window resizing callback method.
 				this->OnChangeScreenBounds();
 			}
@@ -39,18 +46,127 @@ void Application::Run(void)
 			m_bIsRunning = false;
 		}
 
-		// Clearing the previous frame.
-		this->ClearScreen(CORNFLOWER_BLUE);
-
 		// Calling the logic update method.
-		this->Update();
+		this->Simulate(m_pTime.asSeconds());
+
+		// Handing the frame to the render thread.  Waits only if it is two frames behind.
+		this->SubmitFrame();
+	}
+
+	StopRenderThread();
+	AllocationCounter::EndSteadyState();
+}
+
+void Application::SubmitFrame(void)
+{
+	PROFILE_ZONE("SubmitFrame");
+	FramePacket* pPacket = m_pFrameQueue->BeginWrite();
+	if (pPacket == nullptr) return;
+
+	BuildPacket(*pPacket);
+	m_pFrameQueue->EndWrite();
+}
+
+void Application::StartRenderThread(void)
+{
+	m_pFrameQueue->Restart();
+	SetContextActive(false);
+	m_tRenderThread = std::thread(&Application::RenderLoop, this);
+}
+
+void Application::StopRenderThread(void)
+{
+	// Letting the render thread draw what was submitted, then taking the context back.
+	m_pFrameQueue->Stop();
+	if (m_tRenderThread.joinable())
+	{
+		m_tRenderThread.join();
+	}
+	SetContextActive(true);
+}
+
+void Application::RenderLoop(void)
+{
+	CPUProfiler::SetThreadName("Render");
+	SetContextActive(true);
+
+	FramePacket* pPacket = m_pFrameQueue->BeginRead();
+	while (pPacket != nullptr)
+	{
+		RenderFrame(*pPacket);
+		Present(*pPacket);
+		m_pFrameQueue->EndRead();
+		pPacket = m_pFrameQueue->BeginRead();
+	}
+
+	SetContextActive(false);
+}
+
+void Application::PaceFrame(void)
+{
+	PROFILE_ZONE("PaceFrame");
+	float fTargetFramerate = m_fTargetFramerate;
+	if (fTargetFramerate != m_pFramePacer->GetTargetRate())
+	{
+		m_pFramePacer->SetTargetRate(fTargetFramerate);
+	}
+	m_pFramePacer->SetLowLatency(m_bUseLowLatency);
+
+	m_pFramePacer->WaitForFrame();
+	m_tInputTime = std::chrono::high_resolution_clock::now();
+}
 
-		// Coloring and drawing.
-		this->Render();
+void Application::SetTargetFramerate(float a_fFramesPerSecond) { m_fTargetFramerate = a_fFramesPerSecond > 0.0f ? a_fFramesPerSecond : 0.0f; }
+void Application::SetLowLatency(bool a_bIsLowLatency) { m_bUseLowLatency = a_bIsLowLatency; }
 
+void Application::Present(const FramePacket& a_packet)
+{
+	PROFILE_ZONE("Present");
+	if (m_pWindow != nullptr)
+	{
 		// Ending the current frame (internally swaps the front and back buffers)
 		m_pWindow->display();
 	}
+	else
+	{
+		// There is no swap to pace the GPU, so the frame only ends once its work has.
+		GLCall(glFinish());
+	}
+
+	GLCapture::EndFrame();
+	m_pFramePacer->AddLatency(a_packet.InputTime);
+
+	// Frames are timed present to present, since that is the rate they are seen at.
+	std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+	if (m_bHasPresented)
+	{
+		float lStages[STAGE_COUNT];
+		lStages[STAGE_FRAME] = std::chrono::duration<float, std::milli>(now - m_tLastPresent).count();
+		lStages[STAGE_SIMULATION] = a_packet.SimulationMS;
+		lStages[STAGE_RENDER] = m_fRenderMS;
+		lStages[STAGE_RECORD] = m_fRecordMS;
+		lStages[STAGE_GPU] = m_pGPUProfiler->IsEnabled() ? m_pGPUProfiler->GetFrameTime() : 0.0f;
+		lStages[STAGE_WAIT] = a_packet.Pacing.WaitMS;
+		m_pFrameStats->AddFrame(lStages);
+	}
+	m_tLastPresent = now;
+	m_bHasPresented = true;
+	if (m_bRecordPresents)
+	{
+		m_lPresentTimes.push_back(std::chrono::high_resolution_clock::now());
+	}
+}
+
+void Application::SetContextActive(bool a_bIsActive)
+{
+	if (m_pWindow != nullptr)
+	{
+		m_pWindow->setActive(a_bIsActive);
+	}
+	else if (m_pHeadless != nullptr)
+	{
+		m_pHeadless->SetCurrent(a_bIsActive);
+	}
 }
 
 void Application::InitWindow()
@@ -61,6 +177,15 @@ void Application::InitWindow()
 	glewExperimental = GL_TRUE;
 	GLCall(glewInit());
 
+	InitRenderState();
+}
+
+void Application::InitRenderState()
+{
+	// Recording from the first call, so a capture holds every resource its frames use.
+	sf::Vector2u v2Size = GetFramebufferSize();
+	GLCapture::Start(v2Size.x, v2Size.y, m_pHeadless != nullptr ? m_pHeadless->GetFramebuffer() : 0);
+
 	// Enabling pixel blending and its mode.
 	GLCall(glEnable(GL_BLEND));
 	GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
@@ -71,4 +196,13 @@ void Application::InitWindow()
 
 	// Disallows the faces from being viewed from behind.
 	GLCall(glEnable(GL_CULL_FACE));
+}
+
+sf::Vector2u Application::GetFramebufferSize(void)
+{
+	if (m_pHeadless != nullptr)
+	{
+		return sf::Vector2u(m_pHeadless->GetWidth(), m_pHeadless->GetHeight());
+	}
+	return m_pWindow->getSize();
 }
\ No newline at end of file
@@ -1,14 +1,28 @@
 #include "Application.h"
 #include "FileReader.h"
 #include <iostream>
-#include <glm\ext.hpp>
+#include <glm/ext.hpp>
 #include "Debug.h"
 #include "Colors.h"
 #include "Math.h"
+#include "ThreadPool.h"
+#include "TextureStreamer.h"
+#include "TextureTable.h"
+#include "ShaderCache.h"
+#include "CPUProfiler.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "AllocationCounter.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cfloat>
 
 #include "ImGui/imgui.h"
 #include "ImGui/imgui_impl_opengl3.h"
+#ifdef _WIN32
 #include "ImGui/imgui_impl_win32.h"
+#endif
 
 using namespace glm;
 
@@ -25,10 +39,60 @@ void Application::Init(std::string a_sAppName, uint a_uWidth, uint a_uHeight)
 
 	// Initializing the window settings.
 	InitWindow();
+	InitScene();
 
-	std::shared_ptr<Shader> shader = std::make_shared<Shader>();
-	shader->CompileShader("shaders/BasicVertex.glsl", "shaders/BasicFrag.glsl");
-	std::shared_ptr<Material> matScratchedMetal = std::make_shared<Material>(shader, 0.5f);
+	// Setup Dear ImGui context
+#ifdef _WIN32
+	IMGUI_CHECKVERSION();
+	ImGui::SetAllocatorFunctions(MemoryTracker::AllocateUI, MemoryTracker::FreeUI);
+	ImGui::CreateContext();
+	ImGui_ImplWin32_InitForOpenGL(static_cast<HWND>(m_pWindow->getSystemHandle()));
+	ImGui_ImplOpenGL3_Init();
+	ImGui::StyleColorsDark();
+	m_bHasGUI = true;
+#endif
+}
+
+bool Application::InitHeadless(HeadlessBackend a_eBackend, uint a_uWidth, uint a_uHeight)
+{
+	std::cout << "Initializing the headless context." << std::endl;
+
+	m_pHeadless = new HeadlessContext();
+	if (!m_pHeadless->Create(a_eBackend, a_uWidth, a_uHeight))
+	{
+		Realloc(m_pHeadless);
+		return false;
+	}
+
+	InitRenderState();
+	InitScene();
+	return true;
+}
+
+void Application::InitScene(void)
+{
+	// Created before any other thread can record a zone.
+	CPUProfiler::GetInstance();
+
+	// Sampling material textures through the texture table when the driver allows it.
+	TextureTable* pTextureTable = TextureTable::GetInstance();
+	if (pTextureTable->GetBackend() == TEXTURES_BOUND)
+	{
+		m_pEntityShaders = std::make_shared<ShaderVariants>("shaders/BasicVertex.glsl", "shaders/BasicFrag.glsl");
+	}
+	else
+	{
+		m_pEntityShaders = std::make_shared<ShaderVariants>("shaders/BasicVertex.glsl", "shaders/TableFrag.glsl");
+		if (pTextureTable->GetBackend() == TEXTURES_BINDLESS)
+		{
+			m_pEntityShaders->AddDefine("TEXTURE_BINDLESS");
+		}
+		m_pEntityShaders->SetReadyCallback([](GLuint a_uProgram) { TextureTable::GetInstance()->SetupProgram(a_uProgram); });
+	}
+
+	// Only the plain variant is compiled up front, the rest compile when first drawn.
+	m_pEntityShaders->SetFallback(0);
+	std::shared_ptr<Material> matScratchedMetal = std::make_shared<Material>(m_pEntityShaders, m_uShaderFeatures, 0.5f);
 	matScratchedMetal->AddTextureFromFile("textures/cobblestone.png", "Texture");
 
 	// Loading the cube model for the skybox.
@@ -53,59 +117,558 @@ void Application::Init(std::string a_sAppName, uint a_uWidth, uint a_uHeight)
 		Transform* t = m_lEntities[i]->GetTransform();
 		t->Scale(vec3(0.25f, 0.25f, 0.25f));
 		t->MoveGlobal(glm::vec3(i * 5.0f - 5.0f, 0.0f, 0.0f));
+		t->SavePrevious();
+	}
+
+	// Inserting all of the entities into the spatial index.
+	m_pSceneTree = new SceneTree();
+	for (int i = 0; i < m_lEntities.size(); i++)
+	{
+		Entity* e = m_lEntities[i];
+		e->SetProxyID(m_pSceneTree->CreateProxy(e->GetWorldBounds(), e));
 	}
 
-	sf::Vector2u v2WindowSize = m_pWindow->getSize();
+	// The cube is the simplest mesh, so it doubles as the test occluder.
+	m_lEntities[4]->SetOccluder(true);
+	m_pOcclusionCuller = new OcclusionCuller();
+
+	sf::Vector2u v2WindowSize = GetFramebufferSize();
 	float fAspectRatio = (float)v2WindowSize.x / v2WindowSize.y;
 	m_pCamera = new Camera(fAspectRatio, 60.0f);
 	m_pCamera->GetTransform().MoveLocal(glm::vec3(0.85f, -0.25f, -5.0f));
 
 	m_pSky = new SkyBox(cube);
 
-	std::shared_ptr<Shader> pLineShader = std::make_shared<Shader>();
-	pLineShader->CompileShader("shaders/LineVertex.glsl", "shaders/LineFragment.glsl");
+	// Position only shader for the optional depth prepass.
+	m_pDepthShader = std::make_shared<Shader>();
+	m_pDepthShader->CompileShader("shaders/DepthVertex.glsl", "shaders/DepthFrag.glsl");
+	m_dDepthWVPLocation = glGetUniformLocation(m_pDepthShader->GetProgramID(), "WVP");
 
-	// Setup Dear ImGui context
-	IMGUI_CHECKVERSION();
-	ImGui::CreateContext();
-	ImGui_ImplWin32_InitForOpenGL(static_cast<HWND>(m_pWindow->getSystemHandle()));
-	ImGui_ImplOpenGL3_Init();
-	ImGui::StyleColorsDark();
- }
+	ShaderCache* pShaderCache = ShaderCache::GetInstance();
+	std::cout << "Shader setup took " << pShaderCache->GetSetupTime() << " ms (" << pShaderCache->GetHits()
+		<< " cached, " << pShaderCache->GetMisses() << " compiled)" << std::endl;
+	m_pOverdrawCounter = new OverdrawCounter();
+	m_pDynamicResolution = new DynamicResolution();
+	m_pGPUProfiler = new GPUProfiler();
+
+	m_pFrameGraph = new FrameGraph();
+	m_pFrameGraph->SetProfiler(m_pGPUProfiler);
+	m_v2GraphSize = GetFramebufferSize();
+	BuildFrameGraph();
+	m_pFrameQueue = new FrameQueue();
+	m_pTimestep = new FixedTimestep();
+	m_pFramePacer = new FramePacer();
+	m_pFrameStats = new FrameStats();
+	m_pDebugView = new DebugView();
+}
+
+void Application::Simulate(float a_fFrameSeconds)
+{
+	PROFILE_ZONE("Simulate");
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	// Updating the camera once per frame, it follows input rather than the simulation.
+	if (m_pWindow != nullptr)
+	{
+		PROFILE_ZONE("Camera::Update");
+		m_pCamera->Update(a_fFrameSeconds, m_pWindow);
+	}
+
+	// Picking up a rate change from the GUI.
+	float fRate = m_fSimulationRate;
+	if (fRate != m_pTimestep->GetRate())
+	{
+		m_pTimestep->SetRate(fRate);
+	}
+
+	// Stepping at a fixed rate so results do not depend on the framerate.
+	int dSteps = m_pTimestep->Advance(a_fFrameSeconds);
+	for (int i = 0; i < dSteps; i++)
+	{
+		this->Update(m_pTimestep->GetStep());
+	}
+
+	// Refitting the spatial index once for everything that moved during the steps.
+	for (int i = 0; i < m_lEntities.size(); i++)
+	{
+		Entity* e = m_lEntities[i];
+		if (e->HasMoved())
+		{
+			m_pSceneTree->MoveProxy(e->GetProxyID(), e->GetWorldBounds());
+		}
+	}
+
+	m_fSimulationMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
 
-void Application::Update(void)
+void Application::Update(float a_fStep)
 {
-	// Setting the variable which holds the change 
-	// in time between frames.  Also setting ImGui.
-	float fDeltaTime = m_pTime.asSeconds();
-	SetGUI(fDeltaTime);
+	PROFILE_ZONE_ITEMS("Update", m_lEntities.size());
 
-	// Updating the camera.
-	m_pCamera->Update(fDeltaTime, m_pWindow);
+	// Keeping the state this step starts from to interpolate the frame between them.
+	for (int i = 0; i < m_lEntities.size(); i++)
+	{
+		m_lEntities[i]->GetTransform()->SavePrevious();
+	}
 
 	// Rotating the active entities.
 	for (int i = 0; i < m_lEntities.size(); i++)
 	{
 		Transform* t = m_lEntities[i]->GetTransform();
-		t->Rotate(glm::vec3(0.0f, fDeltaTime / 2.0f, 0.0f));
+		t->Rotate(glm::vec3(0.0f, a_fStep / 2.0f, 0.0f));
 	}
 }
 
-void Application::Render(void)
+void Application::SetSimulationRate(float a_fStepsPerSecond)
 {
-	// Setting the variable which holds the change in time between frames.
-	float fDeltaTime = m_pTime.asSeconds();
-	m_pSky->Render(m_pCamera);
+	if (a_fStepsPerSecond > 0.0f)
+	{
+		m_fSimulationRate = a_fStepsPerSecond;
+	}
+}
 
-	// Rendering all entities.
-	for (int i = 0; i < m_lEntities.size(); i++)
+void Application::BuildPacket(FramePacket& a_packet)
+{
+	PROFILE_ZONE("BuildPacket");
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	// Gathering the entities inside of the camera's view.
+	glm::mat4 m4ViewProjection = m_pCamera->GetProjection() * m_pCamera->GetView();
+	m_lVisibleEntities.clear();
+	m_pSceneTree->QueryFrustum(Frustum(m4ViewProjection), m_lVisibleEntities);
+
+	// Removing the entities hidden behind others.
+	DebugViewMode eDebugView = (DebugViewMode)m_dDebugView.load();
+	if (eDebugView == DEBUG_VIEW_CULLING)
+	{
+		m_lFrustumEntities.assign(m_lVisibleEntities.begin(), m_lVisibleEntities.end());
+	}
+	// Entities are drawn part way between their last two steps to hide the fixed rate.
+	float fAlpha = m_pTimestep->GetAlpha();
+	bool bUseOcclusionCulling = m_bUseOcclusionCulling;
+	if (bUseOcclusionCulling)
 	{
-		m_lEntities[i]->Draw(m_pCamera);
+		CullOccludedEntities(m4ViewProjection, fAlpha);
 	}
 
-	// Rendering the ImGui interface.
-	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	// Copying out everything the render thread reads, so simulation can carry on.
+	a_packet.View = m_pCamera->GetView();
+	a_packet.Projection = m_pCamera->GetProjection();
+	a_packet.Draws.clear();
+	for (int i = 0; i < m_lVisibleEntities.size(); i++)
+	{
+		Entity* e = static_cast<Entity*>(m_lVisibleEntities[i]);
+		DrawItem item = DrawItem();
+		item.Owner = e;
+		e->GetTransform()->GetInterpolatedMatrices(fAlpha, item.World, item.InverseTranspose);
+		item.DebugColor = glm::vec4(1.0f);
+		if (eDebugView != DEBUG_VIEW_NONE)
+		{
+			item.DebugColor = DebugView::GetDrawColor(eDebugView, e->GetMesh()->GetVertexCount(), e->GetWorldBounds(),
+				a_packet.View, a_packet.Projection);
+		}
+		a_packet.Draws.push_back(item);
+	}
+
+	// Outlining every entity by what culling made of it.
+	a_packet.DebugView = eDebugView;
+	a_packet.DebugBoxes.clear();
+	if (eDebugView == DEBUG_VIEW_CULLING)
+	{
+		m_lDrawnEntities.assign(m_lVisibleEntities.begin(), m_lVisibleEntities.end());
+		std::sort(m_lDrawnEntities.begin(), m_lDrawnEntities.end());
+		std::sort(m_lFrustumEntities.begin(), m_lFrustumEntities.end());
+		for (int i = 0; i < m_lEntities.size(); i++)
+		{
+			void* pEntity = m_lEntities[i];
+			DebugBox box = DebugBox();
+			box.Bounds = m_lEntities[i]->GetWorldBounds();
+			if (std::binary_search(m_lDrawnEntities.begin(), m_lDrawnEntities.end(), pEntity)) box.Color = glm::vec3(GREEN);
+			else if (std::binary_search(m_lFrustumEntities.begin(), m_lFrustumEntities.end(), pEntity)) box.Color = glm::vec3(RED);
+			else box.Color = glm::vec3(YELLOW);
+			a_packet.DebugBoxes.push_back(box);
+		}
+	}
+
+	sf::Vector2u v2Size = GetFramebufferSize();
+	a_packet.Width = v2Size.x;
+	a_packet.Height = v2Size.y;
+	a_packet.DeltaTime = m_pTime.asSeconds();
+	a_packet.InputTime = m_tInputTime;
+	a_packet.Pacing = m_pFramePacer->GetStats();
+	a_packet.EntityCount = (int)m_lEntities.size();
+	a_packet.UsedOcclusionCulling = bUseOcclusionCulling;
+	a_packet.Occlusion = m_pOcclusionCuller->GetStats();
+	a_packet.SimulationRate = m_pTimestep->GetRate();
+	a_packet.SimulationSteps = m_pTimestep->GetStepCount();
+	a_packet.DroppedSteps = m_pTimestep->GetDroppedSteps();
+	a_packet.SimulationMS = m_fSimulationMS + std::chrono::duration<float, std::milli>(
+		std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void Application::RenderFrame(const FramePacket& a_packet)
+{
+	if (CPUProfiler::IsEnabled())
+	{
+		CPUProfiler::GetInstance()->MarkFrame();
+	}
+	PROFILE_ZONE("RenderFrame");
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	m_pPacket = &a_packet;
+
+	// Closing the previous frame's counters and counting what culling left of this one.
+	int dOccluded = a_packet.UsedOcclusionCulling ? a_packet.Occlusion.Culled : 0;
+	RenderStats::BeginFrame();
+	AllocationCounter::BeginFrame();
+	RenderStats::Add(RS_ENTITIES, a_packet.EntityCount);
+	RenderStats::Add(RS_VISIBLE_ENTITIES, (long long)a_packet.Draws.size());
+	RenderStats::Add(RS_CULLED_ENTITIES, a_packet.EntityCount - (long long)a_packet.Draws.size() - dOccluded);
+	RenderStats::Add(RS_OCCLUDED_ENTITIES, dOccluded);
+
+	// Resizing the window sized render targets.
+	if (a_packet.Width != m_v2GraphSize.x || a_packet.Height != m_v2GraphSize.y)
+	{
+		m_v2GraphSize = sf::Vector2u(a_packet.Width, a_packet.Height);
+		BuildFrameGraph();
+	}
+
+	// Clearing the previous frame.  Headless runs draw into their own framebuffer.
+	if (m_pHeadless != nullptr)
+	{
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_pHeadless->GetFramebuffer()));
+	}
+	// The overdraw view adds up from black, since it leaves out the sky.
+	this->ClearScreen(a_packet.DebugView == DEBUG_VIEW_OVERDRAW ? BLACK : CORNFLOWER_BLUE);
+
+	if (m_bHasGUI)
+	{
+		SetGUI(a_packet);
+	}
+
+	// Uploading whatever texture data the workers have decoded.
+	TextureStreamer::GetInstance()->Update();
+	TextureTable::GetInstance()->Update();
+	m_pEntityShaders->Update();
+
+	// Recording the draws before any pass needs them.
+	RecordCommands(a_packet);
+
+	// Running every render pass of the frame.
+	m_pOverdrawCounter->BeginFrame();
+	if (m_bResetStats.exchange(false))
+	{
+		m_pGPUProfiler->ResetTotals();
+		m_pFrameStats->Reset();
+		RenderStats::ResetTotals();
+		AllocationCounter::StartSteadyState(0);
+	}
+	m_pGPUProfiler->BeginFrame();
+	m_pFrameGraph->Execute();
+
+	m_pPacket = nullptr;
+	m_fRenderMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void Application::RecordCommands(const FramePacket& a_packet)
+{
+	PROFILE_ZONE_ITEMS("RecordCommands", a_packet.Draws.size());
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	// Growing only, so each list keeps its memory from frame to frame.
+	int dChunks = std::max(1, std::min(m_dRecordThreads, (int)a_packet.Draws.size()));
+	if (m_lCommandLists.size() < dChunks)
+	{
+		m_lCommandLists.resize(dChunks);
+	}
+	for (int i = 0; i < m_lCommandLists.size(); i++)
+	{
+		m_lCommandLists[i].Reset();
+	}
+
+	// Each chunk is contiguous, so replaying the lists in order keeps the packet's draw order.
+	// The lambda only captures two pointers, so wrapping it in a std::function does not allocate.
+	struct RecordJob
+	{
+		const FramePacket* Packet;
+		glm::mat4 ViewProjection;
+		int Draws;
+		int Chunks;
+	};
+	RecordJob job = { &a_packet, a_packet.Projection * a_packet.View, (int)a_packet.Draws.size(), dChunks };
+	auto record = [this, &job](unsigned int a_uChunk)
+	{
+		int dBegin = job.Draws * (int)a_uChunk / job.Chunks;
+		int dEnd = job.Draws * ((int)a_uChunk + 1) / job.Chunks;
+		PROFILE_ZONE_ITEMS("Record chunk", dEnd - dBegin);
+		CommandList& list = m_lCommandLists[a_uChunk];
+		for (int i = dBegin; i < dEnd; i++)
+		{
+			const DrawItem& item = job.Packet->Draws[i];
+			item.Owner->Record(list, job.ViewProjection, item.World, item.InverseTranspose, item.DebugColor);
+		}
+	};
+
+	if (dChunks == 1)
+	{
+		record(0);
+	}
+	else
+	{
+		ThreadPool::GetInstance()->ParallelFor((unsigned int)dChunks, record);
+	}
+
+	m_fRecordMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	if (m_bRecordPresents)
+	{
+		m_lRecordTimes.push_back(m_fRecordMS);
+	}
+}
+
+void Application::ReplayCommands(bool a_bIsDepthOnly, GLint a_dWVPLocation)
+{
+	PROFILE_ZONE_ITEMS("ReplayCommands", m_pPacket->Draws.size());
+	// The debug views swap in their variant of every material, so the same draws are submitted.
+	DebugViewMode eDebugView = m_pPacket->DebugView;
+	CommandReplayer replayer = CommandReplayer();
+	replayer.Begin(a_bIsDepthOnly, a_dWVPLocation, a_bIsDepthOnly ? 0 : DebugView::GetFeatures(eDebugView));
+	if (!a_bIsDepthOnly) m_pDebugView->Begin(eDebugView);
+	for (int i = 0; i < m_lCommandLists.size(); i++)
+	{
+		replayer.Execute(m_lCommandLists[i]);
+	}
+	if (!a_bIsDepthOnly) m_pDebugView->End(eDebugView);
+	replayer.End();
+}
+
+void Application::SetDebugView(DebugViewMode a_eMode)
+{
+	m_dDebugView = a_eMode;
+}
+
+void Application::EnableDynamicResolution(float a_fTargetMS, float a_fMinScale, float a_fMaxScale)
+{
+	m_pDynamicResolution->SetBounds(a_fMinScale, a_fMaxScale);
+	m_pDynamicResolution->SetTargetTime(a_fTargetMS);
+	m_pDynamicResolution->SetEnabled(true);
+	BuildFrameGraph();
+}
+
+void Application::EnableGPUProfiler(bool a_bUseStatistics)
+{
+	m_pGPUProfiler->SetEnabled(true);
+	m_pGPUProfiler->SetStatisticsEnabled(a_bUseStatistics);
+}
+
+void Application::SetRecordThreads(int a_dThreads)
+{
+	m_dRecordThreads = std::max(1, std::min(a_dThreads, GetMaxRecordThreads()));
+}
+
+int Application::GetMaxRecordThreads(void)
+{
+	// The thread calling ParallelFor records a chunk too.
+	return (int)ThreadPool::GetInstance()->GetWorkerCount() + 1;
+}
+
+void Application::BuildFrameGraph(void)
+{
+	m_pFrameGraph->Reset();
+
+	sf::Vector2u v2WindowSize = m_v2GraphSize;
+	GLuint uFramebuffer = m_pHeadless != nullptr ? m_pHeadless->GetFramebuffer() : 0;
+	FGResource dBackbuffer = m_pFrameGraph->ImportBackbuffer("Backbuffer", v2WindowSize.x, v2WindowSize.y, uFramebuffer);
+
+	// With dynamic resolution the scene goes into targets of its own, stretched over the window afterwards.
+	FGResource dSceneColor = dBackbuffer;
+	FGResource dSceneDepth = FG_INVALID;
+	if (m_pDynamicResolution->IsEnabled())
+	{
+		FGTextureDesc colorDesc = FGTextureDesc();
+		m_pDynamicResolution->GetTargetSize(v2WindowSize.x, v2WindowSize.y, colorDesc.Width, colorDesc.Height);
+		colorDesc.Format = GL_RGBA8;
+		FGTextureDesc depthDesc = colorDesc;
+		depthDesc.Format = GL_DEPTH_COMPONENT24;
+
+		m_pFrameGraph->AddPass("SceneClear",
+			[&dSceneColor, &dSceneDepth, colorDesc, depthDesc](FrameGraph::Builder& builder)
+			{
+				dSceneColor = builder.Write(builder.CreateTexture("SceneColor", colorDesc));
+				dSceneDepth = builder.Write(builder.CreateTexture("SceneDepth", depthDesc));
+			},
+			[this](FrameGraph::Context&)
+			{
+				m_pDynamicResolution->BeginFrame(m_v2GraphSize.x, m_v2GraphSize.y);
+				m_pDynamicResolution->ApplyViewport();
+				GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+			});
+	}
+	auto writeScene = [dSceneColor, dSceneDepth](FrameGraph::Builder& builder)
+	{
+		builder.Write(dSceneColor);
+		if (dSceneDepth != FG_INVALID)
+		{
+			builder.Write(dSceneDepth);
+		}
+	};
+
+	// Passes writing the same target run in the order they are added here.  The prepass
+	// cannot discard alpha tested texels, so with alpha test on the entities test as usual.
+	bool bUsePrepass = m_bUseDepthPrepass && (m_uShaderFeatures & SHADER_ALPHA_TEST) == 0;
+	if (!bUsePrepass)
+	{
+		// The sky shades the whole screen and the entities are shaded on top of it.
+		m_pFrameGraph->AddPass("Sky",
+			writeScene,
+			[this](FrameGraph::Context&)
+			{
+				if (!DebugView::DrawsSky(m_pPacket->DebugView)) return;
+				m_pDynamicResolution->ApplyViewport();
+				m_pOverdrawCounter->Begin();
+				m_pSky->Render(m_pPacket->View, m_pPacket->Projection);
+				m_pOverdrawCounter->End();
+			});
+
+		m_pFrameGraph->AddPass("Opaque",
+			writeScene,
+			[this](FrameGraph::Context&)
+			{
+				m_pDynamicResolution->ApplyViewport();
+				// Rendering all visible entities.
+				TextureTable::GetInstance()->Bind();
+				m_pOverdrawCounter->Begin();
+				ReplayCommands(false);
+				m_pOverdrawCounter->End();
+			});
+	}
+	else
+	{
+		// Laying down the final depth of the opaque geometry without shading it.
+		m_pFrameGraph->AddPass("DepthPrepass",
+			writeScene,
+			[this](FrameGraph::Context&)
+			{
+				if (!DebugView::UsesDepthPrepass(m_pPacket->DebugView)) return;
+				m_pDynamicResolution->ApplyViewport();
+				GLCall(glUseProgram(m_pDepthShader->GetProgramID()));
+				RenderStats::Add(RS_PROGRAM_BINDS);
+
+				GLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+				GLCall(glDepthFunc(GL_LESS));
+				ReplayCommands(true, m_dDepthWVPLocation);
+				GLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+			});
+
+		// Shading only the fragments that won the prepass.  Debug views without it test as usual.
+		m_pFrameGraph->AddPass("Opaque",
+			writeScene,
+			[this](FrameGraph::Context&)
+			{
+				bool bHasPrepass = DebugView::UsesDepthPrepass(m_pPacket->DebugView);
+				m_pDynamicResolution->ApplyViewport();
+				if (bHasPrepass)
+				{
+					GLCall(glDepthFunc(GL_EQUAL));
+					GLCall(glDepthMask(GL_FALSE));
+				}
+				TextureTable::GetInstance()->Bind();
+				m_pOverdrawCounter->Begin();
+				ReplayCommands(false);
+				m_pOverdrawCounter->End();
+				if (bHasPrepass)
+				{
+					GLCall(glDepthMask(GL_TRUE));
+					GLCall(glDepthFunc(GL_LESS));
+				}
+			});
+
+		// The sky sits on the far plane, so it only shades the uncovered pixels.
+		m_pFrameGraph->AddPass("Sky",
+			writeScene,
+			[this](FrameGraph::Context&)
+			{
+				if (!DebugView::DrawsSky(m_pPacket->DebugView)) return;
+				m_pDynamicResolution->ApplyViewport();
+				m_pOverdrawCounter->Begin();
+				m_pSky->Render(m_pPacket->View, m_pPacket->Projection);
+				m_pOverdrawCounter->End();
+			});
+	}
+
+	// Only the culling view has boxes, every other frame this pass draws nothing.
+	m_pFrameGraph->AddPass("DebugBoxes",
+		writeScene,
+		[this](FrameGraph::Context&)
+		{
+			m_pDynamicResolution->ApplyViewport();
+			m_pDebugView->DrawBoxes(m_pPacket->DebugBoxes, m_pPacket->Projection * m_pPacket->View);
+		});
+
+	if (m_pDynamicResolution->IsEnabled())
+	{
+		m_pFrameGraph->AddPass("Upscale",
+			[dSceneColor, dBackbuffer](FrameGraph::Builder& builder)
+			{
+				builder.Read(dSceneColor, FG_COPY);
+				builder.Write(dBackbuffer);
+			},
+			[this, dSceneColor](FrameGraph::Context& context)
+			{
+				m_pDynamicResolution->Upscale(context.GetTexture(dSceneColor), m_v2GraphSize.x, m_v2GraphSize.y);
+			});
+	}
+
+	// The interface is drawn at the window's resolution on top of the stretched scene.
+	if (m_bHasGUI)
+	{
+		m_pFrameGraph->AddPass("UI",
+			[dBackbuffer](FrameGraph::Builder& builder)
+			{
+				builder.Write(dBackbuffer);
+			},
+			[](FrameGraph::Context&)
+			{
+				// Rendering the ImGui interface.
+				ImGui::Render();
+				ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			});
+	}
+
+	m_pFrameGraph->Compile();
+}
+
+void Application::CullOccludedEntities(const glm::mat4& a_m4ViewProjection, float a_fAlpha)
+{
+	PROFILE_ZONE("Occlusion culling");
+	m_pOcclusionCuller->BeginFrame(a_m4ViewProjection);
+
+	// Drawing the visible occluders into the software depth buffer where they are drawn, not simulated.
+	glm::mat4 m4World, m4InverseTranspose;
+	for (int i = 0; i < m_lVisibleEntities.size(); i++)
+	{
+		Entity* e = static_cast<Entity*>(m_lVisibleEntities[i]);
+		if (e->IsOccluder())
+		{
+			e->GetTransform()->GetInterpolatedMatrices(a_fAlpha, m4World, m4InverseTranspose);
+			m_pOcclusionCuller->AddOccluder(e->GetMesh()->GetVertices(), m4World);
+		}
+	}
+	m_pOcclusionCuller->RasterizeOccluders();
+
+	// Compacting the visible list down to the entities that passed the test.
+	// Occluders are always kept since they were what filled the buffer.
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	int dKept = 0;
+	for (int i = 0; i < m_lVisibleEntities.size(); i++)
+	{
+		Entity* e = static_cast<Entity*>(m_lVisibleEntities[i]);
+		if (e->IsOccluder() || m_pOcclusionCuller->IsVisible(e->GetWorldBounds()))
+		{
+			m_lVisibleEntities[dKept++] = e;
+		}
+	}
+	m_lVisibleEntities.resize(dKept);
+	m_pOcclusionCuller->AddTestTime(std::chrono::duration<float, std::milli>(
+		std::chrono::high_resolution_clock::now() - start).count());
 }
 
 Application::~Application()
@@ -113,35 +676,60 @@ Application::~Application()
 	// Freeing heap allocated variables.
 	Realloc(m_pCamera);
 	Realloc(m_pSky);
+	Realloc(m_pSceneTree);
+	Realloc(m_pOcclusionCuller);
+	Realloc(m_pFrameGraph);
+	Realloc(m_pOverdrawCounter);
+	Realloc(m_pDynamicResolution);
+	Realloc(m_pGPUProfiler);
+	Realloc(m_pFrameQueue);
+	Realloc(m_pTimestep);
+	Realloc(m_pFramePacer);
+	Realloc(m_pFrameStats);
+	Realloc(m_pDebugView);
 	for (int i = 0; i < m_lEntities.size(); i++)
 	{
 		Realloc(m_lEntities[i]);
 	}
 
-	// Releasing singletons.
+	// Releasing singletons.  The streamer waits on decodes running in the pool.
+	TextureTable::ReleaseInstance();
+	TextureStreamer::ReleaseInstance();
+	ShaderCache::ReleaseInstance();
 	FileReader::GetInstance()->ReleaseInstance();
+	ThreadPool::ReleaseInstance();
+	CPUProfiler::ReleaseInstance();
 	
 	// Clearing memory allocated by ImGui.
-	ImGui_ImplOpenGL3_Shutdown();
-	ImGui_ImplWin32_Shutdown();
-	ImGui::DestroyContext();
+#ifdef _WIN32
+	if (m_bHasGUI)
+	{
+		ImGui_ImplOpenGL3_Shutdown();
+		ImGui_ImplWin32_Shutdown();
+		ImGui::DestroyContext();
+	}
+#endif
 
 	// Freeing memory.
 	Realloc(m_pWindow);
+	Realloc(m_pHeadless);
 }
 
 void Application::OnChangeScreenBounds(void)
 {
 	// Recalculating the Camera's projection matrix.
-	sf::Vector2u v2WindowSize = m_pWindow->getSize();
+	sf::Vector2u v2WindowSize = GetFramebufferSize();
 	float fAspectRatio = (float)v2WindowSize.x / v2WindowSize.y;
 	m_pCamera->UpdateProjection(fAspectRatio);
 
+	// The render thread resizes the window sized render targets once the new size reaches it.
+
 	std::cout << "Altering screen bounds" << std::endl;
 }
 
-void Application::SetGUI(float a_fDeltaTime)
+void Application::SetGUI(const FramePacket& a_packet)
 {
+	PROFILE_ZONE("SetGUI");
 	ImGuiIO& io = ImGui::GetIO();
 	
 	// Set mouse position for ImGui input handling.
@@ -155,35 +743,579 @@ void Application::SetGUI(float a_fDeltaTime)
 
 	// Start the Dear ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
+#ifdef _WIN32
 	ImGui_ImplWin32_NewFrame();
+#endif
 	ImGui::NewFrame();
 
 	// Beginning the debug window.
 	ImGui::Begin("Debug Info");
 
-	// Calculating the framerate of this application.
-	static std::string sCurrentFPS = "0.0";
-	static float totalTime = 0.0f;
-	static int frameCount = 0;
-	static float timer = 0.0f;
-	totalTime += a_fDeltaTime;
-	timer += a_fDeltaTime;
-	frameCount++;
+	// The framerate over the recent frames, with the slow ones an average would hide.
+	FrameSummary frame = m_pFrameStats->GetSummary(STAGE_FRAME);
+	ImGui::Text("Framerate: %.1f (%.2f ms)", frame.MeanMS > 0.0f ? 1000.0f / frame.MeanMS : 0.0f, frame.MeanMS);
+	ImGui::Text("p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms", frame.P50MS, frame.P95MS, frame.P99MS, frame.MaxMS);
+	ImGui::Text("Visible entities: %d / %d", (int)a_packet.Draws.size(), a_packet.EntityCount);
+	ImGui::Text("Simulation %.3f ms, render %.3f ms", a_packet.SimulationMS, m_fRenderMS);
+
+	// Fixed simulation rate, independent of the framerate.
+	float fSimulationRate = a_packet.SimulationRate;
+	if (ImGui::SliderFloat("Simulation rate (Hz)", &fSimulationRate, 30.0f, 480.0f, "%.0f"))
+	{
+		SetSimulationRate(fSimulationRate);
+	}
+	ImGui::Text("Steps this frame: %d (%d dropped)", a_packet.SimulationSteps, a_packet.DroppedSteps);
 
-	// Recalculate the FPS every second.
-	if (timer >= 1.0f)
+	// Frame limiting, and how steady and responsive the frames are.
+	const PacingStats& pacing = a_packet.Pacing;
+	float fTargetFramerate = pacing.TargetRate;
+	if (ImGui::SliderFloat("Frame limit (0 = off)", &fTargetFramerate, 0.0f, 240.0f, "%.0f"))
+	{
+		SetTargetFramerate(fTargetFramerate);
+	}
+	bool bUseLowLatency = pacing.IsLowLatency;
+	if (ImGui::Checkbox("Low latency", &bUseLowLatency))
 	{
-		sCurrentFPS = std::to_string(frameCount / totalTime);
-		timer = 0.0f;
-		totalTime = 0.0f;
-		frameCount = 0;
+		SetLowLatency(bUseLowLatency);
 	}
+	ImGui::Text("Frame interval %.2f ms (deviation %.3f ms), waited %.2f ms",
+		pacing.MeanIntervalMS, pacing.IntervalDeviationMS, pacing.WaitMS);
+	ImGui::Text("Input latency %.2f ms, missed frames %d", pacing.LatencyMS, pacing.MissedFrames);
 
-	// Displaying the resulting framerate.
-	std::string displayText = "Framerate: ";
-	displayText.append(sCurrentFPS);
-	ImGui::Text(displayText.c_str());
+	// Threads recording this frame's draws into command lists.
+	int dRecordThreads = m_dRecordThreads;
+	if (ImGui::SliderInt("Recording threads", &dRecordThreads, 1, GetMaxRecordThreads()))
+	{
+		SetRecordThreads(dRecordThreads);
+	}
+	ImGui::Text("Recording %.3f ms", m_fRecordMS);
+
+	// Software occlusion culling results from the frame being drawn.
+	bool bUseOcclusionCulling = m_bUseOcclusionCulling;
+	if (ImGui::Checkbox("Occlusion culling", &bUseOcclusionCulling))
+	{
+		m_bUseOcclusionCulling = bUseOcclusionCulling;
+	}
+	if (a_packet.UsedOcclusionCulling)
+	{
+		const OcclusionStats& stats = a_packet.Occlusion;
+		ImGui::Text("Occluders: %d (%d triangles)", stats.Occluders, stats.Triangles);
+		ImGui::Text("Occlusion culled: %d / %d (%.1f%%)", stats.Culled, stats.Tested, stats.GetCulledPercent());
+		ImGui::Text("Transform %.3f ms, raster %.3f ms, test %.3f ms", stats.TransformMS, stats.RasterMS, stats.TestMS);
+	}
+
+	// Alternative views of the same draws for tuning content.
+	DebugViewMode eDebugView = a_packet.DebugView;
+	if (ImGui::BeginCombo("Debug view", DebugView::GetModeName(eDebugView)))
+	{
+		for (int i = 0; i < DEBUG_VIEW_COUNT; i++)
+		{
+			if (ImGui::Selectable(DebugView::GetModeName((DebugViewMode)i), i == eDebugView))
+			{
+				SetDebugView((DebugViewMode)i);
+			}
+		}
+		ImGui::EndCombo();
+	}
+	if (eDebugView != DEBUG_VIEW_NONE)
+	{
+		ImGui::TextDisabled("%s", DebugView::GetLegend(eDebugView));
+	}
+
+	// Shaded fragments of the sky and opaque passes from a few frames ago.
+	if (ImGui::Checkbox("Depth prepass", &m_bUseDepthPrepass))
+	{
+		BuildFrameGraph();
+	}
+	if (m_bUseDepthPrepass && (m_uShaderFeatures & SHADER_ALPHA_TEST) != 0)
+	{
+		ImGui::TextDisabled("Skipped while alpha test is on.");
+	}
+	int dRenderWidth = (int)a_packet.Width;
+	int dRenderHeight = (int)a_packet.Height;
+	if (m_pDynamicResolution->IsEnabled())
+	{
+		m_pDynamicResolution->GetRenderSize(dRenderWidth, dRenderHeight);
+	}
+	ImGui::Text("Shaded fragments: %llu (%.2f per pixel)",
+		(unsigned long long)m_pOverdrawCounter->GetShadedSamples(),
+		m_pOverdrawCounter->GetOverdraw(dRenderWidth, dRenderHeight));
+
+	// Scene resolution following its GPU time.
+	bool bUseDynamicResolution = m_pDynamicResolution->IsEnabled();
+	if (ImGui::Checkbox("Dynamic resolution", &bUseDynamicResolution))
+	{
+		m_pDynamicResolution->SetEnabled(bUseDynamicResolution);
+		BuildFrameGraph();
+	}
+	if (bUseDynamicResolution)
+	{
+		float fTargetMS = m_pDynamicResolution->GetTargetTime();
+		if (ImGui::SliderFloat("GPU budget (ms)", &fTargetMS, 1.0f, 33.0f, "%.1f"))
+		{
+			m_pDynamicResolution->SetTargetTime(fTargetMS);
+		}
+		float lBounds[2] = { m_pDynamicResolution->GetMinScale(), m_pDynamicResolution->GetMaxScale() };
+		if (ImGui::SliderFloat2("Scale bounds", lBounds, 0.25f, 2.0f, "%.2f"))
+		{
+			m_pDynamicResolution->SetBounds(lBounds[0], lBounds[1]);
+			BuildFrameGraph();
+		}
+		ImGui::Text("Scene at %dx%d (%.0f%%), GPU %.2f ms", dRenderWidth, dRenderHeight,
+			m_pDynamicResolution->GetScale() * 100.0f, m_pDynamicResolution->GetGPUTime());
+	}
+
+	// Textures still arriving from the streamer and how they reach the shaders.
+	TextureTable* pTextureTable = TextureTable::GetInstance();
+	TextureStreamer* pStreamer = TextureStreamer::GetInstance();
+	ImGui::Text("Streaming textures: %d (%.2f MB this frame)",
+		pStreamer->GetPendingCount(), pStreamer->GetUploadedBytes() / (1024.0f * 1024.0f));
+
+	ImGui::Text("Texture backend: %s (%d slots, %d arrays)", pTextureTable->GetBackendName(),
+		pTextureTable->GetSlotCount(), pTextureTable->GetArrayCount());
+
+	// Time spent getting the programs ready at startup.
+	ShaderCache* pShaderCache = ShaderCache::GetInstance();
+	ImGui::Text("Shader setup: %.2f ms (%d cached, %d compiled)",
+		pShaderCache->GetSetupTime(), pShaderCache->GetHits(), pShaderCache->GetMisses());
+
+	// Toggling features compiles their variant in the background on first use.
+	bool bHasFog = (m_uShaderFeatures & SHADER_FOG) != 0;
+	bool bHasAlphaTest = (m_uShaderFeatures & SHADER_ALPHA_TEST) != 0;
+	bool bChanged = ImGui::Checkbox("Fog", &bHasFog);
+	ImGui::SameLine();
+	bChanged |= ImGui::Checkbox("Alpha test", &bHasAlphaTest);
+	if (bChanged)
+	{
+		m_uShaderFeatures = (bHasFog ? SHADER_FOG : 0) | (bHasAlphaTest ? SHADER_ALPHA_TEST : 0);
+		for (int i = 0; i < m_lEntities.size(); i++)
+		{
+			m_lEntities[i]->GetMaterial()->SetFeatures(m_uShaderFeatures);
+		}
+		BuildFrameGraph();
+	}
+	ImGui::Text("Shader variants: %d (%d compiling%s)", m_pEntityShaders->GetVariantCount(),
+		m_pEntityShaders->GetPendingCount(), Shader::SupportsParallelCompile() ? ", parallel" : "");
+
+	// Render passes of the last compiled frame graph.
+	const FGStats& graphStats = m_pFrameGraph->GetStats();
+	ImGui::Text("Render passes: %d (%d culled)", graphStats.Passes, graphStats.CulledPasses);
+	ImGui::Text("Transient targets: %d in %d textures (%.2f MB aliased to %.2f MB)",
+		graphStats.TransientTextures, graphStats.PhysicalTextures,
+		graphStats.TransientBytes / (1024.0f * 1024.0f), graphStats.AliasedBytes / (1024.0f * 1024.0f));
 
 	// Closing the window.
 	ImGui::End();
-}
\ No newline at end of file
+
+	ShowFrameStats();
+	ShowRenderStats();
+	ShowMemory();
+	ShowGPUProfiler();
+	ShowCPUProfiler();
+}
+
+void Application::ShowGPUProfiler(void)
+{
+	ImGui::Begin("GPU Profiler");
+
+	bool bIsEnabled = m_pGPUProfiler->IsEnabled();
+	if (ImGui::Checkbox("Measure passes", &bIsEnabled))
+	{
+		m_pGPUProfiler->SetEnabled(bIsEnabled);
+	}
+	if (m_pGPUProfiler->SupportsStatistics())
+	{
+		ImGui::SameLine();
+		bool bUseStatistics = m_pGPUProfiler->IsStatisticsEnabled();
+		if (ImGui::Checkbox("Pipeline statistics", &bUseStatistics))
+		{
+			m_pGPUProfiler->SetStatisticsEnabled(bUseStatistics);
+		}
+	}
+
+	if (bIsEnabled)
+	{
+		// Results are a few frames old, the queries are read once the GPU is surely done.
+		const std::vector<GPUScope>& lResults = m_pGPUProfiler->GetResults();
+		bool bUseStatistics = m_pGPUProfiler->IsStatisticsEnabled();
+		ImGui::Text("GPU frame: %.3f ms", m_pGPUProfiler->GetFrameTime());
+		if (ImGui::BeginTable("Passes", bUseStatistics ? 5 : 2))
+		{
+			ImGui::TableSetupColumn("Pass");
+			ImGui::TableSetupColumn("ms");
+			if (bUseStatistics)
+			{
+				ImGui::TableSetupColumn("Vertices");
+				ImGui::TableSetupColumn("Primitives");
+				ImGui::TableSetupColumn("Fragments");
+			}
+			ImGui::TableHeadersRow();
+			for (int i = 0; i < lResults.size(); i++)
+			{
+				const GPUScope& scope = lResults[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%*s%s", scope.Depth * 2, "", scope.Name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", scope.MS);
+				if (bUseStatistics)
+				{
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)scope.Vertices);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)scope.Primitives);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)scope.Fragments);
+				}
+			}
+			ImGui::EndTable();
+		}
+
+		// Averages since the last reset, for comparing runs offline.
+		if (ImGui::Button("Export gpu_profile.json"))
+		{
+			m_pGPUProfiler->Export("gpu_profile.json");
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reset averages"))
+		{
+			m_pGPUProfiler->ResetTotals();
+		}
+	}
+
+	ImGui::End();
+}
+
+void Application::ShowFrameStats(void)
+{
+	ImGui::Begin("Frame Statistics");
+
+	float fBudgetMS = m_pFrameStats->GetBudget();
+	if (ImGui::SliderFloat("Budget (ms)", &fBudgetMS, 1.0f, 50.0f, "%.2f"))
+	{
+		m_pFrameStats->SetBudget(fBudgetMS);
+	}
+	FrameSummary frame = m_pFrameStats->GetSummary(STAGE_FRAME);
+	ImGui::Text("Over budget: %d of the last %d frames (%llu of %llu overall)", frame.OverBudget,
+		m_pFrameStats->GetCount(), m_pFrameStats->GetTotalOverBudget(), m_pFrameStats->GetTotalFrames());
+
+	// Frame times oldest to newest, scaled so the budget sits halfway up.
+	char sOverlay[64];
+	snprintf(sOverlay, sizeof(sOverlay), "budget %.2f ms", fBudgetMS);
+	ImGui::PlotLines("Frame times", m_pFrameStats->GetSamples(STAGE_FRAME), m_pFrameStats->GetCount(),
+		m_pFrameStats->GetOffset(), sOverlay, 0.0f, fBudgetMS * 2.0f, ImVec2(0.0f, 80.0f));
+
+	float lBuckets[FRAME_STATS_BUCKETS];
+	m_pFrameStats->GetHistogram(STAGE_FRAME, lBuckets);
+	snprintf(sOverlay, sizeof(sOverlay), "0 to %.1f ms", fBudgetMS * 2.0f);
+	ImGui::PlotHistogram("Histogram", lBuckets, FRAME_STATS_BUCKETS, 0, sOverlay, 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+
+	if (ImGui::BeginTable("Stages", 6))
+	{
+		ImGui::TableSetupColumn("Stage");
+		ImGui::TableSetupColumn("mean");
+		ImGui::TableSetupColumn("p50");
+		ImGui::TableSetupColumn("p95");
+		ImGui::TableSetupColumn("p99");
+		ImGui::TableSetupColumn("max");
+		ImGui::TableHeadersRow();
+		for (int i = 0; i < STAGE_COUNT; i++)
+		{
+			FrameSummary summary = m_pFrameStats->GetSummary((FrameStage)i);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", FrameStats::GetStageName((FrameStage)i));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", summary.MeanMS);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", summary.P50MS);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", summary.P95MS);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", summary.P99MS);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", summary.MaxMS);
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImGui::Button("Export frames.csv"))
+	{
+		m_pFrameStats->ExportCSV("frames.csv");
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export frames.json"))
+	{
+		m_pFrameStats->ExportJSON("frames.json");
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset"))
+	{
+		m_pFrameStats->Reset();
+	}
+
+	ImGui::End();
+}
+
+void Application::ShowRenderStats(void)
+{
+	ImGui::Begin("Render Statistics");
+
+	// The last finished frame next to the mean and worst since the last reset.
+	const RenderCounters& last = RenderStats::GetLastFrame();
+	const RenderCounters& totals = RenderStats::GetTotals();
+	const RenderCounters& peaks = RenderStats::GetPeaks();
+	int dFrames = RenderStats::GetFrameCount();
+	ImGui::Text("Frames: %d", dFrames);
+	if (ImGui::BeginTable("Counters", 4))
+	{
+		ImGui::TableSetupColumn("Counter");
+		ImGui::TableSetupColumn("Last");
+		ImGui::TableSetupColumn("Mean");
+		ImGui::TableSetupColumn("Max");
+		ImGui::TableHeadersRow();
+		for (int i = 0; i < RS_COUNTER_COUNT; i++)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", RenderStats::GetCounterName((RenderCounter)i));
+			ImGui::TableNextColumn();
+			ImGui::Text("%lld", last.Values[i]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", dFrames > 0 ? (double)totals.Values[i] / dFrames : 0.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%lld", peaks.Values[i]);
+		}
+		ImGui::EndTable();
+	}
+	if (ImGui::Button("Reset"))
+	{
+		RenderStats::ResetTotals();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export render_stats.json"))
+	{
+		RenderStats::Export("render_stats.json");
+	}
+
+	ImGui::End();
+}
+
+void Application::ShowMemory(void)
+{
+	ImGui::Begin("Memory");
+
+	const float fMB = 1024.0f * 1024.0f;
+	if (ImGui::BeginTable("Subsystems", 5))
+	{
+		ImGui::TableSetupColumn("Subsystem");
+		ImGui::TableSetupColumn("CPU MB");
+		ImGui::TableSetupColumn("CPU peak");
+		ImGui::TableSetupColumn("GPU MB");
+		ImGui::TableSetupColumn("GPU peak");
+		ImGui::TableHeadersRow();
+		for (int i = 0; i <= MEMORY_TAG_COUNT; i++)
+		{
+			// The last row is every subsystem together.
+			bool bIsTotal = i == MEMORY_TAG_COUNT;
+			MemoryUsage cpu = bIsTotal ? MemoryTracker::GetTotal(MEMORY_CPU) : MemoryTracker::GetUsage(MEMORY_CPU, (MemoryTag)i);
+			MemoryUsage gpu = bIsTotal ? MemoryTracker::GetTotal(MEMORY_GPU) : MemoryTracker::GetUsage(MEMORY_GPU, (MemoryTag)i);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", bIsTotal ? "total" : MemoryTracker::GetTagName((MemoryTag)i));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f (%lld)", cpu.Bytes / fMB, cpu.Allocations);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", cpu.PeakBytes / fMB);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f (%lld)", gpu.Bytes / fMB, gpu.Allocations);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", gpu.PeakBytes / fMB);
+		}
+		ImGui::EndTable();
+	}
+	if (ImGui::Button("Reset peaks"))
+	{
+		MemoryTracker::ResetPeaks();
+	}
+
+	// Heap allocations per frame, which should stop once the engine has warmed up.
+	ImGui::Separator();
+	if (!AllocationCounter::IsAvailable())
+	{
+		ImGui::TextDisabled("Only ImGui's allocations are counted without AERO_COUNT_ALLOCATIONS.");
+	}
+	AllocationCheck eCheck = AllocationCounter::GetCheck();
+	if (ImGui::BeginCombo("Allocation check", AllocationCounter::GetCheckName(eCheck)))
+	{
+		for (int i = 0; i < ALLOCATION_CHECK_COUNT; i++)
+		{
+			if (ImGui::Selectable(AllocationCounter::GetCheckName((AllocationCheck)i), i == eCheck))
+			{
+				AllocationCounter::SetCheck((AllocationCheck)i);
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::Text("Last frame: %lld allocations (%lld bytes)",
+		AllocationCounter::GetLastAllocations(), AllocationCounter::GetLastBytes());
+	if (AllocationCounter::IsSteady())
+	{
+		ImGui::Text("Steady frames allocating: %lld of %lld (%lld allocations)", AllocationCounter::GetAllocatingFrames(),
+			AllocationCounter::GetSteadyFrames(), AllocationCounter::GetSteadyAllocations());
+	}
+	else
+	{
+		ImGui::TextDisabled("Warming up");
+	}
+	if (ImGui::Button("Restart steady state"))
+	{
+		AllocationCounter::StartSteadyState(0);
+	}
+
+	ImGui::End();
+}
+
+void Application::ShowCPUProfiler(void)
+{
+	ImGui::Begin("CPU Profiler");
+
+	bool bIsEnabled = CPUProfiler::IsEnabled();
+	if (ImGui::Checkbox("Record zones", &bIsEnabled))
+	{
+		CPUProfiler::SetEnabled(bIsEnabled);
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120.0f);
+	ImGui::SliderInt("Frames", &m_dFlameFrames, 1, CPU_PROFILER_FRAMES - 1);
+	ImGui::SameLine();
+	CPUProfiler* pProfiler = CPUProfiler::GetInstance();
+	if (ImGui::Button("Export cpu_trace.json"))
+	{
+		pProfiler->ExportTrace("cpu_trace.json");
+	}
+
+	// Hardware counters per zone, where the platform allows them.
+	bool bIsCounting = CPUProfiler::IsCounting();
+	if (ImGui::Checkbox("Hardware counters", &bIsCounting))
+	{
+		CPUProfiler::SetCounting(bIsCounting);
+	}
+	if (!CPUProfiler::IsCounting() && PerfCounters::GetError()[0] != '\0')
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("(%s)", PerfCounters::GetError());
+	}
+
+	uint64_t uBegin = 0;
+	uint64_t uEnd = 0;
+	if (!bIsEnabled || !pProfiler->GetFrameRange(m_dFlameFrames, uBegin, uEnd) || uEnd <= uBegin)
+	{
+		ImGui::End();
+		return;
+	}
+	pProfiler->Collect(uBegin, uEnd, m_lFlameZones);
+	ImGui::Text("Last %d frames: %.2f ms", m_dFlameFrames, (uEnd - uBegin) / 1000000.0f);
+
+	// Finding how deep every thread's lane has to be.
+	int dThreads = pProfiler->GetThreadCount();
+	int lDepths[CPU_PROFILER_MAX_THREADS];
+	for (int i = 0; i < dThreads; i++)
+	{
+		lDepths[i] = -1;
+	}
+	for (int i = 0; i < m_lFlameZones.size(); i++)
+	{
+		const CPUZoneRecord& record = m_lFlameZones[i];
+		lDepths[record.Thread] = std::max(lDepths[record.Thread], record.Zone.Depth);
+	}
+
+	// One lane per thread, one row per nesting level, time running left to right.
+	const float fLabelWidth = 90.0f;
+	const float fRowHeight = ImGui::GetTextLineHeight() + 2.0f;
+	ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+	ImVec2 v2Origin = ImGui::GetCursorScreenPos();
+	float fWidth = std::max(ImGui::GetContentRegionAvail().x - fLabelWidth, 50.0f);
+	double dPixelsPerNS = fWidth / (double)(uEnd - uBegin);
+	float lLaneY[CPU_PROFILER_MAX_THREADS];
+	float fHeight = 0.0f;
+	for (int i = 0; i < dThreads; i++)
+	{
+		lLaneY[i] = v2Origin.y + fHeight;
+		if (lDepths[i] < 0) continue;
+
+		pDrawList->AddText(ImVec2(v2Origin.x, lLaneY[i]), IM_COL32(220, 220, 220, 255), pProfiler->GetThreadName(i));
+		fHeight += (lDepths[i] + 1) * fRowHeight + 4.0f;
+	}
+
+	ImVec2 v2Mouse = ImGui::GetIO().MousePos;
+	for (int i = 0; i < m_lFlameZones.size(); i++)
+	{
+		const CPUZone& zone = m_lFlameZones[i].Zone;
+		float fX0 = v2Origin.x + fLabelWidth + (float)((std::max(zone.Begin, uBegin) - uBegin) * dPixelsPerNS);
+		float fX1 = v2Origin.x + fLabelWidth + (float)((std::min(zone.End, uEnd) - uBegin) * dPixelsPerNS);
+		fX1 = std::max(fX1, fX0 + 1.0f);
+		float fY0 = lLaneY[m_lFlameZones[i].Thread] + zone.Depth * fRowHeight;
+		float fY1 = fY0 + fRowHeight - 1.0f;
+
+		// Coloring by name so the same zone looks the same in every frame.
+		float fHue = (float)(((uintptr_t)zone.Name >> 3) % 64) / 64.0f;
+		pDrawList->AddRectFilled(ImVec2(fX0, fY0), ImVec2(fX1, fY1), ImColor::HSV(fHue, 0.5f, 0.7f));
+		if (fX1 - fX0 > 20.0f)
+		{
+			pDrawList->PushClipRect(ImVec2(fX0, fY0), ImVec2(fX1, fY1), true);
+			pDrawList->AddText(ImVec2(fX0 + 2.0f, fY0), IM_COL32(0, 0, 0, 255), zone.Name);
+			pDrawList->PopClipRect();
+		}
+
+		if (v2Mouse.x >= fX0 && v2Mouse.x < fX1 && v2Mouse.y >= fY0 && v2Mouse.y < fY1)
+		{
+			ImGui::SetTooltip("%s\n%.3f ms", zone.Name, (zone.End - zone.Begin) / 1000000.0f);
+		}
+	}
+	ImGui::Dummy(ImVec2(fLabelWidth + fWidth, fHeight));
+
+	// Zones of the shown frames added up by name.  Counters are per item where the zone counts items.
+	CPUProfiler::Summarize(m_lFlameZones, m_lZoneTotals);
+	if (ImGui::BeginTable("Zones", 8, ImGuiTableFlags_Borders))
+	{
+		ImGui::TableSetupColumn("Zone");
+		ImGui::TableSetupColumn("Calls");
+		ImGui::TableSetupColumn("ms");
+		ImGui::TableSetupColumn("Per");
+		ImGui::TableSetupColumn("IPC");
+		ImGui::TableSetupColumn("L1D misses");
+		ImGui::TableSetupColumn("LLC misses");
+		ImGui::TableSetupColumn("Branch misses");
+		ImGui::TableHeadersRow();
+		for (int i = 0; i < m_lZoneTotals.size(); i++)
+		{
+			const CPUZoneTotals& totals = m_lZoneTotals[i];
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", totals.Name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%d", totals.Calls);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", totals.MS);
+			if (totals.CountedCalls == 0) continue;
+
+			const uint64_t* lValues = totals.Counters.Values;
+			bool bIsPerItem = totals.CountedItems > 0;
+			double dPer = (double)(bIsPerItem ? totals.CountedItems : totals.CountedCalls);
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", bIsPerItem ? "item" : "call");
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", lValues[PERF_CYCLES] > 0 ? (double)lValues[PERF_INSTRUCTIONS] / lValues[PERF_CYCLES] : 0.0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", lValues[PERF_L1D_MISSES] / dPer);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", lValues[PERF_LLC_MISSES] / dPer);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", lValues[PERF_BRANCH_MISSES] / dPer);
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
@@ -2,7 +2,9 @@
 #define __APPLICATION_H_
 
 #include <GL/glew.h>
+#ifdef _WIN32
 #include <GL/wglew.h>
+#endif
 
 #include <SFML/Window.hpp>
 #include <SFML/OpenGL.hpp>
@@ -13,6 +15,25 @@
 #include "Camera.h"
 #include "SkyBox.h"
 #include "Entity.h"
+#include "SceneTree.h"
+#include "OcclusionCuller.h"
+#include "FrameGraph.h"
+#include "OverdrawCounter.h"
+#include "ShaderVariants.h"
+#include "HeadlessContext.h"
+#include "FrameQueue.h"
+#include "CommandList.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "DynamicResolution.h"
+#include "GPUProfiler.h"
+#include "CPUProfiler.h"
+#include "FrameStats.h"
+#include "DebugView.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 typedef unsigned int uint;
 
@@ -24,14 +45,62 @@ class Application
 private:
 	// Fields for the window itself:
 	sf::Window* m_pWindow = nullptr;
+	HeadlessContext* m_pHeadless = nullptr;		// Replaces the window when running without a display.
+	bool m_bHasGUI = false;
 	sf::Time m_pTime;
 	glm::vec3 m_v3Mouse = glm::vec3();
 	bool m_bIsRunning = false;
 
 	// General testing fields:
 	std::vector<Entity*> m_lEntities;
+	std::vector<void*> m_lVisibleEntities;
+	SceneTree* m_pSceneTree = nullptr;
+	OcclusionCuller* m_pOcclusionCuller = nullptr;
+	std::atomic<bool> m_bUseOcclusionCulling{ true };	// Set by the GUI on the render thread.
+	std::atomic<int> m_dDebugView{ DEBUG_VIEW_NONE };	// Set by the GUI on the render thread.
+	DebugView* m_pDebugView = nullptr;
+	std::vector<void*> m_lFrustumEntities;		// Sorted for the culling view, kept between frames.
+	std::vector<void*> m_lDrawnEntities;
+	FrameGraph* m_pFrameGraph = nullptr;
+	OverdrawCounter* m_pOverdrawCounter = nullptr;
+	DynamicResolution* m_pDynamicResolution = nullptr;
+	GPUProfiler* m_pGPUProfiler = nullptr;
+	std::atomic<bool> m_bResetStats{ false };	// Set by the benchmark once warmup is over.
+	int m_dFlameFrames = 3;
+	std::vector<CPUZoneRecord> m_lFlameZones;
+	std::vector<CPUZoneTotals> m_lZoneTotals;
+	std::shared_ptr<Shader> m_pDepthShader = nullptr;
+	GLint m_dDepthWVPLocation = -1;
+	bool m_bUseDepthPrepass = false;
+	std::shared_ptr<ShaderVariants> m_pEntityShaders = nullptr;
+	unsigned int m_uShaderFeatures = 0;
 	Camera* m_pCamera = nullptr;
 	SkyBox* m_pSky = nullptr;
+	float m_fSimulationMS = 0.0f;
+	FixedTimestep* m_pTimestep = nullptr;
+	std::atomic<float> m_fSimulationRate{ SIMULATION_RATE };	// Set by the GUI on the render thread.
+	FramePacer* m_pFramePacer = nullptr;
+	std::atomic<float> m_fTargetFramerate{ FRAME_PACER_RATE };			// Set by the GUI on the render thread.
+	std::atomic<bool> m_bUseLowLatency{ false };
+	std::chrono::high_resolution_clock::time_point m_tInputTime;
+
+	// Fields for the render thread, which owns the GL context while Run is going:
+	FrameQueue* m_pFrameQueue = nullptr;
+	std::thread m_tRenderThread;
+	const FramePacket* m_pPacket = nullptr;		// Packet being drawn.  Read by the render passes.
+	sf::Vector2u m_v2GraphSize = sf::Vector2u();
+	float m_fRenderMS = 0.0f;
+	bool m_bRecordPresents = false;
+	FrameStats* m_pFrameStats = nullptr;
+	bool m_bHasPresented = false;
+	std::chrono::high_resolution_clock::time_point m_tLastPresent;
+	std::vector<std::chrono::high_resolution_clock::time_point> m_lPresentTimes;
+
+	// Fields for recording the draws of a frame on several threads:
+	std::vector<CommandList> m_lCommandLists;	// One per recording thread, replayed in order.
+	int m_dRecordThreads = 1;
+	float m_fRecordMS = 0.0f;
+	std::vector<float> m_lRecordTimes;
 public:
 	/// <summary>
 	/// Constructs the Application object.
@@ -46,11 +115,79 @@ public:
 	/// <param name="a_uHeight">Height of the window. Defaults to 600.</param>
 	void Init(std::string a_sAppName = "Window", uint a_uWidth = 800, uint a_uHeight = 600);
 
+	/// <summary>
+	/// Initializes a rendering context without a window and the same scene as Init.
+	/// </summary>
+	/// <param name="a_eBackend">API used to create the context.</param>
+	/// <param name="a_uWidth">Width of the off screen framebuffer.</param>
+	/// <param name="a_uHeight">Height of the off screen framebuffer.</param>
+	/// <returns>False if the context could not be created.</returns>
+	bool InitHeadless(HeadlessBackend a_eBackend, uint a_uWidth = 800, uint a_uHeight = 600);
+
 	/// <summary>
 	/// Runs the main loop of the Simulation.
 	/// </summary>
 	void Run(void);
 
+	/// <summary>
+	/// Flies the camera along a fixed path and writes the frame time statistics as JSON.
+	/// </summary>
+	/// <param name="a_dFrames">Number of measured frames.</param>
+	/// <param name="a_sOutputFile">Path of the JSON report.</param>
+	/// <param name="a_bUseRenderThread">Whether frames are drawn on the render thread, as in Run.</param>
+	/// <returns>False if the report could not be written.</returns>
+	bool RunBenchmark(int a_dFrames, std::string a_sOutputFile, bool a_bUseRenderThread = true);
+
+	/// <summary>
+	/// Adds copies of the scene's entities in a grid along the benchmark path.
+	/// </summary>
+	/// <param name="a_dCount">Number of entities added.</param>
+	void AddBenchmarkEntities(int a_dCount);
+
+	/// <summary>
+	/// Sets the number of simulation steps per second.
+	/// </summary>
+	void SetSimulationRate(float a_fStepsPerSecond);
+
+	/// <summary>
+	/// Sets the framerate the simulation thread is limited to.  0 leaves frames unlimited.
+	/// </summary>
+	void SetTargetFramerate(float a_fFramesPerSecond);
+
+	/// <summary>
+	/// Draws the scene at a resolution scaled to hold a GPU time budget.  Call before running.
+	/// </summary>
+	/// <param name="a_fTargetMS">GPU time budget of the scene in milliseconds.</param>
+	/// <param name="a_fMinScale">Smallest fraction of the window's resolution.</param>
+	/// <param name="a_fMaxScale">Largest fraction of the window's resolution.</param>
+	void EnableDynamicResolution(float a_fTargetMS, float a_fMinScale, float a_fMaxScale);
+
+	/// <summary>
+	/// Measures every render pass on the GPU.  Benchmarks export the averages next to their report.
+	/// </summary>
+	/// <param name="a_bUseStatistics">Whether vertices, primitives and fragments are counted too.</param>
+	void EnableGPUProfiler(bool a_bUseStatistics);
+
+	/// <summary>
+	/// Sets whether frames start as late as their latency allows, so input is sampled right before simulating.
+	/// </summary>
+	void SetLowLatency(bool a_bIsLowLatency);
+
+	/// <summary>
+	/// Sets the debug view the scene is drawn with.
+	/// </summary>
+	void SetDebugView(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Sets how many threads record the draws of a frame.  Clamped to the ThreadPool's workers plus one.
+	/// </summary>
+	void SetRecordThreads(int a_dThreads);
+
+	/// <summary>
+	/// Gets the most threads that can record the draws of a frame.
+	/// </summary>
+	int GetMaxRecordThreads(void);
+
 	/// <summary>
 	/// Safely Destructs the Application object.
 	/// </summary>
@@ -76,19 +213,142 @@ private:
 	void InitWindow();
 
 	/// <summary>
-	/// Frame to frame update method for the Application.
+	/// Sets the GL state every frame relies on.  Helper method for InitWindow and InitHeadless.
+	/// </summary>
+	void InitRenderState();
+
+	/// <summary>
+	/// Loads the shaders, meshes and entities.  Requires a current GL context.
+	/// </summary>
+	void InitScene(void);
+
+	/// <summary>
+	/// Gets the size of the window, or of the headless framebuffer.
+	/// </summary>
+	sf::Vector2u GetFramebufferSize(void);
+
+	/// <summary>
+	/// Moves the camera and runs as many fixed simulation steps as the frame's time allows.
+	/// Runs on the simulation thread.
+	/// </summary>
+	/// <param name="a_fFrameSeconds">Real time since the previous frame.</param>
+	void Simulate(float a_fFrameSeconds);
+
+	/// <summary>
+	/// Advances the simulation by one fixed step.  Runs on the simulation thread.
+	/// </summary>
+	/// <param name="a_fStep">Length of the step in seconds.</param>
+	void Update(float a_fStep);
+
+	/// <summary>
+	/// Culls the scene and copies the visible state into a frame packet.
 	/// </summary>
-	void Update(void);
+	/// <param name="a_packet">Packet owned by the simulation thread until it is submitted.</param>
+	void BuildPacket(FramePacket& a_packet);
 
 	/// <summary>
-	/// Dictates what to render within the Application.
+	/// Builds the next packet and hands it to the render thread.
 	/// </summary>
-	void Render(void);
+	void SubmitFrame(void);
+
+	/// <summary>
+	/// Draws a frame packet.  Runs on whichever thread owns the GL context.
+	/// </summary>
+	void RenderFrame(const FramePacket& a_packet);
+
+	/// <summary>
+	/// Splits the packet's draws into contiguous chunks and records each into its own
+	/// CommandList on the ThreadPool.
+	/// </summary>
+	void RecordCommands(const FramePacket& a_packet);
+
+	/// <summary>
+	/// Replays the recorded CommandLists in order.  Must run on the thread owning the GL context.
+	/// </summary>
+	/// <param name="a_bIsDepthOnly">Keeps the bound depth shader instead of binding materials.</param>
+	/// <param name="a_dWVPLocation">WVP location of the bound depth shader when depth only.</param>
+	void ReplayCommands(bool a_bIsDepthOnly, GLint a_dWVPLocation = -1);
+
+	/// <summary>
+	/// Waits for the frame pacer, picking up settings changed from the GUI first.
+	/// </summary>
+	void PaceFrame(void);
+
+	/// <summary>
+	/// Shows the finished frame.
+	/// </summary>
+	/// <param name="a_packet">The frame shown, for measuring its latency.</param>
+	void Present(const FramePacket& a_packet);
+
+	/// <summary>
+	/// Moves the GL context to the render thread and starts it.
+	/// </summary>
+	void StartRenderThread(void);
+
+	/// <summary>
+	/// Waits for the render thread to draw what was submitted and takes the GL context back.
+	/// </summary>
+	void StopRenderThread(void);
+
+	/// <summary>
+	/// Body of the render thread.  Draws packets until the queue is stopped.
+	/// </summary>
+	void RenderLoop(void);
+
+	/// <summary>
+	/// Makes the window's or the headless context current on the calling thread, or releases it.
+	/// </summary>
+	void SetContextActive(bool a_bIsActive);
+
+	/// <summary>
+	/// Declares the render passes of a frame.  Rebuilt on the render thread whenever the
+	/// window changes size or the depth prepass is toggled.
+	/// </summary>
+	void BuildFrameGraph(void);
 
 	/// <summary>
 	/// Implements ImGui functionality to a user interface in the application.
 	/// </summary>
-	void SetGUI(float a_fDeltaTime);
+	/// <param name="a_packet">The frame being drawn.</param>
+	void SetGUI(const FramePacket& a_packet);
+
+	/// <summary>
+	/// Shows the GPU profiler's last results in their own window.
+	/// </summary>
+	void ShowGPUProfiler(void);
+
+	/// <summary>
+	/// Shows the frame time graph, histogram and percentiles of every stage in their own window.
+	/// </summary>
+	void ShowFrameStats(void);
+
+	/// <summary>
+	/// Shows the draw calls, state changes and culling counts per frame in their own window.
+	/// </summary>
+	void ShowRenderStats(void);
+
+	/// <summary>
+	/// Shows the CPU and GPU memory of every subsystem in their own window.
+	/// </summary>
+	void ShowMemory(void);
+
+	/// <summary>
+	/// Shows the CPU zones of the last few frames as a flame view in their own window.
+	/// </summary>
+	void ShowCPUProfiler(void);
+
+	/// <summary>
+	/// Removes the entities hidden behind occluders from the visible list.
+	/// </summary>
+	/// <param name="a_m4ViewProjection">Projection * view matrix of the active Camera.</param>
+	/// <param name="a_fAlpha">Interpolation between the last two steps the entities are drawn at.</param>
+	void CullOccludedEntities(const glm::mat4& a_m4ViewProjection, float a_fAlpha);
+
+	/// <summary>
+	/// Places the camera along the benchmark's fixed path.
+	/// </summary>
+	/// <param name="a_fProgress">Position along the path from 0 to 1.</param>
+	void FollowBenchmarkPath(float a_fProgress);
 
 	/// <summary>
 	/// Clears everything off of the screen for the next frame.
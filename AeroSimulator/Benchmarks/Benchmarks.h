@@ -0,0 +1,22 @@
+#ifndef __BENCHMARKS_H_
+#define __BENCHMARKS_H_
+
+#include <string>
+
+/// <summary>
+/// Measures insert, refit and query throughput of the SceneTree.
+/// </summary>
+void RunSceneTreeBenchmark(void);
+
+/// <summary>
+/// Measures the software occlusion culler on a dense city block scene.
+/// </summary>
+void RunOcclusionBenchmark(void);
+
+/// <summary>
+/// Runs the microbenchmarks of the engine's hot paths through MicroBenchmark.
+/// </summary>
+/// <param name="a_sModelFolder">Folder holding the models parsed, ending in a slash.</param>
+void RunCoreBenchmarks(const std::string& a_sModelFolder);
+
+#endif //__BENCHMARKS_H_
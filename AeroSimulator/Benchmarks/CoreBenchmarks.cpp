@@ -0,0 +1,341 @@
+#include "Benchmarks.h"
+#include "MicroBenchmark.h"
+#include "../Transform.h"
+#include "../Camera.h"
+#include "../Bounds.h"
+#include "../Mesh.h"
+#include "../FileReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Boxes tested by each call of the bounds benchmarks.
+#define BOX_COUNT 1024
+
+// Distinct unsorted key sets the render queue benchmark rotates through.
+#define SORT_KEY_SETS 64
+
+// Written next to the executable for the FileReader benchmarks and deleted afterwards.
+#define SMALL_FILE "microbench_small.txt"
+#define LARGE_FILE "microbench_large.txt"
+#define SMALL_FILE_LINES 64
+#define LARGE_FILE_LINES 32768
+
+static const char* MODEL_NAMES[] = { "cube", "cylinder", "sphere", "torus", "helix" };
+
+/// <summary>
+/// Key of a draw in a render queue, ordered by what rebinding costs the most.
+/// The pipeline takes the top bits, then the geometry, then the view depth so
+/// draws sharing both go front to back.
+/// </summary>
+struct RenderKey
+{
+	unsigned long long Key;
+	unsigned int Draw;		// Index of the draw the key belongs to.
+
+	bool operator<(const RenderKey& a_other) const { return Key < a_other.Key; }
+};
+
+/// <summary>
+/// Packs a draw's pipeline, geometry and depth into a RenderKey.
+/// </summary>
+static RenderKey MakeRenderKey(unsigned int a_uPipeline, unsigned int a_uGeometry, float a_fDepth, unsigned int a_uDraw)
+{
+	// Positive floats order the same as their bits, the top 32 of 64 bits are plenty.
+	unsigned int uDepth = 0;
+	float fDepth = std::max(a_fDepth, 0.0f);
+	memcpy(&uDepth, &fDepth, sizeof(float));
+
+	RenderKey key = RenderKey();
+	key.Key = ((unsigned long long)(a_uPipeline & 0xFFFF) << 48) | ((unsigned long long)(a_uGeometry & 0xFFFF) << 32) | uDepth;
+	key.Draw = a_uDraw;
+	return key;
+}
+
+/// <summary>
+/// Builds random boxes spread through a 100 unit cube around the origin.
+/// </summary>
+static std::vector<AABB> MakeBoxes(std::mt19937& a_rng)
+{
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.25f, 4.0f);
+	std::vector<AABB> lBoxes(BOX_COUNT);
+	for (int i = 0; i < BOX_COUNT; i++)
+	{
+		glm::vec3 v3Min = glm::vec3(position(a_rng), position(a_rng), position(a_rng));
+		lBoxes[i] = AABB(v3Min, v3Min + glm::vec3(size(a_rng), size(a_rng), size(a_rng)));
+	}
+	return lBoxes;
+}
+
+/// <summary>
+/// Writes a text file of a number of shader sized lines.
+/// </summary>
+static bool WriteTextFile(const char* a_sPath, int a_dLines)
+{
+	std::ofstream writer(a_sPath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the benchmark file " << a_sPath << std::endl;
+		return false;
+	}
+	for (int i = 0; i < a_dLines; i++)
+	{
+		writer << "\tvec3 v3Value" << i << " = normalize(v3Normal * " << (i % 97) << ".0 + v3Light);\n";
+	}
+	return true;
+}
+
+/// <summary>
+/// Measures recalculating the world matrices and the direction getters.
+/// </summary>
+static void BenchmarkTransform(void)
+{
+	// Rotating around all three axes, so every path of the direction getters runs.
+	Transform transform = Transform();
+	transform.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+	transform.SetRotation(glm::vec3(0.3f, 1.1f, -0.4f));
+	transform.SetScale(glm::vec3(2.0f));
+
+	// Moving the Transform before every read, so each GetWorld recalculates the matrices.
+	MicroBenchmark::Run("transform/calculate_matrices", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			transform.SetPosition(glm::vec3((float)(i & 15), 2.0f, 3.0f));
+			glm::mat4 m4World = transform.GetWorld();
+			MicroBenchmark::Keep(m4World);
+		}
+	});
+	MicroBenchmark::Run("transform/get_forward", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			glm::vec3 v3Forward = transform.GetForward();
+			MicroBenchmark::Keep(v3Forward);
+		}
+	});
+	MicroBenchmark::Run("transform/get_up", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			glm::vec3 v3Up = transform.GetUp();
+			MicroBenchmark::Keep(v3Up);
+		}
+	});
+	MicroBenchmark::Run("transform/get_right", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			glm::vec3 v3Right = transform.GetRight();
+			MicroBenchmark::Keep(v3Right);
+		}
+	});
+}
+
+/// <summary>
+/// Measures rebuilding the Camera's view matrix.
+/// </summary>
+static void BenchmarkCamera(void)
+{
+	Camera camera = Camera(16.0f / 9.0f, 60.0f);
+	camera.GetTransform().SetPosition(glm::vec3(0.0f, 2.0f, -10.0f));
+	camera.GetTransform().SetRotation(glm::vec3(0.2f, 0.7f, 0.0f));
+
+	MicroBenchmark::Run("camera/update_view", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			camera.UpdateView();
+			glm::mat4 m4View = camera.GetView();
+			MicroBenchmark::Keep(m4View);
+		}
+	});
+}
+
+/// <summary>
+/// Measures the culling kernels on a box per entity.
+/// </summary>
+static void BenchmarkBounds(void)
+{
+	std::mt19937 rng(1337);
+	std::vector<AABB> lBoxes = MakeBoxes(rng);
+	std::vector<glm::mat4> lWorlds(BOX_COUNT);
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	for (int i = 0; i < BOX_COUNT; i++)
+	{
+		lWorlds[i] = glm::rotate(glm::translate(glm::mat4(1.0f), lBoxes[i].GetCenter()), angle(rng), glm::vec3(0.3f, 1.0f, 0.2f));
+	}
+
+	// A camera at the center looking down +Z sees about a sixth of the boxes.
+	glm::mat4 m4Projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.01f, 100.0f);
+	glm::mat4 m4View = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 m4ViewProjection = m4Projection * m4View;
+	Frustum frustum = Frustum(m4ViewProjection);
+
+	MicroBenchmark::Run("bounds/frustum_from_matrix", 1, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			Frustum built = Frustum(m4ViewProjection);
+			MicroBenchmark::Keep(built);
+		}
+	});
+	MicroBenchmark::Run("bounds/frustum_classify", BOX_COUNT, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			int dVisible = 0;
+			for (int j = 0; j < BOX_COUNT; j++)
+			{
+				if (frustum.Classify(lBoxes[j]) != Frustum::Outside) dVisible++;
+			}
+			MicroBenchmark::Keep(dVisible);
+		}
+	});
+	MicroBenchmark::Run("bounds/aabb_transformed", BOX_COUNT, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			for (int j = 0; j < BOX_COUNT; j++)
+			{
+				AABB world = lBoxes[j].Transformed(lWorlds[j]);
+				MicroBenchmark::Keep(world);
+			}
+		}
+	});
+	MicroBenchmark::Run("bounds/sphere_overlaps", BOX_COUNT, [&](long long a_lIterations)
+	{
+		Sphere sphere = { glm::vec3(5.0f, 0.0f, 10.0f), 20.0f };
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			int dOverlaps = 0;
+			for (int j = 0; j < BOX_COUNT; j++)
+			{
+				if (sphere.Overlaps(lBoxes[j])) dOverlaps++;
+			}
+			MicroBenchmark::Keep(dOverlaps);
+		}
+	});
+	MicroBenchmark::Run("bounds/ray_intersects", BOX_COUNT, [&](long long a_lIterations)
+	{
+		Ray ray = { glm::vec3(-50.0f, 0.0f, -50.0f), glm::normalize(glm::vec3(1.0f, 0.05f, 1.0f)), 150.0f };
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			int dHits = 0;
+			float fDistance = 0.0f;
+			for (int j = 0; j < BOX_COUNT; j++)
+			{
+				if (ray.Intersects(lBoxes[j], fDistance)) dHits++;
+			}
+			MicroBenchmark::Keep(dHits);
+		}
+	});
+}
+
+/// <summary>
+/// Measures sorting a frame's draws by their RenderKeys.
+/// </summary>
+static void BenchmarkRenderQueue(int a_dDraws)
+{
+	// Scenes share a handful of materials between many meshes, as the sandbox does.
+	std::mt19937 rng(1337);
+	std::uniform_int_distribution<unsigned int> pipeline(0, 7);
+	std::uniform_int_distribution<unsigned int> geometry(0, 63);
+	std::uniform_real_distribution<float> depth(0.01f, 100.0f);
+	// Sorting distinct key sets in turn, a single one would be learned by the branch predictor.
+	std::vector<std::vector<RenderKey>> lUnsorted(SORT_KEY_SETS, std::vector<RenderKey>(a_dDraws));
+	for (int s = 0; s < SORT_KEY_SETS; s++)
+	{
+		for (int i = 0; i < a_dDraws; i++)
+		{
+			lUnsorted[s][i] = MakeRenderKey(pipeline(rng), geometry(rng), depth(rng), (unsigned int)i);
+		}
+	}
+
+	// Copying the unsorted keys back every call, the copy is a small part of the time.
+	std::vector<RenderKey> lKeys(a_dDraws);
+	MicroBenchmark::Run("render_queue/sort/" + std::to_string(a_dDraws), a_dDraws, [&](long long a_lIterations)
+	{
+		for (long long i = 0; i < a_lIterations; i++)
+		{
+			const std::vector<RenderKey>& lSet = lUnsorted[i % SORT_KEY_SETS];
+			std::copy(lSet.begin(), lSet.end(), lKeys.begin());
+			std::sort(lKeys.begin(), lKeys.end());
+			MicroBenchmark::Keep(lKeys[0]);
+		}
+	});
+}
+
+/// <summary>
+/// Measures parsing each of the sandbox's models.
+/// </summary>
+static void BenchmarkObjParsing(const std::string& a_sModelFolder)
+{
+	std::vector<Vertex> lVertices;
+	for (int i = 0; i < sizeof(MODEL_NAMES) / sizeof(MODEL_NAMES[0]); i++)
+	{
+		std::string sPath = a_sModelFolder + MODEL_NAMES[i] + ".graphics_obj";
+		if (!Mesh::LoadObj(sPath.c_str(), lVertices))
+		{
+			std::cout << "Skipping the missing model " << sPath << std::endl;
+			continue;
+		}
+
+		MicroBenchmark::Run(std::string("obj_parse/") + MODEL_NAMES[i], 1, [&](long long a_lIterations)
+		{
+			for (long long j = 0; j < a_lIterations; j++)
+			{
+				Mesh::LoadObj(sPath.c_str(), lVertices);
+				MicroBenchmark::Keep(lVertices.size());
+			}
+		});
+	}
+}
+
+/// <summary>
+/// Measures FileReader::ReadFile on a shader sized file and a large one.
+/// </summary>
+static void BenchmarkReadFile(void)
+{
+	const char* lFiles[2] = { SMALL_FILE, LARGE_FILE };
+	const char* lNames[2] = { "file_reader/read_file/small", "file_reader/read_file/large" };
+	int lLines[2] = { SMALL_FILE_LINES, LARGE_FILE_LINES };
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (!WriteTextFile(lFiles[i], lLines[i])) continue;
+
+		std::string sPath = lFiles[i];
+		MicroBenchmark::Run(lNames[i], 1, [&](long long a_lIterations)
+		{
+			for (long long j = 0; j < a_lIterations; j++)
+			{
+				std::string sContent = FileReader::GetInstance()->ReadFile(sPath);
+				MicroBenchmark::Keep(sContent.size());
+			}
+		});
+		std::remove(lFiles[i]);
+	}
+
+	FileReader::ReleaseInstance();
+}
+
+void RunCoreBenchmarks(const std::string& a_sModelFolder)
+{
+	std::cout << "Running core microbenchmarks." << std::endl;
+
+	BenchmarkObjParsing(a_sModelFolder);
+	BenchmarkTransform();
+	BenchmarkCamera();
+	BenchmarkBounds();
+	BenchmarkRenderQueue(1000);
+	BenchmarkRenderQueue(10000);
+	BenchmarkReadFile();
+}
@@ -0,0 +1,55 @@
+// The benchmarks only depend on glm and the engine's CPU side code so they
+// can also be built on headless machines from this folder with:
+//   g++ -std=c++17 -O2 -pthread -I../include -I.. -o Benchmarks *.cpp
+//       ../Bounds.cpp ../SceneTree.cpp ../ThreadPool.cpp ../OcclusionCuller.cpp
+//       ../CPUProfiler.cpp ../PerfCounters.cpp ../Transform.cpp ../Camera.cpp
+//       ../MeshLoader.cpp ../FileReaderText.cpp
+//
+// Options:
+//   Benchmarks [--micro-only] [--filter transform/] [--samples 25]
+//              [--models ../_Binary/models/] [--output microbenchmarks.json]
+// --filter only runs the microbenchmarks whose name contains the text.  Their
+// results are written to --output for comparing runs.
+#include "Benchmarks.h"
+#include "MicroBenchmark.h"
+#include "../ThreadPool.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	bool bIsMicroOnly = false;
+	std::string sModels = "../_Binary/models/";
+	std::string sOutput = "microbenchmarks.json";
+	for (int i = 1; i < argc; i++)
+	{
+		std::string sArg = argv[i];
+		bool bHasValue = i + 1 < argc;
+		if (sArg == "--micro-only") bIsMicroOnly = true;
+		else if (sArg == "--filter" && bHasValue) MicroBenchmark::SetFilter(argv[++i]);
+		else if (sArg == "--samples" && bHasValue) MicroBenchmark::SetSamples(std::atoi(argv[++i]));
+		else if (sArg == "--models" && bHasValue) sModels = argv[++i];
+		else if (sArg == "--output" && bHasValue) sOutput = argv[++i];
+		else
+		{
+			std::cout << "Unknown option " << sArg << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Running engine benchmarks." << std::endl;
+
+	if (!bIsMicroOnly)
+	{
+		RunSceneTreeBenchmark();
+		RunOcclusionBenchmark();
+	}
+	RunCoreBenchmarks(sModels);
+	bool bWrote = MicroBenchmark::WriteJSON(sOutput);
+
+	ThreadPool::ReleaseInstance();
+
+	std::cout << "Ended execution" << std::endl;
+	return bWrote ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "MicroBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+int MicroBenchmark::m_dSamples = MICRO_DEFAULT_SAMPLES;
+std::string MicroBenchmark::m_sFilter = "";
+std::vector<MicroResult> MicroBenchmark::m_lResults;
+const void* volatile MicroBenchmark::m_pSink = nullptr;
+
+/// <summary>
+/// Times one batch of calls in milliseconds.
+/// </summary>
+static double TimeBatch(const std::function<void(long long)>& a_batch, long long a_lIterations)
+{
+	BenchClock::time_point start = BenchClock::now();
+	a_batch(a_lIterations);
+	return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+/// <summary>
+/// Gets a percentile of sorted values by the nearest rank.
+/// </summary>
+static double Percentile(const std::vector<double>& a_lSorted, double a_dPercent)
+{
+	int dRank = (int)std::ceil(a_dPercent / 100.0 * a_lSorted.size());
+	return a_lSorted[std::max(0, std::min(dRank, (int)a_lSorted.size()) - 1)];
+}
+
+void MicroBenchmark::SetSamples(int a_dSamples) { m_dSamples = std::max(a_dSamples, 1); }
+void MicroBenchmark::SetFilter(const std::string& a_sFilter) { m_sFilter = a_sFilter; }
+const std::vector<MicroResult>& MicroBenchmark::GetResults(void) { return m_lResults; }
+
+bool MicroBenchmark::Run(const std::string& a_sName, int a_dItems, const std::function<void(long long)>& a_batch)
+{
+	if (!m_sFilter.empty() && a_sName.find(m_sFilter) == std::string::npos) return false;
+
+	// Doubling the batch until it is long enough to time, which also warms everything up.
+	long long lIterations = 1;
+	double dMS = TimeBatch(a_batch, lIterations);
+	while (dMS < MICRO_MIN_SAMPLE_MS)
+	{
+		lIterations *= 2;
+		dMS = TimeBatch(a_batch, lIterations);
+	}
+
+	std::vector<double> lSamples(m_dSamples);
+	double dPerItem = 1000000.0 / ((double)lIterations * a_dItems);
+	for (int i = 0; i < m_dSamples; i++)
+	{
+		lSamples[i] = TimeBatch(a_batch, lIterations) * dPerItem;
+	}
+	std::sort(lSamples.begin(), lSamples.end());
+
+	MicroResult result = MicroResult();
+	result.Name = a_sName;
+	result.Samples = m_dSamples;
+	result.Iterations = lIterations;
+	result.Items = a_dItems;
+	result.Min = lSamples.front();
+	result.Max = lSamples.back();
+	result.Median = m_dSamples % 2 == 1 ? lSamples[m_dSamples / 2] : (lSamples[m_dSamples / 2 - 1] + lSamples[m_dSamples / 2]) * 0.5;
+	result.P95 = Percentile(lSamples, 95.0);
+	result.P99 = Percentile(lSamples, 99.0);
+	result.Mean = 0.0;
+	for (int i = 0; i < m_dSamples; i++) result.Mean += lSamples[i];
+	result.Mean /= m_dSamples;
+	result.StdDev = 0.0;
+	for (int i = 0; i < m_dSamples; i++) result.StdDev += (lSamples[i] - result.Mean) * (lSamples[i] - result.Mean);
+	result.StdDev = m_dSamples > 1 ? std::sqrt(result.StdDev / (m_dSamples - 1)) : 0.0;
+	m_lResults.push_back(result);
+
+	std::cout << std::left << std::setw(36) << a_sName << std::right << std::fixed << std::setprecision(2)
+		<< " median " << std::setw(12) << result.Median << " ns"
+		<< "  mean " << std::setw(12) << result.Mean << " ns"
+		<< "  +/- " << std::setw(5) << std::setprecision(1) << (result.Mean > 0.0 ? result.StdDev / result.Mean * 100.0 : 0.0) << "%"
+		<< (a_dItems > 1 ? "  per item" : "") << std::endl;
+	return true;
+}
+
+bool MicroBenchmark::WriteJSON(const std::string& a_sOutputFile)
+{
+	std::ofstream writer(a_sOutputFile, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the microbenchmark report to " << a_sOutputFile << std::endl;
+		return false;
+	}
+
+	writer << std::setprecision(6);
+	writer << "{\n";
+	writer << "\t\"unit\": \"ns_per_item\",\n";
+	writer << "\t\"min_sample_ms\": " << MICRO_MIN_SAMPLE_MS << ",\n";
+	writer << "\t\"benchmarks\": [";
+	for (int i = 0; i < m_lResults.size(); i++)
+	{
+		const MicroResult& result = m_lResults[i];
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t{ \"name\": \"" << result.Name << "\""
+			<< ", \"samples\": " << result.Samples
+			<< ", \"iterations\": " << result.Iterations
+			<< ", \"items\": " << result.Items
+			<< ", \"mean\": " << result.Mean
+			<< ", \"median\": " << result.Median
+			<< ", \"stddev\": " << result.StdDev
+			<< ", \"min\": " << result.Min
+			<< ", \"max\": " << result.Max
+			<< ", \"p95\": " << result.P95
+			<< ", \"p99\": " << result.P99 << " }";
+	}
+	writer << "\n\t]\n";
+	writer << "}\n";
+	writer.close();
+
+	std::cout << "Wrote the microbenchmark report to " << a_sOutputFile << std::endl;
+	return true;
+}
@@ -0,0 +1,93 @@
+#ifndef __MICROBENCHMARK_H_
+#define __MICROBENCHMARK_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Timed samples taken of every microbenchmark after it warmed up.
+#define MICRO_DEFAULT_SAMPLES 25
+
+// Shortest a sample may run, its iterations are raised until a warmup batch takes this long.
+#define MICRO_MIN_SAMPLE_MS 10.0
+
+/// <summary>
+/// Statistics of one microbenchmark, all in nanoseconds per item.
+/// </summary>
+struct MicroResult
+{
+	std::string Name;
+	int Samples;
+	long long Iterations;		// Calls of the measured code per sample.
+	int Items;					// Items handled by each call, like boxes classified.
+	double Mean;
+	double Median;
+	double StdDev;
+	double Min;
+	double Max;
+	double P95;
+	double P99;
+};
+
+/// <summary>
+/// Runs small pieces of engine code in timed batches and summarizes the samples.
+/// Every benchmark first runs until a batch takes MICRO_MIN_SAMPLE_MS, which both
+/// warms the caches and picks the iterations per sample, so short operations are
+/// not lost in the clock's resolution.
+/// </summary>
+class MicroBenchmark
+{
+private:
+	static int m_dSamples;
+	static std::string m_sFilter;
+	static std::vector<MicroResult> m_lResults;
+
+public:
+	/// <summary>
+	/// Sets the number of timed samples per benchmark.
+	/// </summary>
+	static void SetSamples(int a_dSamples);
+
+	/// <summary>
+	/// Only runs the benchmarks whose name contains the filter.  Empty runs all of them.
+	/// </summary>
+	static void SetFilter(const std::string& a_sFilter);
+
+	/// <summary>
+	/// Measures a benchmark and prints its summary.
+	/// </summary>
+	/// <param name="a_sName">Name of the benchmark, grouped with slashes like "bounds/classify".</param>
+	/// <param name="a_dItems">Items each call handles, the results are divided by it.</param>
+	/// <param name="a_batch">Makes the passed in number of calls.</param>
+	/// <returns>False if the filter skipped the benchmark.</returns>
+	static bool Run(const std::string& a_sName, int a_dItems, const std::function<void(long long)>& a_batch);
+
+	/// <summary>
+	/// Gets the results of every benchmark run so far.
+	/// </summary>
+	static const std::vector<MicroResult>& GetResults(void);
+
+	/// <summary>
+	/// Writes the results to a JSON file.
+	/// </summary>
+	/// <returns>False if the file could not be written.</returns>
+	static bool WriteJSON(const std::string& a_sOutputFile);
+
+	/// <summary>
+	/// Keeps the compiler from optimizing away a result nothing else reads.
+	/// </summary>
+	template <typename T>
+	static inline void Keep(const T& a_value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(&a_value) : "memory");
+#else
+		m_pSink = &a_value;
+#endif
+	}
+
+private:
+	static const void* volatile m_pSink;
+};
+
+#endif //__MICROBENCHMARK_H_
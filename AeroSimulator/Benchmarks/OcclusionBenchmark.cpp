@@ -0,0 +1,119 @@
+#include "Benchmarks.h"
+#include "../OcclusionCuller.h"
+#include "../ThreadPool.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#define OCCLUSION_FRAMES 100
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+/// <summary>
+/// Appends the twelve triangles of a unit cube centered on the origin.
+/// </summary>
+static void AppendCube(std::vector<Vertex>& a_lOut)
+{
+	glm::vec3 v3Corners[8];
+	for (int i = 0; i < 8; i++)
+	{
+		v3Corners[i] = glm::vec3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+	}
+
+	// Two triangles per face, listed as corner indices.
+	int dFaces[36] =
+	{
+		0, 1, 3, 0, 3, 2,	4, 6, 7, 4, 7, 5,
+		0, 4, 5, 0, 5, 1,	2, 3, 7, 2, 7, 6,
+		0, 2, 6, 0, 6, 4,	1, 5, 7, 1, 7, 3
+	};
+	for (int i = 0; i < 36; i++)
+	{
+		Vertex v = Vertex();
+		v.Position = v3Corners[dFaces[i]];
+		a_lOut.push_back(v);
+	}
+}
+
+void RunOcclusionBenchmark(void)
+{
+	std::cout << "\nOcclusion benchmark (" << OCCLUSION_WIDTH << "x" << OCCLUSION_HEIGHT << ", " <<
+		ThreadPool::GetInstance()->GetWorkerCount() + 1 << " threads):" << std::endl;
+
+	// A city block: rows of tall buildings acting as occluders.
+	std::vector<Vertex> lCube;
+	AppendCube(lCube);
+	std::vector<glm::mat4> lBuildings;
+	for (int x = -10; x <= 10; x++)
+	{
+		for (int z = 1; z <= 10; z++)
+		{
+			glm::mat4 m4World = glm::translate(glm::mat4(1.0f), glm::vec3(x * 6.0f, 5.0f, -z * 8.0f));
+			lBuildings.push_back(glm::scale(m4World, glm::vec3(4.0f, 10.0f, 4.0f)));
+		}
+	}
+
+	// Small props scattered between and behind the buildings.
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> spreadX(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> spreadZ(-90.0f, -5.0f);
+	std::vector<AABB> lProps;
+	for (int i = 0; i < 10000; i++)
+	{
+		glm::vec3 v3Min = glm::vec3(spreadX(rng), 0.0f, spreadZ(rng));
+		lProps.push_back(AABB(v3Min, v3Min + glm::vec3(0.5f, 1.0f, 0.5f)));
+	}
+
+	glm::mat4 m4Projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.01f, 100.0f);
+	OcclusionCuller culler = OcclusionCuller();
+	OcclusionStats total = OcclusionStats();
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < OCCLUSION_FRAMES; frame++)
+	{
+		// Walking the camera down the street at pedestrian height.
+		glm::vec3 v3Eye = glm::vec3(3.0f, 1.7f, 5.0f - frame * 0.1f);
+		glm::mat4 m4View = glm::lookAt(v3Eye, v3Eye + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 m4ViewProjection = m4Projection * m4View;
+
+		culler.BeginFrame(m4ViewProjection);
+		for (int i = 0; i < lBuildings.size(); i++)
+		{
+			culler.AddOccluder(lCube, lBuildings[i]);
+		}
+		culler.RasterizeOccluders();
+
+		// Only testing what survives the frustum, as the engine does.
+		Frustum frustum = Frustum(m4ViewProjection);
+		BenchClock::time_point testStart = BenchClock::now();
+		for (int i = 0; i < lProps.size(); i++)
+		{
+			if (frustum.Classify(lProps[i]) != Frustum::Outside)
+			{
+				culler.IsVisible(lProps[i]);
+			}
+		}
+		culler.AddTestTime(std::chrono::duration<float, std::milli>(BenchClock::now() - testStart).count());
+
+		const OcclusionStats& stats = culler.GetStats();
+		total.Triangles += stats.Triangles;
+		total.Tested += stats.Tested;
+		total.Culled += stats.Culled;
+		total.TransformMS += stats.TransformMS;
+		total.RasterMS += stats.RasterMS;
+		total.TestMS += stats.TestMS;
+	}
+	double dSeconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "\t  occluders: " << lBuildings.size() << " (" << total.Triangles / OCCLUSION_FRAMES << " triangles after clipping)" << std::endl;
+	std::cout << "\t  candidates in frustum: " << total.Tested / OCCLUSION_FRAMES << " of " << lProps.size() << std::endl;
+	std::cout << "\t  culled: " << total.GetCulledPercent() << "%" << std::endl;
+	std::cout << "\t  transform: " << total.TransformMS / OCCLUSION_FRAMES << " ms" << std::endl;
+	std::cout << "\t  raster:    " << total.RasterMS / OCCLUSION_FRAMES << " ms" << std::endl;
+	std::cout << "\t  test:      " << total.TestMS / OCCLUSION_FRAMES << " ms" << std::endl;
+	std::cout << "\t  frame:     " << dSeconds / OCCLUSION_FRAMES * 1000.0 << " ms" << std::endl;
+}
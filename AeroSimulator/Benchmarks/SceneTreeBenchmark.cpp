@@ -0,0 +1,151 @@
+#include "Benchmarks.h"
+#include "../SceneTree.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Fraction of the objects that move every simulated frame.
+#define MOTION_RATIO 0.1f
+#define FRAME_COUNT 10
+#define QUERY_COUNT 1000
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+/// <summary>
+/// Gets the seconds elapsed since the passed in time point.
+/// </summary>
+static double SecondsSince(BenchClock::time_point a_tStart)
+{
+	return std::chrono::duration<double>(BenchClock::now() - a_tStart).count();
+}
+
+/// <summary>
+/// Runs the full benchmark for a single object count.
+/// </summary>
+static void BenchmarkObjectCount(int a_dCount)
+{
+	// Keeping the density constant so query selectivity does not change with N.
+	float fWorldSize = 10.0f * std::cbrt((float)a_dCount);
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> position(0.0f, fWorldSize);
+	std::uniform_real_distribution<float> size(0.25f, 2.0f);
+	std::uniform_real_distribution<float> velocity(-0.5f, 0.5f);
+
+	std::vector<AABB> lBoxes(a_dCount);
+	std::vector<int> lProxies(a_dCount);
+	for (int i = 0; i < a_dCount; i++)
+	{
+		glm::vec3 v3Min = glm::vec3(position(rng), position(rng), position(rng));
+		lBoxes[i] = AABB(v3Min, v3Min + glm::vec3(size(rng)));
+	}
+
+	// - - Insertion - -
+	SceneTree tree = SceneTree(0.1f);
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < a_dCount; i++)
+	{
+		lProxies[i] = tree.CreateProxy(lBoxes[i], (void*)(intptr_t)i);
+	}
+	double dInsert = SecondsSince(start);
+
+	// - - Refit - -
+	int dMoving = (int)(a_dCount * MOTION_RATIO);
+	int dReinserted = 0;
+	start = BenchClock::now();
+	for (int frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		for (int i = 0; i < dMoving; i++)
+		{
+			// Striding through the objects so a different set moves every frame.
+			int dIndex = (i * 7 + frame * dMoving) % a_dCount;
+			glm::vec3 v3Offset = glm::vec3(velocity(rng), velocity(rng), velocity(rng)) * 0.3f;
+			lBoxes[dIndex].Min += v3Offset;
+			lBoxes[dIndex].Max += v3Offset;
+			if (tree.MoveProxy(lProxies[dIndex], lBoxes[dIndex])) dReinserted++;
+		}
+	}
+	double dRefit = SecondsSince(start);
+	int dMoves = dMoving * FRAME_COUNT;
+
+	// - - Queries - -
+	std::vector<void*> lResults;
+	long long llHits[4] = { 0, 0, 0, 0 };
+	double dQuery[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+	// Frustum queries from cameras scattered through the world.
+	glm::mat4 m4Projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.01f, 100.0f);
+	start = BenchClock::now();
+	for (int i = 0; i < QUERY_COUNT; i++)
+	{
+		glm::vec3 v3Eye = glm::vec3(position(rng), position(rng), position(rng));
+		glm::mat4 m4View = glm::lookAt(v3Eye, v3Eye + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		lResults.clear();
+		tree.QueryFrustum(Frustum(m4Projection * m4View), lResults);
+		llHits[0] += lResults.size();
+	}
+	dQuery[0] = SecondsSince(start);
+
+	// Sphere queries.
+	start = BenchClock::now();
+	for (int i = 0; i < QUERY_COUNT; i++)
+	{
+		Sphere sphere = { glm::vec3(position(rng), position(rng), position(rng)), 20.0f };
+		lResults.clear();
+		tree.QuerySphere(sphere, lResults);
+		llHits[1] += lResults.size();
+	}
+	dQuery[1] = SecondsSince(start);
+
+	// Box queries.
+	start = BenchClock::now();
+	for (int i = 0; i < QUERY_COUNT; i++)
+	{
+		glm::vec3 v3Min = glm::vec3(position(rng), position(rng), position(rng));
+		lResults.clear();
+		tree.QueryAABB(AABB(v3Min, v3Min + glm::vec3(30.0f)), lResults);
+		llHits[2] += lResults.size();
+	}
+	dQuery[2] = SecondsSince(start);
+
+	// Ray queries.
+	start = BenchClock::now();
+	for (int i = 0; i < QUERY_COUNT; i++)
+	{
+		glm::vec3 v3Direction = glm::normalize(glm::vec3(velocity(rng), velocity(rng), velocity(rng)));
+		Ray ray = { glm::vec3(position(rng), position(rng), position(rng)), v3Direction, 100.0f };
+		lResults.clear();
+		tree.QueryRay(ray, lResults);
+		llHits[3] += lResults.size();
+	}
+	dQuery[3] = SecondsSince(start);
+
+	// Reporting.
+	const char* sQueryNames[4] = { "frustum", "sphere", "aabb", "ray" };
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "\n\tObjects: " << a_dCount << " (tree height " << tree.GetHeight() << ")" << std::endl;
+	std::cout << "\t  insert:  " << a_dCount / dInsert / 1.0e6 << " M/s" << std::endl;
+	std::cout << "\t  refit:   " << dMoves / dRefit / 1.0e6 << " M/s (" <<
+		100.0 * dReinserted / dMoves << "% reinserted, " <<
+		dRefit / FRAME_COUNT * 1000.0 << " ms per frame at " << MOTION_RATIO * 100.0f << "% motion)" << std::endl;
+	for (int i = 0; i < 4; i++)
+	{
+		std::cout << "\t  " << std::left << std::setw(8) << sQueryNames[i] << std::right <<
+			" " << dQuery[i] / QUERY_COUNT * 1.0e6 << " us/query (" <<
+			(double)llHits[i] / QUERY_COUNT << " hits avg)" << std::endl;
+	}
+}
+
+void RunSceneTreeBenchmark(void)
+{
+	std::cout << "SceneTree benchmark:" << std::endl;
+
+	int dCounts[3] = { 10000, 100000, 1000000 };
+	for (int i = 0; i < 3; i++)
+	{
+		BenchmarkObjectCount(dCounts[i]);
+	}
+}
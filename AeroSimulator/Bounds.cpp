@@ -0,0 +1,157 @@
+#include "Bounds.h"
+#include <cfloat>
+#include <algorithm>
+
+// - - AABB - -
+AABB::AABB(void)
+{
+	Min = glm::vec3(FLT_MAX);
+	Max = glm::vec3(-FLT_MAX);
+}
+
+AABB::AABB(glm::vec3 a_v3Min, glm::vec3 a_v3Max)
+{
+	Min = a_v3Min;
+	Max = a_v3Max;
+}
+
+glm::vec3 AABB::GetCenter(void) const { return (Min + Max) * 0.5f; }
+glm::vec3 AABB::GetExtents(void) const { return (Max - Min) * 0.5f; }
+
+float AABB::GetSurfaceArea(void) const
+{
+	glm::vec3 v3Size = Max - Min;
+	return 2.0f * (v3Size.x * v3Size.y + v3Size.y * v3Size.z + v3Size.z * v3Size.x);
+}
+
+bool AABB::Contains(const AABB& a_aOther) const
+{
+	return
+		Min.x <= a_aOther.Min.x && Min.y <= a_aOther.Min.y && Min.z <= a_aOther.Min.z &&
+		Max.x >= a_aOther.Max.x && Max.y >= a_aOther.Max.y && Max.z >= a_aOther.Max.z;
+}
+
+bool AABB::Overlaps(const AABB& a_aOther) const
+{
+	return
+		Min.x <= a_aOther.Max.x && Max.x >= a_aOther.Min.x &&
+		Min.y <= a_aOther.Max.y && Max.y >= a_aOther.Min.y &&
+		Min.z <= a_aOther.Max.z && Max.z >= a_aOther.Min.z;
+}
+
+AABB AABB::Expanded(float a_fMargin) const
+{
+	return AABB(Min - glm::vec3(a_fMargin), Max + glm::vec3(a_fMargin));
+}
+
+AABB AABB::Transformed(const glm::mat4& a_m4Transform) const
+{
+	// Arvo's method: each column of the matrix pushes the
+	// minimum and maximum apart independently per axis.
+	glm::vec3 v3Min = glm::vec3(a_m4Transform[3]);
+	glm::vec3 v3Max = v3Min;
+	for (int col = 0; col < 3; col++)
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			float fA = a_m4Transform[col][row] * Min[col];
+			float fB = a_m4Transform[col][row] * Max[col];
+			v3Min[row] += std::min(fA, fB);
+			v3Max[row] += std::max(fA, fB);
+		}
+	}
+
+	return AABB(v3Min, v3Max);
+}
+
+AABB AABB::Merge(const AABB& a_aFirst, const AABB& a_aSecond)
+{
+	return AABB(
+		glm::min(a_aFirst.Min, a_aSecond.Min),
+		glm::max(a_aFirst.Max, a_aSecond.Max));
+}
+
+// - - Sphere - -
+bool Sphere::Overlaps(const AABB& a_aBox) const
+{
+	// Distance from the center to the closest point on the box.
+	glm::vec3 v3Closest = glm::clamp(Center, a_aBox.Min, a_aBox.Max);
+	glm::vec3 v3Delta = v3Closest - Center;
+	return glm::dot(v3Delta, v3Delta) <= Radius * Radius;
+}
+
+// - - Ray - -
+bool Ray::Intersects(const AABB& a_aBox, float& a_fHitDistance) const
+{
+	float fNear = 0.0f;
+	float fFar = Length;
+
+	for (int i = 0; i < 3; i++)
+	{
+		// Parallel to this slab, so the origin must already be inside of it.
+		if (Direction[i] == 0.0f)
+		{
+			if (Origin[i] < a_aBox.Min[i] || Origin[i] > a_aBox.Max[i]) return false;
+			continue;
+		}
+
+		float fInverse = 1.0f / Direction[i];
+		float fT1 = (a_aBox.Min[i] - Origin[i]) * fInverse;
+		float fT2 = (a_aBox.Max[i] - Origin[i]) * fInverse;
+		fNear = std::max(fNear, std::min(fT1, fT2));
+		fFar = std::min(fFar, std::max(fT1, fT2));
+
+		if (fNear > fFar) return false;
+	}
+
+	a_fHitDistance = fNear;
+	return true;
+}
+
+// - - Frustum - -
+Frustum::Frustum(void)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		Planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Frustum::Frustum(const glm::mat4& a_m4ViewProjection)
+{
+	// Gribb/Hartmann plane extraction from the rows of the matrix.
+	glm::mat4 m = glm::transpose(a_m4ViewProjection);
+	Planes[0] = m[3] + m[0];	// Left
+	Planes[1] = m[3] - m[0];	// Right
+	Planes[2] = m[3] + m[1];	// Bottom
+	Planes[3] = m[3] - m[1];	// Top
+	Planes[4] = m[3] + m[2];	// Near
+	Planes[5] = m[3] - m[2];	// Far
+
+	// Normalizing so distances are in world units.
+	for (int i = 0; i < 6; i++)
+	{
+		Planes[i] /= glm::length(glm::vec3(Planes[i]));
+	}
+}
+
+Frustum::Result Frustum::Classify(const AABB& a_aBox) const
+{
+	glm::vec3 v3Center = a_aBox.GetCenter();
+	glm::vec3 v3Extents = a_aBox.GetExtents();
+	Result result = Inside;
+
+	for (int i = 0; i < 6; i++)
+	{
+		glm::vec3 v3Normal = glm::vec3(Planes[i]);
+
+		// Projected radius of the box onto the plane normal.
+		float fRadius = glm::dot(v3Extents, glm::abs(v3Normal));
+		float fDistance = glm::dot(v3Normal, v3Center) + Planes[i].w;
+
+		if (fDistance < -fRadius) return Outside;
+		if (fDistance < fRadius) result = Intersecting;
+	}
+
+	return result;
+}
@@ -0,0 +1,126 @@
+#ifndef __BOUNDS_H_
+#define __BOUNDS_H_
+
+#include <glm/glm.hpp>
+
+/// <summary>
+/// Axis aligned bounding box described by its minimum and maximum corners.
+/// </summary>
+struct AABB
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+
+	/// <summary>
+	/// Constructs an empty (inverted) box that any Merge will overwrite.
+	/// </summary>
+	AABB(void);
+
+	/// <summary>
+	/// Constructs a box from its minimum and maximum corners.
+	/// </summary>
+	AABB(glm::vec3 a_v3Min, glm::vec3 a_v3Max);
+
+	/// <summary>
+	/// Gets the center point of the box.
+	/// </summary>
+	glm::vec3 GetCenter(void) const;
+
+	/// <summary>
+	/// Gets the half size of the box along each axis.
+	/// </summary>
+	glm::vec3 GetExtents(void) const;
+
+	/// <summary>
+	/// Gets the surface area of the box.  Used as the insertion cost heuristic.
+	/// </summary>
+	float GetSurfaceArea(void) const;
+
+	/// <summary>
+	/// Checks if the passed in box lies entirely within this one.
+	/// </summary>
+	bool Contains(const AABB& a_aOther) const;
+
+	/// <summary>
+	/// Checks if the passed in box touches this one.
+	/// </summary>
+	bool Overlaps(const AABB& a_aOther) const;
+
+	/// <summary>
+	/// Grows the box on every side by the passed in amount.
+	/// </summary>
+	AABB Expanded(float a_fMargin) const;
+
+	/// <summary>
+	/// Gets the box enclosing this box after being moved by the passed in matrix.
+	/// </summary>
+	/// <param name="a_m4Transform">World matrix being applied to the box.</param>
+	AABB Transformed(const glm::mat4& a_m4Transform) const;
+
+	/// <summary>
+	/// Gets the smallest box enclosing both of the passed in boxes.
+	/// </summary>
+	static AABB Merge(const AABB& a_aFirst, const AABB& a_aSecond);
+};
+
+/// <summary>
+/// Sphere used for proximity queries.
+/// </summary>
+struct Sphere
+{
+	glm::vec3 Center;
+	float Radius;
+
+	/// <summary>
+	/// Checks if the sphere touches the passed in box.
+	/// </summary>
+	bool Overlaps(const AABB& a_aBox) const;
+};
+
+/// <summary>
+/// Ray segment used for picking and line of sight queries.
+/// </summary>
+struct Ray
+{
+	glm::vec3 Origin;
+	glm::vec3 Direction;
+	float Length;
+
+	/// <summary>
+	/// Slab test against the passed in box.
+	/// </summary>
+	/// <param name="a_aBox">The box being tested.</param>
+	/// <param name="a_fHitDistance">Distance along the ray of the entry point.</param>
+	/// <returns>True if the ray enters the box before its Length.</returns>
+	bool Intersects(const AABB& a_aBox, float& a_fHitDistance) const;
+};
+
+/// <summary>
+/// The six clipping planes of a camera, pointing inwards.
+/// </summary>
+struct Frustum
+{
+	glm::vec4 Planes[6];
+
+	/// <summary>
+	/// Constructs a frustum that contains everything.
+	/// </summary>
+	Frustum(void);
+
+	/// <summary>
+	/// Extracts the planes from a combined projection * view matrix.
+	/// </summary>
+	Frustum(const glm::mat4& a_m4ViewProjection);
+
+	/// <summary>
+	/// Result of testing a box against the frustum.
+	/// </summary>
+	enum Result { Outside = 0, Intersecting, Inside };
+
+	/// <summary>
+	/// Classifies the passed in box against all six planes.
+	/// </summary>
+	Result Classify(const AABB& a_aBox) const;
+};
+
+#endif //__BOUNDS_H_
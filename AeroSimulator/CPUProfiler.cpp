@@ -0,0 +1,373 @@
+#include "CPUProfiler.h"
+#include "Debug.h"
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+CPUProfiler* CPUProfiler::m_pInstance = nullptr;
+std::atomic<bool> CPUProfiler::m_bIsEnabled{ false };
+std::atomic<unsigned int> CPUProfiler::m_uGeneration{ 0 };
+std::atomic<bool> CPUProfiler::m_bIsCounting{ false };
+
+/// <summary>
+/// The calling thread's buffer, tagged with the profiler instance it belongs to.
+/// </summary>
+struct ThreadSlot
+{
+	void* Buffer;
+	unsigned int Generation;
+	const char* Name;
+};
+static thread_local ThreadSlot t_slot = { nullptr, 0, nullptr };
+
+CPUProfiler::CPUProfiler(void)
+{
+	for (int i = 0; i < CPU_PROFILER_MAX_THREADS; i++)
+	{
+		m_lThreads[i].store(nullptr, std::memory_order_relaxed);
+	}
+	for (int i = 0; i < CPU_PROFILER_FRAMES; i++)
+	{
+		m_lFrameStarts[i] = 0;
+	}
+
+	// Buffers handed out by an earlier instance are no longer valid.
+	m_uGeneration++;
+}
+
+CPUProfiler::~CPUProfiler(void)
+{
+	for (int i = 0; i < CPU_PROFILER_MAX_THREADS; i++)
+	{
+		ThreadBuffer* pBuffer = m_lThreads[i].load(std::memory_order_acquire);
+		Realloc(pBuffer);
+	}
+}
+
+CPUProfiler* CPUProfiler::GetInstance(void)
+{
+	// Instantiating the single instance of the CPUProfiler.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new CPUProfiler();
+	}
+
+	return m_pInstance;
+}
+
+void CPUProfiler::ReleaseInstance(void)
+{
+	// If there is an instance of the CPUProfiler:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		m_bIsEnabled = false;
+		Realloc(m_pInstance);
+	}
+}
+
+void CPUProfiler::SetEnabled(bool a_bIsEnabled)
+{
+	// Making sure the instance exists before any thread records into it.
+	GetInstance();
+	m_bIsEnabled = a_bIsEnabled;
+}
+
+bool CPUProfiler::SetCounting(bool a_bIsCounting)
+{
+	if (a_bIsCounting && !PerfCounters::IsAvailable())
+	{
+		m_bIsCounting = false;
+		return false;
+	}
+	m_bIsCounting = a_bIsCounting;
+	return true;
+}
+
+void CPUProfiler::Summarize(const std::vector<CPUZoneRecord>& a_lZones, std::vector<CPUZoneTotals>& a_lTotals)
+{
+	a_lTotals.clear();
+	for (int i = 0; i < a_lZones.size(); i++)
+	{
+		const CPUZone& zone = a_lZones[i].Zone;
+
+		// Names are literals, so comparing pointers is enough.  There are only a few dozen.
+		int dIndex = 0;
+		while (dIndex < a_lTotals.size() && a_lTotals[dIndex].Name != zone.Name)
+		{
+			dIndex++;
+		}
+		if (dIndex == a_lTotals.size())
+		{
+			CPUZoneTotals totals;
+			memset(&totals, 0, sizeof(totals));
+			totals.Name = zone.Name;
+			a_lTotals.push_back(totals);
+		}
+
+		CPUZoneTotals& totals = a_lTotals[dIndex];
+		totals.Calls++;
+		totals.Items += zone.Items;
+		totals.MS += (zone.End - zone.Begin) / 1000000.0;
+		if (zone.HasCounters)
+		{
+			totals.CountedCalls++;
+			totals.CountedItems += zone.Items;
+			for (int c = 0; c < PERF_COUNTER_COUNT; c++)
+			{
+				totals.Counters.Values[c] += zone.Counters.Values[c];
+			}
+		}
+	}
+}
+
+uint64_t CPUProfiler::Now(void)
+{
+	// The steady clock is portable and needs no calibration, unlike the raw timestamp counter.
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CPUProfiler::ThreadBuffer* CPUProfiler::GetThreadBuffer(void)
+{
+	if (t_slot.Buffer != nullptr && t_slot.Generation == m_uGeneration)
+	{
+		return (ThreadBuffer*)t_slot.Buffer;
+	}
+
+	// Claiming a slot without a lock.  Slots are never given back until the profiler is released.
+	int dIndex = m_dThreadCount.fetch_add(1);
+	if (dIndex >= CPU_PROFILER_MAX_THREADS)
+	{
+		m_dThreadCount = CPU_PROFILER_MAX_THREADS;
+		return nullptr;
+	}
+
+	ThreadBuffer* pBuffer = new ThreadBuffer();
+	if (t_slot.Name != nullptr)
+	{
+		snprintf(pBuffer->Name, sizeof(pBuffer->Name), "%s", t_slot.Name);
+	}
+	else
+	{
+		snprintf(pBuffer->Name, sizeof(pBuffer->Name), "Thread %d", dIndex);
+	}
+	pBuffer->Head = 0;
+	pBuffer->Depth = 0;
+	// Released so a reader seeing the pointer also sees the name and head.
+	m_lThreads[dIndex].store(pBuffer, std::memory_order_release);
+
+	t_slot.Buffer = pBuffer;
+	t_slot.Generation = m_uGeneration;
+	return pBuffer;
+}
+
+void CPUProfiler::SetThreadName(const char* a_sName)
+{
+	// Threads that never record do not get a buffer, so the name waits until one is created.
+	t_slot.Name = a_sName;
+	if (t_slot.Buffer != nullptr && t_slot.Generation == m_uGeneration)
+	{
+		ThreadBuffer* pBuffer = (ThreadBuffer*)t_slot.Buffer;
+		snprintf(pBuffer->Name, sizeof(pBuffer->Name), "%s", a_sName);
+	}
+}
+
+void CPUProfiler::MarkFrame(void)
+{
+	uint64_t uFrame = m_uFrameCount.load(std::memory_order_relaxed);
+	m_lFrameStarts[uFrame % CPU_PROFILER_FRAMES] = Now();
+	m_uFrameCount.store(uFrame + 1, std::memory_order_release);
+}
+
+uint64_t CPUProfiler::BeginZone(void)
+{
+	ThreadBuffer* pBuffer = GetThreadBuffer();
+	if (pBuffer != nullptr)
+	{
+		pBuffer->Depth++;
+	}
+	return Now();
+}
+
+void CPUProfiler::EndZone(const char* a_sName, uint64_t a_uBegin, int a_dItems, const PerfCounterValues* a_pCounters)
+{
+	// Read first, so the zone's own bookkeeping is not counted.
+	PerfCounterValues counters;
+	bool bHasCounters = a_pCounters != nullptr && PerfCounters::Read(counters);
+	uint64_t uEnd = Now();
+	ThreadBuffer* pBuffer = GetThreadBuffer();
+	if (pBuffer == nullptr) return;
+
+	// Written whole before the head moves past it, so readers never see a half written zone.
+	pBuffer->Depth--;
+	uint64_t uHead = pBuffer->Head.load(std::memory_order_relaxed);
+	CPUZone& zone = pBuffer->Zones[uHead % CPU_PROFILER_ZONES];
+	zone.Name = a_sName;
+	zone.Begin = a_uBegin;
+	zone.End = uEnd;
+	zone.Depth = pBuffer->Depth;
+	zone.Items = a_dItems;
+	zone.HasCounters = bHasCounters;
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+	{
+		zone.Counters.Values[i] = bHasCounters ? counters.Values[i] - a_pCounters->Values[i] : 0;
+	}
+	pBuffer->Head.store(uHead + 1, std::memory_order_release);
+}
+
+bool CPUProfiler::GetFrameRange(int a_dFrames, uint64_t& a_uBegin, uint64_t& a_uEnd)
+{
+	uint64_t uFrames = m_uFrameCount.load(std::memory_order_acquire);
+	if (a_dFrames < 1 || a_dFrames >= CPU_PROFILER_FRAMES || uFrames <= (uint64_t)a_dFrames) return false;
+
+	a_uBegin = m_lFrameStarts[(uFrames - 1 - a_dFrames) % CPU_PROFILER_FRAMES];
+	a_uEnd = m_lFrameStarts[(uFrames - 1) % CPU_PROFILER_FRAMES];
+	return true;
+}
+
+void CPUProfiler::Collect(uint64_t a_uBegin, uint64_t a_uEnd, std::vector<CPUZoneRecord>& a_lZones)
+{
+	a_lZones.clear();
+	int dThreads = GetThreadCount();
+	for (int t = 0; t < dThreads; t++)
+	{
+		ThreadBuffer* pBuffer = m_lThreads[t].load(std::memory_order_acquire);
+		if (pBuffer == nullptr) continue;
+
+		uint64_t uHead = pBuffer->Head.load(std::memory_order_acquire);
+		// The slot of uHead - CPU_PROFILER_ZONES is the one the owner writes next, so it is never read.
+		uint64_t uFirst = uHead >= CPU_PROFILER_ZONES ? uHead - CPU_PROFILER_ZONES + 1 : 0;
+
+		// Zones are written as they end, so walking back from the newest can stop at the first one ending too early.
+		size_t uStart = a_lZones.size();
+		uint64_t uOldest = uHead;
+		while (uOldest > uFirst)
+		{
+			const CPUZone& zone = pBuffer->Zones[(uOldest - 1) % CPU_PROFILER_ZONES];
+			if (zone.End < a_uBegin) break;
+
+			uOldest--;
+			if (zone.Begin <= a_uEnd)
+			{
+				CPUZoneRecord record = { zone, t };
+				a_lZones.push_back(record);
+			}
+		}
+
+		// The owner reached the oldest slot read while copying, so it may be torn.  Skipping the
+		// thread this time.  The fence keeps the zone reads from moving past the second load.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t uNewHead = pBuffer->Head.load(std::memory_order_relaxed);
+		if (uNewHead - uOldest >= CPU_PROFILER_ZONES)
+		{
+			a_lZones.resize(uStart);
+		}
+	}
+}
+
+int CPUProfiler::GetThreadCount(void)
+{
+	int dCount = m_dThreadCount.load(std::memory_order_acquire);
+	return dCount < CPU_PROFILER_MAX_THREADS ? dCount : CPU_PROFILER_MAX_THREADS;
+}
+
+const char* CPUProfiler::GetThreadName(int a_dThread)
+{
+	ThreadBuffer* pBuffer = m_lThreads[a_dThread].load(std::memory_order_acquire);
+	return pBuffer != nullptr ? pBuffer->Name : "";
+}
+
+bool CPUProfiler::ExportTrace(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the CPU trace to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	std::vector<CPUZoneRecord> lZones;
+	Collect(0, UINT64_MAX, lZones);
+
+	// Trace times are microseconds, starting from the oldest zone.
+	uint64_t uOrigin = UINT64_MAX;
+	for (int i = 0; i < lZones.size(); i++)
+	{
+		uOrigin = lZones[i].Zone.Begin < uOrigin ? lZones[i].Zone.Begin : uOrigin;
+	}
+
+	writer << "{\"traceEvents\": [\n";
+	int dThreads = GetThreadCount();
+	for (int t = 0; t < dThreads; t++)
+	{
+		writer << (t == 0 ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << t
+			<< ", \"args\": {\"name\": \"" << GetThreadName(t) << "\"}}";
+	}
+	char sLine[256];
+	for (int i = 0; i < lZones.size(); i++)
+	{
+		const CPUZone& zone = lZones[i].Zone;
+		snprintf(sLine, sizeof(sLine), ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+			zone.Name, lZones[i].Thread, (zone.Begin - uOrigin) / 1000.0, (zone.End - zone.Begin) / 1000.0);
+		writer << sLine;
+
+		// Counters show up as the event's arguments.
+		if (zone.HasCounters)
+		{
+			writer << ", \"args\": {\"items\": " << zone.Items;
+			for (int c = 0; c < PERF_COUNTER_COUNT; c++)
+			{
+				writer << ", \"" << PerfCounters::GetCounterName((PerfCounter)c) << "\": " << zone.Counters.Values[c];
+			}
+			writer << "}";
+		}
+		writer << "}";
+	}
+	writer << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+	std::cout << "Wrote " << lZones.size() << " CPU zones to " << a_sFilepath << std::endl;
+	return true;
+}
+
+bool CPUProfiler::ExportCounters(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the CPU counters to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	std::vector<CPUZoneRecord> lZones;
+	Collect(0, UINT64_MAX, lZones);
+	std::vector<CPUZoneTotals> lTotals;
+	Summarize(lZones, lTotals);
+
+	writer << "{\n\t\"counting\": " << (IsCounting() ? "true" : "false") << ",\n\t\"zones\": [";
+	for (int i = 0; i < lTotals.size(); i++)
+	{
+		const CPUZoneTotals& totals = lTotals[i];
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t{ \"name\": \"" << totals.Name << "\""
+			<< ", \"calls\": " << totals.Calls
+			<< ", \"items\": " << totals.Items
+			<< ", \"ms\": " << totals.MS;
+		if (totals.CountedCalls > 0)
+		{
+			// Per item where the zone counted items, otherwise per call.
+			const uint64_t* lValues = totals.Counters.Values;
+			double dPer = (double)(totals.CountedItems > 0 ? totals.CountedItems : totals.CountedCalls);
+			writer << ", \"ipc\": " << (lValues[PERF_CYCLES] > 0 ? (double)lValues[PERF_INSTRUCTIONS] / lValues[PERF_CYCLES] : 0.0)
+				<< ", \"per\": \"" << (totals.CountedItems > 0 ? "item" : "call") << "\"";
+			for (int c = 0; c < PERF_COUNTER_COUNT; c++)
+			{
+				writer << ", \"" << PerfCounters::GetCounterName((PerfCounter)c) << "\": " << lValues[c] / dPer;
+			}
+		}
+		writer << " }";
+	}
+	writer << "\n\t]\n}\n";
+	return true;
+}
@@ -0,0 +1,263 @@
+#ifndef __CPUPROFILER_H_
+#define __CPUPROFILER_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "PerfCounters.h"
+
+// Zones kept per thread.  Older ones are overwritten.
+#define CPU_PROFILER_ZONES 16384
+
+// Most threads that can record zones.
+#define CPU_PROFILER_MAX_THREADS 32
+
+// Frame starts remembered for the flame view.
+#define CPU_PROFILER_FRAMES 16
+
+// Defining AERO_DISABLE_PROFILER removes every zone from the build.
+// PROFILE_ZONE_ITEMS also records how many items, like entities, the zone worked on,
+// so hardware counters can be reported per item.
+#ifdef AERO_DISABLE_PROFILER
+#define PROFILE_ZONE(name)
+#define PROFILE_ZONE_ITEMS(name, items)
+#else
+#define PROFILE_ZONE_JOIN2(a, b) a##b
+#define PROFILE_ZONE_JOIN(a, b) PROFILE_ZONE_JOIN2(a, b)
+#define PROFILE_ZONE(name) CPUZoneScope PROFILE_ZONE_JOIN(zone_, __LINE__)(name)
+#define PROFILE_ZONE_ITEMS(name, items) CPUZoneScope PROFILE_ZONE_JOIN(zone_, __LINE__)(name, (int)(items))
+#endif
+
+/// <summary>
+/// A finished zone.  Names must be string literals, only the pointer is kept.
+/// </summary>
+struct CPUZone
+{
+	const char* Name;
+	uint64_t Begin;		// Nanoseconds on the steady clock.
+	uint64_t End;
+	int Depth;			// Nesting level on its thread.
+	int Items;			// 0 unless recorded through PROFILE_ZONE_ITEMS.
+	bool HasCounters;
+	PerfCounterValues Counters;		// Hardware events during the zone, when counting.
+};
+
+/// <summary>
+/// A zone copied out of a thread's buffer along with the thread it ran on.
+/// </summary>
+struct CPUZoneRecord
+{
+	CPUZone Zone;
+	int Thread;
+};
+
+/// <summary>
+/// Every zone of one name added up.
+/// </summary>
+struct CPUZoneTotals
+{
+	const char* Name;
+	int Calls;
+	long long Items;
+	double MS;
+	int CountedCalls;	// Calls that have hardware counters.
+	long long CountedItems;
+	PerfCounterValues Counters;
+};
+
+/// <summary>
+/// Records nested, named CPU zones from any thread.  Every thread writes only to its
+/// own ring buffer, so recording takes no lock.  When profiling is off a zone costs a
+/// single relaxed load.
+/// </summary>
+class CPUProfiler
+{
+private:
+	/// <summary>
+	/// Zones of one thread.  Written only by that thread.
+	/// </summary>
+	struct ThreadBuffer
+	{
+		char Name[32];
+		CPUZone Zones[CPU_PROFILER_ZONES];
+		std::atomic<uint64_t> Head;		// Zones written so far.  Index is Head % CPU_PROFILER_ZONES.
+		int Depth;
+	};
+
+	static CPUProfiler* m_pInstance;
+	static std::atomic<bool> m_bIsEnabled;
+	static std::atomic<unsigned int> m_uGeneration;
+	static std::atomic<bool> m_bIsCounting;
+
+	std::atomic<ThreadBuffer*> m_lThreads[CPU_PROFILER_MAX_THREADS];	// Published once filled in, read by Collect.
+	std::atomic<int> m_dThreadCount{ 0 };
+	uint64_t m_lFrameStarts[CPU_PROFILER_FRAMES];
+	std::atomic<uint64_t> m_uFrameCount{ 0 };
+
+public:
+	/// <summary>
+	/// Retrieves the instance of the CPUProfiler.  Created before other threads start.
+	/// </summary>
+	/// <returns>The single instance of the CPUProfiler.</returns>
+	static CPUProfiler* GetInstance(void);
+
+	/// <summary>
+	/// Removes the single instance of the CPUProfiler from memory.  No zone may be open.
+	/// </summary>
+	static void ReleaseInstance(void);
+
+	/// <summary>
+	/// Gets whether zones are being recorded.
+	/// </summary>
+	static bool IsEnabled(void) { return m_bIsEnabled.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Sets whether zones are being recorded.
+	/// </summary>
+	static void SetEnabled(bool a_bIsEnabled);
+
+	/// <summary>
+	/// Gets whether zones also record hardware counters.
+	/// </summary>
+	static bool IsCounting(void) { return m_bIsCounting.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Sets whether zones also record hardware counters.  Threads without counters keep recording plain zones.
+	/// </summary>
+	/// <returns>False if the calling thread cannot open counters, see PerfCounters::GetError.</returns>
+	static bool SetCounting(bool a_bIsCounting);
+
+	/// <summary>
+	/// Adds up zones by name, in the order each name first appears.
+	/// </summary>
+	static void Summarize(const std::vector<CPUZoneRecord>& a_lZones, std::vector<CPUZoneTotals>& a_lTotals);
+
+	/// <summary>
+	/// Gets the current time on the profiler's clock in nanoseconds.
+	/// </summary>
+	static uint64_t Now(void);
+
+	/// <summary>
+	/// Names the calling thread in the flame view and trace.  Takes effect once the thread records a zone.
+	/// </summary>
+	/// <param name="a_sName">String literal naming the thread.</param>
+	static void SetThreadName(const char* a_sName);
+
+	/// <summary>
+	/// Marks the start of a frame.  Called by one thread only.
+	/// </summary>
+	void MarkFrame(void);
+
+	/// <summary>
+	/// Opens a zone on the calling thread.
+	/// </summary>
+	/// <returns>The zone's start time.</returns>
+	uint64_t BeginZone(void);
+
+	/// <summary>
+	/// Closes the calling thread's innermost zone and records it.
+	/// </summary>
+	/// <param name="a_dItems">Items the zone worked on, or 0.</param>
+	/// <param name="a_pCounters">Counters read when the zone opened, or nullptr.</param>
+	void EndZone(const char* a_sName, uint64_t a_uBegin, int a_dItems, const PerfCounterValues* a_pCounters);
+
+	/// <summary>
+	/// Gets the start of a recent frame and the time now.
+	/// </summary>
+	/// <param name="a_dFrames">How many frames back to start, at most CPU_PROFILER_FRAMES - 1.</param>
+	/// <returns>False if not enough frames were marked.</returns>
+	bool GetFrameRange(int a_dFrames, uint64_t& a_uBegin, uint64_t& a_uEnd);
+
+	/// <summary>
+	/// Copies the recorded zones that overlap a time range.
+	/// </summary>
+	void Collect(uint64_t a_uBegin, uint64_t a_uEnd, std::vector<CPUZoneRecord>& a_lZones);
+
+	/// <summary>
+	/// Gets the number of threads that recorded zones.
+	/// </summary>
+	int GetThreadCount(void);
+
+	/// <summary>
+	/// Gets the name of a thread that recorded zones.
+	/// </summary>
+	const char* GetThreadName(int a_dThread);
+
+	/// <summary>
+	/// Writes every recorded zone in the Chrome trace event format, which Perfetto also opens.
+	/// </summary>
+	/// <returns>False if the file could not be written.</returns>
+	bool ExportTrace(const std::string& a_sFilepath);
+
+	/// <summary>
+	/// Writes the totals of every recorded zone with their IPC and misses per call and per item.
+	/// </summary>
+	/// <returns>False if the file could not be written.</returns>
+	bool ExportCounters(const std::string& a_sFilepath);
+
+private:
+	/// <summary>
+	/// Constructs the CPUProfiler.
+	/// </summary>
+	CPUProfiler(void);
+
+	/// <summary>
+	/// Frees every thread's buffer.
+	/// </summary>
+	~CPUProfiler(void);
+
+	/// <summary>
+	/// Gets the calling thread's buffer, creating it on first use.
+	/// </summary>
+	/// <returns>Nullptr once every buffer is taken.</returns>
+	ThreadBuffer* GetThreadBuffer(void);
+};
+
+/// <summary>
+/// Records a zone from construction to destruction.  Use through PROFILE_ZONE.
+/// </summary>
+class CPUZoneScope
+{
+private:
+	const char* m_sName;
+	uint64_t m_uBegin;
+	int m_dItems;
+	bool m_bIsRecording;
+	bool m_bHasCounters;
+	PerfCounterValues m_counters;
+
+public:
+	/// <summary>
+	/// Opens the zone if profiling is on.
+	/// </summary>
+	/// <param name="a_sName">String literal naming the zone.</param>
+	/// <param name="a_dItems">Items the zone works on, or 0.</param>
+	explicit CPUZoneScope(const char* a_sName, int a_dItems = 0)
+	{
+		m_sName = a_sName;
+		m_dItems = a_dItems;
+		m_bIsRecording = CPUProfiler::IsEnabled();
+		m_uBegin = m_bIsRecording ? CPUProfiler::GetInstance()->BeginZone() : 0;
+
+		// Read last, so the zone's own bookkeeping is not counted.
+		m_bHasCounters = m_bIsRecording && CPUProfiler::IsCounting() && PerfCounters::Read(m_counters);
+	}
+
+	/// <summary>
+	/// Closes and records the zone.
+	/// </summary>
+	~CPUZoneScope(void)
+	{
+		if (m_bIsRecording)
+		{
+			CPUProfiler::GetInstance()->EndZone(m_sName, m_uBegin, m_dItems, m_bHasCounters ? &m_counters : nullptr);
+		}
+	}
+
+	CPUZoneScope(const CPUZoneScope&) = delete;
+	CPUZoneScope& operator=(const CPUZoneScope&) = delete;
+};
+
+#endif //__CPUPROFILER_H_
@@ -0,0 +1,69 @@
+#include "Camera.h"
+#include "Math.h"
+#include <algorithm>
+
+// Reading the keyboard and mouse is the only part of the Camera that links SFML, so
+// the view and projection math in Camera.cpp also builds on machines without it.
+
+void Camera::Update(float a_fDeltaTime, sf::Window* a_pWindow)
+{
+	float fSpeed = 0.75f * a_fDeltaTime;
+
+	// Forward and backwards movement.
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W))
+	{
+		m_tTransform.MoveLocal(glm::vec3(0.0f, 0.0f, fSpeed));
+	}
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S))
+	{
+		m_tTransform.MoveLocal(glm::vec3(0.0f, 0.0f, -fSpeed));
+	}
+
+	// Left and right movement.
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
+	{
+		m_tTransform.MoveLocal(glm::vec3(fSpeed, 0.0f, 0.0f));
+	}
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
+	{
+		m_tTransform.MoveLocal(glm::vec3(-fSpeed, 0.0f, 0.0f));
+	}
+	
+	// Up and down movement.
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
+	{
+		m_tTransform.MoveGlobal(glm::vec3(0.0f, fSpeed, 0.0f));
+	}
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::X))
+	{
+		m_tTransform.MoveGlobal(glm::vec3(0.0f, -fSpeed, 0.0f));
+	}
+
+	// Mouse input checking.
+	sf::Vector2i v2CurrentMousePosition = sf::Mouse::getPosition(*a_pWindow);
+	sf::Vector2i v2CursorDelta = v2CurrentMousePosition - m_v2PrevMousePosition;
+	if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Right))
+	{
+		// Scaling down the delta to be a little more reasonable.
+		float fCursorDeltaY = v2CursorDelta.y * 0.0025f;
+		float fCursorDeltaX = v2CursorDelta.x * 0.0025f;
+
+		// Not very memory efficient but reduces operations.
+		float fRotationX = m_tTransform.GetRotation().x + fCursorDeltaY;	// The future rotation.
+		float fMin = (-90.0f * static_cast<float>(PI / 180.0f));			// -1/2PI
+		float fMax = (+90.0f * static_cast<float>(PI / 180.0f));			// 1/2PI
+		float fPostClamp = std::max(fMin, std::min(fRotationX, fMax));
+		
+		// Checking if the clamp was done.  If it was, do not rotate around the X axis.
+		if (fPostClamp == fMin || fPostClamp == fMax)
+		{
+			fCursorDeltaY = 0.0f;
+		}
+
+		// Rotating with the resulting values.
+		m_tTransform.Rotate(glm::vec3(-fCursorDeltaY, fCursorDeltaX, 0.0f));
+	}
+
+	UpdateView();
+	m_v2PrevMousePosition = v2CurrentMousePosition;
+}
@@ -4,6 +4,7 @@
 #define CORNFLOWER_BLUE glm::vec4(0.39f, 0.58f, 0.92f, 1.0f)
 #define PAPAYA_ORANGE glm::vec4(0.99f, 0.5f, 0.0f, 1.0f)
 #define EMERALD_GREEN glm::vec4(0.12f, 0.3f, 0.18f, 1.0f)
+#define BLACK glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)
 
 // Generic rainbow.
 #define RED glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)
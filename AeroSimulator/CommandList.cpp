@@ -0,0 +1,149 @@
+#include "CommandList.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Debug.h"
+#include "RenderStats.h"
+#include <glm/gtc/type_ptr.hpp>
+
+// - - CommandList - -
+
+CommandList::CommandList(void) {}
+
+CommandList::CommandList(const CommandList& a_pOther)
+{
+	m_lCommands = a_pOther.m_lCommands;
+	m_lDrawData = a_pOther.m_lDrawData;
+	m_pPipeline = a_pOther.m_pPipeline;
+	m_pGeometry = a_pOther.m_pGeometry;
+}
+
+CommandList& CommandList::operator=(const CommandList& a_pOther)
+{
+	m_lCommands = a_pOther.m_lCommands;
+	m_lDrawData = a_pOther.m_lDrawData;
+	m_pPipeline = a_pOther.m_pPipeline;
+	m_pGeometry = a_pOther.m_pGeometry;
+	return *this;
+}
+
+void CommandList::Reset(void)
+{
+	m_lCommands.clear();
+	m_lDrawData.clear();
+	m_pPipeline = nullptr;
+	m_pGeometry = nullptr;
+}
+
+void CommandList::BindPipeline(const Material* a_pMaterial)
+{
+	if (a_pMaterial == m_pPipeline) return;
+
+	RenderCommand command = { RC_BIND_PIPELINE, 0, a_pMaterial };
+	m_lCommands.push_back(command);
+	m_pPipeline = a_pMaterial;
+}
+
+void CommandList::BindGeometry(const Mesh* a_pMesh)
+{
+	if (a_pMesh == m_pGeometry) return;
+
+	RenderCommand command = { RC_BIND_GEOMETRY, 0, a_pMesh };
+	m_lCommands.push_back(command);
+	m_pGeometry = a_pMesh;
+}
+
+void CommandList::SetDrawData(const DrawData& a_data)
+{
+	RenderCommand command = { RC_SET_DRAW_DATA, (unsigned int)m_lDrawData.size(), nullptr };
+	m_lCommands.push_back(command);
+	m_lDrawData.push_back(a_data);
+}
+
+void CommandList::Draw(unsigned int a_uVertexCount)
+{
+	RenderCommand command = { RC_DRAW, a_uVertexCount, nullptr };
+	m_lCommands.push_back(command);
+}
+
+int CommandList::GetCommandCount(void) const { return (int)m_lCommands.size(); }
+const RenderCommand& CommandList::GetCommand(int a_dIndex) const { return m_lCommands[a_dIndex]; }
+const DrawData& CommandList::GetDrawData(unsigned int a_uIndex) const { return m_lDrawData[a_uIndex]; }
+
+// - - CommandReplayer - -
+
+void CommandReplayer::Begin(bool a_bIsDepthOnly, GLint a_dWVPLocation, unsigned int a_uFeatures)
+{
+	m_bIsDepthOnly = a_bIsDepthOnly;
+	m_uFeatures = a_uFeatures;
+	m_dWVPLocation = a_dWVPLocation;
+	m_dWorldLocation = -1;
+	m_dInverseTransposeLocation = -1;
+	m_dDebugColorLocation = -1;
+	m_dExecuted = 0;
+}
+
+void CommandReplayer::Execute(const CommandList& a_list)
+{
+	for (int i = 0; i < a_list.GetCommandCount(); i++)
+	{
+		const RenderCommand& command = a_list.GetCommand(i);
+		switch (command.Type)
+		{
+		case RC_BIND_PIPELINE:
+		{
+			if (m_bIsDepthOnly) break;
+
+			// Materials are only read, preparing one binds its program and textures.
+			Material* pMaterial = (Material*)command.Handle;
+			const MaterialLocations& locations = pMaterial->PrepMaterial(m_uFeatures);
+			m_dWVPLocation = locations.WVP;
+			m_dWorldLocation = locations.World;
+			m_dInverseTransposeLocation = locations.InverseTranspose;
+			m_dDebugColorLocation = locations.DebugColor;
+			break;
+		}
+		case RC_BIND_GEOMETRY:
+		{
+			Mesh* pMesh = (Mesh*)command.Handle;
+			GLCall(glBindVertexArray(pMesh->GetVAO()));
+			RenderStats::Add(RS_VAO_BINDS);
+			break;
+		}
+		case RC_SET_DRAW_DATA:
+		{
+			const DrawData& data = a_list.GetDrawData(command.Argument);
+			GLCall(glUniformMatrix4fv(m_dWVPLocation, 1, GL_FALSE, glm::value_ptr(data.WVP)));
+			RenderStats::Add(RS_UNIFORM_UPLOADS);
+			if (m_bIsDepthOnly) break;
+
+			GLCall(glUniformMatrix4fv(m_dInverseTransposeLocation, 1, GL_FALSE, glm::value_ptr(data.InverseTranspose)));
+			RenderStats::Add(RS_UNIFORM_UPLOADS);
+			if (m_dWorldLocation != -1)
+			{
+				GLCall(glUniformMatrix4fv(m_dWorldLocation, 1, GL_FALSE, glm::value_ptr(data.World)));
+				RenderStats::Add(RS_UNIFORM_UPLOADS);
+			}
+
+			// Absent until a debug view variant has compiled.
+			if (m_dDebugColorLocation != -1)
+			{
+				GLCall(glUniform4fv(m_dDebugColorLocation, 1, glm::value_ptr(data.DebugColor)));
+				RenderStats::Add(RS_UNIFORM_UPLOADS);
+			}
+			break;
+		}
+		case RC_DRAW:
+			GLCall(glDrawArrays(GL_TRIANGLES, 0, command.Argument));
+			RenderStats::AddDraw(command.Argument);
+			break;
+		}
+	}
+	m_dExecuted += a_list.GetCommandCount();
+}
+
+void CommandReplayer::End(void)
+{
+	GLCall(glBindVertexArray(0));
+}
+
+int CommandReplayer::GetExecutedCount(void) { return m_dExecuted; }
@@ -0,0 +1,153 @@
+#ifndef __COMMANDLIST_H_
+#define __COMMANDLIST_H_
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+class Material;
+class Mesh;
+
+/// <summary>
+/// What a RenderCommand does.
+/// </summary>
+enum RenderCommandType
+{
+	RC_BIND_PIPELINE = 0,	// Handle is the Material whose shader and textures are used.
+	RC_BIND_GEOMETRY,		// Handle is the Mesh whose vertices are drawn.
+	RC_SET_DRAW_DATA,		// Argument indexes the list's DrawData.
+	RC_DRAW					// Argument is the vertex count.
+};
+
+/// <summary>
+/// A single recorded command.  Holds no GL state, so any thread can record it.
+/// </summary>
+struct RenderCommand
+{
+	RenderCommandType Type;
+	unsigned int Argument;
+	const void* Handle;
+};
+
+/// <summary>
+/// Per draw values set by RC_SET_DRAW_DATA.
+/// </summary>
+struct DrawData
+{
+	glm::mat4 WVP;
+	glm::mat4 World;
+	glm::mat4 InverseTranspose;
+	glm::vec4 DebugColor;		// Only read by the debug view variants.
+};
+
+/// <summary>
+/// Commands for one chunk of a frame, recorded on any thread and replayed on the
+/// GL thread.  Binds matching the previous one in the list are dropped while recording.
+/// </summary>
+class CommandList
+{
+private:
+	std::vector<RenderCommand> m_lCommands;
+	std::vector<DrawData> m_lDrawData;
+	const void* m_pPipeline = nullptr;
+	const void* m_pGeometry = nullptr;
+
+public:
+	/// <summary>
+	/// Constructs an empty CommandList.
+	/// </summary>
+	CommandList(void);
+
+	/// <summary>
+	/// Copy constructor for the CommandList.
+	/// </summary>
+	CommandList(const CommandList& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the CommandList.
+	/// </summary>
+	CommandList& operator=(const CommandList& a_pOther);
+
+	/// <summary>
+	/// Empties the list for recording.  Keeps the memory.
+	/// </summary>
+	void Reset(void);
+
+	/// <summary>
+	/// Records a switch to the shader and textures of a Material.
+	/// </summary>
+	void BindPipeline(const Material* a_pMaterial);
+
+	/// <summary>
+	/// Records a switch to the vertices of a Mesh.
+	/// </summary>
+	void BindGeometry(const Mesh* a_pMesh);
+
+	/// <summary>
+	/// Records the per draw values of the following draws.
+	/// </summary>
+	void SetDrawData(const DrawData& a_data);
+
+	/// <summary>
+	/// Records a draw of the bound geometry.
+	/// </summary>
+	/// <param name="a_uVertexCount">Number of vertices drawn as triangles.</param>
+	void Draw(unsigned int a_uVertexCount);
+
+	/// <summary>
+	/// Gets the number of recorded commands.
+	/// </summary>
+	int GetCommandCount(void) const;
+
+	/// <summary>
+	/// Gets a recorded command.
+	/// </summary>
+	const RenderCommand& GetCommand(int a_dIndex) const;
+
+	/// <summary>
+	/// Gets the values of an RC_SET_DRAW_DATA command.
+	/// </summary>
+	const DrawData& GetDrawData(unsigned int a_uIndex) const;
+};
+
+/// <summary>
+/// Executes CommandLists in order on the thread owning the GL context.
+/// </summary>
+class CommandReplayer
+{
+private:
+	// Uniform locations of the bound pipeline, looked up once per bind.
+	GLint m_dWVPLocation = -1;
+	GLint m_dWorldLocation = -1;
+	GLint m_dInverseTransposeLocation = -1;
+	GLint m_dDebugColorLocation = -1;
+	bool m_bIsDepthOnly = false;
+	unsigned int m_uFeatures = 0;
+	int m_dExecuted = 0;
+
+public:
+	/// <summary>
+	/// Prepares a replay.
+	/// </summary>
+	/// <param name="a_bIsDepthOnly">Skips pipeline binds so the already bound depth shader is kept.</param>
+	/// <param name="a_dWVPLocation">WVP location of the bound depth shader when depth only.</param>
+	/// <param name="a_uFeatures">ShaderFeature bits added to every Material's variant.</param>
+	void Begin(bool a_bIsDepthOnly, GLint a_dWVPLocation = -1, unsigned int a_uFeatures = 0);
+
+	/// <summary>
+	/// Executes every command of a list.
+	/// </summary>
+	void Execute(const CommandList& a_list);
+
+	/// <summary>
+	/// Unbinds the geometry left bound by the replay.
+	/// </summary>
+	void End(void);
+
+	/// <summary>
+	/// Gets the number of commands executed since Begin.
+	/// </summary>
+	int GetExecutedCount(void);
+};
+
+#endif //__COMMANDLIST_H_
@@ -1,7 +1,9 @@
 #include "Debug.h"
 
 #include <GL/glew.h>
+#ifdef _WIN32
 #include <GL/wglew.h>
+#endif
 #include <iostream>
 
 void GLClearError(void)
@@ -1,6 +1,9 @@
 #ifndef __DEBUG_H_
 #define __DEBUG_H_
 
+// Routes the GL 1.1 calls through pointers a capture can hook.
+#include "GLCapture.h"
+
 /// <summary>
 /// Checks that there are no errors coming from OpenGL.
 /// </summary>
@@ -17,7 +20,11 @@ bool GLLogCall(const char* a_sFunction, const char* a_sFile, int a_uLine);
 
 /* Helper macro for the GLCall macro. If the passed in value evaluates to
    false, it will halt execution at that line of code. */
+#ifdef _MSC_VER
 #define ASSERT(x) if (!(x)) __debugbreak();
+#else
+#define ASSERT(x) if (!(x)) __builtin_trap();
+#endif
 
 /* Error handling macro for GL function calls. */
 #define GLCall(x) GLClearError();\
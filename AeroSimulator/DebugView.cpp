@@ -0,0 +1,257 @@
+#include "DebugView.h"
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "Debug.h"
+#include "Colors.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Added by every fragment in the overdraw view, so ten layers reach a bright orange.
+#define DEBUG_VIEW_OVERDRAW_STEP glm::vec4(0.1f, 0.04f, 0.01f, 1.0f)
+
+// Color of the edges in the wireframe view.
+#define DEBUG_VIEW_WIREFRAME_COLOR glm::vec4(0.9f, 0.9f, 0.9f, 1.0f)
+
+// Floats of one line vertex, a position and a color as LineVertex.glsl reads them.
+#define DEBUG_VIEW_VERTEX_FLOATS 6
+
+// Fraction of the screen's height an entity has to cover to stay at each LOD level.
+static const float LOD_SCREEN_HEIGHTS[DEBUG_VIEW_LOD_LEVELS - 1] = { 0.5f, 0.25f, 0.1f };
+
+// Color of each LOD level, most detailed first.
+static const glm::vec4 LOD_COLORS[DEBUG_VIEW_LOD_LEVELS] = { GREEN, YELLOW, ORANGE, RED };
+
+// Corners of a box joined by each of its twelve edges, with bit 0 to 2 picking Max over Min on x, y and z.
+static const int BOX_EDGES[24] =
+{
+	0, 1, 2, 3, 4, 5, 6, 7,
+	0, 2, 1, 3, 4, 6, 5, 7,
+	0, 4, 1, 5, 2, 6, 3, 7
+};
+
+DebugView::DebugView(void)
+{
+	Create();
+}
+
+DebugView::~DebugView(void)
+{
+	glDeleteVertexArrays(1, &m_uVAO);
+	glDeleteBuffers(1, &m_uVBO);
+	MemoryTracker::RemoveBuffer(m_uVBO);
+}
+
+DebugView::DebugView(const DebugView&)
+{
+	// Vertex arrays cannot be shared between objects, so a copy makes its own.
+	Create();
+}
+
+DebugView& DebugView::operator=(const DebugView&)
+{
+	// Nothing but GL objects is held, which each DebugView keeps to itself.
+	return *this;
+}
+
+void DebugView::Create(void)
+{
+	m_pLineShader = std::make_shared<Shader>();
+	m_pLineShader->CompileShader("shaders/LineVertex.glsl", "shaders/LineFragment.glsl");
+	m_dWVPLocation = glGetUniformLocation(m_pLineShader->GetProgramID(), "WVP");
+
+	GLCall(glGenVertexArrays(1, &m_uVAO));
+	GLCall(glGenBuffers(1, &m_uVBO));
+	GLCall(glBindVertexArray(m_uVAO));
+	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_uVBO));
+	GLCall(glEnableVertexAttribArray(0));
+	GLCall(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, DEBUG_VIEW_VERTEX_FLOATS * sizeof(float), (void*)0));
+	GLCall(glEnableVertexAttribArray(1));
+	GLCall(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, DEBUG_VIEW_VERTEX_FLOATS * sizeof(float), (void*)(3 * sizeof(float))));
+	GLCall(glBindVertexArray(0));
+}
+
+void DebugView::Begin(DebugViewMode a_eMode)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_OVERDRAW:
+		// Depth testing stays as it is, so only fragments that really get shaded add heat.
+		GLCall(glBlendFunc(GL_ONE, GL_ONE));
+		break;
+	case DEBUG_VIEW_WIREFRAME:
+		GLCall(glPolygonMode(GL_FRONT_AND_BACK, GL_LINE));
+		break;
+	default:
+		break;
+	}
+}
+
+void DebugView::End(DebugViewMode a_eMode)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_OVERDRAW:
+		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+		break;
+	case DEBUG_VIEW_WIREFRAME:
+		GLCall(glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
+		break;
+	default:
+		break;
+	}
+}
+
+void DebugView::DrawBoxes(const std::vector<DebugBox>& a_lBoxes, const glm::mat4& a_m4ViewProjection)
+{
+	if (a_lBoxes.empty()) return;
+
+	// Two vertices for each of the twelve edges of every box.
+	m_lVertices.clear();
+	for (int i = 0; i < a_lBoxes.size(); i++)
+	{
+		const DebugBox& box = a_lBoxes[i];
+		for (int j = 0; j < 24; j++)
+		{
+			int dCorner = BOX_EDGES[j];
+			m_lVertices.push_back((dCorner & 1) ? box.Bounds.Max.x : box.Bounds.Min.x);
+			m_lVertices.push_back((dCorner & 2) ? box.Bounds.Max.y : box.Bounds.Min.y);
+			m_lVertices.push_back((dCorner & 4) ? box.Bounds.Max.z : box.Bounds.Min.z);
+			m_lVertices.push_back(box.Color.r);
+			m_lVertices.push_back(box.Color.g);
+			m_lVertices.push_back(box.Color.b);
+		}
+	}
+
+	GLCall(glUseProgram(m_pLineShader->GetProgramID()));
+	RenderStats::Add(RS_PROGRAM_BINDS);
+	GLCall(glUniformMatrix4fv(m_dWVPLocation, 1, GL_FALSE, glm::value_ptr(a_m4ViewProjection)));
+	RenderStats::Add(RS_UNIFORM_UPLOADS);
+
+	// Respecifying the whole buffer every frame, so the driver never waits on last frame's lines.
+	size_t uBytes = m_lVertices.size() * sizeof(float);
+	GLCall(glBindVertexArray(m_uVAO));
+	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_uVBO));
+	GLCall(glBufferData(GL_ARRAY_BUFFER, uBytes, m_lVertices.data(), GL_STREAM_DRAW));
+	RenderStats::Add(RS_VAO_BINDS);
+	RenderStats::Add(RS_BUFFER_BYTES, (long long)uBytes);
+	if (uBytes != m_uBufferBytes)
+	{
+		MemoryTracker::AddBuffer(m_uVBO, MEMORY_MESHES, uBytes);
+		m_uBufferBytes = uBytes;
+	}
+
+	// Boxes behind other geometry are what the culling view is about, so nothing hides them.
+	GLsizei dVertices = (GLsizei)(m_lVertices.size() / DEBUG_VIEW_VERTEX_FLOATS);
+	GLCall(glDisable(GL_DEPTH_TEST));
+	GLCall(glDrawArrays(GL_LINES, 0, dVertices));
+	GLCall(glEnable(GL_DEPTH_TEST));
+	RenderStats::Add(RS_DRAW_CALLS);
+	RenderStats::Add(RS_VERTICES, dVertices);
+	GLCall(glBindVertexArray(0));
+}
+
+unsigned int DebugView::GetFeatures(DebugViewMode a_eMode)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_OVERDRAW:
+	case DEBUG_VIEW_DRAW_COST:
+	case DEBUG_VIEW_LOD:
+	case DEBUG_VIEW_WIREFRAME:
+		return SHADER_DEBUG_VIEW;
+	default:
+		return 0;
+	}
+}
+
+bool DebugView::DrawsSky(DebugViewMode a_eMode)
+{
+	return a_eMode != DEBUG_VIEW_OVERDRAW;
+}
+
+bool DebugView::UsesDepthPrepass(DebugViewMode a_eMode)
+{
+	return a_eMode != DEBUG_VIEW_OVERDRAW && a_eMode != DEBUG_VIEW_WIREFRAME;
+}
+
+glm::vec4 DebugView::GetDrawColor(DebugViewMode a_eMode, unsigned int a_uVertexCount, const AABB& a_aBounds,
+	const glm::mat4& a_m4View, const glm::mat4& a_m4Projection)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_OVERDRAW:
+		return DEBUG_VIEW_OVERDRAW_STEP;
+	case DEBUG_VIEW_DRAW_COST:
+	{
+		// Green through yellow to red as the vertex count grows tenfold.
+		float fVertices = std::max((float)a_uVertexCount, DEBUG_VIEW_COST_LOW);
+		float fCost = std::log(fVertices / DEBUG_VIEW_COST_LOW) / std::log(DEBUG_VIEW_COST_HIGH / DEBUG_VIEW_COST_LOW);
+		fCost = std::min(fCost, 1.0f);
+		return glm::vec4(std::min(fCost * 2.0f, 1.0f), std::min(2.0f - fCost * 2.0f, 1.0f), 0.0f, 1.0f);
+	}
+	case DEBUG_VIEW_LOD:
+		return LOD_COLORS[GetLODLevel(a_aBounds, a_m4View, a_m4Projection)];
+	case DEBUG_VIEW_WIREFRAME:
+		return DEBUG_VIEW_WIREFRAME_COLOR;
+	default:
+		return glm::vec4(1.0f);
+	}
+}
+
+int DebugView::GetLODLevel(const AABB& a_aBounds, const glm::mat4& a_m4View, const glm::mat4& a_m4Projection)
+{
+	// Projecting the bounding sphere, its radius over the half height of the screen.
+	float fRadius = glm::length(a_aBounds.GetExtents());
+	float fDepth = -(a_m4View * glm::vec4(a_aBounds.GetCenter(), 1.0f)).z;
+	if (fDepth <= fRadius) return 0;
+
+	float fScreenHeight = fRadius * a_m4Projection[1][1] / fDepth;
+	for (int i = 0; i < DEBUG_VIEW_LOD_LEVELS - 1; i++)
+	{
+		if (fScreenHeight >= LOD_SCREEN_HEIGHTS[i]) return i;
+	}
+	return DEBUG_VIEW_LOD_LEVELS - 1;
+}
+
+const char* DebugView::GetModeName(DebugViewMode a_eMode)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_NONE: return "none";
+	case DEBUG_VIEW_OVERDRAW: return "overdraw";
+	case DEBUG_VIEW_DRAW_COST: return "draw_cost";
+	case DEBUG_VIEW_LOD: return "lod";
+	case DEBUG_VIEW_CULLING: return "culling";
+	case DEBUG_VIEW_WIREFRAME: return "wireframe";
+	default: return "unknown";
+	}
+}
+
+const char* DebugView::GetLegend(DebugViewMode a_eMode)
+{
+	switch (a_eMode)
+	{
+	case DEBUG_VIEW_OVERDRAW: return "Dark red is one shaded layer, orange about ten.  Opaque pass only, without the depth prepass.";
+	case DEBUG_VIEW_DRAW_COST: return "Green under 1k vertices per draw, yellow around 10k, red over 100k.  Opaque pass over the sky.";
+	case DEBUG_VIEW_LOD: return "LOD 0 green, 1 yellow, 2 orange, 3 red, by the screen height covered.  Opaque pass over the sky.";
+	case DEBUG_VIEW_CULLING: return "Green drawn, yellow outside the frustum, red occluded.  Boxes over every pass.";
+	case DEBUG_VIEW_WIREFRAME: return "Edges of every submitted triangle.  Opaque pass over the sky, without the depth prepass.";
+	default: return "";
+	}
+}
+
+bool DebugView::ParseMode(const std::string& a_sName, DebugViewMode& a_eMode)
+{
+	for (int i = 0; i < DEBUG_VIEW_COUNT; i++)
+	{
+		if (a_sName == GetModeName((DebugViewMode)i))
+		{
+			a_eMode = (DebugViewMode)i;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,153 @@
+#ifndef __DEBUGVIEW_H_
+#define __DEBUGVIEW_H_
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bounds.h"
+
+class Shader;
+
+// Vertices per draw at which the draw cost view turns from green to red, on a log scale.
+#define DEBUG_VIEW_COST_LOW 1000.0f
+#define DEBUG_VIEW_COST_HIGH 100000.0f
+
+// Number of LOD levels the LOD view tells apart.
+#define DEBUG_VIEW_LOD_LEVELS 4
+
+/// <summary>
+/// Ways of viewing the scene for tuning content.  Every mode but the culling one
+/// draws the entities with the SHADER_DEBUG_VIEW variant of their own shader, so
+/// the same draws are submitted as in the normal view.
+/// </summary>
+enum DebugViewMode
+{
+	DEBUG_VIEW_NONE = 0,
+	DEBUG_VIEW_OVERDRAW,		// Adds a little heat for every shaded fragment.
+	DEBUG_VIEW_DRAW_COST,		// Colors each draw by the vertices it submits.
+	DEBUG_VIEW_LOD,				// Colors each draw by the LOD level its screen size selects.
+	DEBUG_VIEW_CULLING,			// Draws the bounds of drawn, frustum culled and occluded entities.
+	DEBUG_VIEW_WIREFRAME,		// Draws the triangles' edges only.
+	DEBUG_VIEW_COUNT
+};
+
+/// <summary>
+/// World space box drawn over the scene.
+/// </summary>
+struct DebugBox
+{
+	AABB Bounds;
+	glm::vec3 Color;
+};
+
+/// <summary>
+/// Sets up the render state of the debug view modes and draws the culling view's
+/// boxes.  Everything else a mode changes is picked per draw through the colors
+/// GetDrawColor hands the frame packet.
+/// </summary>
+class DebugView
+{
+private:
+	std::shared_ptr<Shader> m_pLineShader = nullptr;
+	GLint m_dWVPLocation = -1;
+	GLuint m_uVAO = 0;
+	GLuint m_uVBO = 0;
+	size_t m_uBufferBytes = 0;
+	std::vector<float> m_lVertices;		// Kept between frames so the boxes never allocate.
+
+public:
+	/// <summary>
+	/// Compiles the line shader and creates the box buffers.  Requires a current GL context.
+	/// </summary>
+	DebugView(void);
+
+	/// <summary>
+	/// Deletes the GL objects.
+	/// </summary>
+	~DebugView(void);
+
+	/// <summary>
+	/// Copy constructor for the DebugView.  Creates its own GL objects.
+	/// </summary>
+	DebugView(const DebugView& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the DebugView.  Keeps its own GL objects.
+	/// </summary>
+	DebugView& operator=(const DebugView& a_pOther);
+
+	/// <summary>
+	/// Changes the render state for the entity draws of a mode.
+	/// </summary>
+	void Begin(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Restores the render state Begin changed.
+	/// </summary>
+	void End(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Draws the edges of boxes on top of everything.
+	/// </summary>
+	void DrawBoxes(const std::vector<DebugBox>& a_lBoxes, const glm::mat4& a_m4ViewProjection);
+
+	/// <summary>
+	/// Gets the ShaderFeature bits a mode adds to every material.
+	/// </summary>
+	static unsigned int GetFeatures(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Gets whether the sky is drawn in a mode.  The overdraw view leaves it out so
+	/// only the entities' fragments are counted against a black background.
+	/// </summary>
+	static bool DrawsSky(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Gets whether a mode keeps the depth prepass.  The overdraw and wireframe views
+	/// drop it, since the GL_EQUAL test against it would leave one layer to count and
+	/// lines never hit the depth of the filled triangles exactly.
+	/// </summary>
+	static bool UsesDepthPrepass(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Gets the flat color an entity is drawn with in a mode.
+	/// </summary>
+	/// <param name="a_uVertexCount">Vertices of the entity's draw.</param>
+	/// <param name="a_aBounds">World bounds of the entity.</param>
+	/// <param name="a_m4View">View matrix of the frame.</param>
+	/// <param name="a_m4Projection">Projection matrix of the frame.</param>
+	static glm::vec4 GetDrawColor(DebugViewMode a_eMode, unsigned int a_uVertexCount, const AABB& a_aBounds,
+		const glm::mat4& a_m4View, const glm::mat4& a_m4Projection);
+
+	/// <summary>
+	/// Gets the LOD level an entity's screen size selects.  0 is the most detailed.
+	/// </summary>
+	static int GetLODLevel(const AABB& a_aBounds, const glm::mat4& a_m4View, const glm::mat4& a_m4Projection);
+
+	/// <summary>
+	/// Gets the name of a mode for the GUI and the command line.
+	/// </summary>
+	static const char* GetModeName(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Gets what the colors of a mode mean.
+	/// </summary>
+	static const char* GetLegend(DebugViewMode a_eMode);
+
+	/// <summary>
+	/// Parses a mode name as returned by GetModeName.
+	/// </summary>
+	/// <returns>False if the name is not a mode.</returns>
+	static bool ParseMode(const std::string& a_sName, DebugViewMode& a_eMode);
+
+private:
+	/// <summary>
+	/// Creates the vertex array of the box lines.
+	/// </summary>
+	void Create(void);
+};
+
+#endif //__DEBUGVIEW_H_
@@ -0,0 +1,133 @@
+#include "DynamicResolution.h"
+#include "Debug.h"
+#include <cmath>
+#include <algorithm>
+
+DynamicResolution::DynamicResolution(void)
+{
+	GLCall(glGenQueries(DYNAMIC_RES_LATENCY, m_lQueries));
+	for (int i = 0; i < DYNAMIC_RES_LATENCY; i++)
+	{
+		m_lIsPending[i] = false;
+	}
+	GLCall(glGenFramebuffers(1, &m_uReadFramebuffer));
+}
+
+DynamicResolution::~DynamicResolution(void)
+{
+	glDeleteQueries(DYNAMIC_RES_LATENCY, m_lQueries);
+	glDeleteFramebuffers(1, &m_uReadFramebuffer);
+}
+
+DynamicResolution::DynamicResolution(const DynamicResolution& a_pOther)
+{
+	// Queries and framebuffers cannot be shared, so only the settings are copied.
+	GLCall(glGenQueries(DYNAMIC_RES_LATENCY, m_lQueries));
+	for (int i = 0; i < DYNAMIC_RES_LATENCY; i++)
+	{
+		m_lIsPending[i] = false;
+	}
+	GLCall(glGenFramebuffers(1, &m_uReadFramebuffer));
+	*this = a_pOther;
+}
+
+DynamicResolution& DynamicResolution::operator=(const DynamicResolution& a_pOther)
+{
+	// Queries and framebuffers cannot be shared, so only the settings are copied.
+	m_bIsEnabled = a_pOther.m_bIsEnabled;
+	m_fScale = a_pOther.m_fScale;
+	m_fMinScale = a_pOther.m_fMinScale;
+	m_fMaxScale = a_pOther.m_fMaxScale;
+	m_fTargetMS = a_pOther.m_fTargetMS;
+	return *this;
+}
+
+void DynamicResolution::SetEnabled(bool a_bIsEnabled)
+{
+	m_bIsEnabled = a_bIsEnabled;
+	m_fScale = m_fMaxScale;
+	m_fGPUMS = 0.0f;
+}
+
+bool DynamicResolution::IsEnabled(void) { return m_bIsEnabled; }
+
+void DynamicResolution::SetBounds(float a_fMinScale, float a_fMaxScale)
+{
+	m_fMinScale = std::max(a_fMinScale, 0.1f);
+	m_fMaxScale = std::max(a_fMaxScale, m_fMinScale);
+	m_fScale = std::min(std::max(m_fScale, m_fMinScale), m_fMaxScale);
+}
+
+float DynamicResolution::GetMinScale(void) { return m_fMinScale; }
+float DynamicResolution::GetMaxScale(void) { return m_fMaxScale; }
+void DynamicResolution::SetTargetTime(float a_fMilliseconds) { m_fTargetMS = std::max(a_fMilliseconds, 0.1f); }
+float DynamicResolution::GetTargetTime(void) { return m_fTargetMS; }
+float DynamicResolution::GetScale(void) { return m_fScale; }
+float DynamicResolution::GetGPUTime(void) { return m_fGPUMS; }
+
+void DynamicResolution::GetTargetSize(int a_dWidth, int a_dHeight, int& a_dTargetWidth, int& a_dTargetHeight)
+{
+	a_dTargetWidth = std::max((int)ceilf(a_dWidth * m_fMaxScale), 1);
+	a_dTargetHeight = std::max((int)ceilf(a_dHeight * m_fMaxScale), 1);
+}
+
+void DynamicResolution::GetRenderSize(int& a_dWidth, int& a_dHeight)
+{
+	a_dWidth = m_dRenderWidth;
+	a_dHeight = m_dRenderHeight;
+}
+
+void DynamicResolution::BeginFrame(int a_dWidth, int a_dHeight)
+{
+	// The slot about to be reused holds the oldest frame in flight.
+	m_dFrame = (m_dFrame + 1) % DYNAMIC_RES_LATENCY;
+	if (m_lIsPending[m_dFrame])
+	{
+		GLuint64 uNanoseconds = 0;
+		GLCall(glGetQueryObjectui64v(m_lQueries[m_dFrame], GL_QUERY_RESULT, &uNanoseconds));
+		UpdateScale(uNanoseconds / 1000000.0f);
+	}
+
+	m_dRenderWidth = std::max((int)(a_dWidth * m_fScale), 1);
+	m_dRenderHeight = std::max((int)(a_dHeight * m_fScale), 1);
+
+	GLCall(glBeginQuery(GL_TIME_ELAPSED, m_lQueries[m_dFrame]));
+	m_lIsPending[m_dFrame] = true;
+}
+
+void DynamicResolution::ApplyViewport(void)
+{
+	if (!m_bIsEnabled) return;
+
+	GLCall(glViewport(0, 0, m_dRenderWidth, m_dRenderHeight));
+}
+
+void DynamicResolution::Upscale(GLuint a_uSceneColor, int a_dWidth, int a_dHeight)
+{
+	GLCall(glEndQuery(GL_TIME_ELAPSED));
+
+	// Stretching with a linear filter onto whatever the pass bound for drawing.
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_uReadFramebuffer));
+	GLCall(glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, a_uSceneColor, 0));
+	GLCall(glBlitFramebuffer(
+		0, 0, m_dRenderWidth, m_dRenderHeight,
+		0, 0, a_dWidth, a_dHeight,
+		GL_COLOR_BUFFER_BIT, GL_LINEAR));
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, 0));
+}
+
+void DynamicResolution::UpdateScale(float a_fMeasuredMS)
+{
+	// Smoothing out single slow frames.
+	m_fGPUMS = m_fGPUMS == 0.0f ? a_fMeasuredMS : m_fGPUMS * 0.8f + a_fMeasuredMS * 0.2f;
+	if (m_fGPUMS <= 0.0f) return;
+
+	float fRatio = m_fTargetMS / m_fGPUMS;
+	if (fabsf(1.0f - fRatio) < DYNAMIC_RES_DEADBAND) return;
+
+	// Cost follows the pixel count, which is the square of the scale.  Only part of the
+	// step is taken since the measurement lags a few frames behind the scale.
+	float fIdeal = m_fScale * sqrtf(fRatio);
+	m_fScale += (fIdeal - m_fScale) * DYNAMIC_RES_GAIN;
+	m_fScale = std::min(std::max(m_fScale, m_fMinScale), m_fMaxScale);
+}
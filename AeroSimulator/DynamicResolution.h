@@ -0,0 +1,147 @@
+#ifndef __DYNAMICRESOLUTION_H_
+#define __DYNAMICRESOLUTION_H_
+
+#include <GL/glew.h>
+
+// Frames a timer query is left in flight before it is read, so reading never stalls.
+#define DYNAMIC_RES_LATENCY 3
+
+// Default bounds of the render scale, as a fraction of the window's width and height.
+#define DYNAMIC_RES_MIN_SCALE 0.5f
+#define DYNAMIC_RES_MAX_SCALE 1.0f
+
+// Default GPU time budget of the scaled passes in milliseconds.
+#define DYNAMIC_RES_TARGET_MS 12.0f
+
+// Relative error around the target the scale holds still in, so it does not hunt.
+#define DYNAMIC_RES_DEADBAND 0.05f
+
+// Fraction of the way to the ideal scale moved per measurement.
+#define DYNAMIC_RES_GAIN 0.25f
+
+/// <summary>
+/// Picks the resolution the 3D scene is drawn at so its GPU time stays on a target.
+/// The scene is drawn into the corner of targets sized for the largest scale, so
+/// changing the scale never reallocates, and is then stretched over the window.
+/// </summary>
+class DynamicResolution
+{
+private:
+	GLuint m_lQueries[DYNAMIC_RES_LATENCY];
+	bool m_lIsPending[DYNAMIC_RES_LATENCY];
+	int m_dFrame = 0;
+	GLuint m_uReadFramebuffer = 0;
+
+	bool m_bIsEnabled = false;
+	float m_fScale = DYNAMIC_RES_MAX_SCALE;
+	float m_fMinScale = DYNAMIC_RES_MIN_SCALE;
+	float m_fMaxScale = DYNAMIC_RES_MAX_SCALE;
+	float m_fTargetMS = DYNAMIC_RES_TARGET_MS;
+	float m_fGPUMS = 0.0f;
+	int m_dRenderWidth = 0;
+	int m_dRenderHeight = 0;
+
+public:
+	/// <summary>
+	/// Creates the timer queries and the framebuffer the scene is read through.  Requires a current GL context.
+	/// </summary>
+	DynamicResolution(void);
+
+	/// <summary>
+	/// Deletes the GL objects.
+	/// </summary>
+	~DynamicResolution(void);
+
+	/// <summary>
+	/// Copy constructor for the DynamicResolution.  Creates its own GL objects.
+	/// </summary>
+	DynamicResolution(const DynamicResolution& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the DynamicResolution.  Keeps its own GL objects.
+	/// </summary>
+	DynamicResolution& operator=(const DynamicResolution& a_pOther);
+
+	/// <summary>
+	/// Sets whether the scene is drawn at a scaled resolution.  The frame graph must be rebuilt after.
+	/// </summary>
+	void SetEnabled(bool a_bIsEnabled);
+
+	/// <summary>
+	/// Gets whether the scene is drawn at a scaled resolution.
+	/// </summary>
+	bool IsEnabled(void);
+
+	/// <summary>
+	/// Sets the bounds of the render scale.  The frame graph must be rebuilt after.
+	/// </summary>
+	void SetBounds(float a_fMinScale, float a_fMaxScale);
+
+	/// <summary>
+	/// Gets the smallest render scale.
+	/// </summary>
+	float GetMinScale(void);
+
+	/// <summary>
+	/// Gets the largest render scale.
+	/// </summary>
+	float GetMaxScale(void);
+
+	/// <summary>
+	/// Sets the GPU time budget of the scaled passes.
+	/// </summary>
+	void SetTargetTime(float a_fMilliseconds);
+
+	/// <summary>
+	/// Gets the GPU time budget of the scaled passes.
+	/// </summary>
+	float GetTargetTime(void);
+
+	/// <summary>
+	/// Gets the current render scale.
+	/// </summary>
+	float GetScale(void);
+
+	/// <summary>
+	/// Gets the smoothed GPU time of the scaled passes.
+	/// </summary>
+	float GetGPUTime(void);
+
+	/// <summary>
+	/// Gets the size of the scene targets, big enough for the largest scale.
+	/// </summary>
+	void GetTargetSize(int a_dWidth, int a_dHeight, int& a_dTargetWidth, int& a_dTargetHeight);
+
+	/// <summary>
+	/// Gets the size the scene is drawn at this frame.
+	/// </summary>
+	void GetRenderSize(int& a_dWidth, int& a_dHeight);
+
+	/// <summary>
+	/// Reads back the oldest measurement, adjusts the scale and starts timing the scaled passes.
+	/// </summary>
+	/// <param name="a_dWidth">Width of the window.</param>
+	/// <param name="a_dHeight">Height of the window.</param>
+	void BeginFrame(int a_dWidth, int a_dHeight);
+
+	/// <summary>
+	/// Limits drawing to the scaled corner of the bound scene targets.
+	/// </summary>
+	void ApplyViewport(void);
+
+	/// <summary>
+	/// Stops timing and stretches the scaled scene over the bound draw framebuffer.
+	/// </summary>
+	/// <param name="a_uSceneColor">Color texture the scene was drawn into.</param>
+	/// <param name="a_dWidth">Width of the window.</param>
+	/// <param name="a_dHeight">Height of the window.</param>
+	void Upscale(GLuint a_uSceneColor, int a_dWidth, int a_dHeight);
+
+private:
+	/// <summary>
+	/// Moves the scale toward the one expected to meet the target.
+	/// </summary>
+	void UpdateScale(float a_fMeasuredMS);
+};
+
+#endif //__DYNAMICRESOLUTION_H_
@@ -1,6 +1,8 @@
 #include "Entity.h"
 #include "FileReader.h"
 #include "Debug.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
 #include <glm/gtc/type_ptr.hpp>
 
 Entity::Entity(std::shared_ptr<Mesh> a_pMesh, std::shared_ptr<Material> a_pMaterial)
@@ -8,25 +10,26 @@ Entity::Entity(std::shared_ptr<Mesh> a_pMesh, std::shared_ptr<Material> a_pMater
 	m_pMesh = a_pMesh;
 	m_pMaterial = a_pMaterial;
 	m_pTransform = new Transform();
+	MemoryTracker::Add(MEMORY_CPU, MEMORY_ENTITIES, sizeof(Entity) + sizeof(Transform));
+
+	// Forcing the first bounds calculation.
+	m_uBoundsVersion = m_pTransform->GetVersion() - 1;
 }
 
-void Entity::Draw(Camera* a_pCamera)
+void Entity::Draw(const glm::mat4& a_m4ViewProjection, const glm::mat4& a_m4World, const glm::mat4& a_m4InverseTranspose)
 {
-	m_pMaterial->PrepMaterial();
-
-	// Reading the uniforms from the shader and send values.
-	GLuint WVP = glGetUniformLocation(m_pMaterial->GetShader()->GetProgramID(), "WVP");
-	GLuint WorldInverseTranspose = glGetUniformLocation(m_pMaterial->GetShader()->GetProgramID(), "InverseTransposeWorld");
+	// The Material keeps the uniform locations of its program.
+	const MaterialLocations& locations = m_pMaterial->PrepMaterial();
+	GLint WVP = locations.WVP;
+	GLint WorldInverseTranspose = locations.InverseTranspose;
+	GLint World = locations.World;
 
 	// Setting the WVP matrix in the shader.
 	GLCall(glUniformMatrix4fv(
 		WVP,
 		1,
 		GL_FALSE,
-		glm::value_ptr(
-			a_pCamera->GetProjection() * 
-			a_pCamera->GetView() *
-			m_pTransform->GetWorld())
+		glm::value_ptr(a_m4ViewProjection * a_m4World)
 	));
 
 	// Setting the World Inverse Transpose matrix for the Shader program.
@@ -34,15 +37,60 @@ void Entity::Draw(Camera* a_pCamera)
 		WorldInverseTranspose,
 		1, 
 		GL_FALSE,
-		glm::value_ptr(m_pTransform->GetInverseTranspose())
+		glm::value_ptr(a_m4InverseTranspose)
 	));
 
+	// Only variants with normal mapping use the world matrix.
+	if (World != -1)
+	{
+		GLCall(glUniformMatrix4fv(World, 1, GL_FALSE, glm::value_ptr(a_m4World)));
+	}
+	RenderStats::Add(RS_UNIFORM_UPLOADS, World != -1 ? 3 : 2);
+
 	m_pMesh->Render();
 }
 
+void Entity::Record(CommandList& a_list, const glm::mat4& a_m4ViewProjection, const glm::mat4& a_m4World, const glm::mat4& a_m4InverseTranspose,
+	const glm::vec4& a_v4DebugColor)
+{
+	// Entities outlive every frame, so the list can hold raw pointers to their resources.
+	a_list.BindPipeline(m_pMaterial.get());
+	a_list.BindGeometry(m_pMesh.get());
+
+	DrawData data = DrawData();
+	data.WVP = a_m4ViewProjection * a_m4World;
+	data.World = a_m4World;
+	data.InverseTranspose = a_m4InverseTranspose;
+	data.DebugColor = a_v4DebugColor;
+	a_list.SetDrawData(data);
+
+	a_list.Draw(m_pMesh->GetVertexCount());
+}
+
 Transform* Entity::GetTransform(void) { return m_pTransform; }
 std::shared_ptr<Mesh> Entity::GetMesh(void) { return m_pMesh; }
 std::shared_ptr<Material> Entity::GetMaterial(void) { return m_pMaterial; }
+int Entity::GetProxyID(void) { return m_dProxyID; }
+void Entity::SetProxyID(int a_dProxyID) { m_dProxyID = a_dProxyID; }
+bool Entity::IsOccluder(void) { return m_bIsOccluder; }
+void Entity::SetOccluder(bool a_bIsOccluder) { m_bIsOccluder = a_bIsOccluder; }
+
+bool Entity::HasMoved(void)
+{
+	return m_pTransform->GetVersion() != m_uBoundsVersion;
+}
+
+AABB Entity::GetWorldBounds(void)
+{
+	if (HasMoved())
+	{
+		// Moving the Mesh's local bounds into world space.
+		m_aWorldBounds = m_pMesh->GetBounds().Transformed(m_pTransform->GetWorld());
+		m_uBoundsVersion = m_pTransform->GetVersion();
+	}
+
+	return m_aWorldBounds;
+}
 
 Entity& Entity::operator=(const Entity& a_pOther)
 {
@@ -64,10 +112,16 @@ Entity::Entity(const Entity& a_pOther)
 	m_pMesh = a_pOther.m_pMesh;
 	m_pTransform = a_pOther.m_pTransform;
 	m_pMaterial = a_pOther.m_pMaterial;
+	m_bIsOccluder = a_pOther.m_bIsOccluder;
+	m_uBoundsVersion = m_pTransform->GetVersion() - 1;
+
+	// Copies free the transform too, so they are accounted the same as the original.
+	MemoryTracker::Add(MEMORY_CPU, MEMORY_ENTITIES, sizeof(Entity) + sizeof(Transform));
 }
 
 Entity::~Entity()
 {
 	m_pMesh.reset();
 	Realloc(m_pTransform);
+	MemoryTracker::Remove(MEMORY_CPU, MEMORY_ENTITIES, sizeof(Entity) + sizeof(Transform));
 }
@@ -6,6 +6,7 @@
 #include "Material.h"
 #include "Camera.h"
 #include "Debug.h"
+#include "CommandList.h"
 
 /// <summary>
 /// Container class for Mesh and Transform objects.
@@ -17,6 +18,12 @@ private:
 	std::shared_ptr<Mesh> m_pMesh = nullptr;
 	Transform* m_pTransform = nullptr;
 
+	// Scene tree bookkeeping.
+	int m_dProxyID = -1;
+	unsigned int m_uBoundsVersion = 0;
+	AABB m_aWorldBounds;
+	bool m_bIsOccluder = false;
+
 public:
 	/// <summary>
 	/// Constructs an instance of the entity class.
@@ -25,10 +32,24 @@ public:
 	Entity(std::shared_ptr<Mesh> a_pMesh, std::shared_ptr<Material> a_pMaterial);
 
 	/// <summary>
-	/// Renders the Entity's Mesh using the passed in Camera and Transform field.
+	/// Renders the Entity's Mesh with the matrices captured in a frame packet, so the
+	/// Transform may already be simulating the next frame.
+	/// </summary>
+	/// <param name="a_m4ViewProjection">Projection * view matrix of the frame's Camera.</param>
+	/// <param name="a_m4World">The Entity's world matrix when the frame was simulated.</param>
+	/// <param name="a_m4InverseTranspose">The inverse transpose of that world matrix.</param>
+	void Draw(const glm::mat4& a_m4ViewProjection, const glm::mat4& a_m4World, const glm::mat4& a_m4InverseTranspose);
+
+	/// <summary>
+	/// Records the Entity's draw into a CommandList.  Touches no GL state, so any thread may call it.
 	/// </summary>
-	/// <param name="a_pCamera">The active Camera for the application.</param>
-	void Draw(Camera* a_pCamera);
+	/// <param name="a_list">The list being recorded.</param>
+	/// <param name="a_m4ViewProjection">Projection * view matrix of the frame's Camera.</param>
+	/// <param name="a_m4World">The Entity's world matrix when the frame was simulated.</param>
+	/// <param name="a_m4InverseTranspose">The inverse transpose of that world matrix.</param>
+	/// <param name="a_v4DebugColor">Flat color the debug view variants draw the Entity with.</param>
+	void Record(CommandList& a_list, const glm::mat4& a_m4ViewProjection, const glm::mat4& a_m4World, const glm::mat4& a_m4InverseTranspose,
+		const glm::vec4& a_v4DebugColor);
 
 	/// <summary>
 	/// Gets a pointer to the Entity's Transform.
@@ -45,6 +66,37 @@ public:
 	/// </summary>
 	std::shared_ptr<Material> GetMaterial(void);
 
+	/// <summary>
+	/// Gets the world space bounds of the Entity, recalculating them if the Transform changed.
+	/// </summary>
+	AABB GetWorldBounds(void);
+
+	/// <summary>
+	/// Checks if the Transform changed since the world bounds were last calculated.
+	/// </summary>
+	bool HasMoved(void);
+
+	/// <summary>
+	/// Gets the ID of this Entity's proxy in the SceneTree.  -1 if not inserted.
+	/// </summary>
+	int GetProxyID(void);
+
+	/// <summary>
+	/// Sets the ID of this Entity's proxy in the SceneTree.
+	/// </summary>
+	void SetProxyID(int a_dProxyID);
+
+	/// <summary>
+	/// Gets whether this Entity is drawn into the software occlusion buffer.
+	/// </summary>
+	bool IsOccluder(void);
+
+	/// <summary>
+	/// Sets whether this Entity is drawn into the software occlusion buffer.
+	/// Should only be set for large and simple meshes.
+	/// </summary>
+	void SetOccluder(bool a_bIsOccluder);
+
 	/// <summary>
 	/// Copy operator for the Entity class.
 	/// </summary>
@@ -1,91 +1,196 @@
 #include "FileReader.h"
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <algorithm>
 #include <FreeImage/FreeImage.h>
 #include "Debug.h"
+#include "MemoryTracker.h"
 
 #define NULL_STR ""
 
-FileReader* FileReader::m_pInstance = nullptr;
+// Size of the fixed part of a KTX2 header, followed by the level index.
+#define KTX2_HEADER_SIZE 80
 
-FileReader::~FileReader(void) { Release(); }
-
-FileReader::FileReader(void) {}
-
-FileReader* FileReader::GetInstance(void)
+/// <summary>
+/// Maps the Vulkan format of a KTX2 container to its GL equivalent.
+/// The renderer works on gamma encoded values, so sRGB variants are sampled as
+/// stored, exactly like the images loaded through FreeImage.
+/// </summary>
+/// <returns>The GL format, or GL_NONE if unsupported.</returns>
+static GLenum GetFormatFromVulkan(unsigned int a_uVkFormat, bool& a_bIsCompressed, bool& a_bIsSRGB)
 {
-	// Instantiating the single instance of the FileReader.
-	if (m_pInstance == nullptr)
+	a_bIsCompressed = true;
+	a_bIsSRGB = false;
+	switch (a_uVkFormat)
 	{
-		m_pInstance = new FileReader();
+	case 43: a_bIsSRGB = true;	// R8G8B8A8_SRGB
+	case 37: a_bIsCompressed = false; return GL_RGBA8;	// R8G8B8A8_UNORM
+	case 132: a_bIsSRGB = true;	// BC1_RGB_SRGB_BLOCK
+	case 131: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case 134: a_bIsSRGB = true;	// BC1_RGBA_SRGB_BLOCK
+	case 133: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case 138: a_bIsSRGB = true;	// BC3_SRGB_BLOCK
+	case 137: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case 146: a_bIsSRGB = true;	// BC7_SRGB_BLOCK
+	case 145: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	case 148: a_bIsSRGB = true;	// ETC2_R8G8B8_SRGB_BLOCK
+	case 147: return GL_COMPRESSED_RGB8_ETC2;
+	case 150: a_bIsSRGB = true;	// ETC2_R8G8B8A1_SRGB_BLOCK
+	case 149: return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+	case 152: a_bIsSRGB = true;	// ETC2_R8G8B8A8_SRGB_BLOCK
+	case 151: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+	default: return GL_NONE;
 	}
-
-	return m_pInstance;
 }
 
-void FileReader::Release(void)
+/// <summary>
+/// Gets the bytes a level of the passed in size needs in a KTX2 format from GetFormatFromVulkan.
+/// </summary>
+static size_t GetLevelSize(GLenum a_eFormat, int a_dWidth, int a_dHeight)
 {
-	// Reallocate any memory here.
+	size_t uBlocks = (size_t)((a_dWidth + 3) / 4) * (size_t)((a_dHeight + 3) / 4);
+	switch (a_eFormat)
+	{
+	case GL_RGBA8: return (size_t)a_dWidth * (size_t)a_dHeight * 4;
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: return uBlocks * 8;
+	default: return uBlocks * 16;
+	}
 }
 
-void FileReader::ReleaseInstance(void)
+/// <summary>
+/// Reads a little endian integer out of a byte buffer.
+/// </summary>
+template <typename T>
+static T ReadValue(const std::vector<char>& a_lBytes, size_t a_uOffset)
 {
-	// If there is an instance of the FileReader:
-	if (m_pInstance != nullptr)
-	{
-		// Reallocate the memory.
-		Realloc(m_pInstance);
-	}
+	T value = T();
+	memcpy(&value, &a_lBytes[a_uOffset], sizeof(T));
+	return value;
 }
 
-std::string FileReader::ReadFile(std::string a_sFilepath)
+GLuint FileReader::LoadTexture(std::string a_sFilepath, bool a_bIsSRGB)
 {
-	if (a_sFilepath == NULL_STR)
+	TextureData data = TextureData();
+	if (!DecodeImage(a_sFilepath, data, a_bIsSRGB))
 	{
-		return NULL_STR;
+		return 0;
 	}
 
-	// Initializing the stream reader.
-	std::string fileContent;
-	std::ifstream reader(a_sFilepath, std::ios::in);
+	// Return the ID for the created texture.
+	return CreateTexture(data);
+}
 
-	// Checking that the file was successfully opened.
-	if (reader.is_open())
+GLuint FileReader::LoadCubeMap(const std::vector<std::string>& a_lFaces)
+{
+	// Generating texture IDs and binding the texture.
+	GLuint textureID;
+	GLCall(glGenTextures(1, &textureID));
+	GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, textureID));
+
+	// For each filepath to the faces of the cube map,
+	int dLevels = 0;
+	size_t uBytes = 0;
+	for (GLuint i = 0; i < a_lFaces.size(); i++)
 	{
-		std::string Line = "";
+		// Cube map faces are stored top row first, unlike regular textures.
+		TextureData data = TextureData();
+		if (!DecodeImage(a_lFaces[i], data, true, true))
+		{
+			std::cout << "Failed to load image: " << a_lFaces[i] << std::endl;
+			continue;
+		}
 
-		// Compiling all of the lines in the single string.
-		while (getline(reader, Line))
+		// Allocating every face and level at once from the first face.
+		if (dLevels == 0)
 		{
-			fileContent += "\n" + Line;
+			if (data.IsCompressed && !IsFormatSupported(data.InternalFormat))
+			{
+				std::cout << "Unsupported compressed format in " << a_lFaces[i] << std::endl;
+				break;
+			}
+
+			dLevels = (int)data.Levels.size();
+			if (glTexStorage2D != nullptr)
+			{
+				GLCall(glTexStorage2D(GL_TEXTURE_CUBE_MAP, dLevels, data.InternalFormat, data.Levels[0].Width, data.Levels[0].Height));
+			}
 		}
 
-		// Closing the file.
-		reader.close();
-	}
-	else
-	{
-		std::cout << "There was an error opening the file." << std::endl;
+		GLenum eFace = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
+		uBytes += data.GetByteSize();
+		for (int j = 0; j < dLevels && j < data.Levels.size(); j++)
+		{
+			const TextureLevel& level = data.Levels[j];
+			if (glTexStorage2D == nullptr && data.IsCompressed)
+			{
+				GLCall(glCompressedTexImage2D(eFace, j, data.InternalFormat, level.Width, level.Height, 0, (GLsizei)level.Data.size(), level.Data.data()));
+			}
+			else if (glTexStorage2D == nullptr)
+			{
+				GLCall(glTexImage2D(eFace, j, data.InternalFormat, level.Width, level.Height, 0, data.PixelFormat, data.PixelType, level.Data.data()));
+			}
+			else if (data.IsCompressed)
+			{
+				GLCall(glCompressedTexSubImage2D(eFace, j, 0, 0, level.Width, level.Height, data.InternalFormat, (GLsizei)level.Data.size(), level.Data.data()));
+			}
+			else
+			{
+				GLCall(glTexSubImage2D(eFace, j, 0, 0, level.Width, level.Height, data.PixelFormat, data.PixelType, level.Data.data()));
+			}
+		}
 	}
 
-	return fileContent;
+	// Cube maps are sampled with a direction, so the edges must not wrap.
+	MemoryTracker::AddTexture(textureID, MEMORY_TEXTURES, uBytes);
+	ApplySampling(GL_TEXTURE_CUBE_MAP, dLevels);
+	GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+
+	return textureID;
 }
 
-GLuint FileReader::LoadTexture(std::string a_sFilepath)
+bool FileReader::DecodeImage(std::string a_sFilepath, TextureData& a_tOut, bool a_bIsSRGB, bool a_bFlipVertical)
 {
+	// Preferring an offline compressed version of the image when there is one.
+	size_t uDot = a_sFilepath.find_last_of('.');
+	std::string sExtension = uDot == std::string::npos ? NULL_STR : a_sFilepath.substr(uDot);
+	if (sExtension == ".ktx2")
+	{
+		return DecodeKTX2(a_sFilepath, a_tOut, a_bIsSRGB, a_bFlipVertical);
+	}
+	std::string sCompressed = uDot == std::string::npos ? NULL_STR : a_sFilepath.substr(0, uDot) + ".ktx2";
+	if (sCompressed != NULL_STR && std::ifstream(sCompressed).good())
+	{
+		if (DecodeKTX2(sCompressed, a_tOut, a_bIsSRGB, a_bFlipVertical))
+		{
+			return true;
+		}
+		std::cout << "Falling back to " << a_sFilepath << std::endl;
+	}
+
 	// Figuring out the file format.
 	FREE_IMAGE_FORMAT fif = FreeImage_GetFileType(a_sFilepath.c_str(), 0);
 
 	// If an unknown file type, return a default value.
 	if (fif == FIF_UNKNOWN)
 	{
-		return 0;
+		return false;
 	}
 
 	// Load in the actual bitmap.
 	FIBITMAP* bitmap = FreeImage_Load(fif, a_sFilepath.c_str());
 	if (!bitmap)
-		return 0;
+		return false;
+
+	if (a_bFlipVertical)
+	{
+		FreeImage_FlipVertical(bitmap);
+	}
 
 	// Loading in the bitmap in 32 bit for proper data format.
 	FIBITMAP* bitmap32 = FreeImage_ConvertTo32Bits(bitmap);
@@ -93,35 +198,232 @@ GLuint FileReader::LoadTexture(std::string a_sFilepath)
 	// Unloading the original since it is unneeded.
 	FreeImage_Unload(bitmap);
 
-	// Getting the width, height and individual pixels of the image.
-	int width = FreeImage_GetWidth(bitmap32);
-	int height = FreeImage_GetHeight(bitmap32);
-	BYTE* pixels = FreeImage_GetBits(bitmap32);
+	// Copying the pixels row by row since FreeImage may pad them.
+	TextureLevel level = TextureLevel();
+	level.Width = FreeImage_GetWidth(bitmap32);
+	level.Height = FreeImage_GetHeight(bitmap32);
+	level.Data.resize(level.Width * level.Height * 4);
+	for (int y = 0; y < level.Height; y++)
+	{
+		memcpy(&level.Data[y * level.Width * 4], FreeImage_GetScanLine(bitmap32, y), level.Width * 4);
+	}
+
+	// Unload the second and final bitmap.
+	FreeImage_Unload(bitmap32);
+
+	a_tOut = TextureData();
+	a_tOut.IsSRGB = a_bIsSRGB;
+	a_tOut.Levels.push_back(std::move(level));
+	a_tOut.GenerateMipmaps();
+	return true;
+}
+
+bool FileReader::DecodeKTX2(std::string a_sFilepath, TextureData& a_tOut, bool a_bIsSRGB, bool a_bFlipVertical)
+{
+	static const unsigned char uIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	// Reading the whole container.
+	std::ifstream reader(a_sFilepath, std::ios::in | std::ios::binary);
+	if (!reader.is_open())
+	{
+		std::cout << "There was an error opening the file." << std::endl;
+		return false;
+	}
+	std::vector<char> lBytes = std::vector<char>(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+	reader.close();
+
+	if (lBytes.size() < KTX2_HEADER_SIZE || memcmp(lBytes.data(), uIdentifier, sizeof(uIdentifier)) != 0)
+	{
+		std::cout << "Not a KTX2 file: " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	unsigned int uVkFormat = ReadValue<unsigned int>(lBytes, 12);
+	int dWidth = ReadValue<int>(lBytes, 20);
+	int dHeight = ReadValue<int>(lBytes, 24);
+	int dDepth = ReadValue<int>(lBytes, 28);
+	int dLayers = ReadValue<int>(lBytes, 32);
+	int dFaces = ReadValue<int>(lBytes, 36);
+	int dLevels = ReadValue<int>(lBytes, 40);
+	int dSupercompression = ReadValue<int>(lBytes, 44);
+
+	// Only plain 2D images are supported.  Basis and zstd need a transcoder.
+	if (dDepth > 1 || dLayers > 1 || dFaces != 1 || dSupercompression != 0)
+	{
+		std::cout << "Unsupported KTX2 layout in " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	bool bIsCompressed = false;
+	bool bIsSRGB = false;
+	GLenum eFormat = GetFormatFromVulkan(uVkFormat, bIsCompressed, bIsSRGB);
+	if (eFormat == GL_NONE)
+	{
+		std::cout << "Unsupported KTX2 format " << uVkFormat << " in " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	// The sizes come straight from the file, so they are checked before anything is read with them.
+	int dMaxLevels = 1;
+	while (dWidth > 0 && dHeight > 0 && (std::max(dWidth, dHeight) >> dMaxLevels) > 0) dMaxLevels++;
+	if (dWidth <= 0 || dHeight <= 0 || dLevels < 0 || dLevels > dMaxLevels)
+	{
+		std::cout << "Invalid KTX2 size " << dWidth << "x" << dHeight << " with " << dLevels << " levels in " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	// A level count of 0 asks the loader to build the chain itself, which only works on uncompressed data.
+	bool bGenerateMips = dLevels == 0 && !bIsCompressed;
+	dLevels = std::max(dLevels, 1);
+	if (KTX2_HEADER_SIZE + (size_t)dLevels * 24 > lBytes.size())
+	{
+		std::cout << "Truncated KTX2 file: " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	a_tOut = TextureData();
+	a_tOut.InternalFormat = eFormat;
+	a_tOut.PixelFormat = GL_RGBA;
+	a_tOut.IsCompressed = bIsCompressed;
+	a_tOut.IsSRGB = a_bIsSRGB;
+	if (bIsSRGB != a_bIsSRGB)
+	{
+		std::cout << "KTX2 color space of " << a_sFilepath << " differs from its use, mipmaps follow the use." << std::endl;
+	}
+	if (a_bFlipVertical && bIsCompressed)
+	{
+		std::cout << "Compressed blocks cannot be flipped, keeping the orientation of " << a_sFilepath << std::endl;
+	}
+	for (int i = 0; i < dLevels; i++)
+	{
+		// Each level index entry is an offset, a length and an uncompressed length.
+		unsigned long long uOffset = ReadValue<unsigned long long>(lBytes, KTX2_HEADER_SIZE + i * 24);
+		unsigned long long uLength = ReadValue<unsigned long long>(lBytes, KTX2_HEADER_SIZE + i * 24 + 8);
+		if (uOffset > lBytes.size() || uLength > lBytes.size() - uOffset)
+		{
+			std::cout << "Truncated KTX2 file: " << a_sFilepath << std::endl;
+			return false;
+		}
+
+		// Level 0 is the largest.  Images are expected to be exported bottom row first for GL.
+		TextureLevel level = TextureLevel();
+		level.Width = std::max(1, dWidth >> i);
+		level.Height = std::max(1, dHeight >> i);
+		size_t uSize = GetLevelSize(eFormat, level.Width, level.Height);
+		if (uLength < uSize)
+		{
+			std::cout << "KTX2 level " << i << " is too small for its size in " << a_sFilepath << std::endl;
+			return false;
+		}
+		level.Data.assign(lBytes.begin() + (size_t)uOffset, lBytes.begin() + (size_t)uOffset + uSize);
+		if (a_bFlipVertical && !bIsCompressed)
+		{
+			// Swapping whole rows of the RGBA8 level.
+			size_t uRow = (size_t)level.Width * 4;
+			for (int y = 0; y < level.Height / 2; y++)
+			{
+				std::swap_ranges(level.Data.begin() + y * uRow, level.Data.begin() + (y + 1) * uRow,
+					level.Data.begin() + (level.Height - 1 - y) * uRow);
+			}
+		}
+		a_tOut.Levels.push_back(std::move(level));
+	}
+
+	if (bGenerateMips)
+	{
+		a_tOut.GenerateMipmaps();
+	}
+	return true;
+}
+
+GLuint FileReader::CreateTexture(const TextureData& a_tData)
+{
+	if (a_tData.Levels.empty()) return 0;
+
+	// Block compressed data cannot be decoded here, so unsupported formats fail outright.
+	if (a_tData.IsCompressed && !IsFormatSupported(a_tData.InternalFormat))
+	{
+		std::cout << "Unsupported compressed texture format " << a_tData.InternalFormat << std::endl;
+		return 0;
+	}
 
 	// Allocating an ID for the loaded image.
 	GLuint textureID;
 	GLCall(glGenTextures(1, &textureID));
 	GLCall(glBindTexture(GL_TEXTURE_2D, textureID));
 
+	// Allocating every level up front so the driver never has to reallocate.
+	int dLevels = (int)a_tData.Levels.size();
+	bool bHasStorage = glTexStorage2D != nullptr;
+	if (bHasStorage)
+	{
+		GLCall(glTexStorage2D(GL_TEXTURE_2D, dLevels, a_tData.InternalFormat, a_tData.Levels[0].Width, a_tData.Levels[0].Height));
+	}
+
 	// Uploading the image to the GPU with the new ID.
-	GLCall(glTexImage2D(
-		GL_TEXTURE_2D,				// The type of texture.
-		0,							// Base image level.
-		GL_RGBA,					// Internal GL storage type.
-		width,						// Width of the texture.
-		height,						// Height of the texture.
-		0,							// Always 0.  Depracated GL feature.
-		GL_BGRA,					// Format of the incoming data.
-		GL_UNSIGNED_BYTE,			// The type of each color component.
-		pixels));					// Pointer to the actual pixel data.
+	for (int i = 0; i < dLevels; i++)
+	{
+		const TextureLevel& level = a_tData.Levels[i];
+		if (a_tData.IsCompressed && bHasStorage)
+		{
+			GLCall(glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.Width, level.Height, a_tData.InternalFormat, (GLsizei)level.Data.size(), level.Data.data()));
+		}
+		else if (a_tData.IsCompressed)
+		{
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, i, a_tData.InternalFormat, level.Width, level.Height, 0, (GLsizei)level.Data.size(), level.Data.data()));
+		}
+		else if (bHasStorage)
+		{
+			GLCall(glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.Width, level.Height, a_tData.PixelFormat, a_tData.PixelType, level.Data.data()));
+		}
+		else
+		{
+			GLCall(glTexImage2D(GL_TEXTURE_2D, i, a_tData.InternalFormat, level.Width, level.Height, 0, a_tData.PixelFormat, a_tData.PixelType, level.Data.data()));
+		}
+	}
 
 	// Set the parameters of the texture properly.
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-
-	// Unload the second and final bitmap.
-	FreeImage_Unload(bitmap32);
+	ApplySampling(GL_TEXTURE_2D, dLevels);
+	MemoryTracker::AddTexture(textureID, MEMORY_TEXTURES, a_tData.GetByteSize());
 
-	// Return the ID for the created texture.
 	return textureID;
-}
\ No newline at end of file
+}
+
+bool FileReader::IsFormatSupported(GLenum a_eFormat)
+{
+	switch (a_eFormat)
+	{
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		return GLEW_EXT_texture_compression_s3tc;
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		return GLEW_ARB_texture_compression_bptc || GLEW_VERSION_4_2;
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		return GLEW_ARB_ES3_compatibility || GLEW_VERSION_4_3;
+	default:
+		return true;
+	}
+}
+
+void FileReader::SetAnisotropy(float a_fAnisotropy) { m_fAnisotropy = a_fAnisotropy; }
+float FileReader::GetAnisotropy(void) { return m_fAnisotropy; }
+
+void FileReader::ApplySampling(GLenum a_eTarget, int a_dLevels)
+{
+	// Trilinear filtering across the whole chain.
+	GLCall(glTexParameteri(a_eTarget, GL_TEXTURE_MIN_FILTER, a_dLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+	GLCall(glTexParameteri(a_eTarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(a_eTarget, GL_TEXTURE_MAX_LEVEL, a_dLevels > 0 ? a_dLevels - 1 : 0));
+
+	// Keeping surfaces at grazing angles sharp.
+	if (GLEW_EXT_texture_filter_anisotropic && a_dLevels > 1)
+	{
+		float fMaxAnisotropy = 1.0f;
+		GLCall(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &fMaxAnisotropy));
+		float fAnisotropy = std::max(1.0f, std::min(m_fAnisotropy, fMaxAnisotropy));
+		GLCall(glTexParameterf(a_eTarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, fAnisotropy));
+	}
+}
@@ -2,8 +2,16 @@
 #define __FILEREADER_H_
 
 #include <string>
+#include <vector>
 #include <GL/glew.h>
+#ifdef _WIN32
 #include <GL/wglew.h>
+#endif
+
+#include "TextureData.h"
+
+// Anisotropic filtering applied to new textures, clamped to what the driver supports.
+#define DEFAULT_ANISOTROPY 8.0f
 
 /// <summary>
 /// Contains functionality for reading from external files.
@@ -12,6 +20,7 @@ class FileReader
 {
 private:
 	static FileReader* m_pInstance;
+	float m_fAnisotropy = DEFAULT_ANISOTROPY;
 
 public:
 	/// <summary>
@@ -33,11 +42,59 @@ public:
 	std::string ReadFile(std::string a_sFilepath = "");
 
 	/// <summary>
-	/// Loads in a texture from the passed in filepath.
+	/// Loads in a texture from the passed in filepath.  A .ktx2 file next to the
+	/// image with the same name is preferred, so assets can be compressed offline.
 	/// </summary>
 	/// <param name="a_sFilepath">Filepath to the texture.</param>
+	/// <param name="a_bIsSRGB">Whether the texture holds color rather than data like normals.</param>
 	/// <returns>The GLuint ID to that texture.</returns>
-	GLuint LoadTexture(std::string a_sFilepath);
+	GLuint LoadTexture(std::string a_sFilepath, bool a_bIsSRGB = true);
+
+	/// <summary>
+	/// Loads in six images as the faces of a cube map.
+	/// </summary>
+	/// <param name="a_lFaces">Filepaths to the +X, -X, +Y, -Y, +Z and -Z faces.</param>
+	/// <returns>The GLuint ID to the cube map.</returns>
+	GLuint LoadCubeMap(const std::vector<std::string>& a_lFaces);
+
+	/// <summary>
+	/// Decodes an image with its full mip chain into CPU memory.  Makes no GL calls.
+	/// </summary>
+	/// <param name="a_sFilepath">Filepath to the image or KTX2 container.</param>
+	/// <param name="a_tOut">Receives the decoded levels.</param>
+	/// <param name="a_bIsSRGB">Whether the image holds color rather than data like normals.</param>
+	/// <param name="a_bFlipVertical">Whether to flip the rows of a regular image.</param>
+	/// <returns>False if the file could not be decoded.</returns>
+	bool DecodeImage(std::string a_sFilepath, TextureData& a_tOut, bool a_bIsSRGB = true, bool a_bFlipVertical = false);
+
+	/// <summary>
+	/// Creates an immutable texture from decoded data.
+	/// </summary>
+	/// <param name="a_tData">The decoded levels.</param>
+	/// <returns>The GLuint ID to the texture, or 0 if the format is unsupported.</returns>
+	GLuint CreateTexture(const TextureData& a_tData);
+
+	/// <summary>
+	/// Gets whether the driver can sample the passed in compressed format.
+	/// </summary>
+	bool IsFormatSupported(GLenum a_eFormat);
+
+	/// <summary>
+	/// Sets the anisotropic filtering level used by textures created afterwards.
+	/// </summary>
+	void SetAnisotropy(float a_fAnisotropy);
+
+	/// <summary>
+	/// Gets the anisotropic filtering level used by new textures.
+	/// </summary>
+	float GetAnisotropy(void);
+
+	/// <summary>
+	/// Sets mipmapped trilinear and anisotropic filtering on the bound texture.
+	/// </summary>
+	/// <param name="a_eTarget">Target the texture is bound to.</param>
+	/// <param name="a_dLevels">Number of mip levels of the texture.</param>
+	void ApplySampling(GLenum a_eTarget, int a_dLevels);
 
 private:
 	/// <summary>
@@ -54,6 +111,12 @@ private:
 	/// Frees the memory allocated by the FileReader object.
 	/// </summary>
 	static void Release(void);
+
+	/// <summary>
+	/// Reads a KTX2 container holding pre-built, possibly block compressed, mip levels.
+	/// Only uncompressed levels can be flipped, compressed ones keep the container's orientation.
+	/// </summary>
+	bool DecodeKTX2(std::string a_sFilepath, TextureData& a_tOut, bool a_bIsSRGB, bool a_bFlipVertical);
 };
 
 #endif //__FILEREADER_H_
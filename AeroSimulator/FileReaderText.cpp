@@ -0,0 +1,74 @@
+#include "FileReader.h"
+#include <iostream>
+#include <fstream>
+#include "Debug.h"
+
+#define NULL_STR ""
+
+// The instance and plain text reading only need the standard library, so they build
+// without GL and FreeImage.  Everything about textures is in FileReader.cpp.
+
+FileReader* FileReader::m_pInstance = nullptr;
+
+FileReader::~FileReader(void) { Release(); }
+
+FileReader::FileReader(void) {}
+
+FileReader* FileReader::GetInstance(void)
+{
+	// Instantiating the single instance of the FileReader.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new FileReader();
+	}
+
+	return m_pInstance;
+}
+
+void FileReader::Release(void)
+{
+	// Reallocate any memory here.
+}
+
+void FileReader::ReleaseInstance(void)
+{
+	// If there is an instance of the FileReader:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		Realloc(m_pInstance);
+	}
+}
+
+std::string FileReader::ReadFile(std::string a_sFilepath)
+{
+	if (a_sFilepath == NULL_STR)
+	{
+		return NULL_STR;
+	}
+
+	// Initializing the stream reader.
+	std::string fileContent;
+	std::ifstream reader(a_sFilepath, std::ios::in);
+
+	// Checking that the file was successfully opened.
+	if (reader.is_open())
+	{
+		std::string Line = "";
+
+		// Compiling all of the lines in the single string.
+		while (getline(reader, Line))
+		{
+			fileContent += "\n" + Line;
+		}
+
+		// Closing the file.
+		reader.close();
+	}
+	else
+	{
+		std::cout << "There was an error opening the file." << std::endl;
+	}
+
+	return fileContent;
+}
@@ -0,0 +1,66 @@
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(void) {}
+
+FixedTimestep::FixedTimestep(const FixedTimestep& a_pOther)
+{
+	*this = a_pOther;
+}
+
+FixedTimestep& FixedTimestep::operator=(const FixedTimestep& a_pOther)
+{
+	m_fRate = a_pOther.m_fRate;
+	m_fStep = a_pOther.m_fStep;
+	m_dMaxSubsteps = a_pOther.m_dMaxSubsteps;
+	m_fAccumulator = a_pOther.m_fAccumulator;
+	m_fAlpha = a_pOther.m_fAlpha;
+	m_dSteps = a_pOther.m_dSteps;
+	m_dDroppedSteps = a_pOther.m_dDroppedSteps;
+	return *this;
+}
+
+int FixedTimestep::Advance(float a_fFrameSeconds)
+{
+	if (a_fFrameSeconds > 0.0f)
+	{
+		m_fAccumulator += a_fFrameSeconds;
+	}
+
+	m_dSteps = (int)(m_fAccumulator / m_fStep);
+	m_fAccumulator -= m_dSteps * m_fStep;
+
+	// Falling behind for good, so the simulation slows down instead of spiraling.
+	if (m_dSteps > m_dMaxSubsteps)
+	{
+		m_dDroppedSteps += m_dSteps - m_dMaxSubsteps;
+		m_dSteps = m_dMaxSubsteps;
+	}
+
+	m_fAlpha = m_fAccumulator / m_fStep;
+	return m_dSteps;
+}
+
+void FixedTimestep::Reset(void)
+{
+	m_fAccumulator = 0.0f;
+	m_fAlpha = 0.0f;
+	m_dSteps = 0;
+	m_dDroppedSteps = 0;
+}
+
+void FixedTimestep::SetRate(float a_fStepsPerSecond)
+{
+	if (a_fStepsPerSecond <= 0.0f) return;
+
+	// Keeping the blend factor where it was at the old rate.
+	m_fRate = a_fStepsPerSecond;
+	m_fStep = 1.0f / a_fStepsPerSecond;
+	m_fAccumulator = m_fAlpha * m_fStep;
+}
+
+float FixedTimestep::GetRate(void) { return m_fRate; }
+float FixedTimestep::GetStep(void) { return m_fStep; }
+void FixedTimestep::SetMaxSubsteps(int a_dMaxSubsteps) { m_dMaxSubsteps = a_dMaxSubsteps > 0 ? a_dMaxSubsteps : 1; }
+float FixedTimestep::GetAlpha(void) { return m_fAlpha; }
+int FixedTimestep::GetStepCount(void) { return m_dSteps; }
+int FixedTimestep::GetDroppedSteps(void) { return m_dDroppedSteps; }
@@ -0,0 +1,91 @@
+#ifndef __FIXEDTIMESTEP_H_
+#define __FIXEDTIMESTEP_H_
+
+// Default simulation steps per second.
+#define SIMULATION_RATE 120.0f
+
+// Most steps run for a single frame.  Time beyond them is dropped so a long
+// frame cannot make the next one longer still.
+#define SIMULATION_MAX_SUBSTEPS 8
+
+/// <summary>
+/// Accumulates frame time and hands it out in steps of a fixed length, so the
+/// simulation gives the same results at any framerate.  The time left over is
+/// exposed as a blend factor between the last two simulated states.
+/// </summary>
+class FixedTimestep
+{
+private:
+	float m_fRate = SIMULATION_RATE;
+	float m_fStep = 1.0f / SIMULATION_RATE;
+	int m_dMaxSubsteps = SIMULATION_MAX_SUBSTEPS;
+	float m_fAccumulator = 0.0f;
+	float m_fAlpha = 0.0f;
+	int m_dSteps = 0;
+	int m_dDroppedSteps = 0;
+
+public:
+	/// <summary>
+	/// Constructs a FixedTimestep at the default rate.
+	/// </summary>
+	FixedTimestep(void);
+
+	/// <summary>
+	/// Copy constructor for the FixedTimestep.
+	/// </summary>
+	FixedTimestep(const FixedTimestep& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the FixedTimestep.
+	/// </summary>
+	FixedTimestep& operator=(const FixedTimestep& a_pOther);
+
+	/// <summary>
+	/// Adds a frame's time and works out how many steps to simulate.
+	/// </summary>
+	/// <param name="a_fFrameSeconds">Real time since the previous frame.</param>
+	/// <returns>The number of steps of GetStep seconds to run this frame.</returns>
+	int Advance(float a_fFrameSeconds);
+
+	/// <summary>
+	/// Empties the accumulator, e.g. after a load screen.
+	/// </summary>
+	void Reset(void);
+
+	/// <summary>
+	/// Sets the number of steps per second.  Ignored if not positive.
+	/// </summary>
+	void SetRate(float a_fStepsPerSecond);
+
+	/// <summary>
+	/// Gets the number of steps per second.
+	/// </summary>
+	float GetRate(void);
+
+	/// <summary>
+	/// Gets the length of a step in seconds.
+	/// </summary>
+	float GetStep(void);
+
+	/// <summary>
+	/// Sets the most steps run for a single frame.
+	/// </summary>
+	void SetMaxSubsteps(int a_dMaxSubsteps);
+
+	/// <summary>
+	/// Gets how far the current time is between the last two simulated states, from 0 to 1.
+	/// </summary>
+	float GetAlpha(void);
+
+	/// <summary>
+	/// Gets the number of steps handed out by the last Advance.
+	/// </summary>
+	int GetStepCount(void);
+
+	/// <summary>
+	/// Gets the number of steps dropped by the substep cap since the last Reset.
+	/// </summary>
+	int GetDroppedSteps(void);
+};
+
+#endif //__FIXEDTIMESTEP_H_
@@ -0,0 +1,731 @@
+#include "FrameGraph.h"
+#include "Debug.h"
+#include "GPUProfiler.h"
+#include "CPUProfiler.h"
+#include "MemoryTracker.h"
+#include <iostream>
+#include <algorithm>
+
+// Render target markers for passes that do not use a pooled framebuffer.
+#define FG_BACKBUFFER -1
+#define FG_NO_TARGETS -2
+
+/// <summary>
+/// Gets whether a sized internal format is a depth or depth stencil format.
+/// </summary>
+static bool IsDepthFormat(GLenum a_eFormat)
+{
+	return a_eFormat == GL_DEPTH_COMPONENT16 || a_eFormat == GL_DEPTH_COMPONENT24 ||
+		a_eFormat == GL_DEPTH_COMPONENT32 || a_eFormat == GL_DEPTH_COMPONENT32F ||
+		a_eFormat == GL_DEPTH24_STENCIL8 || a_eFormat == GL_DEPTH32F_STENCIL8;
+}
+
+/// <summary>
+/// Gets whether a sized internal format also carries stencil.
+/// </summary>
+static bool IsStencilFormat(GLenum a_eFormat)
+{
+	return a_eFormat == GL_DEPTH24_STENCIL8 || a_eFormat == GL_DEPTH32F_STENCIL8;
+}
+
+/// <summary>
+/// Gets the approximate size of one texel of a sized internal format.
+/// </summary>
+static size_t GetTexelSize(GLenum a_eFormat)
+{
+	switch (a_eFormat)
+	{
+	case GL_R8: return 1;
+	case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+	case GL_RGB8: case GL_SRGB8: return 3;
+	case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+	case GL_RGBA32F: return 16;
+	default: return 4;
+	}
+}
+
+bool FGTextureDesc::operator==(const FGTextureDesc& a_dOther) const
+{
+	return Width == a_dOther.Width && Height == a_dOther.Height && Format == a_dOther.Format;
+}
+
+// - - Builder - -
+
+FrameGraph::Builder::Builder(FrameGraph* a_pGraph, int a_dPass)
+{
+	m_pGraph = a_pGraph;
+	m_dPass = a_dPass;
+}
+
+FGResource FrameGraph::Builder::CreateTexture(std::string a_sName, FGTextureDesc a_dDesc)
+{
+	Resource resource = Resource();
+	resource.Name = a_sName;
+	resource.IsTexture = true;
+	resource.TextureDesc = a_dDesc;
+	return m_pGraph->AddResource(resource);
+}
+
+FGResource FrameGraph::Builder::CreateBuffer(std::string a_sName, FGBufferDesc a_dDesc)
+{
+	Resource resource = Resource();
+	resource.Name = a_sName;
+	resource.IsTexture = false;
+	resource.BufferDesc = a_dDesc;
+	return m_pGraph->AddResource(resource);
+}
+
+FGResource FrameGraph::Builder::Read(FGResource a_dResource, FGUsage a_eUsage)
+{
+	m_pGraph->m_lPasses[m_dPass].Reads.push_back({ a_dResource, a_eUsage });
+	return a_dResource;
+}
+
+FGResource FrameGraph::Builder::Write(FGResource a_dResource, FGUsage a_eUsage)
+{
+	m_pGraph->m_lPasses[m_dPass].Writes.push_back({ a_dResource, a_eUsage });
+	m_pGraph->m_lResources[a_dResource].Writers.push_back(m_dPass);
+	return a_dResource;
+}
+
+void FrameGraph::Builder::SideEffect(void)
+{
+	m_pGraph->m_lPasses[m_dPass].HasSideEffect = true;
+}
+
+// - - Context - -
+
+FrameGraph::Context::Context(FrameGraph* a_pGraph)
+{
+	m_pGraph = a_pGraph;
+}
+
+GLuint FrameGraph::Context::GetTexture(FGResource a_dResource) { return m_pGraph->m_lResources[a_dResource].Physical; }
+GLuint FrameGraph::Context::GetBuffer(FGResource a_dResource) { return m_pGraph->m_lResources[a_dResource].Physical; }
+const FGTextureDesc& FrameGraph::Context::GetTextureDesc(FGResource a_dResource) { return m_pGraph->m_lResources[a_dResource].TextureDesc; }
+
+// - - FrameGraph - -
+
+FrameGraph::FrameGraph(void)
+{
+	m_sStats = FGStats();
+}
+
+FrameGraph::~FrameGraph(void)
+{
+	ReleasePools();
+}
+
+FrameGraph::FrameGraph(const FrameGraph& a_pOther)
+{
+	// GL objects are not shared, so the copy compiles its own.
+	m_lResources = a_pOther.m_lResources;
+	m_lPasses = a_pOther.m_lPasses;
+	m_bIsCompiled = false;
+	m_sStats = FGStats();
+	m_pProfiler = a_pOther.m_pProfiler;
+}
+
+FrameGraph& FrameGraph::operator=(const FrameGraph& a_pOther)
+{
+	ReleasePools();
+
+	// GL objects are not shared, so the copy compiles its own.
+	m_lResources = a_pOther.m_lResources;
+	m_lPasses = a_pOther.m_lPasses;
+	m_lOrder.clear();
+	m_bIsCompiled = false;
+	m_sStats = FGStats();
+	m_pProfiler = a_pOther.m_pProfiler;
+
+	return *this;
+}
+
+FGResource FrameGraph::ImportTexture(std::string a_sName, GLuint a_dTexture, FGTextureDesc a_dDesc)
+{
+	Resource resource = Resource();
+	resource.Name = a_sName;
+	resource.IsTexture = true;
+	resource.IsImported = true;
+	resource.TextureDesc = a_dDesc;
+	resource.Physical = a_dTexture;
+	return AddResource(resource);
+}
+
+FGResource FrameGraph::ImportBackbuffer(std::string a_sName, int a_dWidth, int a_dHeight, GLuint a_uFramebuffer)
+{
+	// The framebuffer name takes the place of the texture name.
+	FGTextureDesc desc = { a_dWidth, a_dHeight, GL_RGBA8 };
+	FGResource dResource = ImportTexture(a_sName, a_uFramebuffer, desc);
+	m_lResources[dResource].IsBackbuffer = true;
+	return dResource;
+}
+
+void FrameGraph::AddPass(std::string a_sName, SetupFunction a_Setup, ExecuteFunction a_Execute)
+{
+	Pass pass = Pass();
+	pass.Name = a_sName;
+	pass.Execute = a_Execute;
+	m_lPasses.push_back(pass);
+
+	// Letting the pass declare what it touches.
+	Builder builder = Builder(this, (int)m_lPasses.size() - 1);
+	a_Setup(builder);
+
+	m_bIsCompiled = false;
+}
+
+void FrameGraph::Compile(void)
+{
+	m_sStats = FGStats();
+	m_sStats.Passes = (int)m_lPasses.size();
+
+	CullPasses();
+	SortPasses();
+	AllocateResources();
+	PreparePasses();
+
+	m_bIsCompiled = true;
+}
+
+void FrameGraph::Execute(void)
+{
+	PROFILE_ZONE("FrameGraph::Execute");
+	if (!m_bIsCompiled)
+	{
+		Compile();
+	}
+
+	// Memory barriers only exist from GL 4.2 on.
+	bool bHasBarriers = glMemoryBarrier != nullptr;
+
+	Context context = Context(this);
+	for (int i = 0; i < m_lOrder.size(); i++)
+	{
+		Pass& pass = m_lPasses[m_lOrder[i]];
+
+		// Making earlier shader writes visible to this pass.
+		if (pass.Barriers != 0 && bHasBarriers)
+		{
+			GLCall(glMemoryBarrier(pass.Barriers));
+		}
+
+		// Binding the pass' render targets.
+		if (pass.Target != FG_NO_TARGETS)
+		{
+			int dWidth = 0;
+			int dHeight = 0;
+			if (pass.Target == FG_BACKBUFFER)
+			{
+				GLuint uFramebuffer = 0;
+				for (int j = 0; j < pass.Writes.size(); j++)
+				{
+					const Resource& resource = m_lResources[pass.Writes[j].Resource];
+					if (resource.IsBackbuffer)
+					{
+						uFramebuffer = resource.Physical;
+						dWidth = resource.TextureDesc.Width;
+						dHeight = resource.TextureDesc.Height;
+					}
+				}
+				GLCall(glBindFramebuffer(GL_FRAMEBUFFER, uFramebuffer));
+			}
+			else
+			{
+				const Framebuffer& framebuffer = m_lFramebuffers[pass.Target];
+				GLCall(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.ID));
+				dWidth = framebuffer.Width;
+				dHeight = framebuffer.Height;
+			}
+			GLCall(glViewport(0, 0, dWidth, dHeight));
+		}
+
+		if (m_pProfiler != nullptr)
+		{
+			m_pProfiler->BeginScope(pass.Name);
+			pass.Execute(context);
+			m_pProfiler->EndScope();
+		}
+		else
+		{
+			pass.Execute(context);
+		}
+	}
+
+	// Leaving the window's framebuffer bound for anything drawn outside of the graph.
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void FrameGraph::SetProfiler(GPUProfiler* a_pProfiler) { m_pProfiler = a_pProfiler; }
+
+void FrameGraph::Reset(void)
+{
+	m_lResources.clear();
+	m_lPasses.clear();
+	m_lOrder.clear();
+	m_bIsCompiled = false;
+}
+
+const FGStats& FrameGraph::GetStats(void) { return m_sStats; }
+int FrameGraph::GetPassCount(void) { return (int)m_lPasses.size(); }
+const std::string& FrameGraph::GetPassName(int a_dPass) { return m_lPasses[a_dPass].Name; }
+bool FrameGraph::IsPassCulled(int a_dPass) { return m_lPasses[a_dPass].IsCulled; }
+
+FGResource FrameGraph::AddResource(Resource a_rResource)
+{
+	m_lResources.push_back(a_rResource);
+	m_bIsCompiled = false;
+	return (FGResource)m_lResources.size() - 1;
+}
+
+/// <summary>
+/// Gets whether a pass writes the passed in resource.
+/// </summary>
+static bool WritesResource(const std::vector<int>& a_lWriters, int a_dPass)
+{
+	return std::find(a_lWriters.begin(), a_lWriters.end(), a_dPass) != a_lWriters.end();
+}
+
+void FrameGraph::CullPasses(void)
+{
+	// A pass is needed as long as one of its outputs is. Read-modify-write
+	// passes count as writers of the resource and not as its readers.
+	for (int i = 0; i < m_lPasses.size(); i++)
+	{
+		m_lPasses[i].IsCulled = false;
+		m_lPasses[i].RefCount = (int)m_lPasses[i].Writes.size();
+	}
+	for (int i = 0; i < m_lResources.size(); i++)
+	{
+		m_lResources[i].RefCount = 0;
+	}
+	for (int i = 0; i < m_lPasses.size(); i++)
+	{
+		for (int j = 0; j < m_lPasses[i].Reads.size(); j++)
+		{
+			Resource& resource = m_lResources[m_lPasses[i].Reads[j].Resource];
+			if (!WritesResource(resource.Writers, i))
+			{
+				resource.RefCount++;
+			}
+		}
+	}
+
+	// Flood filling from the unread transient resources back to their producers.
+	std::vector<int> lUnused;
+	for (int i = 0; i < m_lResources.size(); i++)
+	{
+		if (m_lResources[i].RefCount == 0 && !m_lResources[i].IsImported)
+		{
+			lUnused.push_back(i);
+		}
+	}
+	while (!lUnused.empty())
+	{
+		Resource& resource = m_lResources[lUnused.back()];
+		lUnused.pop_back();
+
+		for (int i = 0; i < resource.Writers.size(); i++)
+		{
+			Pass& writer = m_lPasses[resource.Writers[i]];
+			if (--writer.RefCount > 0 || writer.HasSideEffect || writer.IsCulled) continue;
+
+			// Nothing uses this pass anymore, so its inputs lose a reader.
+			writer.IsCulled = true;
+			m_sStats.CulledPasses++;
+			for (int j = 0; j < writer.Reads.size(); j++)
+			{
+				Resource& input = m_lResources[writer.Reads[j].Resource];
+				if (WritesResource(input.Writers, resource.Writers[i])) continue;
+
+				if (--input.RefCount == 0 && !input.IsImported)
+				{
+					lUnused.push_back(writer.Reads[j].Resource);
+				}
+			}
+		}
+	}
+}
+
+void FrameGraph::SortPasses(void)
+{
+	// Building the dependencies: the writers of a resource run in the
+	// order they were added, and its readers run after every writer.
+	int dPasses = (int)m_lPasses.size();
+	std::vector<std::vector<int>> lEdges(dPasses);
+	std::vector<int> lIncoming(dPasses, 0);
+	for (int i = 0; i < m_lResources.size(); i++)
+	{
+		const std::vector<int>& lWriters = m_lResources[i].Writers;
+		for (int j = 1; j < lWriters.size(); j++)
+		{
+			lEdges[lWriters[j - 1]].push_back(lWriters[j]);
+			lIncoming[lWriters[j]]++;
+		}
+	}
+	for (int i = 0; i < dPasses; i++)
+	{
+		for (int j = 0; j < m_lPasses[i].Reads.size(); j++)
+		{
+			const std::vector<int>& lWriters = m_lResources[m_lPasses[i].Reads[j].Resource].Writers;
+			if (WritesResource(lWriters, i)) continue;
+
+			for (int k = 0; k < lWriters.size(); k++)
+			{
+				lEdges[lWriters[k]].push_back(i);
+				lIncoming[i]++;
+			}
+		}
+	}
+
+	// Kahn's algorithm, preferring the earliest added pass when several are ready.
+	std::vector<int> lSorted;
+	std::vector<bool> lDone(dPasses, false);
+	for (int n = 0; n < dPasses; n++)
+	{
+		int dNext = -1;
+		for (int i = 0; i < dPasses; i++)
+		{
+			if (!lDone[i] && lIncoming[i] == 0)
+			{
+				dNext = i;
+				break;
+			}
+		}
+
+		if (dNext == -1)
+		{
+			std::cout << "FrameGraph: cyclic pass dependencies, falling back to the order passes were added." << std::endl;
+			lSorted.clear();
+			for (int i = 0; i < dPasses; i++)
+			{
+				lSorted.push_back(i);
+			}
+			break;
+		}
+
+		lDone[dNext] = true;
+		lSorted.push_back(dNext);
+		for (int i = 0; i < lEdges[dNext].size(); i++)
+		{
+			lIncoming[lEdges[dNext][i]]--;
+		}
+	}
+
+	// Only the surviving passes are executed.
+	m_lOrder.clear();
+	for (int i = 0; i < lSorted.size(); i++)
+	{
+		if (!m_lPasses[lSorted[i]].IsCulled)
+		{
+			m_lOrder.push_back(lSorted[i]);
+		}
+	}
+}
+
+void FrameGraph::AllocateResources(void)
+{
+	// Finding the span of executed passes each resource is alive for.
+	for (int i = 0; i < m_lResources.size(); i++)
+	{
+		m_lResources[i].FirstUse = -1;
+		m_lResources[i].LastUse = -1;
+	}
+	for (int i = 0; i < m_lOrder.size(); i++)
+	{
+		const Pass& pass = m_lPasses[m_lOrder[i]];
+		for (int j = 0; j < pass.Reads.size() + pass.Writes.size(); j++)
+		{
+			FGResource dResource = j < pass.Reads.size() ? pass.Reads[j].Resource : pass.Writes[j - pass.Reads.size()].Resource;
+			Resource& resource = m_lResources[dResource];
+			if (resource.FirstUse == -1)
+			{
+				resource.FirstUse = i;
+			}
+			resource.LastUse = i;
+		}
+	}
+
+	// Visiting the transients in the order they come alive.
+	std::vector<int> lTransients;
+	for (int i = 0; i < m_lResources.size(); i++)
+	{
+		if (!m_lResources[i].IsImported && m_lResources[i].FirstUse != -1)
+		{
+			lTransients.push_back(i);
+		}
+	}
+	std::stable_sort(lTransients.begin(), lTransients.end(), [this](int a, int b)
+	{
+		return m_lResources[a].FirstUse < m_lResources[b].FirstUse;
+	});
+
+	// Every pooled object starts out free.
+	for (int i = 0; i < m_lTexturePool.size(); i++)
+	{
+		m_lTexturePool[i].LastUse = -1;
+	}
+	for (int i = 0; i < m_lBufferPool.size(); i++)
+	{
+		m_lBufferPool[i].LastUse = -1;
+	}
+
+	for (int i = 0; i < lTransients.size(); i++)
+	{
+		Resource& resource = m_lResources[lTransients[i]];
+
+		if (resource.IsTexture)
+		{
+			const FGTextureDesc& desc = resource.TextureDesc;
+			m_sStats.TransientTextures++;
+			m_sStats.TransientBytes += desc.Width * desc.Height * GetTexelSize(desc.Format);
+
+			// Reusing a matching texture whose previous owner is already dead.
+			int dFound = -1;
+			for (int j = 0; j < m_lTexturePool.size(); j++)
+			{
+				if (m_lTexturePool[j].Desc == desc && m_lTexturePool[j].LastUse < resource.FirstUse)
+				{
+					dFound = j;
+					break;
+				}
+			}
+			if (dFound == -1)
+			{
+				PhysicalTexture texture = PhysicalTexture();
+				texture.Desc = desc;
+				GLCall(glGenTextures(1, &texture.ID));
+				GLCall(glBindTexture(GL_TEXTURE_2D, texture.ID));
+				if (glTexStorage2D != nullptr)
+				{
+					GLCall(glTexStorage2D(GL_TEXTURE_2D, 1, desc.Format, desc.Width, desc.Height));
+				}
+				else
+				{
+					GLenum ePixelFormat = IsDepthFormat(desc.Format) ? (IsStencilFormat(desc.Format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT) : GL_RGBA;
+					GLenum ePixelType = IsStencilFormat(desc.Format) ? GL_UNSIGNED_INT_24_8 : GL_UNSIGNED_BYTE;
+					GLCall(glTexImage2D(GL_TEXTURE_2D, 0, desc.Format, desc.Width, desc.Height, 0, ePixelFormat, ePixelType, nullptr));
+				}
+				GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+				GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+				GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+				GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+				GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+				MemoryTracker::AddTexture(texture.ID, MEMORY_RENDER_TARGETS, desc.Width * desc.Height * GetTexelSize(desc.Format));
+
+				dFound = (int)m_lTexturePool.size();
+				m_lTexturePool.push_back(texture);
+			}
+
+			m_lTexturePool[dFound].LastUse = resource.LastUse;
+			resource.Physical = m_lTexturePool[dFound].ID;
+		}
+		else
+		{
+			// Reusing any large enough buffer whose previous owner is already dead.
+			int dFound = -1;
+			for (int j = 0; j < m_lBufferPool.size(); j++)
+			{
+				if (m_lBufferPool[j].Size >= resource.BufferDesc.Size && m_lBufferPool[j].LastUse < resource.FirstUse)
+				{
+					dFound = j;
+					break;
+				}
+			}
+			if (dFound == -1)
+			{
+				PhysicalBuffer buffer = PhysicalBuffer();
+				buffer.Size = resource.BufferDesc.Size;
+				GLCall(glGenBuffers(1, &buffer.ID));
+				GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.ID));
+				GLCall(glBufferData(GL_COPY_WRITE_BUFFER, buffer.Size, nullptr, GL_DYNAMIC_DRAW));
+				GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+				MemoryTracker::AddBuffer(buffer.ID, MEMORY_RENDER_TARGETS, buffer.Size);
+
+				dFound = (int)m_lBufferPool.size();
+				m_lBufferPool.push_back(buffer);
+			}
+
+			m_lBufferPool[dFound].LastUse = resource.LastUse;
+			resource.Physical = m_lBufferPool[dFound].ID;
+		}
+	}
+
+	// Freeing whatever the new graph no longer needs, e.g. targets of the old window size.
+	for (int i = (int)m_lTexturePool.size() - 1; i >= 0; i--)
+	{
+		if (m_lTexturePool[i].LastUse == -1)
+		{
+			MemoryTracker::RemoveTexture(m_lTexturePool[i].ID);
+			GLCall(glDeleteTextures(1, &m_lTexturePool[i].ID));
+			m_lTexturePool.erase(m_lTexturePool.begin() + i);
+		}
+	}
+	for (int i = (int)m_lBufferPool.size() - 1; i >= 0; i--)
+	{
+		if (m_lBufferPool[i].LastUse == -1)
+		{
+			MemoryTracker::RemoveBuffer(m_lBufferPool[i].ID);
+			GLCall(glDeleteBuffers(1, &m_lBufferPool[i].ID));
+			m_lBufferPool.erase(m_lBufferPool.begin() + i);
+		}
+	}
+
+	m_sStats.PhysicalTextures = (int)m_lTexturePool.size();
+	for (int i = 0; i < m_lTexturePool.size(); i++)
+	{
+		const FGTextureDesc& desc = m_lTexturePool[i].Desc;
+		m_sStats.AliasedBytes += desc.Width * desc.Height * GetTexelSize(desc.Format);
+	}
+}
+
+/// <summary>
+/// Gets the barrier bits that make a shader write visible to a later access.
+/// </summary>
+static GLbitfield GetBarrierBits(FGUsage a_eUsage, bool a_bIsTexture)
+{
+	switch (a_eUsage)
+	{
+	case FG_RENDER_TARGET: return GL_FRAMEBUFFER_BARRIER_BIT;
+	case FG_SAMPLED: return GL_TEXTURE_FETCH_BARRIER_BIT;
+	case FG_STORAGE: return a_bIsTexture ? GL_SHADER_IMAGE_ACCESS_BARRIER_BIT : GL_SHADER_STORAGE_BARRIER_BIT;
+	case FG_VERTEX: return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+	case FG_INDIRECT: return GL_COMMAND_BARRIER_BIT;
+	case FG_UNIFORM: return GL_UNIFORM_BARRIER_BIT;
+	case FG_COPY: return a_bIsTexture ? GL_TEXTURE_UPDATE_BARRIER_BIT : GL_BUFFER_UPDATE_BARRIER_BIT;
+	default: return 0;
+	}
+}
+
+void FrameGraph::PreparePasses(void)
+{
+	ReleaseFramebuffers();
+
+	// Only incoherent shader writes need explicit barriers, framebuffer
+	// writes are synchronized by GL when the framebuffer changes.
+	std::vector<bool> lHasPendingWrite(m_lResources.size(), false);
+	for (int i = 0; i < m_lOrder.size(); i++)
+	{
+		Pass& pass = m_lPasses[m_lOrder[i]];
+		pass.Barriers = 0;
+
+		for (int j = 0; j < pass.Reads.size() + pass.Writes.size(); j++)
+		{
+			const Access& access = j < pass.Reads.size() ? pass.Reads[j] : pass.Writes[j - pass.Reads.size()];
+			if (lHasPendingWrite[access.Resource])
+			{
+				pass.Barriers |= GetBarrierBits(access.Usage, m_lResources[access.Resource].IsTexture);
+				lHasPendingWrite[access.Resource] = false;
+			}
+		}
+		for (int j = 0; j < pass.Writes.size(); j++)
+		{
+			if (pass.Writes[j].Usage == FG_STORAGE)
+			{
+				lHasPendingWrite[pass.Writes[j].Resource] = true;
+			}
+		}
+
+		// Gathering the render targets of the pass.
+		std::vector<FGResource> lTargets;
+		bool bUsesBackbuffer = false;
+		for (int j = 0; j < pass.Writes.size(); j++)
+		{
+			if (pass.Writes[j].Usage != FG_RENDER_TARGET) continue;
+
+			if (m_lResources[pass.Writes[j].Resource].IsBackbuffer)
+			{
+				bUsesBackbuffer = true;
+			}
+			else
+			{
+				lTargets.push_back(pass.Writes[j].Resource);
+			}
+		}
+
+		if (bUsesBackbuffer)
+		{
+			if (!lTargets.empty())
+			{
+				std::cout << "FrameGraph: pass " << pass.Name << " mixes the backbuffer with other render targets." << std::endl;
+			}
+			pass.Target = FG_BACKBUFFER;
+			continue;
+		}
+		if (lTargets.empty())
+		{
+			pass.Target = FG_NO_TARGETS;
+			continue;
+		}
+
+		// Building a framebuffer around the pass' textures.
+		Framebuffer framebuffer = Framebuffer();
+		framebuffer.Width = m_lResources[lTargets[0]].TextureDesc.Width;
+		framebuffer.Height = m_lResources[lTargets[0]].TextureDesc.Height;
+		GLCall(glGenFramebuffers(1, &framebuffer.ID));
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.ID));
+
+		std::vector<GLenum> lDrawBuffers;
+		for (int j = 0; j < lTargets.size(); j++)
+		{
+			const Resource& resource = m_lResources[lTargets[j]];
+			GLenum eAttachment = GL_COLOR_ATTACHMENT0 + (GLenum)lDrawBuffers.size();
+			if (IsDepthFormat(resource.TextureDesc.Format))
+			{
+				eAttachment = IsStencilFormat(resource.TextureDesc.Format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+			}
+			else
+			{
+				lDrawBuffers.push_back(eAttachment);
+			}
+			GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, eAttachment, GL_TEXTURE_2D, resource.Physical, 0));
+		}
+
+		// Depth only passes draw no color at all.
+		if (lDrawBuffers.empty())
+		{
+			GLCall(glDrawBuffer(GL_NONE));
+		}
+		else
+		{
+			GLCall(glDrawBuffers((GLsizei)lDrawBuffers.size(), lDrawBuffers.data()));
+		}
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "FrameGraph: framebuffer of pass " << pass.Name << " is incomplete." << std::endl;
+		}
+
+		pass.Target = (int)m_lFramebuffers.size();
+		m_lFramebuffers.push_back(framebuffer);
+	}
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void FrameGraph::ReleasePools(void)
+{
+	ReleaseFramebuffers();
+
+	for (int i = 0; i < m_lTexturePool.size(); i++)
+	{
+		MemoryTracker::RemoveTexture(m_lTexturePool[i].ID);
+		glDeleteTextures(1, &m_lTexturePool[i].ID);
+	}
+	for (int i = 0; i < m_lBufferPool.size(); i++)
+	{
+		MemoryTracker::RemoveBuffer(m_lBufferPool[i].ID);
+		glDeleteBuffers(1, &m_lBufferPool[i].ID);
+	}
+	m_lTexturePool.clear();
+	m_lBufferPool.clear();
+	m_bIsCompiled = false;
+}
+
+void FrameGraph::ReleaseFramebuffers(void)
+{
+	for (int i = 0; i < m_lFramebuffers.size(); i++)
+	{
+		glDeleteFramebuffers(1, &m_lFramebuffers[i].ID);
+	}
+	m_lFramebuffers.clear();
+}
@@ -0,0 +1,347 @@
+#ifndef __FRAMEGRAPH_H_
+#define __FRAMEGRAPH_H_
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+class GPUProfiler;
+
+// Handle to a resource declared in the FrameGraph.
+typedef int FGResource;
+#define FG_INVALID -1
+
+/// <summary>
+/// How a pass touches a resource.  Drives framebuffer setup and barrier insertion.
+/// </summary>
+enum FGUsage
+{
+	FG_RENDER_TARGET = 0,	// Color or depth attachment of the pass' framebuffer.
+	FG_SAMPLED,				// Read through a sampler in a shader.
+	FG_STORAGE,				// Image load/store or shader storage buffer access.
+	FG_VERTEX,				// Vertex or index data.
+	FG_INDIRECT,			// Indirect draw or dispatch arguments.
+	FG_UNIFORM,				// Uniform buffer data.
+	FG_COPY					// Blit or buffer copy source/destination.
+};
+
+/// <summary>
+/// Describes a texture owned by the FrameGraph.
+/// </summary>
+struct FGTextureDesc
+{
+	int Width;
+	int Height;
+	GLenum Format;		// Sized internal format, e.g. GL_RGBA8 or GL_DEPTH_COMPONENT24.
+
+	bool operator==(const FGTextureDesc& a_dOther) const;
+};
+
+/// <summary>
+/// Describes a buffer owned by the FrameGraph.
+/// </summary>
+struct FGBufferDesc
+{
+	GLsizeiptr Size;
+};
+
+/// <summary>
+/// Memory totals of the last compiled graph.
+/// </summary>
+struct FGStats
+{
+	int Passes;
+	int CulledPasses;
+	int TransientTextures;
+	int PhysicalTextures;
+	size_t TransientBytes;	// What every transient would cost without aliasing.
+	size_t AliasedBytes;	// What the physical textures actually cost.
+};
+
+/// <summary>
+/// Declarative render pass graph.  Passes declare the resources they read and write,
+/// the graph derives the execution order, culls passes whose output is never used,
+/// inserts memory barriers and aliases transient textures with disjoint lifetimes.
+/// The graph is built and compiled once and executed every frame until it changes.
+/// </summary>
+class FrameGraph
+{
+public:
+	/// <summary>
+	/// Handed to a pass' setup function to declare its resources.
+	/// </summary>
+	class Builder
+	{
+	private:
+		FrameGraph* m_pGraph;
+		int m_dPass;
+
+	public:
+		/// <summary>
+		/// Constructs a Builder for the passed in pass.
+		/// </summary>
+		Builder(FrameGraph* a_pGraph, int a_dPass);
+
+		/// <summary>
+		/// Declares a texture that only lives for the duration of the frame.
+		/// </summary>
+		FGResource CreateTexture(std::string a_sName, FGTextureDesc a_dDesc);
+
+		/// <summary>
+		/// Declares a buffer that only lives for the duration of the frame.
+		/// </summary>
+		FGResource CreateBuffer(std::string a_sName, FGBufferDesc a_dDesc);
+
+		/// <summary>
+		/// Declares that the pass reads the resource.
+		/// </summary>
+		FGResource Read(FGResource a_dResource, FGUsage a_eUsage = FG_SAMPLED);
+
+		/// <summary>
+		/// Declares that the pass writes the resource.
+		/// </summary>
+		FGResource Write(FGResource a_dResource, FGUsage a_eUsage = FG_RENDER_TARGET);
+
+		/// <summary>
+		/// Keeps the pass from ever being culled, e.g. for readbacks or queries.
+		/// </summary>
+		void SideEffect(void);
+	};
+
+	/// <summary>
+	/// Handed to a pass' execute function to look up its physical resources.
+	/// </summary>
+	class Context
+	{
+	private:
+		FrameGraph* m_pGraph;
+
+	public:
+		/// <summary>
+		/// Constructs a Context over the passed in graph.
+		/// </summary>
+		Context(FrameGraph* a_pGraph);
+
+		/// <summary>
+		/// Gets the GL texture name backing a resource.
+		/// </summary>
+		GLuint GetTexture(FGResource a_dResource);
+
+		/// <summary>
+		/// Gets the GL buffer name backing a resource.
+		/// </summary>
+		GLuint GetBuffer(FGResource a_dResource);
+
+		/// <summary>
+		/// Gets the description of a texture resource.
+		/// </summary>
+		const FGTextureDesc& GetTextureDesc(FGResource a_dResource);
+	};
+
+	typedef std::function<void(Builder&)> SetupFunction;
+	typedef std::function<void(Context&)> ExecuteFunction;
+
+private:
+	/// <summary>
+	/// A resource node.  Transient ones are mapped onto pooled physical objects.
+	/// </summary>
+	struct Resource
+	{
+		std::string Name;
+		bool IsTexture;
+		bool IsImported;
+		bool IsBackbuffer;
+		FGTextureDesc TextureDesc;
+		FGBufferDesc BufferDesc;
+		GLuint Physical;	// GL object backing the resource, imported or pooled.
+		int RefCount;
+		int FirstUse;
+		int LastUse;
+		std::vector<int> Writers;
+	};
+
+	/// <summary>
+	/// A single access of a resource by a pass.
+	/// </summary>
+	struct Access
+	{
+		FGResource Resource;
+		FGUsage Usage;
+	};
+
+	/// <summary>
+	/// A pass node.
+	/// </summary>
+	struct Pass
+	{
+		std::string Name;
+		ExecuteFunction Execute;
+		std::vector<Access> Reads;
+		std::vector<Access> Writes;
+		bool HasSideEffect;
+		bool IsCulled;
+		int RefCount;
+		GLbitfield Barriers;	// Issued before the pass runs.
+		int Target;			// Index into m_lFramebuffers, or FG_BACKBUFFER / FG_NO_TARGETS.
+	};
+
+	/// <summary>
+	/// A pooled GL texture that transient textures alias onto.
+	/// </summary>
+	struct PhysicalTexture
+	{
+		GLuint ID;
+		FGTextureDesc Desc;
+		int LastUse;
+	};
+
+	/// <summary>
+	/// A pooled GL buffer that transient buffers alias onto.
+	/// </summary>
+	struct PhysicalBuffer
+	{
+		GLuint ID;
+		GLsizeiptr Size;
+		int LastUse;
+	};
+
+	/// <summary>
+	/// A framebuffer object built for one pass' render targets.
+	/// </summary>
+	struct Framebuffer
+	{
+		GLuint ID;
+		int Width;
+		int Height;
+	};
+
+	std::vector<Resource> m_lResources;
+	std::vector<Pass> m_lPasses;
+	std::vector<int> m_lOrder;
+	std::vector<PhysicalTexture> m_lTexturePool;
+	std::vector<PhysicalBuffer> m_lBufferPool;
+	std::vector<Framebuffer> m_lFramebuffers;
+	bool m_bIsCompiled = false;
+	FGStats m_sStats;
+	GPUProfiler* m_pProfiler = nullptr;
+
+public:
+	/// <summary>
+	/// Constructs an empty FrameGraph.
+	/// </summary>
+	FrameGraph(void);
+
+	/// <summary>
+	/// Frees every pooled GL object.
+	/// </summary>
+	~FrameGraph(void);
+
+	/// <summary>
+	/// Copy constructor for the FrameGraph.  Only the declarations are copied.
+	/// </summary>
+	FrameGraph(const FrameGraph& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the FrameGraph.  Only the declarations are copied.
+	/// </summary>
+	FrameGraph& operator=(const FrameGraph& a_pOther);
+
+	/// <summary>
+	/// Declares an externally owned texture.  Imported resources are never culled.
+	/// </summary>
+	FGResource ImportTexture(std::string a_sName, GLuint a_dTexture, FGTextureDesc a_dDesc);
+
+	/// <summary>
+	/// Declares the default framebuffer of the window.  Passes writing it draw to the screen.
+	/// </summary>
+	/// <param name="a_uFramebuffer">Framebuffer standing in for the window, e.g. when rendering headless.</param>
+	FGResource ImportBackbuffer(std::string a_sName, int a_dWidth, int a_dHeight, GLuint a_uFramebuffer = 0);
+
+	/// <summary>
+	/// Adds a pass.  The setup function runs immediately to declare the pass' resources.
+	/// </summary>
+	/// <param name="a_sName">Name of the pass for debugging and profiling.</param>
+	/// <param name="a_Setup">Declares the reads and writes of the pass.</param>
+	/// <param name="a_Execute">Issues the pass' GL commands.</param>
+	void AddPass(std::string a_sName, SetupFunction a_Setup, ExecuteFunction a_Execute);
+
+	/// <summary>
+	/// Culls, orders and allocates the graph.  Called automatically by Execute.
+	/// </summary>
+	void Compile(void);
+
+	/// <summary>
+	/// Runs every surviving pass in order.
+	/// </summary>
+	void Execute(void);
+
+	/// <summary>
+	/// Removes every pass and resource so the graph can be rebuilt.
+	/// Pooled GL objects are kept for the next build.
+	/// </summary>
+	void Reset(void);
+
+	/// <summary>
+	/// Sets the profiler every executed pass is measured with.  Not owned by the graph.
+	/// </summary>
+	void SetProfiler(GPUProfiler* a_pProfiler);
+
+	/// <summary>
+	/// Gets the statistics of the last compile.
+	/// </summary>
+	const FGStats& GetStats(void);
+
+	/// <summary>
+	/// Gets the number of declared passes.
+	/// </summary>
+	int GetPassCount(void);
+
+	/// <summary>
+	/// Gets the name of a declared pass.
+	/// </summary>
+	const std::string& GetPassName(int a_dPass);
+
+	/// <summary>
+	/// Gets whether a declared pass was culled by the last compile.
+	/// </summary>
+	bool IsPassCulled(int a_dPass);
+
+private:
+	/// <summary>
+	/// Declares a new resource node.
+	/// </summary>
+	FGResource AddResource(Resource a_rResource);
+
+	/// <summary>
+	/// Removes the passes that do not contribute to an imported resource or side effect.
+	/// </summary>
+	void CullPasses(void);
+
+	/// <summary>
+	/// Sorts the surviving passes so every access happens in declaration order.
+	/// </summary>
+	void SortPasses(void);
+
+	/// <summary>
+	/// Maps transient resources onto pooled GL objects, sharing them between disjoint lifetimes.
+	/// </summary>
+	void AllocateResources(void);
+
+	/// <summary>
+	/// Finds the memory barriers and framebuffer every pass needs.
+	/// </summary>
+	void PreparePasses(void);
+
+	/// <summary>
+	/// Frees every pooled texture, buffer and framebuffer.
+	/// </summary>
+	void ReleasePools(void);
+
+	/// <summary>
+	/// Frees the framebuffers built for the passes.
+	/// </summary>
+	void ReleaseFramebuffers(void);
+};
+
+#endif //__FRAMEGRAPH_H_
@@ -0,0 +1,164 @@
+#include "FramePacer.h"
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+FramePacer::FramePacer(void)
+{
+	// Sleeps are rounded up to the 15.6 ms system tick unless asked otherwise.
+#ifdef _WIN32
+	timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer(void)
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+FramePacer::FramePacer(const FramePacer& a_pOther)
+{
+#ifdef _WIN32
+	timeBeginPeriod(1);
+#endif
+	*this = a_pOther;
+}
+
+FramePacer& FramePacer::operator=(const FramePacer& a_pOther)
+{
+	// The pacing history belongs to the original's frames, so only the settings are copied.
+	m_fTargetRate = a_pOther.m_fTargetRate;
+	m_bIsLowLatency = a_pOther.m_bIsLowLatency;
+	m_bHasStarted = false;
+	m_dMissedFrames = 0;
+	m_dIntervalCount = 0;
+	m_dNextInterval = 0;
+	return *this;
+}
+
+void FramePacer::SetTargetRate(float a_fFramesPerSecond)
+{
+	m_fTargetRate = a_fFramesPerSecond > 0.0f ? a_fFramesPerSecond : 0.0f;
+	m_bHasStarted = false;
+	m_dMissedFrames = 0;
+}
+
+float FramePacer::GetTargetRate(void) { return m_fTargetRate; }
+void FramePacer::SetLowLatency(bool a_bIsLowLatency) { m_bIsLowLatency = a_bIsLowLatency; }
+bool FramePacer::IsLowLatency(void) { return m_bIsLowLatency; }
+
+void FramePacer::WaitForFrame(void)
+{
+	Clock::time_point now = Clock::now();
+	m_fWaitMS = 0.0f;
+
+	if (m_fTargetRate > 0.0f)
+	{
+		Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / m_fTargetRate));
+
+		// Deadlines advance by whole periods so small delays do not add up.
+		m_tNextPresent = m_bHasStarted ? m_tNextPresent + period : now + period;
+		m_bHasStarted = true;
+
+		// A frame normally starts a period before its deadline.  In low latency mode it starts
+		// just early enough for the measured latency, leaving the rest of the period idle.
+		Clock::duration lead = period;
+		if (m_bIsLowLatency)
+		{
+			float fLeadMS = m_fLatencyMS + FRAME_PACER_LATENCY_MARGIN_MS;
+			Clock::duration latency = std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<float, std::milli>(fLeadMS));
+			lead = std::min(period, latency);
+		}
+
+		Clock::time_point start = m_tNextPresent - lead;
+		if (start > now)
+		{
+			WaitUntil(start);
+			m_fWaitMS = std::chrono::duration<float, std::milli>(Clock::now() - now).count();
+		}
+		else if (now - start > period)
+		{
+			// More than a frame behind.  Starting over from now instead of rushing to catch up.
+			m_tNextPresent = now + lead;
+			m_dMissedFrames++;
+		}
+	}
+
+	// Keeping the time between frame starts for the variance.
+	Clock::time_point frameStart = Clock::now();
+	if (m_tLastFrame != Clock::time_point())
+	{
+		m_lIntervals[m_dNextInterval] = std::chrono::duration<float, std::milli>(frameStart - m_tLastFrame).count();
+		m_dNextInterval = (m_dNextInterval + 1) % FRAME_PACER_HISTORY;
+		m_dIntervalCount = std::min(m_dIntervalCount + 1, FRAME_PACER_HISTORY);
+	}
+	m_tLastFrame = frameStart;
+}
+
+void FramePacer::AddLatency(Clock::time_point a_tInputTime)
+{
+	// Smoothed so one slow frame does not start the next ones much earlier.
+	float fLatency = std::chrono::duration<float, std::milli>(Clock::now() - a_tInputTime).count();
+	float fPrevious = m_fLatencyMS;
+	m_fLatencyMS = fPrevious == 0.0f ? fLatency : fPrevious * 0.9f + fLatency * 0.1f;
+}
+
+PacingStats FramePacer::GetStats(void)
+{
+	PacingStats stats = PacingStats();
+	stats.TargetRate = m_fTargetRate;
+	stats.IsLowLatency = m_bIsLowLatency;
+	stats.LatencyMS = m_fLatencyMS;
+	stats.WaitMS = m_fWaitMS;
+	stats.MissedFrames = m_dMissedFrames;
+	if (m_dIntervalCount == 0) return stats;
+
+	float fTotal = 0.0f;
+	for (int i = 0; i < m_dIntervalCount; i++)
+	{
+		fTotal += m_lIntervals[i];
+	}
+	stats.MeanIntervalMS = fTotal / m_dIntervalCount;
+
+	float fSquares = 0.0f;
+	for (int i = 0; i < m_dIntervalCount; i++)
+	{
+		float fOffset = m_lIntervals[i] - stats.MeanIntervalMS;
+		fSquares += fOffset * fOffset;
+	}
+	stats.IntervalDeviationMS = sqrtf(fSquares / m_dIntervalCount);
+	return stats;
+}
+
+void FramePacer::WaitUntil(Clock::time_point a_tDeadline)
+{
+	// Sleeping a millisecond at a time while a sleep plus its usual overshoot still fits.
+	while (true)
+	{
+		Clock::time_point before = Clock::now();
+		float fRemainingMS = std::chrono::duration<float, std::milli>(a_tDeadline - before).count();
+		if (fRemainingMS <= 1.0f + m_fOvershootMS * 2.0f) break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		// Learning how late sleeps wake up on this system.
+		float fSleptMS = std::chrono::duration<float, std::milli>(Clock::now() - before).count();
+		m_fOvershootMS = m_fOvershootMS * 0.9f + std::max(fSleptMS - 1.0f, 0.0f) * 0.1f;
+	}
+
+	// Spinning the rest for sub millisecond accuracy.
+	while (Clock::now() < a_tDeadline)
+	{
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,120 @@
+#ifndef __FRAMEPACER_H_
+#define __FRAMEPACER_H_
+
+#include <chrono>
+#include <atomic>
+
+// Default frame limit of the window.  0 leaves frames unlimited.
+#define FRAME_PACER_RATE 60.0f
+
+// Frame intervals kept for the variance reported in the stats.
+#define FRAME_PACER_HISTORY 120
+
+// Extra time given to a frame in low latency mode on top of its measured latency.
+#define FRAME_PACER_LATENCY_MARGIN_MS 1.0f
+
+/// <summary>
+/// Pacing results of the recent frames.
+/// </summary>
+struct PacingStats
+{
+	float TargetRate;			// 0 when frames are unlimited.
+	bool IsLowLatency;
+	float MeanIntervalMS;		// Time between frame starts.
+	float IntervalDeviationMS;	// Standard deviation of those times.
+	float LatencyMS;			// From input sampling to the frame being shown.
+	float WaitMS;				// Time the last frame waited before starting.
+	int MissedFrames;			// Frames started late since the target was set.
+};
+
+/// <summary>
+/// Limits the simulation thread to a target framerate.  Waits sleep while far from the
+/// deadline and spin for the last stretch, since sleeps can overshoot by a millisecond
+/// or more.  In low latency mode a frame starts only as early as its measured input to
+/// present latency needs, so input is sampled as late as possible.
+/// </summary>
+class FramePacer
+{
+private:
+	typedef std::chrono::high_resolution_clock Clock;
+
+	float m_fTargetRate = 0.0f;
+	bool m_bIsLowLatency = false;
+	bool m_bHasStarted = false;
+	Clock::time_point m_tNextPresent;
+	Clock::time_point m_tLastFrame;
+	float m_fOvershootMS = 1.0f;
+	float m_fWaitMS = 0.0f;
+	int m_dMissedFrames = 0;
+	std::atomic<float> m_fLatencyMS{ 0.0f };	// Written by the render thread.
+
+	float m_lIntervals[FRAME_PACER_HISTORY];
+	int m_dIntervalCount = 0;
+	int m_dNextInterval = 0;
+
+public:
+	/// <summary>
+	/// Constructs a FramePacer with no frame limit.
+	/// </summary>
+	FramePacer(void);
+
+	/// <summary>
+	/// Restores the system timer resolution.
+	/// </summary>
+	~FramePacer(void);
+
+	/// <summary>
+	/// Copy constructor for the FramePacer.
+	/// </summary>
+	FramePacer(const FramePacer& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the FramePacer.
+	/// </summary>
+	FramePacer& operator=(const FramePacer& a_pOther);
+
+	/// <summary>
+	/// Sets the target framerate.  0 or less leaves frames unlimited.
+	/// </summary>
+	void SetTargetRate(float a_fFramesPerSecond);
+
+	/// <summary>
+	/// Gets the target framerate.  0 when frames are unlimited.
+	/// </summary>
+	float GetTargetRate(void);
+
+	/// <summary>
+	/// Sets whether frames start as late as their latency allows.
+	/// </summary>
+	void SetLowLatency(bool a_bIsLowLatency);
+
+	/// <summary>
+	/// Gets whether frames start as late as their latency allows.
+	/// </summary>
+	bool IsLowLatency(void);
+
+	/// <summary>
+	/// Waits until the next frame should start.  Called on the simulation thread right
+	/// before input is sampled.
+	/// </summary>
+	void WaitForFrame(void);
+
+	/// <summary>
+	/// Adds the latency of a frame that was just shown.  Safe to call from the render thread.
+	/// </summary>
+	/// <param name="a_tInputTime">When the frame's input was sampled.</param>
+	void AddLatency(Clock::time_point a_tInputTime);
+
+	/// <summary>
+	/// Gets the pacing results of the recent frames.
+	/// </summary>
+	PacingStats GetStats(void);
+
+private:
+	/// <summary>
+	/// Sleeps, then spins, until the deadline.
+	/// </summary>
+	void WaitUntil(Clock::time_point a_tDeadline);
+};
+
+#endif //__FRAMEPACER_H_
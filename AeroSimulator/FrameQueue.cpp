@@ -0,0 +1,85 @@
+#include "FrameQueue.h"
+
+FrameQueue::FrameQueue(void)
+{
+	for (int i = 0; i < FRAME_PACKET_COUNT; i++)
+	{
+		m_lStates[i] = PACKET_FREE;
+	}
+}
+
+FrameQueue::FrameQueue(const FrameQueue&)
+{
+	// Packets belong to the threads using the other queue.
+	for (int i = 0; i < FRAME_PACKET_COUNT; i++)
+	{
+		m_lStates[i] = PACKET_FREE;
+	}
+}
+
+FrameQueue& FrameQueue::operator=(const FrameQueue&)
+{
+	// Packets belong to the threads using the other queue.
+	return *this;
+}
+
+FramePacket* FrameQueue::BeginWrite(void)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cvChanged.wait(lock, [this]() { return m_bIsStopped || m_lStates[m_dWrite] == PACKET_FREE; });
+	if (m_bIsStopped) return nullptr;
+
+	m_lStates[m_dWrite] = PACKET_WRITING;
+	return &m_lPackets[m_dWrite];
+}
+
+void FrameQueue::EndWrite(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_lStates[m_dWrite] = PACKET_READY;
+		m_dWrite = (m_dWrite + 1) % FRAME_PACKET_COUNT;
+	}
+	m_cvChanged.notify_all();
+}
+
+FramePacket* FrameQueue::BeginRead(void)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cvChanged.wait(lock, [this]() { return m_bIsStopped || m_lStates[m_dRead] == PACKET_READY; });
+	if (m_lStates[m_dRead] != PACKET_READY) return nullptr;
+
+	m_lStates[m_dRead] = PACKET_READING;
+	return &m_lPackets[m_dRead];
+}
+
+void FrameQueue::EndRead(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_lStates[m_dRead] = PACKET_FREE;
+		m_dRead = (m_dRead + 1) % FRAME_PACKET_COUNT;
+	}
+	m_cvChanged.notify_all();
+}
+
+void FrameQueue::Stop(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bIsStopped = true;
+	}
+	m_cvChanged.notify_all();
+}
+
+void FrameQueue::Restart(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (int i = 0; i < FRAME_PACKET_COUNT; i++)
+	{
+		m_lStates[i] = PACKET_FREE;
+	}
+	m_dWrite = 0;
+	m_dRead = 0;
+	m_bIsStopped = false;
+}
@@ -0,0 +1,133 @@
+#ifndef __FRAMEQUEUE_H_
+#define __FRAMEQUEUE_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "OcclusionCuller.h"
+#include "FramePacer.h"
+#include "DebugView.h"
+
+class Entity;
+
+// Number of frame packets.  Two lets the simulation build frame N+1 while frame N is drawn.
+#define FRAME_PACKET_COUNT 2
+
+/// <summary>
+/// A visible Entity as it was when the frame was simulated.
+/// </summary>
+struct DrawItem
+{
+	Entity* Owner;					// Only the Mesh and Material are read, they never change.
+	glm::mat4 World;
+	glm::mat4 InverseTranspose;
+	glm::vec4 DebugColor;			// Flat color of the debug view modes.
+};
+
+/// <summary>
+/// Everything the render thread needs to draw one frame.  Written by the simulation
+/// thread and read only by the render thread afterwards.
+/// </summary>
+struct FramePacket
+{
+	glm::mat4 View;
+	glm::mat4 Projection;
+	std::vector<DrawItem> Draws;
+	unsigned int Width;
+	unsigned int Height;
+	float DeltaTime;
+	std::chrono::high_resolution_clock::time_point InputTime;	// When the frame's input was sampled.
+	DebugViewMode DebugView;
+	std::vector<DebugBox> DebugBoxes;		// Only filled in the culling view.
+
+	// Simulation side results shown by the debug window.
+	int EntityCount;
+	bool UsedOcclusionCulling;
+	OcclusionStats Occlusion;
+	float SimulationMS;
+	float SimulationRate;
+	int SimulationSteps;
+	int DroppedSteps;
+	PacingStats Pacing;
+};
+
+/// <summary>
+/// A fixed ring of FramePackets handed from one producer thread to one consumer thread.
+/// </summary>
+class FrameQueue
+{
+private:
+	/// <summary>
+	/// Who currently owns a packet.
+	/// </summary>
+	enum PacketState
+	{
+		PACKET_FREE = 0,
+		PACKET_WRITING,
+		PACKET_READY,
+		PACKET_READING
+	};
+
+	FramePacket m_lPackets[FRAME_PACKET_COUNT];
+	PacketState m_lStates[FRAME_PACKET_COUNT];
+	int m_dWrite = 0;
+	int m_dRead = 0;
+	bool m_bIsStopped = false;
+
+	std::mutex m_mutex;
+	std::condition_variable m_cvChanged;
+
+public:
+	/// <summary>
+	/// Constructs a FrameQueue with every packet free.
+	/// </summary>
+	FrameQueue(void);
+
+	/// <summary>
+	/// Copy constructor for the FrameQueue.  Starts empty, packets in flight are not copied.
+	/// </summary>
+	FrameQueue(const FrameQueue& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the FrameQueue.  Packets in flight are not copied.
+	/// </summary>
+	FrameQueue& operator=(const FrameQueue& a_pOther);
+
+	/// <summary>
+	/// Waits for a free packet to fill.  Its previous contents are left in place so
+	/// vectors keep their capacity.
+	/// </summary>
+	/// <returns>The packet, or nullptr once the queue is stopped.</returns>
+	FramePacket* BeginWrite(void);
+
+	/// <summary>
+	/// Hands the packet from BeginWrite to the consumer.
+	/// </summary>
+	void EndWrite(void);
+
+	/// <summary>
+	/// Waits for the next packet in submission order.
+	/// </summary>
+	/// <returns>The packet, or nullptr once the queue is stopped and drained.</returns>
+	FramePacket* BeginRead(void);
+
+	/// <summary>
+	/// Returns the packet from BeginRead to the producer.
+	/// </summary>
+	void EndRead(void);
+
+	/// <summary>
+	/// Wakes both threads.  Packets already submitted are still read.
+	/// </summary>
+	void Stop(void);
+
+	/// <summary>
+	/// Makes the queue usable again after Stop.
+	/// </summary>
+	void Restart(void);
+};
+
+#endif //__FRAMEQUEUE_H_
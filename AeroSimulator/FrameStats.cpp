@@ -0,0 +1,213 @@
+#include "FrameStats.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+FrameStats::FrameStats(int a_dWindow)
+{
+	SetWindow(a_dWindow);
+}
+
+FrameStats::FrameStats(const FrameStats& a_pOther)
+{
+	*this = a_pOther;
+}
+
+FrameStats& FrameStats::operator=(const FrameStats& a_pOther)
+{
+	for (int i = 0; i < STAGE_COUNT; i++)
+	{
+		m_lSamples[i] = a_pOther.m_lSamples[i];
+	}
+	m_lSorted = a_pOther.m_lSorted;
+	m_dCount = a_pOther.m_dCount;
+	m_dNext = a_pOther.m_dNext;
+	m_fBudgetMS = a_pOther.m_fBudgetMS;
+	m_uTotalFrames = a_pOther.m_uTotalFrames;
+	m_uTotalOverBudget = a_pOther.m_uTotalOverBudget;
+	return *this;
+}
+
+void FrameStats::AddFrame(const float a_lStages[STAGE_COUNT])
+{
+	for (int i = 0; i < STAGE_COUNT; i++)
+	{
+		m_lSamples[i][m_dNext] = a_lStages[i];
+	}
+	m_dNext = (m_dNext + 1) % (int)m_lSorted.size();
+	m_dCount = std::min(m_dCount + 1, (int)m_lSorted.size());
+
+	m_uTotalFrames++;
+	if (a_lStages[STAGE_FRAME] > m_fBudgetMS)
+	{
+		m_uTotalOverBudget++;
+	}
+}
+
+void FrameStats::Reset(void)
+{
+	m_dCount = 0;
+	m_dNext = 0;
+	m_uTotalFrames = 0;
+	m_uTotalOverBudget = 0;
+}
+
+void FrameStats::SetWindow(int a_dWindow)
+{
+	// Everything is allocated here so adding frames and summarizing them never allocates.
+	a_dWindow = std::max(a_dWindow, 1);
+	for (int i = 0; i < STAGE_COUNT; i++)
+	{
+		m_lSamples[i].assign(a_dWindow, 0.0f);
+	}
+	m_lSorted.resize(a_dWindow);
+	Reset();
+}
+
+int FrameStats::GetWindow(void) { return (int)m_lSorted.size(); }
+int FrameStats::GetCount(void) { return m_dCount; }
+void FrameStats::SetBudget(float a_fMilliseconds) { m_fBudgetMS = std::max(a_fMilliseconds, 0.1f); }
+float FrameStats::GetBudget(void) { return m_fBudgetMS; }
+unsigned long long FrameStats::GetTotalFrames(void) { return m_uTotalFrames; }
+unsigned long long FrameStats::GetTotalOverBudget(void) { return m_uTotalOverBudget; }
+const float* FrameStats::GetSamples(FrameStage a_eStage) { return m_lSamples[a_eStage].data(); }
+
+int FrameStats::GetOffset(void)
+{
+	// Until the ring wraps the oldest sample is the first one.
+	return m_dCount < (int)m_lSorted.size() ? 0 : m_dNext;
+}
+
+FrameSummary FrameStats::GetSummary(FrameStage a_eStage)
+{
+	FrameSummary summary = FrameSummary();
+	if (m_dCount == 0) return summary;
+
+	// Samples fill the ring from the start, so the first m_dCount are the ones in use.
+	const std::vector<float>& lSamples = m_lSamples[a_eStage];
+	float fTotal = 0.0f;
+	for (int i = 0; i < m_dCount; i++)
+	{
+		m_lSorted[i] = lSamples[i];
+		fTotal += lSamples[i];
+		if (lSamples[i] > m_fBudgetMS)
+		{
+			summary.OverBudget++;
+		}
+	}
+	std::sort(m_lSorted.begin(), m_lSorted.begin() + m_dCount);
+
+	// Nearest rank percentiles, matching the benchmark report.
+	float lPercents[3] = { 50.0f, 95.0f, 99.0f };
+	float lResults[3];
+	for (int i = 0; i < 3; i++)
+	{
+		int dRank = (int)(lPercents[i] / 100.0f * m_dCount + 0.5f);
+		dRank = std::min(std::max(dRank, 1), m_dCount);
+		lResults[i] = m_lSorted[dRank - 1];
+	}
+	summary.MeanMS = fTotal / m_dCount;
+	summary.P50MS = lResults[0];
+	summary.P95MS = lResults[1];
+	summary.P99MS = lResults[2];
+	summary.MaxMS = m_lSorted[m_dCount - 1];
+	return summary;
+}
+
+void FrameStats::GetHistogram(FrameStage a_eStage, float a_lBuckets[FRAME_STATS_BUCKETS])
+{
+	float fBucketMS = m_fBudgetMS * 2.0f / FRAME_STATS_BUCKETS;
+	for (int i = 0; i < FRAME_STATS_BUCKETS; i++)
+	{
+		a_lBuckets[i] = 0.0f;
+	}
+	const std::vector<float>& lSamples = m_lSamples[a_eStage];
+	for (int i = 0; i < m_dCount; i++)
+	{
+		int dBucket = std::min((int)(lSamples[i] / fBucketMS), FRAME_STATS_BUCKETS - 1);
+		a_lBuckets[std::max(dBucket, 0)] += 1.0f;
+	}
+}
+
+bool FrameStats::ExportCSV(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the frame statistics to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	writer << "index";
+	for (int s = 0; s < STAGE_COUNT; s++)
+	{
+		writer << "," << GetStageName((FrameStage)s) << "_ms";
+	}
+	writer << "\n";
+
+	// Oldest frame first.
+	int dOffset = GetOffset();
+	for (int i = 0; i < m_dCount; i++)
+	{
+		int dIndex = (dOffset + i) % (int)m_lSorted.size();
+		writer << i;
+		for (int s = 0; s < STAGE_COUNT; s++)
+		{
+			writer << "," << m_lSamples[s][dIndex];
+		}
+		writer << "\n";
+	}
+	return true;
+}
+
+bool FrameStats::ExportJSON(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the frame statistics to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	writer << "{\n";
+	writer << "\t\"frames\": " << m_dCount << ",\n";
+	writer << "\t\"budget_ms\": " << m_fBudgetMS << ",\n";
+	writer << "\t\"over_budget\": " << GetSummary(STAGE_FRAME).OverBudget << ",\n";
+	writer << "\t\"stages\": {";
+	for (int s = 0; s < STAGE_COUNT; s++)
+	{
+		FrameSummary summary = GetSummary((FrameStage)s);
+		writer << (s == 0 ? "\n" : ",\n") << "\t\t\"" << GetStageName((FrameStage)s) << "\": {"
+			<< " \"mean_ms\": " << summary.MeanMS
+			<< ", \"p50_ms\": " << summary.P50MS
+			<< ", \"p95_ms\": " << summary.P95MS
+			<< ", \"p99_ms\": " << summary.P99MS
+			<< ", \"max_ms\": " << summary.MaxMS << " }";
+	}
+	writer << "\n\t},\n";
+
+	float lBuckets[FRAME_STATS_BUCKETS];
+	GetHistogram(STAGE_FRAME, lBuckets);
+	writer << "\t\"histogram_bucket_ms\": " << m_fBudgetMS * 2.0f / FRAME_STATS_BUCKETS << ",\n";
+	writer << "\t\"histogram\": [";
+	for (int i = 0; i < FRAME_STATS_BUCKETS; i++)
+	{
+		writer << (i == 0 ? "" : ", ") << (int)lBuckets[i];
+	}
+	writer << "]\n}\n";
+	return true;
+}
+
+const char* FrameStats::GetStageName(FrameStage a_eStage)
+{
+	switch (a_eStage)
+	{
+	case STAGE_FRAME: return "frame";
+	case STAGE_SIMULATION: return "simulation";
+	case STAGE_RENDER: return "render";
+	case STAGE_RECORD: return "record";
+	case STAGE_GPU: return "gpu";
+	case STAGE_WAIT: return "wait";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,160 @@
+#ifndef __FRAMESTATS_H_
+#define __FRAMESTATS_H_
+
+#include <string>
+#include <vector>
+
+// Frames kept in the rolling window.
+#define FRAME_STATS_WINDOW 1024
+
+// Buckets of the histogram.  They span twice the budget, with the last one catching everything slower.
+#define FRAME_STATS_BUCKETS 32
+
+// Default frame time budget, a 60 Hz frame.
+#define FRAME_STATS_BUDGET_MS (1000.0f / 60.0f)
+
+/// <summary>
+/// The parts of a frame timed separately.
+/// </summary>
+enum FrameStage
+{
+	STAGE_FRAME = 0,		// Time between presents.
+	STAGE_SIMULATION,		// Simulating and building the packet.
+	STAGE_RENDER,			// Submitting the frame's GL work.
+	STAGE_RECORD,			// Recording the command lists, part of rendering.
+	STAGE_GPU,				// GPU time of the frame graph, when the GPU profiler is on.
+	STAGE_WAIT,				// Time the frame pacer waited.
+	STAGE_COUNT
+};
+
+/// <summary>
+/// Distribution of one stage over the window.
+/// </summary>
+struct FrameSummary
+{
+	float MeanMS;
+	float P50MS;
+	float P95MS;
+	float P99MS;
+	float MaxMS;
+	int OverBudget;			// Samples above the budget.
+};
+
+/// <summary>
+/// Keeps the last frames' times per stage so stutters show up as percentiles and a
+/// histogram instead of vanishing into an average.  Only touched by one thread.
+/// </summary>
+class FrameStats
+{
+private:
+	std::vector<float> m_lSamples[STAGE_COUNT];
+	std::vector<float> m_lSorted;	// Scratch space of the summaries, sized once.
+	int m_dCount = 0;
+	int m_dNext = 0;
+	float m_fBudgetMS = FRAME_STATS_BUDGET_MS;
+	unsigned long long m_uTotalFrames = 0;
+	unsigned long long m_uTotalOverBudget = 0;
+
+public:
+	/// <summary>
+	/// Constructs FrameStats with an empty window.
+	/// </summary>
+	/// <param name="a_dWindow">Number of frames kept.</param>
+	FrameStats(int a_dWindow = FRAME_STATS_WINDOW);
+
+	/// <summary>
+	/// Copy constructor of FrameStats.
+	/// </summary>
+	FrameStats(const FrameStats& a_pOther);
+
+	/// <summary>
+	/// Copy operator of FrameStats.
+	/// </summary>
+	FrameStats& operator=(const FrameStats& a_pOther);
+
+	/// <summary>
+	/// Adds a finished frame, overwriting the oldest once the window is full.
+	/// </summary>
+	/// <param name="a_lStages">Time of every stage in milliseconds, indexed by FrameStage.</param>
+	void AddFrame(const float a_lStages[STAGE_COUNT]);
+
+	/// <summary>
+	/// Empties the window and the totals.
+	/// </summary>
+	void Reset(void);
+
+	/// <summary>
+	/// Changes how many frames are kept.  Empties the window.
+	/// </summary>
+	void SetWindow(int a_dWindow);
+
+	/// <summary>
+	/// Gets how many frames are kept.
+	/// </summary>
+	int GetWindow(void);
+
+	/// <summary>
+	/// Gets how many frames are in the window.
+	/// </summary>
+	int GetCount(void);
+
+	/// <summary>
+	/// Sets the frame time budget frames are counted against.
+	/// </summary>
+	void SetBudget(float a_fMilliseconds);
+
+	/// <summary>
+	/// Gets the frame time budget.
+	/// </summary>
+	float GetBudget(void);
+
+	/// <summary>
+	/// Gets the frames added since the last reset.
+	/// </summary>
+	unsigned long long GetTotalFrames(void);
+
+	/// <summary>
+	/// Gets the frames over budget since the last reset.
+	/// </summary>
+	unsigned long long GetTotalOverBudget(void);
+
+	/// <summary>
+	/// Computes the percentiles of a stage over the window.
+	/// </summary>
+	FrameSummary GetSummary(FrameStage a_eStage);
+
+	/// <summary>
+	/// Gets the ring of a stage's samples.  Start reading at GetOffset to go from oldest to newest.
+	/// </summary>
+	const float* GetSamples(FrameStage a_eStage);
+
+	/// <summary>
+	/// Gets the index of the oldest sample in the ring.
+	/// </summary>
+	int GetOffset(void);
+
+	/// <summary>
+	/// Counts the samples of a stage falling in FRAME_STATS_BUCKETS buckets from 0 to twice the budget.
+	/// </summary>
+	/// <param name="a_lBuckets">Receives the count of every bucket.</param>
+	void GetHistogram(FrameStage a_eStage, float a_lBuckets[FRAME_STATS_BUCKETS]);
+
+	/// <summary>
+	/// Writes every frame in the window as a row of stage times.
+	/// </summary>
+	/// <returns>False if the file cannot be written.</returns>
+	bool ExportCSV(const std::string& a_sFilepath);
+
+	/// <summary>
+	/// Writes the summary of every stage and the frame time histogram.
+	/// </summary>
+	/// <returns>False if the file cannot be written.</returns>
+	bool ExportJSON(const std::string& a_sFilepath);
+
+	/// <summary>
+	/// Gets the display name of a stage.
+	/// </summary>
+	static const char* GetStageName(FrameStage a_eStage);
+};
+
+#endif //__FRAMESTATS_H_
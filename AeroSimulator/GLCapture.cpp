@@ -0,0 +1,1253 @@
+#define GL_CAPTURE_NO_REDIRECT
+#include "GLCapture.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+PFNGLCAPTUREENABLEPROC __glcaptureEnable = glEnable;
+PFNGLCAPTUREDISABLEPROC __glcaptureDisable = glDisable;
+PFNGLCAPTUREBLENDFUNCPROC __glcaptureBlendFunc = glBlendFunc;
+PFNGLCAPTUREDEPTHFUNCPROC __glcaptureDepthFunc = glDepthFunc;
+PFNGLCAPTUREDEPTHMASKPROC __glcaptureDepthMask = glDepthMask;
+PFNGLCAPTURECOLORMASKPROC __glcaptureColorMask = glColorMask;
+PFNGLCAPTUREPOLYGONMODEPROC __glcapturePolygonMode = glPolygonMode;
+PFNGLCAPTURECLEARCOLORPROC __glcaptureClearColor = glClearColor;
+PFNGLCAPTURECLEARPROC __glcaptureClear = glClear;
+PFNGLCAPTUREVIEWPORTPROC __glcaptureViewport = glViewport;
+PFNGLCAPTUREDRAWARRAYSPROC __glcaptureDrawArrays = glDrawArrays;
+PFNGLCAPTUREDRAWBUFFERPROC __glcaptureDrawBuffer = glDrawBuffer;
+PFNGLCAPTUREFLUSHPROC __glcaptureFlush = glFlush;
+PFNGLCAPTUREFINISHPROC __glcaptureFinish = glFinish;
+PFNGLCAPTUREGENTEXTURESPROC __glcaptureGenTextures = glGenTextures;
+PFNGLCAPTUREDELETETEXTURESPROC __glcaptureDeleteTextures = glDeleteTextures;
+PFNGLCAPTUREBINDTEXTUREPROC __glcaptureBindTexture = glBindTexture;
+PFNGLCAPTURETEXPARAMETERIPROC __glcaptureTexParameteri = glTexParameteri;
+PFNGLCAPTURETEXPARAMETERFPROC __glcaptureTexParameterf = glTexParameterf;
+PFNGLCAPTURETEXIMAGE2DPROC __glcaptureTexImage2D = glTexImage2D;
+PFNGLCAPTURETEXSUBIMAGE2DPROC __glcaptureTexSubImage2D = glTexSubImage2D;
+
+// Every GLEW loaded function that is hooked.  Their driver pointers are kept in s_pfn<name>.
+#define GL_CAPTURE_GLEW_FUNCTIONS(X) \
+	X(ActiveTexture) X(TexStorage2D) X(TexStorage3D) X(CompressedTexImage2D) X(CompressedTexSubImage2D) \
+	X(CopyImageSubData) X(GenBuffers) X(DeleteBuffers) X(BindBuffer) X(BindBufferBase) X(BufferData) \
+	X(MapBufferRange) X(FlushMappedBufferRange) X(UnmapBuffer) X(GenVertexArrays) X(DeleteVertexArrays) \
+	X(BindVertexArray) X(EnableVertexAttribArray) X(VertexAttribPointer) X(GenFramebuffers) \
+	X(DeleteFramebuffers) X(BindFramebuffer) X(FramebufferTexture2D) X(GenRenderbuffers) \
+	X(DeleteRenderbuffers) X(BindRenderbuffer) X(RenderbufferStorage) X(FramebufferRenderbuffer) \
+	X(DrawBuffers) X(BlitFramebuffer) X(CreateShader) X(ShaderSource) X(CompileShader) X(DeleteShader) \
+	X(CreateProgram) X(AttachShader) X(DetachShader) X(LinkProgram) X(DeleteProgram) X(ProgramParameteri) \
+	X(UseProgram) X(GetUniformLocation) X(Uniform1i) X(Uniform1iv) X(Uniform4fv) X(UniformMatrix4fv) X(GenQueries) \
+	X(DeleteQueries) X(BeginQuery) X(EndQuery) X(QueryCounter) X(GetQueryObjectui64v) X(FenceSync) \
+	X(ClientWaitSync) X(DeleteSync) X(MemoryBarrier)
+
+#define GL_CAPTURE_DECLARE(name) static decltype(__glew##name) s_pfn##name = nullptr;
+GL_CAPTURE_GLEW_FUNCTIONS(GL_CAPTURE_DECLARE)
+
+/// <summary>
+/// A buffer range mapped for writing, kept until it is flushed or unmapped.
+/// </summary>
+struct MappedRange
+{
+	GLenum Target;
+	const unsigned char* Data;
+	uint64_t Offset;
+	uint64_t Length;
+	GLbitfield Access;
+};
+
+// The hooks are free functions, so the capture's state lives here rather than in the class.
+static std::ofstream s_writer;
+static std::vector<unsigned char> s_lBuffer;
+static std::string s_sFilepath;
+static GLCaptureHeader s_header;
+static uint32_t s_uFrame = 0;
+static uint32_t s_uLastFrame = 0;
+static bool s_bIsOpen = false;
+static bool s_bIsCapturing = false;
+static GLuint s_uUnpackBuffer = 0;
+static std::vector<MappedRange> s_lMapped;
+
+// - - Writing - -
+
+/// <summary>
+/// Writes out the buffered calls.
+/// </summary>
+static void FlushBuffer(void)
+{
+	if (s_lBuffer.empty()) return;
+	s_writer.write((const char*)s_lBuffer.data(), s_lBuffer.size());
+	s_lBuffer.clear();
+}
+
+template <typename T>
+static void Put(T a_value)
+{
+	size_t uSize = s_lBuffer.size();
+	s_lBuffer.resize(uSize + sizeof(T));
+	memcpy(&s_lBuffer[uSize], &a_value, sizeof(T));
+}
+
+/// <summary>
+/// Writes a length and the bytes.  Large data skips the buffer.
+/// </summary>
+static void PutData(const void* a_pData, size_t a_uBytes)
+{
+	Put<uint32_t>((uint32_t)a_uBytes);
+	if (a_uBytes >= GL_CAPTURE_FLUSH_BYTES)
+	{
+		FlushBuffer();
+		s_writer.write((const char*)a_pData, a_uBytes);
+		return;
+	}
+	size_t uSize = s_lBuffer.size();
+	s_lBuffer.resize(uSize + a_uBytes);
+	memcpy(&s_lBuffer[uSize], a_pData, a_uBytes);
+}
+
+/// <summary>
+/// Writes a count and that many names.
+/// </summary>
+static void PutNames(GLsizei a_dCount, const GLuint* a_pNames)
+{
+	Put<int32_t>(a_dCount);
+	for (GLsizei i = 0; i < a_dCount; i++)
+	{
+		Put<uint32_t>(a_pNames[i]);
+	}
+}
+
+/// <summary>
+/// Calls that only matter to the frame they are made in.  Frames before the
+/// first captured one drop them, keeping only what the captured frames build on.
+/// </summary>
+static bool IsFrameLocal(GLCaptureOp a_eOp)
+{
+	switch (a_eOp)
+	{
+	case GLC_CLEAR:
+	case GLC_DRAW_ARRAYS:
+	case GLC_BLIT_FRAMEBUFFER:
+	case GLC_UNIFORM_4FV:
+	case GLC_UNIFORM_MATRIX_4FV:
+	case GLC_BEGIN_QUERY:
+	case GLC_END_QUERY:
+	case GLC_QUERY_COUNTER:
+	case GLC_GET_QUERY_OBJECT:
+	case GLC_FENCE_SYNC:
+	case GLC_CLIENT_WAIT_SYNC:
+	case GLC_FLUSH:
+	case GLC_FINISH:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/// <summary>
+/// Starts recording a call.
+/// </summary>
+/// <returns>False if the call is not recorded.</returns>
+static bool BeginCall(GLCaptureOp a_eOp)
+{
+	if (!s_bIsCapturing) return false;
+	if (s_uFrame < s_header.FirstFrame && IsFrameLocal(a_eOp)) return false;
+
+	Put<uint16_t>((uint16_t)a_eOp);
+	s_header.Calls++;
+	return true;
+}
+
+/// <summary>
+/// Bytes of one pixel of uncompressed data.
+/// </summary>
+static size_t GetPixelBytes(GLenum a_eFormat, GLenum a_eType)
+{
+	switch (a_eType)
+	{
+	case GL_UNSIGNED_SHORT_5_6_5:
+	case GL_UNSIGNED_SHORT_4_4_4_4:
+	case GL_UNSIGNED_SHORT_5_5_5_1:
+		return 2;
+	case GL_UNSIGNED_INT_8_8_8_8:
+	case GL_UNSIGNED_INT_8_8_8_8_REV:
+	case GL_UNSIGNED_INT_2_10_10_10_REV:
+	case GL_UNSIGNED_INT_24_8:
+	case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		return 4;
+	}
+
+	size_t uComponents = 4;
+	switch (a_eFormat)
+	{
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		uComponents = 1;
+		break;
+	case GL_RG:
+	case GL_RG_INTEGER:
+		uComponents = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+	case GL_RGB_INTEGER:
+		uComponents = 3;
+		break;
+	}
+
+	switch (a_eType)
+	{
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		return uComponents;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return uComponents * 2;
+	default:
+		return uComponents * 4;
+	}
+}
+
+/// <summary>
+/// Writes pixels read from memory, or their offset when an unpack buffer holds them.
+/// Rows are padded to the default unpack alignment of 4, which the engine never changes.
+/// </summary>
+static void PutPixels(GLsizei a_dWidth, GLsizei a_dHeight, GLenum a_eFormat, GLenum a_eType, const GLvoid* a_pPixels)
+{
+	if (s_uUnpackBuffer != 0)
+	{
+		Put<uint8_t>(1);
+		Put<uint64_t>((uint64_t)(uintptr_t)a_pPixels);
+		return;
+	}
+
+	Put<uint8_t>(0);
+	if (a_pPixels == nullptr || a_dWidth <= 0 || a_dHeight <= 0)
+	{
+		PutData(nullptr, 0);
+		return;
+	}
+	size_t uRow = (size_t)a_dWidth * GetPixelBytes(a_eFormat, a_eType);
+	size_t uStride = (uRow + 3) & ~(size_t)3;
+	PutData(a_pPixels, uStride * (a_dHeight - 1) + uRow);
+}
+
+/// <summary>
+/// Writes compressed data, or its offset when an unpack buffer holds it.
+/// </summary>
+static void PutCompressed(GLsizei a_dBytes, const GLvoid* a_pData)
+{
+	if (s_uUnpackBuffer != 0)
+	{
+		Put<uint8_t>(1);
+		Put<uint64_t>((uint64_t)(uintptr_t)a_pData);
+		return;
+	}
+	Put<uint8_t>(0);
+	PutData(a_pData, a_pData != nullptr ? a_dBytes : 0);
+}
+
+/// <summary>
+/// Finds the mapped range of a target, or nullptr.
+/// </summary>
+static MappedRange* FindMapped(GLenum a_eTarget)
+{
+	for (int i = 0; i < s_lMapped.size(); i++)
+	{
+		if (s_lMapped[i].Target == a_eTarget) return &s_lMapped[i];
+	}
+	return nullptr;
+}
+
+// - - GL 1.1 hooks - -
+
+static void GLAPIENTRY HookEnable(GLenum cap)
+{
+	if (BeginCall(GLC_ENABLE)) Put<uint32_t>(cap);
+	glEnable(cap);
+}
+
+static void GLAPIENTRY HookDisable(GLenum cap)
+{
+	if (BeginCall(GLC_DISABLE)) Put<uint32_t>(cap);
+	glDisable(cap);
+}
+
+static void GLAPIENTRY HookBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (BeginCall(GLC_BLEND_FUNC))
+	{
+		Put<uint32_t>(sfactor);
+		Put<uint32_t>(dfactor);
+	}
+	glBlendFunc(sfactor, dfactor);
+}
+
+static void GLAPIENTRY HookDepthFunc(GLenum func)
+{
+	if (BeginCall(GLC_DEPTH_FUNC)) Put<uint32_t>(func);
+	glDepthFunc(func);
+}
+
+static void GLAPIENTRY HookDepthMask(GLboolean flag)
+{
+	if (BeginCall(GLC_DEPTH_MASK)) Put<uint8_t>(flag);
+	glDepthMask(flag);
+}
+
+static void GLAPIENTRY HookColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+	if (BeginCall(GLC_COLOR_MASK))
+	{
+		Put<uint8_t>(red);
+		Put<uint8_t>(green);
+		Put<uint8_t>(blue);
+		Put<uint8_t>(alpha);
+	}
+	glColorMask(red, green, blue, alpha);
+}
+
+static void GLAPIENTRY HookPolygonMode(GLenum face, GLenum mode)
+{
+	if (BeginCall(GLC_POLYGON_MODE))
+	{
+		Put<uint32_t>(face);
+		Put<uint32_t>(mode);
+	}
+	glPolygonMode(face, mode);
+}
+
+static void GLAPIENTRY HookClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+	if (BeginCall(GLC_CLEAR_COLOR))
+	{
+		Put<float>(red);
+		Put<float>(green);
+		Put<float>(blue);
+		Put<float>(alpha);
+	}
+	glClearColor(red, green, blue, alpha);
+}
+
+static void GLAPIENTRY HookClear(GLbitfield mask)
+{
+	if (BeginCall(GLC_CLEAR)) Put<uint32_t>(mask);
+	glClear(mask);
+}
+
+static void GLAPIENTRY HookViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (BeginCall(GLC_VIEWPORT))
+	{
+		Put<int32_t>(x);
+		Put<int32_t>(y);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+	}
+	glViewport(x, y, width, height);
+}
+
+static void GLAPIENTRY HookDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	if (BeginCall(GLC_DRAW_ARRAYS))
+	{
+		Put<uint32_t>(mode);
+		Put<int32_t>(first);
+		Put<int32_t>(count);
+	}
+	glDrawArrays(mode, first, count);
+}
+
+static void GLAPIENTRY HookDrawBuffer(GLenum mode)
+{
+	if (BeginCall(GLC_DRAW_BUFFER)) Put<uint32_t>(mode);
+	glDrawBuffer(mode);
+}
+
+static void GLAPIENTRY HookFlush(void)
+{
+	BeginCall(GLC_FLUSH);
+	glFlush();
+}
+
+static void GLAPIENTRY HookFinish(void)
+{
+	BeginCall(GLC_FINISH);
+	glFinish();
+}
+
+static void GLAPIENTRY HookGenTextures(GLsizei n, GLuint* textures)
+{
+	glGenTextures(n, textures);
+	if (BeginCall(GLC_GEN_TEXTURES)) PutNames(n, textures);
+}
+
+static void GLAPIENTRY HookDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	if (BeginCall(GLC_DELETE_TEXTURES)) PutNames(n, textures);
+	glDeleteTextures(n, textures);
+}
+
+static void GLAPIENTRY HookBindTexture(GLenum target, GLuint texture)
+{
+	if (BeginCall(GLC_BIND_TEXTURE))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(texture);
+	}
+	glBindTexture(target, texture);
+}
+
+static void GLAPIENTRY HookTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	if (BeginCall(GLC_TEX_PARAMETER_I))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(pname);
+		Put<int32_t>(param);
+	}
+	glTexParameteri(target, pname, param);
+}
+
+static void GLAPIENTRY HookTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+	if (BeginCall(GLC_TEX_PARAMETER_F))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(pname);
+		Put<float>(param);
+	}
+	glTexParameterf(target, pname, param);
+}
+
+static void GLAPIENTRY HookTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+	GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+	if (BeginCall(GLC_TEX_IMAGE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(level);
+		Put<int32_t>(internalformat);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+		Put<int32_t>(border);
+		Put<uint32_t>(format);
+		Put<uint32_t>(type);
+		PutPixels(width, height, format, type, pixels);
+	}
+	glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+static void GLAPIENTRY HookTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, const GLvoid* pixels)
+{
+	if (BeginCall(GLC_TEX_SUB_IMAGE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(level);
+		Put<int32_t>(xoffset);
+		Put<int32_t>(yoffset);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+		Put<uint32_t>(format);
+		Put<uint32_t>(type);
+		PutPixels(width, height, format, type, pixels);
+	}
+	glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+// - - GLEW hooks - -
+
+static void GLAPIENTRY HookActiveTexture(GLenum texture)
+{
+	if (BeginCall(GLC_ACTIVE_TEXTURE)) Put<uint32_t>(texture);
+	s_pfnActiveTexture(texture);
+}
+
+static void GLAPIENTRY HookTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+	if (BeginCall(GLC_TEX_STORAGE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(levels);
+		Put<uint32_t>(internalformat);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+	}
+	s_pfnTexStorage2D(target, levels, internalformat, width, height);
+}
+
+static void GLAPIENTRY HookTexStorage3D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth)
+{
+	if (BeginCall(GLC_TEX_STORAGE_3D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(levels);
+		Put<uint32_t>(internalformat);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+		Put<int32_t>(depth);
+	}
+	s_pfnTexStorage3D(target, levels, internalformat, width, height, depth);
+}
+
+static void GLAPIENTRY HookCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+	GLint border, GLsizei imageSize, const GLvoid* data)
+{
+	if (BeginCall(GLC_COMPRESSED_TEX_IMAGE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(level);
+		Put<uint32_t>(internalformat);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+		Put<int32_t>(border);
+		Put<int32_t>(imageSize);
+		PutCompressed(imageSize, data);
+	}
+	s_pfnCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+
+static void GLAPIENTRY HookCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+	GLenum format, GLsizei imageSize, const GLvoid* data)
+{
+	if (BeginCall(GLC_COMPRESSED_TEX_SUB_IMAGE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<int32_t>(level);
+		Put<int32_t>(xoffset);
+		Put<int32_t>(yoffset);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+		Put<uint32_t>(format);
+		Put<int32_t>(imageSize);
+		PutCompressed(imageSize, data);
+	}
+	s_pfnCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+}
+
+static void GLAPIENTRY HookCopyImageSubData(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ,
+	GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth)
+{
+	if (BeginCall(GLC_COPY_IMAGE_SUB_DATA))
+	{
+		Put<uint32_t>(srcName);
+		Put<uint32_t>(srcTarget);
+		Put<int32_t>(srcLevel);
+		Put<int32_t>(srcX);
+		Put<int32_t>(srcY);
+		Put<int32_t>(srcZ);
+		Put<uint32_t>(dstName);
+		Put<uint32_t>(dstTarget);
+		Put<int32_t>(dstLevel);
+		Put<int32_t>(dstX);
+		Put<int32_t>(dstY);
+		Put<int32_t>(dstZ);
+		Put<int32_t>(srcWidth);
+		Put<int32_t>(srcHeight);
+		Put<int32_t>(srcDepth);
+	}
+	s_pfnCopyImageSubData(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth);
+}
+
+static void GLAPIENTRY HookGenBuffers(GLsizei n, GLuint* buffers)
+{
+	s_pfnGenBuffers(n, buffers);
+	if (BeginCall(GLC_GEN_BUFFERS)) PutNames(n, buffers);
+}
+
+static void GLAPIENTRY HookDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	if (BeginCall(GLC_DELETE_BUFFERS)) PutNames(n, buffers);
+	s_pfnDeleteBuffers(n, buffers);
+}
+
+static void GLAPIENTRY HookBindBuffer(GLenum target, GLuint buffer)
+{
+	// Texture uploads read an offset instead of memory while an unpack buffer is bound.
+	if (target == GL_PIXEL_UNPACK_BUFFER) s_uUnpackBuffer = buffer;
+	if (BeginCall(GLC_BIND_BUFFER))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(buffer);
+	}
+	s_pfnBindBuffer(target, buffer);
+}
+
+static void GLAPIENTRY HookBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	if (BeginCall(GLC_BIND_BUFFER_BASE))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(index);
+		Put<uint32_t>(buffer);
+	}
+	s_pfnBindBufferBase(target, index, buffer);
+}
+
+static void GLAPIENTRY HookBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+	if (BeginCall(GLC_BUFFER_DATA))
+	{
+		Put<uint32_t>(target);
+		Put<uint64_t>((uint64_t)size);
+		Put<uint32_t>(usage);
+		PutData(data, data != nullptr ? (size_t)size : 0);
+	}
+	s_pfnBufferData(target, size, data, usage);
+}
+
+static GLvoid* GLAPIENTRY HookMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	GLvoid* pMapped = s_pfnMapBufferRange(target, offset, length, access);
+	if (BeginCall(GLC_MAP_BUFFER_RANGE))
+	{
+		Put<uint32_t>(target);
+		Put<uint64_t>((uint64_t)offset);
+		Put<uint64_t>((uint64_t)length);
+		Put<uint32_t>(access);
+	}
+
+	// Only written ranges are worth keeping, their bytes are read back at flush or unmap.
+	if (pMapped != nullptr && (access & GL_MAP_WRITE_BIT))
+	{
+		MappedRange range = { target, (const unsigned char*)pMapped, (uint64_t)offset, (uint64_t)length, access };
+		s_lMapped.push_back(range);
+	}
+	return pMapped;
+}
+
+static void GLAPIENTRY HookFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+	MappedRange* pRange = FindMapped(target);
+	if (BeginCall(GLC_FLUSH_MAPPED_BUFFER_RANGE))
+	{
+		Put<uint32_t>(target);
+		Put<uint64_t>((uint64_t)offset);
+		PutData(pRange != nullptr ? pRange->Data + offset : nullptr, pRange != nullptr ? (size_t)length : 0);
+	}
+	s_pfnFlushMappedBufferRange(target, offset, length);
+}
+
+static GLboolean GLAPIENTRY HookUnmapBuffer(GLenum target)
+{
+	MappedRange* pRange = FindMapped(target);
+	if (BeginCall(GLC_UNMAP_BUFFER))
+	{
+		// Explicitly flushed ranges were written at their flush.
+		bool bHasData = pRange != nullptr && !(pRange->Access & GL_MAP_FLUSH_EXPLICIT_BIT);
+		Put<uint32_t>(target);
+		PutData(bHasData ? pRange->Data : nullptr, bHasData ? (size_t)pRange->Length : 0);
+	}
+	if (pRange != nullptr)
+	{
+		s_lMapped.erase(s_lMapped.begin() + (pRange - &s_lMapped[0]));
+	}
+	return s_pfnUnmapBuffer(target);
+}
+
+static void GLAPIENTRY HookGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+	s_pfnGenVertexArrays(n, arrays);
+	if (BeginCall(GLC_GEN_VERTEX_ARRAYS)) PutNames(n, arrays);
+}
+
+static void GLAPIENTRY HookDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	if (BeginCall(GLC_DELETE_VERTEX_ARRAYS)) PutNames(n, arrays);
+	s_pfnDeleteVertexArrays(n, arrays);
+}
+
+static void GLAPIENTRY HookBindVertexArray(GLuint array)
+{
+	if (BeginCall(GLC_BIND_VERTEX_ARRAY)) Put<uint32_t>(array);
+	s_pfnBindVertexArray(array);
+}
+
+static void GLAPIENTRY HookEnableVertexAttribArray(GLuint index)
+{
+	if (BeginCall(GLC_ENABLE_VERTEX_ATTRIB_ARRAY)) Put<uint32_t>(index);
+	s_pfnEnableVertexAttribArray(index);
+}
+
+static void GLAPIENTRY HookVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+	// The engine always sources attributes from a bound buffer, so the pointer is an offset.
+	if (BeginCall(GLC_VERTEX_ATTRIB_POINTER))
+	{
+		Put<uint32_t>(index);
+		Put<int32_t>(size);
+		Put<uint32_t>(type);
+		Put<uint8_t>(normalized);
+		Put<int32_t>(stride);
+		Put<uint64_t>((uint64_t)(uintptr_t)pointer);
+	}
+	s_pfnVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+static void GLAPIENTRY HookGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+	s_pfnGenFramebuffers(n, framebuffers);
+	if (BeginCall(GLC_GEN_FRAMEBUFFERS)) PutNames(n, framebuffers);
+}
+
+static void GLAPIENTRY HookDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	if (BeginCall(GLC_DELETE_FRAMEBUFFERS)) PutNames(n, framebuffers);
+	s_pfnDeleteFramebuffers(n, framebuffers);
+}
+
+static void GLAPIENTRY HookBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	if (BeginCall(GLC_BIND_FRAMEBUFFER))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(framebuffer);
+	}
+	s_pfnBindFramebuffer(target, framebuffer);
+}
+
+static void GLAPIENTRY HookFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+	if (BeginCall(GLC_FRAMEBUFFER_TEXTURE_2D))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(attachment);
+		Put<uint32_t>(textarget);
+		Put<uint32_t>(texture);
+		Put<int32_t>(level);
+	}
+	s_pfnFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+static void GLAPIENTRY HookGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+	s_pfnGenRenderbuffers(n, renderbuffers);
+	if (BeginCall(GLC_GEN_RENDERBUFFERS)) PutNames(n, renderbuffers);
+}
+
+static void GLAPIENTRY HookDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+	if (BeginCall(GLC_DELETE_RENDERBUFFERS)) PutNames(n, renderbuffers);
+	s_pfnDeleteRenderbuffers(n, renderbuffers);
+}
+
+static void GLAPIENTRY HookBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+	if (BeginCall(GLC_BIND_RENDERBUFFER))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(renderbuffer);
+	}
+	s_pfnBindRenderbuffer(target, renderbuffer);
+}
+
+static void GLAPIENTRY HookRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+	if (BeginCall(GLC_RENDERBUFFER_STORAGE))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(internalformat);
+		Put<int32_t>(width);
+		Put<int32_t>(height);
+	}
+	s_pfnRenderbufferStorage(target, internalformat, width, height);
+}
+
+static void GLAPIENTRY HookFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+	if (BeginCall(GLC_FRAMEBUFFER_RENDERBUFFER))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(attachment);
+		Put<uint32_t>(renderbuffertarget);
+		Put<uint32_t>(renderbuffer);
+	}
+	s_pfnFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+
+static void GLAPIENTRY HookDrawBuffers(GLsizei n, const GLenum* bufs)
+{
+	if (BeginCall(GLC_DRAW_BUFFERS)) PutNames(n, bufs);
+	s_pfnDrawBuffers(n, bufs);
+}
+
+static void GLAPIENTRY HookBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1,
+	GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+	if (BeginCall(GLC_BLIT_FRAMEBUFFER))
+	{
+		Put<int32_t>(srcX0);
+		Put<int32_t>(srcY0);
+		Put<int32_t>(srcX1);
+		Put<int32_t>(srcY1);
+		Put<int32_t>(dstX0);
+		Put<int32_t>(dstY0);
+		Put<int32_t>(dstX1);
+		Put<int32_t>(dstY1);
+		Put<uint32_t>(mask);
+		Put<uint32_t>(filter);
+	}
+	s_pfnBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+static GLuint GLAPIENTRY HookCreateShader(GLenum type)
+{
+	GLuint uShader = s_pfnCreateShader(type);
+	if (BeginCall(GLC_CREATE_SHADER))
+	{
+		Put<uint32_t>(type);
+		Put<uint32_t>(uShader);
+	}
+	return uShader;
+}
+
+static void GLAPIENTRY HookShaderSource(GLuint shader, GLsizei count, const GLchar** strings, const GLint* lengths)
+{
+	if (BeginCall(GLC_SHADER_SOURCE))
+	{
+		// Joined into one string, which is what the compiler sees.
+		std::string sSource;
+		for (GLsizei i = 0; i < count; i++)
+		{
+			if (lengths != nullptr && lengths[i] >= 0) sSource.append(strings[i], lengths[i]);
+			else sSource.append(strings[i]);
+		}
+		Put<uint32_t>(shader);
+		PutData(sSource.data(), sSource.size());
+	}
+	s_pfnShaderSource(shader, count, strings, lengths);
+}
+
+static void GLAPIENTRY HookCompileShader(GLuint shader)
+{
+	if (BeginCall(GLC_COMPILE_SHADER)) Put<uint32_t>(shader);
+	s_pfnCompileShader(shader);
+}
+
+static void GLAPIENTRY HookDeleteShader(GLuint shader)
+{
+	if (BeginCall(GLC_DELETE_SHADER)) Put<uint32_t>(shader);
+	s_pfnDeleteShader(shader);
+}
+
+static GLuint GLAPIENTRY HookCreateProgram(void)
+{
+	GLuint uProgram = s_pfnCreateProgram();
+	if (BeginCall(GLC_CREATE_PROGRAM)) Put<uint32_t>(uProgram);
+	return uProgram;
+}
+
+static void GLAPIENTRY HookAttachShader(GLuint program, GLuint shader)
+{
+	if (BeginCall(GLC_ATTACH_SHADER))
+	{
+		Put<uint32_t>(program);
+		Put<uint32_t>(shader);
+	}
+	s_pfnAttachShader(program, shader);
+}
+
+static void GLAPIENTRY HookDetachShader(GLuint program, GLuint shader)
+{
+	if (BeginCall(GLC_DETACH_SHADER))
+	{
+		Put<uint32_t>(program);
+		Put<uint32_t>(shader);
+	}
+	s_pfnDetachShader(program, shader);
+}
+
+static void GLAPIENTRY HookLinkProgram(GLuint program)
+{
+	if (BeginCall(GLC_LINK_PROGRAM)) Put<uint32_t>(program);
+	s_pfnLinkProgram(program);
+}
+
+static void GLAPIENTRY HookDeleteProgram(GLuint program)
+{
+	if (BeginCall(GLC_DELETE_PROGRAM)) Put<uint32_t>(program);
+	s_pfnDeleteProgram(program);
+}
+
+static void GLAPIENTRY HookProgramParameteri(GLuint program, GLenum pname, GLint value)
+{
+	if (BeginCall(GLC_PROGRAM_PARAMETER_I))
+	{
+		Put<uint32_t>(program);
+		Put<uint32_t>(pname);
+		Put<int32_t>(value);
+	}
+	s_pfnProgramParameteri(program, pname, value);
+}
+
+static void GLAPIENTRY HookUseProgram(GLuint program)
+{
+	if (BeginCall(GLC_USE_PROGRAM)) Put<uint32_t>(program);
+	s_pfnUseProgram(program);
+}
+
+static GLint GLAPIENTRY HookGetUniformLocation(GLuint program, const GLchar* name)
+{
+	GLint dLocation = s_pfnGetUniformLocation(program, name);
+	if (BeginCall(GLC_GET_UNIFORM_LOCATION))
+	{
+		Put<uint32_t>(program);
+		PutData(name, strlen(name));
+		Put<int32_t>(dLocation);
+	}
+	return dLocation;
+}
+
+static void GLAPIENTRY HookUniform1i(GLint location, GLint v0)
+{
+	if (BeginCall(GLC_UNIFORM_1I))
+	{
+		Put<int32_t>(location);
+		Put<int32_t>(v0);
+	}
+	s_pfnUniform1i(location, v0);
+}
+
+static void GLAPIENTRY HookUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+	if (BeginCall(GLC_UNIFORM_1IV))
+	{
+		Put<int32_t>(location);
+		PutData(value, count * sizeof(GLint));
+	}
+	s_pfnUniform1iv(location, count, value);
+}
+
+static void GLAPIENTRY HookUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	if (BeginCall(GLC_UNIFORM_4FV))
+	{
+		Put<int32_t>(location);
+		PutData(value, count * 4 * sizeof(GLfloat));
+	}
+	s_pfnUniform4fv(location, count, value);
+}
+
+static void GLAPIENTRY HookUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+	if (BeginCall(GLC_UNIFORM_MATRIX_4FV))
+	{
+		Put<int32_t>(location);
+		Put<uint8_t>(transpose);
+		PutData(value, count * 16 * sizeof(GLfloat));
+	}
+	s_pfnUniformMatrix4fv(location, count, transpose, value);
+}
+
+static void GLAPIENTRY HookGenQueries(GLsizei n, GLuint* ids)
+{
+	s_pfnGenQueries(n, ids);
+	if (BeginCall(GLC_GEN_QUERIES)) PutNames(n, ids);
+}
+
+static void GLAPIENTRY HookDeleteQueries(GLsizei n, const GLuint* ids)
+{
+	if (BeginCall(GLC_DELETE_QUERIES)) PutNames(n, ids);
+	s_pfnDeleteQueries(n, ids);
+}
+
+static void GLAPIENTRY HookBeginQuery(GLenum target, GLuint id)
+{
+	if (BeginCall(GLC_BEGIN_QUERY))
+	{
+		Put<uint32_t>(target);
+		Put<uint32_t>(id);
+	}
+	s_pfnBeginQuery(target, id);
+}
+
+static void GLAPIENTRY HookEndQuery(GLenum target)
+{
+	if (BeginCall(GLC_END_QUERY)) Put<uint32_t>(target);
+	s_pfnEndQuery(target);
+}
+
+static void GLAPIENTRY HookQueryCounter(GLuint id, GLenum target)
+{
+	if (BeginCall(GLC_QUERY_COUNTER))
+	{
+		Put<uint32_t>(id);
+		Put<uint32_t>(target);
+	}
+	s_pfnQueryCounter(id, target);
+}
+
+static void GLAPIENTRY HookGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+	// Kept because reading a result can stall the CPU on the GPU.
+	if (BeginCall(GLC_GET_QUERY_OBJECT))
+	{
+		Put<uint32_t>(id);
+		Put<uint32_t>(pname);
+	}
+	s_pfnGetQueryObjectui64v(id, pname, params);
+}
+
+static GLsync GLAPIENTRY HookFenceSync(GLenum condition, GLbitfield flags)
+{
+	GLsync sync = s_pfnFenceSync(condition, flags);
+	if (BeginCall(GLC_FENCE_SYNC))
+	{
+		Put<uint32_t>(condition);
+		Put<uint32_t>(flags);
+		Put<uint64_t>((uint64_t)(uintptr_t)sync);
+	}
+	return sync;
+}
+
+static GLenum GLAPIENTRY HookClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	if (BeginCall(GLC_CLIENT_WAIT_SYNC))
+	{
+		Put<uint64_t>((uint64_t)(uintptr_t)sync);
+		Put<uint32_t>(flags);
+		Put<uint64_t>(timeout);
+	}
+	return s_pfnClientWaitSync(sync, flags, timeout);
+}
+
+static void GLAPIENTRY HookDeleteSync(GLsync sync)
+{
+	if (BeginCall(GLC_DELETE_SYNC)) Put<uint64_t>((uint64_t)(uintptr_t)sync);
+	s_pfnDeleteSync(sync);
+}
+
+static void GLAPIENTRY HookMemoryBarrier(GLbitfield barriers)
+{
+	if (BeginCall(GLC_MEMORY_BARRIER)) Put<uint32_t>(barriers);
+	s_pfnMemoryBarrier(barriers);
+}
+
+// - - GLCapture - -
+
+bool GLCapture::Open(const std::string& a_sFilepath, int a_dFirstFrame, int a_dFrames)
+{
+	Stop();
+	s_writer.open(a_sFilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!s_writer.is_open())
+	{
+		std::cout << "Could not write the GL capture to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	s_sFilepath = a_sFilepath;
+	memset(&s_header, 0, sizeof(s_header));
+	memcpy(s_header.Magic, GL_CAPTURE_MAGIC, sizeof(GL_CAPTURE_MAGIC));
+	s_header.Version = GL_CAPTURE_VERSION;
+	s_header.FirstFrame = a_dFirstFrame > 0 ? a_dFirstFrame : 0;
+	s_uLastFrame = s_header.FirstFrame + (a_dFrames > 0 ? a_dFrames : 1);
+	s_bIsOpen = true;
+	return true;
+}
+
+void GLCapture::Start(unsigned int a_uWidth, unsigned int a_uHeight, GLuint a_uDefaultFramebuffer)
+{
+	if (!s_bIsOpen || s_bIsCapturing) return;
+
+	s_header.Width = a_uWidth;
+	s_header.Height = a_uHeight;
+	s_header.DefaultFramebuffer = a_uDefaultFramebuffer;
+	s_uFrame = 0;
+	s_uUnpackBuffer = 0;
+	s_lMapped.clear();
+
+	// The header is rewritten with the counts once the capture ends, the driver follows it.
+	const char* sRenderer = (const char*)glGetString(GL_RENDERER);
+	const char* sVersion = (const char*)glGetString(GL_VERSION);
+	std::string sDriver = std::string(sRenderer ? sRenderer : "") + " | " + (sVersion ? sVersion : "");
+	s_writer.write((const char*)&s_header, sizeof(s_header));
+	PutData(sDriver.data(), sDriver.size());
+
+	__glcaptureEnable = HookEnable;
+	__glcaptureDisable = HookDisable;
+	__glcaptureBlendFunc = HookBlendFunc;
+	__glcaptureDepthFunc = HookDepthFunc;
+	__glcaptureDepthMask = HookDepthMask;
+	__glcaptureColorMask = HookColorMask;
+	__glcapturePolygonMode = HookPolygonMode;
+	__glcaptureClearColor = HookClearColor;
+	__glcaptureClear = HookClear;
+	__glcaptureViewport = HookViewport;
+	__glcaptureDrawArrays = HookDrawArrays;
+	__glcaptureDrawBuffer = HookDrawBuffer;
+	__glcaptureFlush = HookFlush;
+	__glcaptureFinish = HookFinish;
+	__glcaptureGenTextures = HookGenTextures;
+	__glcaptureDeleteTextures = HookDeleteTextures;
+	__glcaptureBindTexture = HookBindTexture;
+	__glcaptureTexParameteri = HookTexParameteri;
+	__glcaptureTexParameterf = HookTexParameterf;
+	__glcaptureTexImage2D = HookTexImage2D;
+	__glcaptureTexSubImage2D = HookTexSubImage2D;
+
+#define GL_CAPTURE_INSTALL(name) s_pfn##name = __glew##name; if (s_pfn##name != nullptr) __glew##name = Hook##name;
+	GL_CAPTURE_GLEW_FUNCTIONS(GL_CAPTURE_INSTALL)
+#undef GL_CAPTURE_INSTALL
+
+	s_bIsCapturing = true;
+	std::cout << "Capturing GL calls to " << s_sFilepath << " from frame " << s_header.FirstFrame
+		<< " to " << s_uLastFrame << "." << std::endl;
+}
+
+void GLCapture::EndFrame(void)
+{
+	if (!s_bIsCapturing) return;
+
+	Put<uint16_t>((uint16_t)GLC_FRAME);
+	s_uFrame++;
+	s_header.Frames = s_uFrame;
+	if (s_lBuffer.size() >= GL_CAPTURE_FLUSH_BYTES)
+	{
+		FlushBuffer();
+	}
+
+	if (s_uFrame >= s_uLastFrame)
+	{
+		Stop();
+	}
+}
+
+void GLCapture::Stop(void)
+{
+	if (s_bIsCapturing)
+	{
+		__glcaptureEnable = glEnable;
+		__glcaptureDisable = glDisable;
+		__glcaptureBlendFunc = glBlendFunc;
+		__glcaptureDepthFunc = glDepthFunc;
+		__glcaptureDepthMask = glDepthMask;
+		__glcaptureColorMask = glColorMask;
+		__glcapturePolygonMode = glPolygonMode;
+		__glcaptureClearColor = glClearColor;
+		__glcaptureClear = glClear;
+		__glcaptureViewport = glViewport;
+		__glcaptureDrawArrays = glDrawArrays;
+		__glcaptureDrawBuffer = glDrawBuffer;
+		__glcaptureFlush = glFlush;
+		__glcaptureFinish = glFinish;
+		__glcaptureGenTextures = glGenTextures;
+		__glcaptureDeleteTextures = glDeleteTextures;
+		__glcaptureBindTexture = glBindTexture;
+		__glcaptureTexParameteri = glTexParameteri;
+		__glcaptureTexParameterf = glTexParameterf;
+		__glcaptureTexImage2D = glTexImage2D;
+		__glcaptureTexSubImage2D = glTexSubImage2D;
+
+#define GL_CAPTURE_REMOVE(name) if (s_pfn##name != nullptr) __glew##name = s_pfn##name;
+		GL_CAPTURE_GLEW_FUNCTIONS(GL_CAPTURE_REMOVE)
+#undef GL_CAPTURE_REMOVE
+
+		s_bIsCapturing = false;
+		FlushBuffer();
+		long long lBytes = (long long)s_writer.tellp();
+		s_writer.seekp(0);
+		s_writer.write((const char*)&s_header, sizeof(s_header));
+		std::cout << "GL capture: " << s_header.Frames << " frames, " << s_header.Calls << " calls, "
+			<< lBytes / (1024.0 * 1024.0) << " MB written to " << s_sFilepath << std::endl;
+	}
+
+	if (s_bIsOpen)
+	{
+		s_writer.close();
+		s_lBuffer.clear();
+		s_lBuffer.shrink_to_fit();
+		s_lMapped.clear();
+		s_bIsOpen = false;
+	}
+}
+
+bool GLCapture::IsCapturing(void) { return s_bIsCapturing; }
+
+const char* GLCapture::GetOpName(GLCaptureOp a_eOp)
+{
+	switch (a_eOp)
+	{
+	case GLC_FRAME: return "frame";
+	case GLC_ENABLE: return "glEnable";
+	case GLC_DISABLE: return "glDisable";
+	case GLC_BLEND_FUNC: return "glBlendFunc";
+	case GLC_DEPTH_FUNC: return "glDepthFunc";
+	case GLC_DEPTH_MASK: return "glDepthMask";
+	case GLC_COLOR_MASK: return "glColorMask";
+	case GLC_POLYGON_MODE: return "glPolygonMode";
+	case GLC_CLEAR_COLOR: return "glClearColor";
+	case GLC_CLEAR: return "glClear";
+	case GLC_VIEWPORT: return "glViewport";
+	case GLC_DRAW_ARRAYS: return "glDrawArrays";
+	case GLC_DRAW_BUFFER: return "glDrawBuffer";
+	case GLC_FLUSH: return "glFlush";
+	case GLC_FINISH: return "glFinish";
+	case GLC_GEN_TEXTURES: return "glGenTextures";
+	case GLC_DELETE_TEXTURES: return "glDeleteTextures";
+	case GLC_BIND_TEXTURE: return "glBindTexture";
+	case GLC_ACTIVE_TEXTURE: return "glActiveTexture";
+	case GLC_TEX_PARAMETER_I: return "glTexParameteri";
+	case GLC_TEX_PARAMETER_F: return "glTexParameterf";
+	case GLC_TEX_IMAGE_2D: return "glTexImage2D";
+	case GLC_TEX_SUB_IMAGE_2D: return "glTexSubImage2D";
+	case GLC_TEX_STORAGE_2D: return "glTexStorage2D";
+	case GLC_TEX_STORAGE_3D: return "glTexStorage3D";
+	case GLC_COMPRESSED_TEX_IMAGE_2D: return "glCompressedTexImage2D";
+	case GLC_COMPRESSED_TEX_SUB_IMAGE_2D: return "glCompressedTexSubImage2D";
+	case GLC_COPY_IMAGE_SUB_DATA: return "glCopyImageSubData";
+	case GLC_GEN_BUFFERS: return "glGenBuffers";
+	case GLC_DELETE_BUFFERS: return "glDeleteBuffers";
+	case GLC_BIND_BUFFER: return "glBindBuffer";
+	case GLC_BIND_BUFFER_BASE: return "glBindBufferBase";
+	case GLC_BUFFER_DATA: return "glBufferData";
+	case GLC_MAP_BUFFER_RANGE: return "glMapBufferRange";
+	case GLC_FLUSH_MAPPED_BUFFER_RANGE: return "glFlushMappedBufferRange";
+	case GLC_UNMAP_BUFFER: return "glUnmapBuffer";
+	case GLC_GEN_VERTEX_ARRAYS: return "glGenVertexArrays";
+	case GLC_DELETE_VERTEX_ARRAYS: return "glDeleteVertexArrays";
+	case GLC_BIND_VERTEX_ARRAY: return "glBindVertexArray";
+	case GLC_ENABLE_VERTEX_ATTRIB_ARRAY: return "glEnableVertexAttribArray";
+	case GLC_VERTEX_ATTRIB_POINTER: return "glVertexAttribPointer";
+	case GLC_GEN_FRAMEBUFFERS: return "glGenFramebuffers";
+	case GLC_DELETE_FRAMEBUFFERS: return "glDeleteFramebuffers";
+	case GLC_BIND_FRAMEBUFFER: return "glBindFramebuffer";
+	case GLC_FRAMEBUFFER_TEXTURE_2D: return "glFramebufferTexture2D";
+	case GLC_GEN_RENDERBUFFERS: return "glGenRenderbuffers";
+	case GLC_DELETE_RENDERBUFFERS: return "glDeleteRenderbuffers";
+	case GLC_BIND_RENDERBUFFER: return "glBindRenderbuffer";
+	case GLC_RENDERBUFFER_STORAGE: return "glRenderbufferStorage";
+	case GLC_FRAMEBUFFER_RENDERBUFFER: return "glFramebufferRenderbuffer";
+	case GLC_DRAW_BUFFERS: return "glDrawBuffers";
+	case GLC_BLIT_FRAMEBUFFER: return "glBlitFramebuffer";
+	case GLC_CREATE_SHADER: return "glCreateShader";
+	case GLC_SHADER_SOURCE: return "glShaderSource";
+	case GLC_COMPILE_SHADER: return "glCompileShader";
+	case GLC_DELETE_SHADER: return "glDeleteShader";
+	case GLC_CREATE_PROGRAM: return "glCreateProgram";
+	case GLC_ATTACH_SHADER: return "glAttachShader";
+	case GLC_DETACH_SHADER: return "glDetachShader";
+	case GLC_LINK_PROGRAM: return "glLinkProgram";
+	case GLC_DELETE_PROGRAM: return "glDeleteProgram";
+	case GLC_PROGRAM_PARAMETER_I: return "glProgramParameteri";
+	case GLC_USE_PROGRAM: return "glUseProgram";
+	case GLC_GET_UNIFORM_LOCATION: return "glGetUniformLocation";
+	case GLC_UNIFORM_1I: return "glUniform1i";
+	case GLC_UNIFORM_1IV: return "glUniform1iv";
+	case GLC_UNIFORM_4FV: return "glUniform4fv";
+	case GLC_UNIFORM_MATRIX_4FV: return "glUniformMatrix4fv";
+	case GLC_GEN_QUERIES: return "glGenQueries";
+	case GLC_DELETE_QUERIES: return "glDeleteQueries";
+	case GLC_BEGIN_QUERY: return "glBeginQuery";
+	case GLC_END_QUERY: return "glEndQuery";
+	case GLC_QUERY_COUNTER: return "glQueryCounter";
+	case GLC_GET_QUERY_OBJECT: return "glGetQueryObjectui64v";
+	case GLC_FENCE_SYNC: return "glFenceSync";
+	case GLC_CLIENT_WAIT_SYNC: return "glClientWaitSync";
+	case GLC_DELETE_SYNC: return "glDeleteSync";
+	case GLC_MEMORY_BARRIER: return "glMemoryBarrier";
+	default: return "unknown";
+	}
+}
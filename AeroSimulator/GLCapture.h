@@ -0,0 +1,237 @@
+#ifndef __GLCAPTURE_H_
+#define __GLCAPTURE_H_
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+// First bytes of every capture file and the layout version after them.
+#define GL_CAPTURE_MAGIC "AEROGLC"
+#define GL_CAPTURE_VERSION 2
+
+// Calls are buffered up to this many bytes before they are written out.
+#define GL_CAPTURE_FLUSH_BYTES (4 * 1024 * 1024)
+
+/// <summary>
+/// Every GL call a capture can hold.  Each is stored as its 16 bit op followed
+/// by its arguments, with 64 bit sizes and offsets, and data as a 32 bit length
+/// and the bytes.
+/// </summary>
+enum GLCaptureOp
+{
+	GLC_FRAME = 0,				// End of a frame, written at present.
+	GLC_ENABLE,
+	GLC_DISABLE,
+	GLC_BLEND_FUNC,
+	GLC_DEPTH_FUNC,
+	GLC_DEPTH_MASK,
+	GLC_COLOR_MASK,
+	GLC_POLYGON_MODE,
+	GLC_CLEAR_COLOR,
+	GLC_CLEAR,
+	GLC_VIEWPORT,
+	GLC_DRAW_ARRAYS,
+	GLC_DRAW_BUFFER,
+	GLC_FLUSH,
+	GLC_FINISH,
+	GLC_GEN_TEXTURES,
+	GLC_DELETE_TEXTURES,
+	GLC_BIND_TEXTURE,
+	GLC_ACTIVE_TEXTURE,
+	GLC_TEX_PARAMETER_I,
+	GLC_TEX_PARAMETER_F,
+	GLC_TEX_IMAGE_2D,
+	GLC_TEX_SUB_IMAGE_2D,
+	GLC_TEX_STORAGE_2D,
+	GLC_TEX_STORAGE_3D,
+	GLC_COMPRESSED_TEX_IMAGE_2D,
+	GLC_COMPRESSED_TEX_SUB_IMAGE_2D,
+	GLC_COPY_IMAGE_SUB_DATA,
+	GLC_GEN_BUFFERS,
+	GLC_DELETE_BUFFERS,
+	GLC_BIND_BUFFER,
+	GLC_BIND_BUFFER_BASE,
+	GLC_BUFFER_DATA,
+	GLC_MAP_BUFFER_RANGE,
+	GLC_FLUSH_MAPPED_BUFFER_RANGE,	// Carries the bytes written to the flushed range.
+	GLC_UNMAP_BUFFER,				// Carries the whole range unless it was flushed explicitly.
+	GLC_GEN_VERTEX_ARRAYS,
+	GLC_DELETE_VERTEX_ARRAYS,
+	GLC_BIND_VERTEX_ARRAY,
+	GLC_ENABLE_VERTEX_ATTRIB_ARRAY,
+	GLC_VERTEX_ATTRIB_POINTER,
+	GLC_GEN_FRAMEBUFFERS,
+	GLC_DELETE_FRAMEBUFFERS,
+	GLC_BIND_FRAMEBUFFER,
+	GLC_FRAMEBUFFER_TEXTURE_2D,
+	GLC_GEN_RENDERBUFFERS,
+	GLC_DELETE_RENDERBUFFERS,
+	GLC_BIND_RENDERBUFFER,
+	GLC_RENDERBUFFER_STORAGE,
+	GLC_FRAMEBUFFER_RENDERBUFFER,
+	GLC_DRAW_BUFFERS,
+	GLC_BLIT_FRAMEBUFFER,
+	GLC_CREATE_SHADER,
+	GLC_SHADER_SOURCE,
+	GLC_COMPILE_SHADER,
+	GLC_DELETE_SHADER,
+	GLC_CREATE_PROGRAM,
+	GLC_ATTACH_SHADER,
+	GLC_DETACH_SHADER,
+	GLC_LINK_PROGRAM,
+	GLC_DELETE_PROGRAM,
+	GLC_PROGRAM_PARAMETER_I,
+	GLC_USE_PROGRAM,
+	GLC_GET_UNIFORM_LOCATION,	// Kept with its result so later uniforms can be remapped.
+	GLC_UNIFORM_1I,
+	GLC_UNIFORM_1IV,
+	GLC_UNIFORM_4FV,
+	GLC_UNIFORM_MATRIX_4FV,
+	GLC_GEN_QUERIES,
+	GLC_DELETE_QUERIES,
+	GLC_BEGIN_QUERY,
+	GLC_END_QUERY,
+	GLC_QUERY_COUNTER,
+	GLC_GET_QUERY_OBJECT,
+	GLC_FENCE_SYNC,
+	GLC_CLIENT_WAIT_SYNC,
+	GLC_DELETE_SYNC,
+	GLC_MEMORY_BARRIER,
+	GLC_OP_COUNT
+};
+
+/// <summary>
+/// Start of every capture file.
+/// </summary>
+struct GLCaptureHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t DefaultFramebuffer;	// What the engine drew to in place of framebuffer 0, if not 0.
+	uint32_t FirstFrame;			// Frames before it only keep the calls later frames depend on.
+	uint32_t Frames;				// Every frame in the file, including the ones before FirstFrame.
+	uint64_t Calls;
+};
+
+/// <summary>
+/// Records every GL call the engine makes into a file the replayer can re-issue
+/// without the simulation.  Functions GLEW loads are hooked by swapping its
+/// pointers, the GL 1.1 ones the engine uses are redirected below to pointers
+/// that only leave the driver while capturing.  GL is only ever called from the
+/// thread holding the context, so recording takes no locks.  ImGui loads its own
+/// entry points and is left out, its backend restores all state it touches.
+/// </summary>
+class GLCapture
+{
+public:
+	/// <summary>
+	/// Arms a capture.  Recording starts with Start once GL is loaded, so every
+	/// resource later frames use is in the file.
+	/// </summary>
+	/// <param name="a_dFirstFrame">Frame the full recording starts at.  Earlier frames drop draws, clears, matrices and queries.</param>
+	/// <param name="a_dFrames">Frames recorded in full before the file is closed.</param>
+	/// <returns>False if the file cannot be written.</returns>
+	static bool Open(const std::string& a_sFilepath, int a_dFirstFrame, int a_dFrames);
+
+	/// <summary>
+	/// Installs the hooks if a capture was opened.  Called right after GLEW is initialized.
+	/// </summary>
+	/// <param name="a_uDefaultFramebuffer">Framebuffer standing in for 0, for headless contexts.</param>
+	static void Start(unsigned int a_uWidth, unsigned int a_uHeight, GLuint a_uDefaultFramebuffer);
+
+	/// <summary>
+	/// Marks the end of a frame and closes the file after the last one.
+	/// </summary>
+	static void EndFrame(void);
+
+	/// <summary>
+	/// Removes the hooks and finishes the file.  Safe to call when nothing is captured.
+	/// </summary>
+	static void Stop(void);
+
+	/// <summary>
+	/// Whether calls are being recorded.  Features the replayer cannot reproduce,
+	/// like driver program binaries or bindless handles, stay off while it is true.
+	/// </summary>
+	static bool IsCapturing(void);
+
+	/// <summary>
+	/// Gets the GL name of an op.
+	/// </summary>
+	static const char* GetOpName(GLCaptureOp a_eOp);
+};
+
+// GL 1.1 entry points are plain exports GLEW does not load, so the engine calls
+// them through these instead.  They point at the driver unless capturing.
+typedef void (GLAPIENTRY * PFNGLCAPTUREENABLEPROC) (GLenum cap);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDISABLEPROC) (GLenum cap);
+typedef void (GLAPIENTRY * PFNGLCAPTUREBLENDFUNCPROC) (GLenum sfactor, GLenum dfactor);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDEPTHFUNCPROC) (GLenum func);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDEPTHMASKPROC) (GLboolean flag);
+typedef void (GLAPIENTRY * PFNGLCAPTURECOLORMASKPROC) (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+typedef void (GLAPIENTRY * PFNGLCAPTUREPOLYGONMODEPROC) (GLenum face, GLenum mode);
+typedef void (GLAPIENTRY * PFNGLCAPTURECLEARCOLORPROC) (GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+typedef void (GLAPIENTRY * PFNGLCAPTURECLEARPROC) (GLbitfield mask);
+typedef void (GLAPIENTRY * PFNGLCAPTUREVIEWPORTPROC) (GLint x, GLint y, GLsizei width, GLsizei height);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDRAWARRAYSPROC) (GLenum mode, GLint first, GLsizei count);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDRAWBUFFERPROC) (GLenum mode);
+typedef void (GLAPIENTRY * PFNGLCAPTUREFLUSHPROC) (void);
+typedef void (GLAPIENTRY * PFNGLCAPTUREFINISHPROC) (void);
+typedef void (GLAPIENTRY * PFNGLCAPTUREGENTEXTURESPROC) (GLsizei n, GLuint* textures);
+typedef void (GLAPIENTRY * PFNGLCAPTUREDELETETEXTURESPROC) (GLsizei n, const GLuint* textures);
+typedef void (GLAPIENTRY * PFNGLCAPTUREBINDTEXTUREPROC) (GLenum target, GLuint texture);
+typedef void (GLAPIENTRY * PFNGLCAPTURETEXPARAMETERIPROC) (GLenum target, GLenum pname, GLint param);
+typedef void (GLAPIENTRY * PFNGLCAPTURETEXPARAMETERFPROC) (GLenum target, GLenum pname, GLfloat param);
+typedef void (GLAPIENTRY * PFNGLCAPTURETEXIMAGE2DPROC) (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+typedef void (GLAPIENTRY * PFNGLCAPTURETEXSUBIMAGE2DPROC) (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
+
+extern PFNGLCAPTUREENABLEPROC __glcaptureEnable;
+extern PFNGLCAPTUREDISABLEPROC __glcaptureDisable;
+extern PFNGLCAPTUREBLENDFUNCPROC __glcaptureBlendFunc;
+extern PFNGLCAPTUREDEPTHFUNCPROC __glcaptureDepthFunc;
+extern PFNGLCAPTUREDEPTHMASKPROC __glcaptureDepthMask;
+extern PFNGLCAPTURECOLORMASKPROC __glcaptureColorMask;
+extern PFNGLCAPTUREPOLYGONMODEPROC __glcapturePolygonMode;
+extern PFNGLCAPTURECLEARCOLORPROC __glcaptureClearColor;
+extern PFNGLCAPTURECLEARPROC __glcaptureClear;
+extern PFNGLCAPTUREVIEWPORTPROC __glcaptureViewport;
+extern PFNGLCAPTUREDRAWARRAYSPROC __glcaptureDrawArrays;
+extern PFNGLCAPTUREDRAWBUFFERPROC __glcaptureDrawBuffer;
+extern PFNGLCAPTUREFLUSHPROC __glcaptureFlush;
+extern PFNGLCAPTUREFINISHPROC __glcaptureFinish;
+extern PFNGLCAPTUREGENTEXTURESPROC __glcaptureGenTextures;
+extern PFNGLCAPTUREDELETETEXTURESPROC __glcaptureDeleteTextures;
+extern PFNGLCAPTUREBINDTEXTUREPROC __glcaptureBindTexture;
+extern PFNGLCAPTURETEXPARAMETERIPROC __glcaptureTexParameteri;
+extern PFNGLCAPTURETEXPARAMETERFPROC __glcaptureTexParameterf;
+extern PFNGLCAPTURETEXIMAGE2DPROC __glcaptureTexImage2D;
+extern PFNGLCAPTURETEXSUBIMAGE2DPROC __glcaptureTexSubImage2D;
+
+// The capture itself and the replayer define this to reach the driver directly.
+#ifndef GL_CAPTURE_NO_REDIRECT
+#define glEnable __glcaptureEnable
+#define glDisable __glcaptureDisable
+#define glBlendFunc __glcaptureBlendFunc
+#define glDepthFunc __glcaptureDepthFunc
+#define glDepthMask __glcaptureDepthMask
+#define glColorMask __glcaptureColorMask
+#define glPolygonMode __glcapturePolygonMode
+#define glClearColor __glcaptureClearColor
+#define glClear __glcaptureClear
+#define glViewport __glcaptureViewport
+#define glDrawArrays __glcaptureDrawArrays
+#define glDrawBuffer __glcaptureDrawBuffer
+#define glFlush __glcaptureFlush
+#define glFinish __glcaptureFinish
+#define glGenTextures __glcaptureGenTextures
+#define glDeleteTextures __glcaptureDeleteTextures
+#define glBindTexture __glcaptureBindTexture
+#define glTexParameteri __glcaptureTexParameteri
+#define glTexParameterf __glcaptureTexParameterf
+#define glTexImage2D __glcaptureTexImage2D
+#define glTexSubImage2D __glcaptureTexSubImage2D
+#endif
+
+#endif //__GLCAPTURE_H_
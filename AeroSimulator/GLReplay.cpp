@@ -0,0 +1,868 @@
+#define GL_CAPTURE_NO_REDIRECT
+#include "GLReplay.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+// Shaders and programs are looked up by the same captured name.
+#define GL_REPLAY_LOCATION_KEY(program, location) (((uint64_t)(program) << 32) | (uint32_t)(location))
+
+GLReplayer::GLReplayer(void)
+{
+	memset(m_lOpCounts, 0, sizeof(m_lOpCounts));
+}
+
+GLReplayer::GLReplayer(const GLReplayer& a_pOther)
+{
+	m_lData = a_pOther.m_lData;
+	m_header = a_pOther.m_header;
+	m_sDriver = a_pOther.m_sDriver;
+	memset(m_lOpCounts, 0, sizeof(m_lOpCounts));
+}
+
+GLReplayer& GLReplayer::operator=(const GLReplayer& a_pOther)
+{
+	m_lData = a_pOther.m_lData;
+	m_uCursor = 0;
+	m_bHasFailed = false;
+	m_header = a_pOther.m_header;
+	m_sDriver = a_pOther.m_sDriver;
+	m_lFrames.clear();
+	memset(m_lOpCounts, 0, sizeof(m_lOpCounts));
+	return *this;
+}
+
+bool GLReplayer::Load(const std::string& a_sFilepath)
+{
+	std::ifstream reader(a_sFilepath, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!reader.is_open())
+	{
+		std::cout << "Could not read the GL capture " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	std::streamsize lSize = reader.tellg();
+	reader.seekg(0);
+	m_lData.resize((size_t)lSize);
+	reader.read((char*)m_lData.data(), lSize);
+
+	m_uCursor = 0;
+	m_bHasFailed = false;
+	m_header = Read<GLCaptureHeader>();
+	if (m_bHasFailed || memcmp(m_header.Magic, GL_CAPTURE_MAGIC, sizeof(GL_CAPTURE_MAGIC)) != 0 || m_header.Version != GL_CAPTURE_VERSION)
+	{
+		std::cout << a_sFilepath << " is not a version " << GL_CAPTURE_VERSION << " GL capture." << std::endl;
+		m_lData.clear();
+		return false;
+	}
+
+	uint32_t uBytes = 0;
+	const unsigned char* pDriver = ReadData(uBytes);
+	m_sDriver = pDriver != nullptr ? std::string((const char*)pDriver, uBytes) : "";
+	return !m_bHasFailed;
+}
+
+bool GLReplayer::Replay(GLuint a_uDefaultFramebuffer)
+{
+	if (m_lData.empty()) return false;
+
+	// Starting over after the header, so the same capture can be replayed again.
+	m_uCursor = sizeof(GLCaptureHeader);
+	uint32_t uBytes = 0;
+	ReadData(uBytes);
+	m_uDefaultFramebuffer = a_uDefaultFramebuffer;
+	m_uDrawFramebuffer = a_uDefaultFramebuffer;
+	m_lFrames.clear();
+	memset(m_lOpCounts, 0, sizeof(m_lOpCounts));
+
+	// Timestamps show the GPU's share of every frame where the driver has them.
+	bool bHasTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+	if (bHasTimers && m_lTimers[0] == 0)
+	{
+		glGenQueries(2, m_lTimers);
+	}
+	while (glGetError() != GL_NO_ERROR);
+
+	uint32_t uFrame = 0;
+	GLReplayFrame frame = GLReplayFrame();
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	bool bIsTimed = m_header.FirstFrame == 0;
+	if (bIsTimed && bHasTimers) glQueryCounter(m_lTimers[0], GL_TIMESTAMP);
+
+	while (m_uCursor < m_lData.size())
+	{
+		GLCaptureOp eOp = (GLCaptureOp)Read<uint16_t>();
+		if (eOp >= GLC_OP_COUNT)
+		{
+			std::cout << "Unknown GL capture op " << eOp << " at byte " << m_uCursor - sizeof(uint16_t) << std::endl;
+			return false;
+		}
+
+		if (eOp != GLC_FRAME)
+		{
+			if (!ReplayCall(eOp)) return false;
+			if (bIsTimed)
+			{
+				frame.Calls++;
+				m_lOpCounts[eOp]++;
+			}
+		}
+		else
+		{
+			// Timing the frame the same way a headless engine frame ends, with a finish.
+			if (bIsTimed)
+			{
+				if (bHasTimers) glQueryCounter(m_lTimers[1], GL_TIMESTAMP);
+				frame.IssueMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			}
+			glFinish();
+			if (bIsTimed)
+			{
+				frame.FrameMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+				if (bHasTimers)
+				{
+					GLuint64 uBegin = 0;
+					GLuint64 uEnd = 0;
+					glGetQueryObjectui64v(m_lTimers[0], GL_QUERY_RESULT, &uBegin);
+					glGetQueryObjectui64v(m_lTimers[1], GL_QUERY_RESULT, &uEnd);
+					frame.GPUMS = (uEnd - uBegin) / 1000000.0f;
+				}
+				while (glGetError() != GL_NO_ERROR) frame.Errors++;
+				m_lFrames.push_back(frame);
+			}
+
+			uFrame++;
+			frame = GLReplayFrame();
+			bIsTimed = uFrame >= m_header.FirstFrame;
+			start = std::chrono::high_resolution_clock::now();
+			if (bIsTimed && bHasTimers) glQueryCounter(m_lTimers[0], GL_TIMESTAMP);
+		}
+
+		if (m_bHasFailed)
+		{
+			std::cout << "The GL capture ends part way through " << GLCapture::GetOpName(eOp) << "." << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+const unsigned char* GLReplayer::ReadData(uint32_t& a_uBytes)
+{
+	a_uBytes = Read<uint32_t>();
+	if (m_bHasFailed || m_uCursor + a_uBytes > m_lData.size())
+	{
+		m_bHasFailed = true;
+		a_uBytes = 0;
+		return nullptr;
+	}
+
+	const unsigned char* pData = a_uBytes > 0 ? &m_lData[m_uCursor] : nullptr;
+	m_uCursor += a_uBytes;
+	return pData;
+}
+
+const GLvoid* GLReplayer::ReadPixels(void)
+{
+	if (Read<uint8_t>() != 0)
+	{
+		return (const GLvoid*)(uintptr_t)Read<uint64_t>();
+	}
+	uint32_t uBytes = 0;
+	return ReadData(uBytes);
+}
+
+GLuint GLReplayer::Map(const std::unordered_map<GLuint, GLuint>& a_mNames, GLuint a_uName)
+{
+	if (a_uName == 0) return 0;
+	std::unordered_map<GLuint, GLuint>::const_iterator it = a_mNames.find(a_uName);
+	return it != a_mNames.end() ? it->second : 0;
+}
+
+GLint GLReplayer::MapLocation(GLint a_dLocation)
+{
+	if (a_dLocation == -1) return -1;
+	std::unordered_map<uint64_t, GLint>::iterator it = m_mLocations.find(GL_REPLAY_LOCATION_KEY(m_uProgram, a_dLocation));
+	return it != m_mLocations.end() ? it->second : a_dLocation;
+}
+
+void GLReplayer::ReplayGen(std::unordered_map<GLuint, GLuint>& a_mNames, void (GLAPIENTRY* a_pfnGen)(GLsizei, GLuint*))
+{
+	int32_t dCount = Read<int32_t>();
+	for (int32_t i = 0; i < dCount && !m_bHasFailed; i++)
+	{
+		GLuint uCaptured = Read<uint32_t>();
+		GLuint uName = 0;
+		a_pfnGen(1, &uName);
+		a_mNames[uCaptured] = uName;
+	}
+}
+
+void GLReplayer::ReplayDelete(std::unordered_map<GLuint, GLuint>& a_mNames, void (GLAPIENTRY* a_pfnDelete)(GLsizei, const GLuint*))
+{
+	int32_t dCount = Read<int32_t>();
+	for (int32_t i = 0; i < dCount && !m_bHasFailed; i++)
+	{
+		GLuint uCaptured = Read<uint32_t>();
+		GLuint uName = Map(a_mNames, uCaptured);
+		if (uName != 0)
+		{
+			a_pfnDelete(1, &uName);
+			a_mNames.erase(uCaptured);
+		}
+	}
+}
+
+bool GLReplayer::ReplayCall(GLCaptureOp a_eOp)
+{
+	uint32_t uBytes = 0;
+	switch (a_eOp)
+	{
+	case GLC_ENABLE:
+		glEnable(Read<uint32_t>());
+		break;
+	case GLC_DISABLE:
+		glDisable(Read<uint32_t>());
+		break;
+	case GLC_BLEND_FUNC:
+	{
+		GLenum eSource = Read<uint32_t>();
+		GLenum eDestination = Read<uint32_t>();
+		glBlendFunc(eSource, eDestination);
+		break;
+	}
+	case GLC_DEPTH_FUNC:
+		glDepthFunc(Read<uint32_t>());
+		break;
+	case GLC_DEPTH_MASK:
+		glDepthMask(Read<uint8_t>());
+		break;
+	case GLC_COLOR_MASK:
+	{
+		GLboolean bRed = Read<uint8_t>();
+		GLboolean bGreen = Read<uint8_t>();
+		GLboolean bBlue = Read<uint8_t>();
+		GLboolean bAlpha = Read<uint8_t>();
+		glColorMask(bRed, bGreen, bBlue, bAlpha);
+		break;
+	}
+	case GLC_POLYGON_MODE:
+	{
+		GLenum eFace = Read<uint32_t>();
+		GLenum eMode = Read<uint32_t>();
+		glPolygonMode(eFace, eMode);
+		break;
+	}
+	case GLC_CLEAR_COLOR:
+	{
+		float fRed = Read<float>();
+		float fGreen = Read<float>();
+		float fBlue = Read<float>();
+		float fAlpha = Read<float>();
+		glClearColor(fRed, fGreen, fBlue, fAlpha);
+		break;
+	}
+	case GLC_CLEAR:
+		glClear(Read<uint32_t>());
+		break;
+	case GLC_VIEWPORT:
+	{
+		GLint dX = Read<int32_t>();
+		GLint dY = Read<int32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		glViewport(dX, dY, dWidth, dHeight);
+		break;
+	}
+	case GLC_DRAW_ARRAYS:
+	{
+		GLenum eMode = Read<uint32_t>();
+		GLint dFirst = Read<int32_t>();
+		GLsizei dCount = Read<int32_t>();
+		glDrawArrays(eMode, dFirst, dCount);
+		break;
+	}
+	case GLC_DRAW_BUFFER:
+	{
+		// The window's back buffer is the replay target's first attachment.
+		GLenum eBuffer = Read<uint32_t>();
+		if (m_uDrawFramebuffer != 0 && m_uDrawFramebuffer == m_uDefaultFramebuffer && (eBuffer == GL_BACK || eBuffer == GL_BACK_LEFT))
+		{
+			eBuffer = GL_COLOR_ATTACHMENT0;
+		}
+		glDrawBuffer(eBuffer);
+		break;
+	}
+	case GLC_FLUSH:
+		glFlush();
+		break;
+	case GLC_FINISH:
+		glFinish();
+		break;
+	case GLC_GEN_TEXTURES:
+		ReplayGen(m_mTextures, glGenTextures);
+		break;
+	case GLC_DELETE_TEXTURES:
+		ReplayDelete(m_mTextures, glDeleteTextures);
+		break;
+	case GLC_BIND_TEXTURE:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uTexture = Map(m_mTextures, Read<uint32_t>());
+		glBindTexture(eTarget, uTexture);
+		break;
+	}
+	case GLC_ACTIVE_TEXTURE:
+		glActiveTexture(Read<uint32_t>());
+		break;
+	case GLC_TEX_PARAMETER_I:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLenum eName = Read<uint32_t>();
+		GLint dValue = Read<int32_t>();
+		glTexParameteri(eTarget, eName, dValue);
+		break;
+	}
+	case GLC_TEX_PARAMETER_F:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLenum eName = Read<uint32_t>();
+		GLfloat fValue = Read<float>();
+		glTexParameterf(eTarget, eName, fValue);
+		break;
+	}
+	case GLC_TEX_IMAGE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLint dLevel = Read<int32_t>();
+		GLint dInternalFormat = Read<int32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLint dBorder = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLenum eType = Read<uint32_t>();
+		const GLvoid* pPixels = ReadPixels();
+		glTexImage2D(eTarget, dLevel, dInternalFormat, dWidth, dHeight, dBorder, eFormat, eType, pPixels);
+		break;
+	}
+	case GLC_TEX_SUB_IMAGE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLint dLevel = Read<int32_t>();
+		GLint dX = Read<int32_t>();
+		GLint dY = Read<int32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLenum eType = Read<uint32_t>();
+		const GLvoid* pPixels = ReadPixels();
+		glTexSubImage2D(eTarget, dLevel, dX, dY, dWidth, dHeight, eFormat, eType, pPixels);
+		break;
+	}
+	case GLC_TEX_STORAGE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLsizei dLevels = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		glTexStorage2D(eTarget, dLevels, eFormat, dWidth, dHeight);
+		break;
+	}
+	case GLC_TEX_STORAGE_3D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLsizei dLevels = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLsizei dDepth = Read<int32_t>();
+		glTexStorage3D(eTarget, dLevels, eFormat, dWidth, dHeight, dDepth);
+		break;
+	}
+	case GLC_COMPRESSED_TEX_IMAGE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLint dLevel = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLint dBorder = Read<int32_t>();
+		GLsizei dSize = Read<int32_t>();
+		const GLvoid* pData = ReadPixels();
+		glCompressedTexImage2D(eTarget, dLevel, eFormat, dWidth, dHeight, dBorder, dSize, pData);
+		break;
+	}
+	case GLC_COMPRESSED_TEX_SUB_IMAGE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLint dLevel = Read<int32_t>();
+		GLint dX = Read<int32_t>();
+		GLint dY = Read<int32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLsizei dSize = Read<int32_t>();
+		const GLvoid* pData = ReadPixels();
+		glCompressedTexSubImage2D(eTarget, dLevel, dX, dY, dWidth, dHeight, eFormat, dSize, pData);
+		break;
+	}
+	case GLC_COPY_IMAGE_SUB_DATA:
+	{
+		GLuint lNames[2];
+		GLenum lTargets[2];
+		GLint lCoordinates[2][4];
+		for (int i = 0; i < 2; i++)
+		{
+			GLuint uName = Read<uint32_t>();
+			lTargets[i] = Read<uint32_t>();
+			lNames[i] = Map(lTargets[i] == GL_RENDERBUFFER ? m_mRenderbuffers : m_mTextures, uName);
+			for (int j = 0; j < 4; j++)
+			{
+				lCoordinates[i][j] = Read<int32_t>();
+			}
+		}
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		GLsizei dDepth = Read<int32_t>();
+		glCopyImageSubData(lNames[0], lTargets[0], lCoordinates[0][0], lCoordinates[0][1], lCoordinates[0][2], lCoordinates[0][3],
+			lNames[1], lTargets[1], lCoordinates[1][0], lCoordinates[1][1], lCoordinates[1][2], lCoordinates[1][3],
+			dWidth, dHeight, dDepth);
+		break;
+	}
+	case GLC_GEN_BUFFERS:
+		ReplayGen(m_mBuffers, glGenBuffers);
+		break;
+	case GLC_DELETE_BUFFERS:
+		ReplayDelete(m_mBuffers, glDeleteBuffers);
+		break;
+	case GLC_BIND_BUFFER:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uBuffer = Map(m_mBuffers, Read<uint32_t>());
+		glBindBuffer(eTarget, uBuffer);
+		break;
+	}
+	case GLC_BIND_BUFFER_BASE:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uIndex = Read<uint32_t>();
+		GLuint uBuffer = Map(m_mBuffers, Read<uint32_t>());
+		glBindBufferBase(eTarget, uIndex, uBuffer);
+		break;
+	}
+	case GLC_BUFFER_DATA:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLsizeiptr lSize = (GLsizeiptr)Read<uint64_t>();
+		GLenum eUsage = Read<uint32_t>();
+		const unsigned char* pData = ReadData(uBytes);
+		glBufferData(eTarget, lSize, pData, eUsage);
+		break;
+	}
+	case GLC_MAP_BUFFER_RANGE:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLintptr lOffset = (GLintptr)Read<uint64_t>();
+		GLsizeiptr lLength = (GLsizeiptr)Read<uint64_t>();
+		GLbitfield uAccess = Read<uint32_t>();
+		m_mMapped[eTarget] = (unsigned char*)glMapBufferRange(eTarget, lOffset, lLength, uAccess);
+		break;
+	}
+	case GLC_FLUSH_MAPPED_BUFFER_RANGE:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLintptr lOffset = (GLintptr)Read<uint64_t>();
+		const unsigned char* pData = ReadData(uBytes);
+		unsigned char* pMapped = m_mMapped[eTarget];
+		if (pMapped != nullptr && pData != nullptr)
+		{
+			memcpy(pMapped + lOffset, pData, uBytes);
+		}
+		glFlushMappedBufferRange(eTarget, lOffset, uBytes);
+		break;
+	}
+	case GLC_UNMAP_BUFFER:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		const unsigned char* pData = ReadData(uBytes);
+		unsigned char* pMapped = m_mMapped[eTarget];
+		if (pMapped != nullptr && pData != nullptr)
+		{
+			memcpy(pMapped, pData, uBytes);
+		}
+		glUnmapBuffer(eTarget);
+		m_mMapped.erase(eTarget);
+		break;
+	}
+	case GLC_GEN_VERTEX_ARRAYS:
+		ReplayGen(m_mVertexArrays, glGenVertexArrays);
+		break;
+	case GLC_DELETE_VERTEX_ARRAYS:
+		ReplayDelete(m_mVertexArrays, glDeleteVertexArrays);
+		break;
+	case GLC_BIND_VERTEX_ARRAY:
+		glBindVertexArray(Map(m_mVertexArrays, Read<uint32_t>()));
+		break;
+	case GLC_ENABLE_VERTEX_ATTRIB_ARRAY:
+		glEnableVertexAttribArray(Read<uint32_t>());
+		break;
+	case GLC_VERTEX_ATTRIB_POINTER:
+	{
+		GLuint uIndex = Read<uint32_t>();
+		GLint dSize = Read<int32_t>();
+		GLenum eType = Read<uint32_t>();
+		GLboolean bNormalized = Read<uint8_t>();
+		GLsizei dStride = Read<int32_t>();
+		const GLvoid* pOffset = (const GLvoid*)(uintptr_t)Read<uint64_t>();
+		glVertexAttribPointer(uIndex, dSize, eType, bNormalized, dStride, pOffset);
+		break;
+	}
+	case GLC_GEN_FRAMEBUFFERS:
+		ReplayGen(m_mFramebuffers, glGenFramebuffers);
+		break;
+	case GLC_DELETE_FRAMEBUFFERS:
+		ReplayDelete(m_mFramebuffers, glDeleteFramebuffers);
+		break;
+	case GLC_BIND_FRAMEBUFFER:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uCaptured = Read<uint32_t>();
+		bool bIsDefault = uCaptured == 0 || uCaptured == m_header.DefaultFramebuffer;
+		GLuint uFramebuffer = bIsDefault ? m_uDefaultFramebuffer : Map(m_mFramebuffers, uCaptured);
+		if (eTarget != GL_READ_FRAMEBUFFER) m_uDrawFramebuffer = uFramebuffer;
+		glBindFramebuffer(eTarget, uFramebuffer);
+		break;
+	}
+	case GLC_FRAMEBUFFER_TEXTURE_2D:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLenum eAttachment = Read<uint32_t>();
+		GLenum eTextureTarget = Read<uint32_t>();
+		GLuint uTexture = Map(m_mTextures, Read<uint32_t>());
+		GLint dLevel = Read<int32_t>();
+		glFramebufferTexture2D(eTarget, eAttachment, eTextureTarget, uTexture, dLevel);
+		break;
+	}
+	case GLC_GEN_RENDERBUFFERS:
+		ReplayGen(m_mRenderbuffers, glGenRenderbuffers);
+		break;
+	case GLC_DELETE_RENDERBUFFERS:
+		ReplayDelete(m_mRenderbuffers, glDeleteRenderbuffers);
+		break;
+	case GLC_BIND_RENDERBUFFER:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uRenderbuffer = Map(m_mRenderbuffers, Read<uint32_t>());
+		glBindRenderbuffer(eTarget, uRenderbuffer);
+		break;
+	}
+	case GLC_RENDERBUFFER_STORAGE:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLenum eFormat = Read<uint32_t>();
+		GLsizei dWidth = Read<int32_t>();
+		GLsizei dHeight = Read<int32_t>();
+		glRenderbufferStorage(eTarget, eFormat, dWidth, dHeight);
+		break;
+	}
+	case GLC_FRAMEBUFFER_RENDERBUFFER:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLenum eAttachment = Read<uint32_t>();
+		GLenum eRenderbufferTarget = Read<uint32_t>();
+		GLuint uRenderbuffer = Map(m_mRenderbuffers, Read<uint32_t>());
+		glFramebufferRenderbuffer(eTarget, eAttachment, eRenderbufferTarget, uRenderbuffer);
+		break;
+	}
+	case GLC_DRAW_BUFFERS:
+	{
+		int32_t dCount = Read<int32_t>();
+		std::vector<GLenum> lBuffers;
+		for (int32_t i = 0; i < dCount && !m_bHasFailed; i++)
+		{
+			lBuffers.push_back(Read<uint32_t>());
+		}
+		glDrawBuffers((GLsizei)lBuffers.size(), lBuffers.data());
+		break;
+	}
+	case GLC_BLIT_FRAMEBUFFER:
+	{
+		GLint lCoordinates[8];
+		for (int i = 0; i < 8; i++)
+		{
+			lCoordinates[i] = Read<int32_t>();
+		}
+		GLbitfield uMask = Read<uint32_t>();
+		GLenum eFilter = Read<uint32_t>();
+		glBlitFramebuffer(lCoordinates[0], lCoordinates[1], lCoordinates[2], lCoordinates[3],
+			lCoordinates[4], lCoordinates[5], lCoordinates[6], lCoordinates[7], uMask, eFilter);
+		break;
+	}
+	case GLC_CREATE_SHADER:
+	{
+		GLenum eType = Read<uint32_t>();
+		GLuint uCaptured = Read<uint32_t>();
+		m_mPrograms[uCaptured] = glCreateShader(eType);
+		break;
+	}
+	case GLC_SHADER_SOURCE:
+	{
+		GLuint uShader = Map(m_mPrograms, Read<uint32_t>());
+		const GLchar* sSource = (const GLchar*)ReadData(uBytes);
+		GLint dLength = (GLint)uBytes;
+		glShaderSource(uShader, 1, &sSource, &dLength);
+		break;
+	}
+	case GLC_COMPILE_SHADER:
+		glCompileShader(Map(m_mPrograms, Read<uint32_t>()));
+		break;
+	case GLC_DELETE_SHADER:
+	case GLC_DELETE_PROGRAM:
+	{
+		GLuint uCaptured = Read<uint32_t>();
+		GLuint uName = Map(m_mPrograms, uCaptured);
+		if (uName == 0) break;
+		if (a_eOp == GLC_DELETE_SHADER) glDeleteShader(uName);
+		else glDeleteProgram(uName);
+		m_mPrograms.erase(uCaptured);
+		break;
+	}
+	case GLC_CREATE_PROGRAM:
+		m_mPrograms[Read<uint32_t>()] = glCreateProgram();
+		break;
+	case GLC_ATTACH_SHADER:
+	case GLC_DETACH_SHADER:
+	{
+		GLuint uProgram = Map(m_mPrograms, Read<uint32_t>());
+		GLuint uShader = Map(m_mPrograms, Read<uint32_t>());
+		if (a_eOp == GLC_ATTACH_SHADER) glAttachShader(uProgram, uShader);
+		else glDetachShader(uProgram, uShader);
+		break;
+	}
+	case GLC_LINK_PROGRAM:
+		glLinkProgram(Map(m_mPrograms, Read<uint32_t>()));
+		break;
+	case GLC_PROGRAM_PARAMETER_I:
+	{
+		GLuint uProgram = Map(m_mPrograms, Read<uint32_t>());
+		GLenum eName = Read<uint32_t>();
+		GLint dValue = Read<int32_t>();
+		glProgramParameteri(uProgram, eName, dValue);
+		break;
+	}
+	case GLC_USE_PROGRAM:
+		m_uProgram = Map(m_mPrograms, Read<uint32_t>());
+		glUseProgram(m_uProgram);
+		break;
+	case GLC_GET_UNIFORM_LOCATION:
+	{
+		GLuint uProgram = Map(m_mPrograms, Read<uint32_t>());
+		const unsigned char* pName = ReadData(uBytes);
+		std::string sName = pName != nullptr ? std::string((const char*)pName, uBytes) : "";
+		GLint dCaptured = Read<int32_t>();
+		if (dCaptured != -1)
+		{
+			m_mLocations[GL_REPLAY_LOCATION_KEY(uProgram, dCaptured)] = glGetUniformLocation(uProgram, sName.c_str());
+		}
+		else
+		{
+			glGetUniformLocation(uProgram, sName.c_str());
+		}
+		break;
+	}
+	case GLC_UNIFORM_1I:
+	{
+		GLint dLocation = MapLocation(Read<int32_t>());
+		GLint dValue = Read<int32_t>();
+		glUniform1i(dLocation, dValue);
+		break;
+	}
+	case GLC_UNIFORM_1IV:
+	{
+		GLint dLocation = MapLocation(Read<int32_t>());
+		const GLint* pValues = (const GLint*)ReadData(uBytes);
+		glUniform1iv(dLocation, uBytes / sizeof(GLint), pValues);
+		break;
+	}
+	case GLC_UNIFORM_4FV:
+	{
+		GLint dLocation = MapLocation(Read<int32_t>());
+		const GLfloat* pValues = (const GLfloat*)ReadData(uBytes);
+		glUniform4fv(dLocation, uBytes / (4 * sizeof(GLfloat)), pValues);
+		break;
+	}
+	case GLC_UNIFORM_MATRIX_4FV:
+	{
+		GLint dLocation = MapLocation(Read<int32_t>());
+		GLboolean bTranspose = Read<uint8_t>();
+		const GLfloat* pValues = (const GLfloat*)ReadData(uBytes);
+		glUniformMatrix4fv(dLocation, uBytes / (16 * sizeof(GLfloat)), bTranspose, pValues);
+		break;
+	}
+	case GLC_GEN_QUERIES:
+		ReplayGen(m_mQueries, glGenQueries);
+		break;
+	case GLC_DELETE_QUERIES:
+		ReplayDelete(m_mQueries, glDeleteQueries);
+		break;
+	case GLC_BEGIN_QUERY:
+	{
+		GLenum eTarget = Read<uint32_t>();
+		GLuint uQuery = Map(m_mQueries, Read<uint32_t>());
+		glBeginQuery(eTarget, uQuery);
+		break;
+	}
+	case GLC_END_QUERY:
+		glEndQuery(Read<uint32_t>());
+		break;
+	case GLC_QUERY_COUNTER:
+	{
+		GLuint uQuery = Map(m_mQueries, Read<uint32_t>());
+		GLenum eTarget = Read<uint32_t>();
+		glQueryCounter(uQuery, eTarget);
+		break;
+	}
+	case GLC_GET_QUERY_OBJECT:
+	{
+		GLuint uQuery = Map(m_mQueries, Read<uint32_t>());
+		GLenum eName = Read<uint32_t>();
+		GLuint64 uResult = 0;
+		if (uQuery != 0) glGetQueryObjectui64v(uQuery, eName, &uResult);
+		break;
+	}
+	case GLC_FENCE_SYNC:
+	{
+		GLenum eCondition = Read<uint32_t>();
+		GLbitfield uFlags = Read<uint32_t>();
+		m_mSyncs[Read<uint64_t>()] = glFenceSync(eCondition, uFlags);
+		break;
+	}
+	case GLC_CLIENT_WAIT_SYNC:
+	{
+		uint64_t uCaptured = Read<uint64_t>();
+		GLbitfield uFlags = Read<uint32_t>();
+		GLuint64 uTimeout = Read<uint64_t>();
+		std::unordered_map<uint64_t, GLsync>::iterator it = m_mSyncs.find(uCaptured);
+		if (it != m_mSyncs.end()) glClientWaitSync(it->second, uFlags, uTimeout);
+		break;
+	}
+	case GLC_DELETE_SYNC:
+	{
+		// Fences from before the first frame were dropped, so their deletes find nothing.
+		std::unordered_map<uint64_t, GLsync>::iterator it = m_mSyncs.find(Read<uint64_t>());
+		if (it != m_mSyncs.end())
+		{
+			glDeleteSync(it->second);
+			m_mSyncs.erase(it);
+		}
+		break;
+	}
+	case GLC_MEMORY_BARRIER:
+		glMemoryBarrier(Read<uint32_t>());
+		break;
+	default:
+		std::cout << "The replayer cannot issue " << GLCapture::GetOpName(a_eOp) << "." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+const GLCaptureHeader& GLReplayer::GetHeader(void) { return m_header; }
+const std::string& GLReplayer::GetDriver(void) { return m_sDriver; }
+const std::vector<GLReplayFrame>& GLReplayer::GetFrames(void) { return m_lFrames; }
+long long GLReplayer::GetOpCount(GLCaptureOp a_eOp) { return a_eOp < GLC_OP_COUNT ? m_lOpCounts[a_eOp] : 0; }
+
+/// <summary>
+/// Gets a percentile of sorted samples using the nearest rank.
+/// </summary>
+static float GetPercentile(const std::vector<float>& a_lSorted, float a_fPercent)
+{
+	if (a_lSorted.empty()) return 0.0f;
+	int dRank = (int)(a_fPercent / 100.0f * a_lSorted.size() + 0.5f);
+	dRank = std::min(std::max(dRank, 1), (int)a_lSorted.size());
+	return a_lSorted[dRank - 1];
+}
+
+/// <summary>
+/// Escapes the characters JSON strings cannot hold.
+/// </summary>
+static std::string EscapeJSON(const char* a_sText)
+{
+	std::string sResult = "";
+	for (const char* c = a_sText; c != nullptr && *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\') sResult += '\\';
+		if ((unsigned char)*c >= 0x20) sResult += *c;
+	}
+	return sResult;
+}
+
+bool GLReplayer::Export(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the replay results to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	std::vector<float> lFrameTimes;
+	std::vector<float> lGPUTimes;
+	float fFrameMean = 0.0f;
+	float fGPUMean = 0.0f;
+	int dErrors = 0;
+	for (int i = 0; i < m_lFrames.size(); i++)
+	{
+		lFrameTimes.push_back(m_lFrames[i].FrameMS);
+		lGPUTimes.push_back(m_lFrames[i].GPUMS);
+		fFrameMean += m_lFrames[i].FrameMS;
+		fGPUMean += m_lFrames[i].GPUMS;
+		dErrors += m_lFrames[i].Errors;
+	}
+	if (!m_lFrames.empty())
+	{
+		fFrameMean /= m_lFrames.size();
+		fGPUMean /= m_lFrames.size();
+	}
+	std::vector<float> lSorted = lFrameTimes;
+	std::sort(lSorted.begin(), lSorted.end());
+
+	writer << "{\n";
+	writer << "\t\"captured_on\": \"" << EscapeJSON(m_sDriver.c_str()) << "\",\n";
+	writer << "\t\"renderer\": \"" << EscapeJSON((const char*)glGetString(GL_RENDERER)) << "\",\n";
+	writer << "\t\"version\": \"" << EscapeJSON((const char*)glGetString(GL_VERSION)) << "\",\n";
+	writer << "\t\"width\": " << m_header.Width << ",\n";
+	writer << "\t\"height\": " << m_header.Height << ",\n";
+	writer << "\t\"frames\": " << m_lFrames.size() << ",\n";
+	writer << "\t\"gl_errors\": " << dErrors << ",\n";
+	writer << "\t\"mean_ms\": " << fFrameMean << ",\n";
+	writer << "\t\"p50_ms\": " << GetPercentile(lSorted, 50.0f) << ",\n";
+	writer << "\t\"p95_ms\": " << GetPercentile(lSorted, 95.0f) << ",\n";
+	writer << "\t\"p99_ms\": " << GetPercentile(lSorted, 99.0f) << ",\n";
+	writer << "\t\"max_ms\": " << (lSorted.empty() ? 0.0f : lSorted.back()) << ",\n";
+	writer << "\t\"gpu_mean_ms\": " << fGPUMean << ",\n";
+	writer << "\t\"calls\": {";
+	bool bIsFirst = true;
+	for (int i = 0; i < GLC_OP_COUNT; i++)
+	{
+		if (m_lOpCounts[i] == 0) continue;
+		writer << (bIsFirst ? "\n" : ",\n") << "\t\t\"" << GLCapture::GetOpName((GLCaptureOp)i) << "\": " << m_lOpCounts[i];
+		bIsFirst = false;
+	}
+	writer << "\n\t},\n";
+	writer << "\t\"frame_ms\": [";
+	for (int i = 0; i < lFrameTimes.size(); i++)
+	{
+		writer << (i == 0 ? "" : ", ") << lFrameTimes[i];
+	}
+	writer << "],\n";
+	writer << "\t\"gpu_ms\": [";
+	for (int i = 0; i < lGPUTimes.size(); i++)
+	{
+		writer << (i == 0 ? "" : ", ") << lGPUTimes[i];
+	}
+	writer << "]\n}\n";
+	return true;
+}
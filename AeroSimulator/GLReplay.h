@@ -0,0 +1,164 @@
+#ifndef __GLREPLAY_H_
+#define __GLREPLAY_H_
+
+#include "GLCapture.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+/// <summary>
+/// Timing of one replayed frame.
+/// </summary>
+struct GLReplayFrame
+{
+	int Calls;
+	int Errors;			// GL errors raised while replaying it.
+	float IssueMS;		// CPU time spent making its calls.
+	float FrameMS;		// Until the GPU finished it.
+	float GPUMS;		// Between the GPU reaching its first and last call.
+};
+
+/// <summary>
+/// Re-issues a file written by GLCapture on the current context and times every
+/// captured frame.  Object names, uniform locations and syncs are remapped to the
+/// ones this context hands out, and framebuffer 0 becomes the given target.
+/// </summary>
+class GLReplayer
+{
+private:
+	std::vector<unsigned char> m_lData;
+	size_t m_uCursor = 0;
+	bool m_bHasFailed = false;
+	GLCaptureHeader m_header = GLCaptureHeader();
+	std::string m_sDriver = "";
+
+	GLuint m_uDefaultFramebuffer = 0;
+	GLuint m_uDrawFramebuffer = 0;
+	GLuint m_uProgram = 0;
+	GLuint m_lTimers[2] = { 0, 0 };
+	std::unordered_map<GLuint, GLuint> m_mTextures;
+	std::unordered_map<GLuint, GLuint> m_mBuffers;
+	std::unordered_map<GLuint, GLuint> m_mVertexArrays;
+	std::unordered_map<GLuint, GLuint> m_mFramebuffers;
+	std::unordered_map<GLuint, GLuint> m_mRenderbuffers;
+	std::unordered_map<GLuint, GLuint> m_mQueries;
+	std::unordered_map<GLuint, GLuint> m_mPrograms;		// Shaders and programs share names.
+	std::unordered_map<uint64_t, GLsync> m_mSyncs;
+	std::unordered_map<uint64_t, GLint> m_mLocations;	// Keyed by replayed program and captured location.
+	std::unordered_map<GLenum, unsigned char*> m_mMapped;
+
+	std::vector<GLReplayFrame> m_lFrames;
+	long long m_lOpCounts[GLC_OP_COUNT];
+
+public:
+	/// <summary>
+	/// Constructs an empty replayer.
+	/// </summary>
+	GLReplayer(void);
+
+	/// <summary>
+	/// Copies the loaded capture.  Replayed objects are not copied.
+	/// </summary>
+	GLReplayer(const GLReplayer& a_pOther);
+
+	/// <summary>
+	/// Copies the loaded capture.  Replayed objects are not copied.
+	/// </summary>
+	GLReplayer& operator=(const GLReplayer& a_pOther);
+
+	/// <summary>
+	/// Reads a capture into memory, so replaying never waits on the disk.
+	/// </summary>
+	/// <returns>False if the file is missing or not a capture.</returns>
+	bool Load(const std::string& a_sFilepath);
+
+	/// <summary>
+	/// Re-issues every call of the loaded capture.
+	/// </summary>
+	/// <param name="a_uDefaultFramebuffer">Target of the calls that drew to framebuffer 0.</param>
+	/// <returns>False if the capture ends part way through a call or holds an unknown one.</returns>
+	bool Replay(GLuint a_uDefaultFramebuffer);
+
+	/// <summary>
+	/// Gets the header of the loaded capture.
+	/// </summary>
+	const GLCaptureHeader& GetHeader(void);
+
+	/// <summary>
+	/// Gets the renderer and version the capture was made on.
+	/// </summary>
+	const std::string& GetDriver(void);
+
+	/// <summary>
+	/// Gets the timing of every replayed frame from the capture's first frame on.
+	/// </summary>
+	const std::vector<GLReplayFrame>& GetFrames(void);
+
+	/// <summary>
+	/// Gets how many times the timed frames made a call.
+	/// </summary>
+	long long GetOpCount(GLCaptureOp a_eOp);
+
+	/// <summary>
+	/// Writes the frame times, their percentiles and the calls made.
+	/// </summary>
+	/// <returns>False if the file cannot be written.</returns>
+	bool Export(const std::string& a_sFilepath);
+
+private:
+	/// <summary>
+	/// Reads the next value of the capture, or 0 past its end.
+	/// </summary>
+	template <typename T>
+	T Read(void)
+	{
+		T value = T();
+		if (m_uCursor + sizeof(T) > m_lData.size())
+		{
+			m_bHasFailed = true;
+			return value;
+		}
+		memcpy(&value, &m_lData[m_uCursor], sizeof(T));
+		m_uCursor += sizeof(T);
+		return value;
+	}
+
+	/// <summary>
+	/// Reads a length and points at the bytes after it, or nullptr if there are none.
+	/// </summary>
+	const unsigned char* ReadData(uint32_t& a_uBytes);
+
+	/// <summary>
+	/// Reads pixels, or an unpack buffer offset in their place.
+	/// </summary>
+	const GLvoid* ReadPixels(void);
+
+	/// <summary>
+	/// Gets the replayed name of a captured one.  Names made before the capture become 0.
+	/// </summary>
+	GLuint Map(const std::unordered_map<GLuint, GLuint>& a_mNames, GLuint a_uName);
+
+	/// <summary>
+	/// Gets the replayed location of a captured one in the bound program.
+	/// </summary>
+	GLint MapLocation(GLint a_dLocation);
+
+	/// <summary>
+	/// Makes as many objects as a captured Gen call and remembers their names.
+	/// </summary>
+	void ReplayGen(std::unordered_map<GLuint, GLuint>& a_mNames, void (GLAPIENTRY* a_pfnGen)(GLsizei, GLuint*));
+
+	/// <summary>
+	/// Deletes the objects of a captured Delete call and forgets their names.
+	/// </summary>
+	void ReplayDelete(std::unordered_map<GLuint, GLuint>& a_mNames, void (GLAPIENTRY* a_pfnDelete)(GLsizei, const GLuint*));
+
+	/// <summary>
+	/// Re-issues one call whose op was just read.
+	/// </summary>
+	/// <returns>False if the op is unknown.</returns>
+	bool ReplayCall(GLCaptureOp a_eOp);
+};
+
+#endif //__GLREPLAY_H_
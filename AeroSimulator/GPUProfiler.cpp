@@ -0,0 +1,223 @@
+#include "GPUProfiler.h"
+#include "Debug.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const GLenum STATISTIC_TARGETS[GPU_PROFILER_STATISTICS] =
+{
+	GL_VERTICES_SUBMITTED_ARB,
+	GL_PRIMITIVES_SUBMITTED_ARB,
+	GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+};
+
+GPUProfiler::GPUProfiler(void)
+{
+	for (int i = 0; i < GPU_PROFILER_LATENCY; i++)
+	{
+		GLCall(glGenQueries(GPU_PROFILER_MAX_SCOPES * 2, m_lFrames[i].Timestamps));
+		GLCall(glGenQueries(GPU_PROFILER_MAX_SCOPES * GPU_PROFILER_STATISTICS, &m_lFrames[i].Statistics[0][0]));
+		m_lFrames[i].ScopeCount = 0;
+	}
+
+	// GLEW 2.1 predates the extension, so the extension strings are searched directly.
+	GLint dCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &dCount);
+	for (int i = 0; i < dCount; i++)
+	{
+		const char* sName = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (sName != nullptr && strcmp(sName, "GL_ARB_pipeline_statistics_query") == 0)
+		{
+			m_bSupportsStatistics = true;
+			break;
+		}
+	}
+}
+
+GPUProfiler::~GPUProfiler(void)
+{
+	for (int i = 0; i < GPU_PROFILER_LATENCY; i++)
+	{
+		glDeleteQueries(GPU_PROFILER_MAX_SCOPES * 2, m_lFrames[i].Timestamps);
+		glDeleteQueries(GPU_PROFILER_MAX_SCOPES * GPU_PROFILER_STATISTICS, &m_lFrames[i].Statistics[0][0]);
+	}
+}
+
+GPUProfiler::GPUProfiler(const GPUProfiler& a_pOther) : GPUProfiler()
+{
+	*this = a_pOther;
+}
+
+GPUProfiler& GPUProfiler::operator=(const GPUProfiler& a_pOther)
+{
+	// Queries cannot be shared, so only the settings and results are copied.
+	m_bIsEnabled = a_pOther.m_bIsEnabled;
+	m_bUseStatistics = a_pOther.m_bUseStatistics;
+	m_lResults = a_pOther.m_lResults;
+	m_lTotals = a_pOther.m_lTotals;
+	return *this;
+}
+
+void GPUProfiler::SetEnabled(bool a_bIsEnabled) { m_bIsEnabled = a_bIsEnabled; }
+bool GPUProfiler::IsEnabled(void) { return m_bIsEnabled; }
+void GPUProfiler::SetStatisticsEnabled(bool a_bUseStatistics) { m_bUseStatistics = a_bUseStatistics && m_bSupportsStatistics; }
+bool GPUProfiler::IsStatisticsEnabled(void) { return m_bUseStatistics; }
+bool GPUProfiler::SupportsStatistics(void) { return m_bSupportsStatistics; }
+const std::vector<GPUScope>& GPUProfiler::GetResults(void) { return m_lResults; }
+void GPUProfiler::ResetTotals(void) { m_lTotals.clear(); }
+
+void GPUProfiler::BeginFrame(void)
+{
+	// Scopes left open by the previous frame are closed so the ring stays consistent.
+	while (!m_lOpenScopes.empty())
+	{
+		EndScope();
+	}
+
+	// The slot about to be reused holds the oldest frame in flight.
+	m_dFrame = (m_dFrame + 1) % GPU_PROFILER_LATENCY;
+	Frame& frame = m_lFrames[m_dFrame];
+	if (frame.ScopeCount > 0)
+	{
+		Resolve(frame);
+	}
+	frame.ScopeCount = 0;
+}
+
+void GPUProfiler::BeginScope(const std::string& a_sName)
+{
+	Frame& frame = m_lFrames[m_dFrame];
+	if (!m_bIsEnabled || frame.ScopeCount == GPU_PROFILER_MAX_SCOPES)
+	{
+		// Still tracked so the matching EndScope is ignored.
+		m_lOpenScopes.push_back(-1);
+		return;
+	}
+
+	int dScope = frame.ScopeCount++;
+	frame.Names[dScope] = a_sName;
+	frame.Depths[dScope] = (int)m_lOpenScopes.size();
+	frame.HasStatistics[dScope] = false;
+	GLCall(glQueryCounter(frame.Timestamps[dScope * 2], GL_TIMESTAMP));
+
+	if (m_bUseStatistics && m_dStatisticsScope == -1)
+	{
+		for (int i = 0; i < GPU_PROFILER_STATISTICS; i++)
+		{
+			GLCall(glBeginQuery(STATISTIC_TARGETS[i], frame.Statistics[dScope][i]));
+		}
+		frame.HasStatistics[dScope] = true;
+		m_dStatisticsScope = dScope;
+	}
+
+	m_lOpenScopes.push_back(dScope);
+}
+
+void GPUProfiler::EndScope(void)
+{
+	if (m_lOpenScopes.empty()) return;
+
+	int dScope = m_lOpenScopes.back();
+	m_lOpenScopes.pop_back();
+	if (dScope == -1) return;
+
+	Frame& frame = m_lFrames[m_dFrame];
+	if (m_dStatisticsScope == dScope)
+	{
+		for (int i = 0; i < GPU_PROFILER_STATISTICS; i++)
+		{
+			GLCall(glEndQuery(STATISTIC_TARGETS[i]));
+		}
+		m_dStatisticsScope = -1;
+	}
+	GLCall(glQueryCounter(frame.Timestamps[dScope * 2 + 1], GL_TIMESTAMP));
+}
+
+float GPUProfiler::GetFrameTime(void)
+{
+	float fTotal = 0.0f;
+	for (int i = 0; i < m_lResults.size(); i++)
+	{
+		if (m_lResults[i].Depth == 0)
+		{
+			fTotal += m_lResults[i].MS;
+		}
+	}
+	return fTotal;
+}
+
+void GPUProfiler::Resolve(Frame& a_frame)
+{
+	m_lResults.resize(a_frame.ScopeCount);
+	for (int i = 0; i < a_frame.ScopeCount; i++)
+	{
+		GLuint64 uBegin = 0;
+		GLuint64 uEnd = 0;
+		GLCall(glGetQueryObjectui64v(a_frame.Timestamps[i * 2], GL_QUERY_RESULT, &uBegin));
+		GLCall(glGetQueryObjectui64v(a_frame.Timestamps[i * 2 + 1], GL_QUERY_RESULT, &uEnd));
+
+		GPUScope& scope = m_lResults[i];
+		scope.Name = a_frame.Names[i];
+		scope.Depth = a_frame.Depths[i];
+		scope.MS = uEnd > uBegin ? (uEnd - uBegin) / 1000000.0f : 0.0f;
+		scope.Vertices = 0;
+		scope.Primitives = 0;
+		scope.Fragments = 0;
+		if (a_frame.HasStatistics[i])
+		{
+			GLCall(glGetQueryObjectui64v(a_frame.Statistics[i][0], GL_QUERY_RESULT, &scope.Vertices));
+			GLCall(glGetQueryObjectui64v(a_frame.Statistics[i][1], GL_QUERY_RESULT, &scope.Primitives));
+			GLCall(glGetQueryObjectui64v(a_frame.Statistics[i][2], GL_QUERY_RESULT, &scope.Fragments));
+		}
+
+		// Adding to the totals of the scope with the same name.
+		GPUScopeTotals* pTotals = nullptr;
+		for (int j = 0; j < m_lTotals.size(); j++)
+		{
+			if (m_lTotals[j].Name == scope.Name)
+			{
+				pTotals = &m_lTotals[j];
+				break;
+			}
+		}
+		if (pTotals == nullptr)
+		{
+			GPUScopeTotals totals = GPUScopeTotals();
+			totals.Name = scope.Name;
+			m_lTotals.push_back(totals);
+			pTotals = &m_lTotals.back();
+		}
+		pTotals->Frames++;
+		pTotals->TotalMS += scope.MS;
+		pTotals->MaxMS = scope.MS > pTotals->MaxMS ? scope.MS : pTotals->MaxMS;
+		pTotals->Vertices += (double)scope.Vertices;
+		pTotals->Primitives += (double)scope.Primitives;
+		pTotals->Fragments += (double)scope.Fragments;
+	}
+}
+
+bool GPUProfiler::Export(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the GPU profile to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	writer << "{\n\t\"statistics\": " << (m_bUseStatistics ? "true" : "false") << ",\n\t\"scopes\": [";
+	for (int i = 0; i < m_lTotals.size(); i++)
+	{
+		const GPUScopeTotals& totals = m_lTotals[i];
+		double dFrames = totals.Frames > 0 ? (double)totals.Frames : 1.0;
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t{ \"name\": \"" << totals.Name << "\""
+			<< ", \"frames\": " << totals.Frames
+			<< ", \"mean_ms\": " << totals.TotalMS / dFrames
+			<< ", \"max_ms\": " << totals.MaxMS
+			<< ", \"vertices\": " << totals.Vertices / dFrames
+			<< ", \"primitives\": " << totals.Primitives / dFrames
+			<< ", \"fragments\": " << totals.Fragments / dFrames << " }";
+	}
+	writer << "\n\t]\n}\n";
+	return true;
+}
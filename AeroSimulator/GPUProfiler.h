@@ -0,0 +1,172 @@
+#ifndef __GPUPROFILER_H_
+#define __GPUPROFILER_H_
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+// ARB_pipeline_statistics_query tokens.  GLEW 2.1 predates the extension.
+#ifndef GL_VERTICES_SUBMITTED_ARB
+#define GL_VERTICES_SUBMITTED_ARB 0x82EE
+#define GL_PRIMITIVES_SUBMITTED_ARB 0x82EF
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
+
+// Frames a query result is left in flight before it is read, so reading never stalls.
+#define GPU_PROFILER_LATENCY 4
+
+// Maximum number of measured scopes in a single frame.
+#define GPU_PROFILER_MAX_SCOPES 16
+
+// Number of pipeline statistics gathered per scope.
+#define GPU_PROFILER_STATISTICS 3
+
+/// <summary>
+/// GPU time and pipeline statistics of one scope in a resolved frame.
+/// </summary>
+struct GPUScope
+{
+	std::string Name;
+	int Depth;					// Nesting level, 0 for the outermost scopes.
+	float MS;
+	GLuint64 Vertices;			// Only filled in when statistics are gathered.
+	GLuint64 Primitives;
+	GLuint64 Fragments;
+};
+
+/// <summary>
+/// Running totals of a scope across every resolved frame, for export.
+/// </summary>
+struct GPUScopeTotals
+{
+	std::string Name;
+	int Frames;
+	double TotalMS;
+	float MaxMS;
+	double Vertices;
+	double Primitives;
+	double Fragments;
+};
+
+/// <summary>
+/// Times GPU work with pairs of GL_TIMESTAMP queries so scopes can nest, and optionally
+/// counts vertices, primitives and fragment invocations with ARB_pipeline_statistics_query.
+/// Frames cycle through a ring of queries, so results are a few frames old but never stall.
+/// </summary>
+class GPUProfiler
+{
+private:
+	/// <summary>
+	/// Queries of one frame in flight.
+	/// </summary>
+	struct Frame
+	{
+		GLuint Timestamps[GPU_PROFILER_MAX_SCOPES * 2];
+		GLuint Statistics[GPU_PROFILER_MAX_SCOPES][GPU_PROFILER_STATISTICS];
+		bool HasStatistics[GPU_PROFILER_MAX_SCOPES];
+		std::string Names[GPU_PROFILER_MAX_SCOPES];
+		int Depths[GPU_PROFILER_MAX_SCOPES];
+		int ScopeCount;
+	};
+
+	Frame m_lFrames[GPU_PROFILER_LATENCY];
+	int m_dFrame = 0;
+	bool m_bIsEnabled = false;
+	bool m_bUseStatistics = false;
+	bool m_bSupportsStatistics = false;
+	std::vector<int> m_lOpenScopes;
+	int m_dStatisticsScope = -1;	// Statistics queries cannot nest, so only one scope holds them.
+
+	std::vector<GPUScope> m_lResults;
+	std::vector<GPUScopeTotals> m_lTotals;
+
+public:
+	/// <summary>
+	/// Creates the query objects.  Requires a current GL context.
+	/// </summary>
+	GPUProfiler(void);
+
+	/// <summary>
+	/// Deletes the query objects.
+	/// </summary>
+	~GPUProfiler(void);
+
+	/// <summary>
+	/// Copy constructor for the GPUProfiler.  Creates its own queries.
+	/// </summary>
+	GPUProfiler(const GPUProfiler& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the GPUProfiler.  Keeps its own queries.
+	/// </summary>
+	GPUProfiler& operator=(const GPUProfiler& a_pOther);
+
+	/// <summary>
+	/// Sets whether scopes are measured.
+	/// </summary>
+	void SetEnabled(bool a_bIsEnabled);
+
+	/// <summary>
+	/// Gets whether scopes are measured.
+	/// </summary>
+	bool IsEnabled(void);
+
+	/// <summary>
+	/// Sets whether pipeline statistics are gathered.  Ignored without driver support.
+	/// </summary>
+	void SetStatisticsEnabled(bool a_bUseStatistics);
+
+	/// <summary>
+	/// Gets whether pipeline statistics are gathered.
+	/// </summary>
+	bool IsStatisticsEnabled(void);
+
+	/// <summary>
+	/// Gets whether the driver supports ARB_pipeline_statistics_query.
+	/// </summary>
+	bool SupportsStatistics(void);
+
+	/// <summary>
+	/// Reads back the oldest frame in flight and starts recording a new one.
+	/// </summary>
+	void BeginFrame(void);
+
+	/// <summary>
+	/// Starts measuring the following GPU work.  Scopes may nest.
+	/// </summary>
+	void BeginScope(const std::string& a_sName);
+
+	/// <summary>
+	/// Stops measuring the innermost open scope.
+	/// </summary>
+	void EndScope(void);
+
+	/// <summary>
+	/// Gets the scopes of the last resolved frame in the order they began.
+	/// </summary>
+	const std::vector<GPUScope>& GetResults(void);
+
+	/// <summary>
+	/// Gets the GPU time of the outermost scopes of the last resolved frame.
+	/// </summary>
+	float GetFrameTime(void);
+
+	/// <summary>
+	/// Forgets the running totals.
+	/// </summary>
+	void ResetTotals(void);
+
+	/// <summary>
+	/// Writes the average and worst time and the average statistics of every scope as JSON.
+	/// </summary>
+	/// <returns>False if the file could not be written.</returns>
+	bool Export(const std::string& a_sFilepath);
+
+private:
+	/// <summary>
+	/// Reads the queries of a finished frame into the results and totals.
+	/// </summary>
+	void Resolve(Frame& a_frame);
+};
+
+#endif //__GPUPROFILER_H_
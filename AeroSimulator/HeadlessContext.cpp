@@ -0,0 +1,291 @@
+#include "HeadlessContext.h"
+#include "Debug.h"
+#include <iostream>
+
+#ifdef AERO_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#ifdef AERO_HEADLESS_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+HeadlessContext::HeadlessContext(void) {}
+
+HeadlessContext::~HeadlessContext(void)
+{
+	Release();
+}
+
+HeadlessContext::HeadlessContext(const HeadlessContext& a_pOther)
+{
+	// Contexts cannot be shared, so a new one is made.
+	if (a_pOther.m_bIsCreated)
+	{
+		Create(a_pOther.m_eBackend, a_pOther.m_dWidth, a_pOther.m_dHeight);
+	}
+}
+
+HeadlessContext& HeadlessContext::operator=(const HeadlessContext& a_pOther)
+{
+	// Contexts cannot be shared, so a new one is made.
+	Release();
+	if (a_pOther.m_bIsCreated)
+	{
+		Create(a_pOther.m_eBackend, a_pOther.m_dWidth, a_pOther.m_dHeight);
+	}
+	return *this;
+}
+
+bool HeadlessContext::Create(HeadlessBackend a_eBackend, int a_dWidth, int a_dHeight)
+{
+	Release();
+	m_eBackend = a_eBackend;
+	m_dWidth = a_dWidth;
+	m_dHeight = a_dHeight;
+
+	bool bIsCurrent = m_eBackend == HEADLESS_EGL ? CreateEGL() : CreateOSMesa();
+	if (!bIsCurrent)
+	{
+		Release();
+		return false;
+	}
+
+	// Only the core entry points matter here.  Without a window system GLEW may
+	// report the WGL/GLX part as missing after it has loaded them.
+	glewExperimental = GL_TRUE;
+	GLenum eResult = glewInit();
+	if (eResult != GLEW_OK)
+	{
+		std::cout << "GLEW reported: " << glewGetErrorString(eResult) << std::endl;
+	}
+	if (glGenFramebuffers == nullptr)
+	{
+		std::cout << "GLEW could not load GL from the " << GetBackendName() << " context." << std::endl;
+		Release();
+		return false;
+	}
+
+	if (!CreateFramebuffer())
+	{
+		Release();
+		return false;
+	}
+
+	m_bIsCreated = true;
+	std::cout << "Headless " << GetBackendName() << " context: " << glGetString(GL_RENDERER)
+		<< ", " << glGetString(GL_VERSION) << std::endl;
+	return true;
+}
+
+bool HeadlessContext::SetCurrent(bool a_bIsCurrent)
+{
+	if (!m_bIsCreated) return false;
+
+#ifdef AERO_HEADLESS_EGL
+	if (m_eBackend == HEADLESS_EGL)
+	{
+		EGLContext context = a_bIsCurrent ? (EGLContext)m_pContext : EGL_NO_CONTEXT;
+		return eglMakeCurrent((EGLDisplay)m_pDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_TRUE;
+	}
+#endif
+
+#ifdef AERO_HEADLESS_OSMESA
+	if (m_eBackend == HEADLESS_OSMESA)
+	{
+		// OSMesa has no way to release a context, binding it elsewhere moves it.
+		if (!a_bIsCurrent) return true;
+		return OSMesaMakeCurrent((OSMesaContext)m_pContext, m_lOSMesaBuffer.data(), GL_UNSIGNED_BYTE, 1, 1) == GL_TRUE;
+	}
+#endif
+
+	return false;
+}
+
+GLuint HeadlessContext::GetFramebuffer(void) { return m_uFramebuffer; }
+int HeadlessContext::GetWidth(void) { return m_dWidth; }
+int HeadlessContext::GetHeight(void) { return m_dHeight; }
+
+const char* HeadlessContext::GetBackendName(void)
+{
+	return m_eBackend == HEADLESS_EGL ? "EGL" : "OSMesa";
+}
+
+bool HeadlessContext::ParseBackend(const std::string& a_sName, HeadlessBackend& a_eBackend)
+{
+	if (a_sName == "egl")
+	{
+		a_eBackend = HEADLESS_EGL;
+		return true;
+	}
+	if (a_sName == "osmesa")
+	{
+		a_eBackend = HEADLESS_OSMESA;
+		return true;
+	}
+	return false;
+}
+
+// - - Private Methods - -
+
+bool HeadlessContext::CreateEGL(void)
+{
+#ifdef AERO_HEADLESS_EGL
+	// Mesa's surfaceless platform needs neither a display server nor a GPU.
+	EGLDisplay display = EGL_NO_DISPLAY;
+	PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (eglGetPlatformDisplayEXT != nullptr)
+	{
+		display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	EGLint dMajor = 0;
+	EGLint dMinor = 0;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &dMajor, &dMinor))
+	{
+		std::cout << "Could not initialize an EGL display." << std::endl;
+		return false;
+	}
+	m_pDisplay = display;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cout << "EGL does not support desktop GL." << std::endl;
+		return false;
+	}
+
+	// No surface is ever created, but the default surface type of a window would match no config.
+	EGLint lConfigAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+	EGLConfig config;
+	EGLint dConfigs = 0;
+	if (!eglChooseConfig(display, lConfigAttributes, &config, 1, &dConfigs) || dConfigs == 0)
+	{
+		std::cout << "No EGL config supports desktop GL." << std::endl;
+		return false;
+	}
+
+	// A compatibility context, matching what SFML creates for the window.
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+	if (context == EGL_NO_CONTEXT)
+	{
+		std::cout << "Could not create an EGL context." << std::endl;
+		return false;
+	}
+	m_pContext = context;
+
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		std::cout << "EGL does not support surfaceless contexts." << std::endl;
+		return false;
+	}
+	return true;
+#else
+	std::cout << "EGL support was not compiled in.  Define AERO_HEADLESS_EGL." << std::endl;
+	return false;
+#endif
+}
+
+bool HeadlessContext::CreateOSMesa(void)
+{
+#ifdef AERO_HEADLESS_OSMESA
+	// Depth lives in the framebuffer object, so the context itself gets none.
+	const int lAttributes[] =
+	{
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 0,
+		OSMESA_PROFILE, OSMESA_COMPAT_PROFILE,
+		0
+	};
+	OSMesaContext context = OSMesaCreateContextAttribs(lAttributes, nullptr);
+	if (context == nullptr)
+	{
+		std::cout << "Could not create an OSMesa context." << std::endl;
+		return false;
+	}
+	m_pContext = context;
+
+	// Making a context current requires a buffer, even though nothing draws into it.
+	m_lOSMesaBuffer.resize(4);
+	if (!OSMesaMakeCurrent(context, m_lOSMesaBuffer.data(), GL_UNSIGNED_BYTE, 1, 1))
+	{
+		std::cout << "Could not make the OSMesa context current." << std::endl;
+		return false;
+	}
+	return true;
+#else
+	std::cout << "OSMesa support was not compiled in.  Define AERO_HEADLESS_OSMESA." << std::endl;
+	return false;
+#endif
+}
+
+bool HeadlessContext::CreateFramebuffer(void)
+{
+	GLCall(glGenTextures(1, &m_uColor));
+	GLCall(glBindTexture(GL_TEXTURE_2D, m_uColor));
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_dWidth, m_dHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+	GLCall(glGenRenderbuffers(1, &m_uDepth));
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_uDepth));
+	GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_dWidth, m_dHeight));
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+	GLCall(glGenFramebuffers(1, &m_uFramebuffer));
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_uFramebuffer));
+	GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_uColor, 0));
+	GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_uDepth));
+	GLenum eStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	// Leaving it bound so clears and draws outside of the frame graph land in it too.
+	if (eStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "The headless framebuffer is incomplete: " << eStatus << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void HeadlessContext::Release(void)
+{
+	if (m_pContext != nullptr)
+	{
+		if (m_uFramebuffer != 0) glDeleteFramebuffers(1, &m_uFramebuffer);
+		if (m_uDepth != 0) glDeleteRenderbuffers(1, &m_uDepth);
+		if (m_uColor != 0) glDeleteTextures(1, &m_uColor);
+	}
+	m_uFramebuffer = 0;
+	m_uDepth = 0;
+	m_uColor = 0;
+
+#ifdef AERO_HEADLESS_EGL
+	if (m_eBackend == HEADLESS_EGL && m_pDisplay != nullptr)
+	{
+		eglMakeCurrent((EGLDisplay)m_pDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (m_pContext != nullptr)
+		{
+			eglDestroyContext((EGLDisplay)m_pDisplay, (EGLContext)m_pContext);
+		}
+		eglTerminate((EGLDisplay)m_pDisplay);
+	}
+#endif
+
+#ifdef AERO_HEADLESS_OSMESA
+	if (m_eBackend == HEADLESS_OSMESA && m_pContext != nullptr)
+	{
+		OSMesaDestroyContext((OSMesaContext)m_pContext);
+	}
+#endif
+
+	m_pDisplay = nullptr;
+	m_pContext = nullptr;
+	m_lOSMesaBuffer.clear();
+	m_bIsCreated = false;
+}
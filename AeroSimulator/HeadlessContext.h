@@ -0,0 +1,127 @@
+#ifndef __HEADLESSCONTEXT_H_
+#define __HEADLESSCONTEXT_H_
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+// Backends compiled into the build.  Define AERO_HEADLESS_EGL to link against libEGL
+// and AERO_HEADLESS_OSMESA to link against libOSMesa.  GLEW has to be built with the
+// matching GLEW_EGL or GLEW_OSMESA flag so it loads entry points through that API.
+
+/// <summary>
+/// API used to create a GL context without a window.
+/// </summary>
+enum HeadlessBackend
+{
+	HEADLESS_EGL = 0,		// EGL without a surface.  Runs on llvmpipe or a GPU.
+	HEADLESS_OSMESA			// Mesa's off screen software renderer.
+};
+
+/// <summary>
+/// A GL context with no window or display, rendering into an off screen framebuffer.
+/// Used to run the renderer on build agents.
+/// </summary>
+class HeadlessContext
+{
+private:
+	HeadlessBackend m_eBackend = HEADLESS_EGL;
+	int m_dWidth = 0;
+	int m_dHeight = 0;
+	bool m_bIsCreated = false;
+
+	// EGLDisplay and EGLContext, or the OSMesaContext, kept opaque so the
+	// platform headers stay out of the rest of the engine.
+	void* m_pDisplay = nullptr;
+	void* m_pContext = nullptr;
+	std::vector<unsigned char> m_lOSMesaBuffer;		// OSMesa needs memory to make a context current.
+
+	GLuint m_uFramebuffer = 0;
+	GLuint m_uColor = 0;
+	GLuint m_uDepth = 0;
+
+public:
+	/// <summary>
+	/// Constructs a HeadlessContext.  Nothing is created until Create.
+	/// </summary>
+	HeadlessContext(void);
+
+	/// <summary>
+	/// Destroys the framebuffer and the context.
+	/// </summary>
+	~HeadlessContext(void);
+
+	/// <summary>
+	/// Copy constructor for the HeadlessContext.  Creates a new context like the other one.
+	/// </summary>
+	HeadlessContext(const HeadlessContext& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the HeadlessContext.  Recreates the context like the other one.
+	/// </summary>
+	HeadlessContext& operator=(const HeadlessContext& a_pOther);
+
+	/// <summary>
+	/// Creates the context, makes it current, loads GLEW and creates the framebuffer.
+	/// </summary>
+	/// <param name="a_eBackend">API used to create the context.</param>
+	/// <param name="a_dWidth">Width of the off screen framebuffer.</param>
+	/// <param name="a_dHeight">Height of the off screen framebuffer.</param>
+	/// <returns>False if the backend is not compiled in or the context could not be made.</returns>
+	bool Create(HeadlessBackend a_eBackend, int a_dWidth, int a_dHeight);
+
+	/// <summary>
+	/// Makes the context current on the calling thread, or releases it.
+	/// </summary>
+	/// <returns>False if the backend refused.</returns>
+	bool SetCurrent(bool a_bIsCurrent);
+
+	/// <summary>
+	/// Gets the framebuffer standing in for the window.
+	/// </summary>
+	GLuint GetFramebuffer(void);
+
+	/// <summary>
+	/// Gets the width of the framebuffer.
+	/// </summary>
+	int GetWidth(void);
+
+	/// <summary>
+	/// Gets the height of the framebuffer.
+	/// </summary>
+	int GetHeight(void);
+
+	/// <summary>
+	/// Gets the name of the backend for logs and reports.
+	/// </summary>
+	const char* GetBackendName(void);
+
+	/// <summary>
+	/// Parses "egl" or "osmesa".
+	/// </summary>
+	/// <returns>False if the name is not a backend.</returns>
+	static bool ParseBackend(const std::string& a_sName, HeadlessBackend& a_eBackend);
+
+private:
+	/// <summary>
+	/// Creates a surfaceless EGL context with the desktop GL API.
+	/// </summary>
+	bool CreateEGL(void);
+
+	/// <summary>
+	/// Creates an OSMesa context bound to a small client side buffer.
+	/// </summary>
+	bool CreateOSMesa(void);
+
+	/// <summary>
+	/// Creates the color and depth attachments and the framebuffer.
+	/// </summary>
+	bool CreateFramebuffer(void);
+
+	/// <summary>
+	/// Releases everything Create made.
+	/// </summary>
+	void Release(void);
+};
+
+#endif //__HEADLESSCONTEXT_H_
@@ -1,24 +1,207 @@
 #include "Application.h"
 #include "Debug.h"
+#include "AllocationCounter.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
 
-int main()
+// Headless benchmark usage, e.g. on a Linux build agent with Mesa:
+//   AeroSimulator --benchmark [--backend egl|osmesa] [--frames 600]
+//                 [--width 1280] [--height 720] [--output benchmark.json]
+//                 [--entities 0] [--single-thread]
+//                 [--record-threads 1] [--record-scaling] [--sim-rate 120]
+//                 [--target-fps 0] [--low-latency]
+//                 [--dynamic-resolution <gpu ms>] [--min-scale 0.5] [--max-scale 1.0]
+//                 [--gpu-profile] [--pipeline-statistics] [--cpu-trace] [--perf-counters]
+// --record-scaling repeats the run for 1 up to every recording thread, writing
+// one report per count with a _t<count> suffix before the extension.
+// Every run also writes its frame and stage times as <output>_frames.csv and
+// their percentiles and histogram as <output>_frames.json.
+// --cpu-trace writes the last frames' CPU zones as <output>_trace.json, which
+// chrome://tracing and ui.perfetto.dev open.  --perf-counters adds hardware
+// counters to every zone on Linux and writes their totals as <output>_counters.json.
+//
+// Any run, windowed or benchmark, can record its GL calls for the replayer with
+//   [--gl-capture capture.aeroglc] [--capture-start 0] [--capture-frames 60]
+// Frames before --capture-start only keep the calls later frames depend on.
+// Any run can also start in a debug view with
+//   [--debug-view none|overdraw|draw_cost|lod|culling|wireframe]
+// and check that its frames stop allocating once warmed up with
+//   [--alloc-check off|report|assert]
+// which counts every allocation in builds defining AERO_COUNT_ALLOCATIONS.
+// Run it from the _Binary folder so the shaders, models and textures are found.
+//
+// On Linux the engine is built from this folder with:
+//   g++ -std=c++17 -O2 -pthread -DAERO_HEADLESS_EGL -Iinclude -I. -o AeroSimulator *.cpp
+//       ImGui/imgui.cpp ImGui/imgui_demo.cpp ImGui/imgui_draw.cpp ImGui/imgui_tables.cpp
+//       ImGui/imgui_widgets.cpp ImGui/imgui_impl_opengl3.cpp
+//       -lsfml-window -lsfml-system -lfreeimage -lGLEW -lEGL -lGL
+// needing the SFML, FreeImage, GLEW and EGL development packages.  Adding
+// -DAERO_HEADLESS_OSMESA and -lOSMesa also builds the software backend, and
+// -DAERO_COUNT_ALLOCATIONS the allocation counting of the Debug configurations.
+// The Win32 ImGui backend is left out, the GUI is only set up on Windows.
+
+int main(int argc, char** argv)
 {
+	// Reading the benchmark options.
+	bool bIsBenchmark = false;
+	HeadlessBackend eBackend = HEADLESS_EGL;
+	int dFrames = 600;
+	uint uWidth = 1280;
+	uint uHeight = 720;
+	std::string sOutput = "benchmark.json";
+	int dExtraEntities = 0;
+	bool bUseRenderThread = true;
+	int dRecordThreads = 1;
+	bool bIsRecordScaling = false;
+	float fSimulationRate = SIMULATION_RATE;
+	float fTargetFramerate = 0.0f;
+	bool bUseLowLatency = false;
+	float fResolutionTargetMS = 0.0f;
+	float fMinScale = DYNAMIC_RES_MIN_SCALE;
+	float fMaxScale = DYNAMIC_RES_MAX_SCALE;
+	bool bUseGPUProfiler = false;
+	bool bUsePipelineStatistics = false;
+	bool bUseCPUProfiler = false;
+	bool bUsePerfCounters = false;
+	std::string sCapture = "";
+	int dCaptureStart = 0;
+	int dCaptureFrames = 60;
+	DebugViewMode eDebugView = DEBUG_VIEW_NONE;
+	AllocationCheck eAllocationCheck = ALLOCATION_CHECK_OFF;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string sArg = argv[i];
+		bool bHasValue = i + 1 < argc;
+		if (sArg == "--benchmark")
+		{
+			bIsBenchmark = true;
+		}
+		else if (sArg == "--backend" && bHasValue)
+		{
+			if (!HeadlessContext::ParseBackend(argv[++i], eBackend))
+			{
+				std::cout << "Unknown backend " << argv[i] << ", expected egl or osmesa." << std::endl;
+				return 1;
+			}
+		}
+		else if (sArg == "--frames" && bHasValue) dFrames = std::atoi(argv[++i]);
+		else if (sArg == "--width" && bHasValue) uWidth = (uint)std::atoi(argv[++i]);
+		else if (sArg == "--height" && bHasValue) uHeight = (uint)std::atoi(argv[++i]);
+		else if (sArg == "--output" && bHasValue) sOutput = argv[++i];
+		else if (sArg == "--entities" && bHasValue) dExtraEntities = std::atoi(argv[++i]);
+		else if (sArg == "--single-thread") bUseRenderThread = false;
+		else if (sArg == "--record-threads" && bHasValue) dRecordThreads = std::atoi(argv[++i]);
+		else if (sArg == "--record-scaling") bIsRecordScaling = true;
+		else if (sArg == "--sim-rate" && bHasValue) fSimulationRate = (float)std::atof(argv[++i]);
+		else if (sArg == "--target-fps" && bHasValue) fTargetFramerate = (float)std::atof(argv[++i]);
+		else if (sArg == "--low-latency") bUseLowLatency = true;
+		else if (sArg == "--dynamic-resolution" && bHasValue) fResolutionTargetMS = (float)std::atof(argv[++i]);
+		else if (sArg == "--min-scale" && bHasValue) fMinScale = (float)std::atof(argv[++i]);
+		else if (sArg == "--max-scale" && bHasValue) fMaxScale = (float)std::atof(argv[++i]);
+		else if (sArg == "--gpu-profile") bUseGPUProfiler = true;
+		else if (sArg == "--pipeline-statistics") bUseGPUProfiler = bUsePipelineStatistics = true;
+		else if (sArg == "--cpu-trace") bUseCPUProfiler = true;
+		else if (sArg == "--perf-counters") bUseCPUProfiler = bUsePerfCounters = true;
+		else if (sArg == "--gl-capture" && bHasValue) sCapture = argv[++i];
+		else if (sArg == "--capture-start" && bHasValue) dCaptureStart = std::atoi(argv[++i]);
+		else if (sArg == "--capture-frames" && bHasValue) dCaptureFrames = std::atoi(argv[++i]);
+		else if (sArg == "--debug-view" && bHasValue)
+		{
+			if (!DebugView::ParseMode(argv[++i], eDebugView))
+			{
+				std::cout << "Unknown debug view " << argv[i] << "." << std::endl;
+				return 1;
+			}
+		}
+		else if (sArg == "--alloc-check" && bHasValue)
+		{
+			if (!AllocationCounter::ParseCheck(argv[++i], eAllocationCheck))
+			{
+				std::cout << "Unknown allocation check " << argv[i] << ", expected off, report or assert." << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	AllocationCounter::SetCheck(eAllocationCheck);
+	if (eAllocationCheck != ALLOCATION_CHECK_OFF && !AllocationCounter::IsAvailable())
+	{
+		std::cout << "Only ImGui's allocations are counted, build with AERO_COUNT_ALLOCATIONS to count the rest." << std::endl;
+	}
+
+	// Armed before the context exists, recording starts as soon as GL is loaded.
+	if (!sCapture.empty() && !GLCapture::Open(sCapture, dCaptureStart, dCaptureFrames))
+	{
+		return 1;
+	}
+
+	if (bIsBenchmark)
+	{
+		Application* app = new Application();
+		bool bSucceeded = app->InitHeadless(eBackend, uWidth, uHeight);
+		if (bSucceeded)
+		{
+			app->AddBenchmarkEntities(dExtraEntities);
+			app->SetSimulationRate(fSimulationRate);
+			app->SetTargetFramerate(fTargetFramerate);
+			app->SetLowLatency(bUseLowLatency);
+			app->SetDebugView(eDebugView);
+			if (bUseGPUProfiler)
+			{
+				app->EnableGPUProfiler(bUsePipelineStatistics);
+			}
+			CPUProfiler::SetEnabled(bUseCPUProfiler);
+			if (bUsePerfCounters && !CPUProfiler::SetCounting(true))
+			{
+				std::cout << "Hardware counters unavailable: " << PerfCounters::GetError() << std::endl;
+			}
+			if (fResolutionTargetMS > 0.0f)
+			{
+				app->EnableDynamicResolution(fResolutionTargetMS, fMinScale, fMaxScale);
+			}
+			if (!bIsRecordScaling)
+			{
+				app->SetRecordThreads(dRecordThreads);
+				bSucceeded = app->RunBenchmark(dFrames, sOutput, bUseRenderThread);
+			}
+			else
+			{
+				// Splitting the output name so every thread count gets its own report.
+				size_t uDot = sOutput.find_last_of('.');
+				std::string sStem = uDot == std::string::npos ? sOutput : sOutput.substr(0, uDot);
+				std::string sExtension = uDot == std::string::npos ? "" : sOutput.substr(uDot);
+				for (int t = 1; bSucceeded && t <= app->GetMaxRecordThreads(); t++)
+				{
+					app->SetRecordThreads(t);
+					bSucceeded = app->RunBenchmark(dFrames, sStem + "_t" + std::to_string(t) + sExtension, bUseRenderThread);
+				}
+			}
+		}
+		GLCapture::Stop();
+		Realloc(app);
+		return bSucceeded ? 0 : 1;
+	}
+
 	{
 		// Creating the application.
 		Application* app = new Application();
 		app->Init("AshEngine");
+		app->SetDebugView(eDebugView);
 		app->Run();
 
 		// Clean up.
+		GLCapture::Stop();
 		Realloc(app);
 
 		std::cout << "Ended execution" << std::endl;
 		return 0;
 	}
 
+#ifdef _WIN32
 	if (_CrtDumpMemoryLeaks())
 	{
 		std::cout << "There are memory leaks present !!" << std::endl;
 	}
-}
\ No newline at end of file
+#endif
+}
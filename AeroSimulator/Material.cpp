@@ -1,37 +1,116 @@
 #include "Material.h"
-#include "FileReader.h"
+#include "TextureStreamer.h"
+#include "TextureTable.h"
 #include "Debug.h"
+#include "RenderStats.h"
 
 Material::Material(std::shared_ptr<Shader> a_pShader, float a_fRoughness)
 {
 	m_pShader = a_pShader;
+	m_pVariants = nullptr;
+	m_uFeatures = 0;
 	m_fRoughness = a_fRoughness;
+	m_locations = MaterialLocations();
 }
 
-std::shared_ptr<Shader> Material::GetShader() { return m_pShader; }
+Material::Material(std::shared_ptr<ShaderVariants> a_pVariants, unsigned int a_uFeatures, float a_fRoughness)
+{
+	m_pShader = nullptr;
+	m_pVariants = a_pVariants;
+	m_uFeatures = a_uFeatures;
+	m_fRoughness = a_fRoughness;
+	m_locations = MaterialLocations();
+}
+
+std::shared_ptr<Shader> Material::GetShader(unsigned int a_uExtraFeatures)
+{
+	if (m_pVariants) return m_pVariants->GetShader(m_uFeatures | a_uExtraFeatures);
+	return m_pShader;
+}
+
+void Material::SetFeatures(unsigned int a_uFeatures) { m_uFeatures = a_uFeatures; }
+unsigned int Material::GetFeatures(void) { return m_uFeatures; }
 
 void Material::AddTextureFromFile(std::string a_sFilepath, std::string a_sUniformName)
 {
-	// Loading in the texture from the address passed in.
-	GLuint textureID = FileReader::GetInstance()->LoadTexture(a_sFilepath);
+	// Streaming in the texture from the address passed in.  The ID is usable right away.
+	GLuint textureID = TextureStreamer::GetInstance()->RequestTexture(a_sFilepath);
 
 	// Inserting it into the hash table.
 	m_mTextures.insert({ a_sUniformName, textureID });
+	AddTableTexture(a_sUniformName, textureID, true);
+	m_locations.Program = 0;
 }
 
 void Material::AddTexture(std::string a_sUniformName, GLuint a_dTextureID)
 {
 	// Inserting both values into the hash table.
 	m_mTextures.insert({ a_sUniformName, a_dTextureID });
+	AddTableTexture(a_sUniformName, a_dTextureID, false);
+	m_locations.Program = 0;
 }
 
-void Material::PrepMaterial()
+void Material::AddTableTexture(std::string a_sUniformName, GLuint a_dTextureID, bool a_bTakeOwnership)
+{
+	TextureTable* pTable = TextureTable::GetInstance();
+	if (pTable->GetBackend() == TEXTURES_BOUND) return;
+
+	TableTexture texture = TableTexture();
+	texture.SlotUniform = a_sUniformName + "Slot";
+	texture.Slot = pTable->Register(a_dTextureID, a_bTakeOwnership);
+	m_lTableTextures.push_back(texture);
+}
+
+void Material::CacheLocations(GLuint a_uProgram)
+{
+	m_locations.Program = a_uProgram;
+	m_locations.WVP = glGetUniformLocation(a_uProgram, "WVP");
+	m_locations.World = glGetUniformLocation(a_uProgram, "World");
+	m_locations.InverseTranspose = glGetUniformLocation(a_uProgram, "InverseTransposeWorld");
+	m_locations.DebugColor = glGetUniformLocation(a_uProgram, "DebugColor");
+
+	m_lTextureLocations.clear();
+	if (!m_lTableTextures.empty())
+	{
+		for (int i = 0; i < m_lTableTextures.size(); i++)
+		{
+			m_lTextureLocations.push_back(glGetUniformLocation(a_uProgram, m_lTableTextures[i].SlotUniform.c_str()));
+		}
+		return;
+	}
+	for (const auto& t : m_mTextures)
+	{
+		m_lTextureLocations.push_back(glGetUniformLocation(a_uProgram, t.first.c_str()));
+	}
+}
+
+const MaterialLocations& Material::PrepMaterial(unsigned int a_uExtraFeatures)
 {	
 	int dTextureUnit = 0;
+	GLuint uProgram = GetShader(a_uExtraFeatures)->GetProgramID();
+	if (uProgram != m_locations.Program)
+	{
+		CacheLocations(uProgram);
+	}
 
 	// Assigning the program to use this Mesh's Shaders.
-	GLCall(glUseProgram(m_pShader->GetProgramID()));
-	
+	GLCall(glUseProgram(uProgram));
+	RenderStats::Add(RS_PROGRAM_BINDS);
+
+	// Pointing the shader at the table slots instead of binding anything.
+	if (!m_lTableTextures.empty())
+	{
+		TextureTable* pTable = TextureTable::GetInstance();
+		for (int i = 0; i < m_lTableTextures.size(); i++)
+		{
+			const TableTexture& texture = m_lTableTextures[i];
+			int dSlot = pTable->IsReady(texture.Slot) ? texture.Slot : TEXTURE_TABLE_PLACEHOLDER;
+			GLCall(glUniform1i(m_lTextureLocations[i], dSlot));
+		}
+		RenderStats::Add(RS_UNIFORM_UPLOADS, m_lTableTextures.size());
+		return m_locations;
+	}
+
 	// Looping through all textures.
 	for (const auto& t : m_mTextures) 
 	{
@@ -39,8 +118,11 @@ void Material::PrepMaterial()
 
 		// Binding the texture and setting it in the Shader program.
 		GLCall(glBindTexture(GL_TEXTURE_2D, t.second));
-		GLCall(glUniform1i(glGetUniformLocation(m_pShader->GetProgramID(), t.first.c_str()), dTextureUnit));
+		GLCall(glUniform1i(m_lTextureLocations[dTextureUnit], dTextureUnit));
+		RenderStats::Add(RS_TEXTURE_BINDS);
+		RenderStats::Add(RS_UNIFORM_UPLOADS);
 
 		dTextureUnit++;
 	}
+	return m_locations;
 }
@@ -4,8 +4,23 @@
 #include <memory>
 #include <glm/glm.hpp>
 #include <unordered_map>
+#include <vector>
 
 #include "Shader.h"
+#include "ShaderVariants.h"
+
+/// <summary>
+/// Uniform locations of the program a Material was last prepared with.  -1 where
+/// the program does not use the uniform.
+/// </summary>
+struct MaterialLocations
+{
+	GLuint Program;
+	GLint WVP;
+	GLint World;
+	GLint InverseTranspose;
+	GLint DebugColor;
+};
 
 /// <summary>
 /// Manages a set of shaders and handles uniforms for those shaders.
@@ -14,11 +29,37 @@ class Material
 {
 private:
 	std::shared_ptr<Shader> m_pShader;
+	std::shared_ptr<ShaderVariants> m_pVariants;	// Replaces m_pShader when set.
+	unsigned int m_uFeatures;
 	glm::vec2 m_v2Offset;
 	glm::vec2 m_v2Scale;
 	float m_fRoughness;
 
 	std::unordered_map<std::string, GLuint> m_mTextures;
+
+	/// <summary>
+	/// A texture sampled through the TextureTable instead of being bound.
+	/// </summary>
+	struct TableTexture
+	{
+		std::string SlotUniform;	// The texture's uniform name followed by "Slot".
+		int Slot;
+	};
+	std::vector<TableTexture> m_lTableTextures;
+
+	// Looked up again only when the program changes, so preparing never builds names.
+	MaterialLocations m_locations;
+	std::vector<GLint> m_lTextureLocations;		// In the order PrepMaterial sets the textures.
+
+	/// <summary>
+	/// Registers a texture with the TextureTable when its backend is active.
+	/// </summary>
+	void AddTableTexture(std::string a_sUniformName, GLuint a_dTextureID, bool a_bTakeOwnership);
+
+	/// <summary>
+	/// Looks up every uniform location the Material sets in a program.
+	/// </summary>
+	void CacheLocations(GLuint a_uProgram);
 public:
 	/// <summary>
 	/// Constructs a Material with the passed in Shader and roughness value.
@@ -28,9 +69,30 @@ public:
 	Material(std::shared_ptr<Shader> a_pShader, float a_fRoughness);
 
 	/// <summary>
-	/// Retrieves the Shader used by this Material.
+	/// Constructs a Material that draws with a variant of the passed in ShaderVariants.
+	/// </summary>
+	/// <param name="a_pVariants">Permutations to pick the Shader from.</param>
+	/// <param name="a_uFeatures">Mask of ShaderFeature bits.</param>
+	/// <param name="a_fRoughness">The roughness value used by this Material.</param>
+	Material(std::shared_ptr<ShaderVariants> a_pVariants, unsigned int a_uFeatures, float a_fRoughness);
+
+	/// <summary>
+	/// Retrieves the Shader used by this Material.  With ShaderVariants this is the
+	/// fallback until the Material's variant has compiled.
+	/// </summary>
+	/// <param name="a_uExtraFeatures">ShaderFeature bits added for this use only, like the debug views'.</param>
+	std::shared_ptr<Shader> GetShader(unsigned int a_uExtraFeatures = 0);
+
+	/// <summary>
+	/// Changes the features of the Material's variant.  The variant is compiled on demand.
+	/// </summary>
+	/// <param name="a_uFeatures">Mask of ShaderFeature bits.</param>
+	void SetFeatures(unsigned int a_uFeatures);
+
+	/// <summary>
+	/// Gets the mask of ShaderFeature bits the Material draws with.
 	/// </summary>
-	std::shared_ptr<Shader> GetShader(void);
+	unsigned int GetFeatures(void);
 	
 	/// <summary>
 	/// Adds a texture to the texture map from the specified filepath.
@@ -47,9 +109,12 @@ public:
 	void AddTexture(std::string a_sUniformName, GLuint a_dTextureID);
 
 	/// <summary>
-	/// Sets all of the textures for upcoming render calls.
+	/// Sets all of the textures for upcoming render calls.  With the TextureTable
+	/// active only slot indices are set, TextureTable::Bind must run first.
 	/// </summary>
-	void PrepMaterial();
+	/// <param name="a_uExtraFeatures">ShaderFeature bits added for this use only, like the debug views'.</param>
+	/// <returns>The locations of the bound program's per draw uniforms.</returns>
+	const MaterialLocations& PrepMaterial(unsigned int a_uExtraFeatures = 0);
 };
 
 #endif //__MATERIAL_H_
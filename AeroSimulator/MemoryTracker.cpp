@@ -0,0 +1,160 @@
+#include "MemoryTracker.h"
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<long long> MemoryTracker::m_lBytes[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+std::atomic<long long> MemoryTracker::m_lPeaks[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+std::atomic<long long> MemoryTracker::m_lCounts[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+std::atomic<long long> MemoryTracker::m_lTotals[MEMORY_KIND_COUNT];
+std::atomic<long long> MemoryTracker::m_lTotalPeaks[MEMORY_KIND_COUNT];
+
+// Header in front of every ImGui allocation holding its size.  Keeps the rest aligned for any type.
+#define MEMORY_UI_HEADER 16
+
+/// <summary>
+/// Size and owner of a GL object, so deleting it only needs the name.
+/// </summary>
+struct TrackedObject
+{
+	MemoryTag Tag;
+	size_t Bytes;
+};
+
+// Textures and buffers are created and deleted rarely, so one lock is plenty.
+static std::mutex s_objectMutex;
+static std::unordered_map<unsigned long long, TrackedObject> s_lObjects;
+
+// Textures and buffers have separate name spaces, so buffers are keyed above every texture.
+#define MEMORY_BUFFER_KEY(name) ((1ull << 32) | (unsigned long long)(name))
+
+/// <summary>
+/// Raises a high-water mark if the value passed it.
+/// </summary>
+static void RaisePeak(std::atomic<long long>& a_peak, long long a_lValue)
+{
+	long long lPeak = a_peak.load(std::memory_order_relaxed);
+	while (a_lValue > lPeak && !a_peak.compare_exchange_weak(lPeak, a_lValue, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MemoryTracker::Add(MemoryKind a_eKind, MemoryTag a_eTag, size_t a_uBytes, int a_dAllocations)
+{
+	long long lBytes = m_lBytes[a_eKind][a_eTag].fetch_add((long long)a_uBytes, std::memory_order_relaxed) + (long long)a_uBytes;
+	long long lTotal = m_lTotals[a_eKind].fetch_add((long long)a_uBytes, std::memory_order_relaxed) + (long long)a_uBytes;
+	m_lCounts[a_eKind][a_eTag].fetch_add(a_dAllocations, std::memory_order_relaxed);
+	RaisePeak(m_lPeaks[a_eKind][a_eTag], lBytes);
+	RaisePeak(m_lTotalPeaks[a_eKind], lTotal);
+}
+
+void MemoryTracker::Remove(MemoryKind a_eKind, MemoryTag a_eTag, size_t a_uBytes, int a_dAllocations)
+{
+	m_lBytes[a_eKind][a_eTag].fetch_sub((long long)a_uBytes, std::memory_order_relaxed);
+	m_lTotals[a_eKind].fetch_sub((long long)a_uBytes, std::memory_order_relaxed);
+	m_lCounts[a_eKind][a_eTag].fetch_sub(a_dAllocations, std::memory_order_relaxed);
+}
+
+void MemoryTracker::AddObject(unsigned long long a_uKey, MemoryTag a_eTag, size_t a_uBytes)
+{
+	std::lock_guard<std::mutex> lock(s_objectMutex);
+	std::unordered_map<unsigned long long, TrackedObject>::iterator it = s_lObjects.find(a_uKey);
+	if (it != s_lObjects.end())
+	{
+		Remove(MEMORY_GPU, it->second.Tag, it->second.Bytes);
+	}
+
+	TrackedObject object = { a_eTag, a_uBytes };
+	s_lObjects[a_uKey] = object;
+	Add(MEMORY_GPU, a_eTag, a_uBytes);
+}
+
+void MemoryTracker::RemoveObject(unsigned long long a_uKey)
+{
+	std::lock_guard<std::mutex> lock(s_objectMutex);
+	std::unordered_map<unsigned long long, TrackedObject>::iterator it = s_lObjects.find(a_uKey);
+	if (it == s_lObjects.end()) return;
+
+	Remove(MEMORY_GPU, it->second.Tag, it->second.Bytes);
+	s_lObjects.erase(it);
+}
+
+void MemoryTracker::AddTexture(GLuint a_uTexture, MemoryTag a_eTag, size_t a_uBytes) { AddObject(a_uTexture, a_eTag, a_uBytes); }
+void MemoryTracker::RemoveTexture(GLuint a_uTexture) { RemoveObject(a_uTexture); }
+void MemoryTracker::AddBuffer(GLuint a_uBuffer, MemoryTag a_eTag, size_t a_uBytes) { AddObject(MEMORY_BUFFER_KEY(a_uBuffer), a_eTag, a_uBytes); }
+void MemoryTracker::RemoveBuffer(GLuint a_uBuffer) { RemoveObject(MEMORY_BUFFER_KEY(a_uBuffer)); }
+
+size_t MemoryTracker::GetTextureBytes(GLuint a_uTexture)
+{
+	std::lock_guard<std::mutex> lock(s_objectMutex);
+	std::unordered_map<unsigned long long, TrackedObject>::iterator it = s_lObjects.find(a_uTexture);
+	return it != s_lObjects.end() ? it->second.Bytes : 0;
+}
+
+MemoryUsage MemoryTracker::GetUsage(MemoryKind a_eKind, MemoryTag a_eTag)
+{
+	MemoryUsage usage = MemoryUsage();
+	usage.Bytes = m_lBytes[a_eKind][a_eTag].load(std::memory_order_relaxed);
+	usage.PeakBytes = m_lPeaks[a_eKind][a_eTag].load(std::memory_order_relaxed);
+	usage.Allocations = m_lCounts[a_eKind][a_eTag].load(std::memory_order_relaxed);
+	return usage;
+}
+
+MemoryUsage MemoryTracker::GetTotal(MemoryKind a_eKind)
+{
+	MemoryUsage usage = MemoryUsage();
+	usage.Bytes = m_lTotals[a_eKind].load(std::memory_order_relaxed);
+	usage.PeakBytes = m_lTotalPeaks[a_eKind].load(std::memory_order_relaxed);
+	for (int i = 0; i < MEMORY_TAG_COUNT; i++)
+	{
+		usage.Allocations += m_lCounts[a_eKind][i].load(std::memory_order_relaxed);
+	}
+	return usage;
+}
+
+void MemoryTracker::ResetPeaks(void)
+{
+	for (int k = 0; k < MEMORY_KIND_COUNT; k++)
+	{
+		for (int i = 0; i < MEMORY_TAG_COUNT; i++)
+		{
+			m_lPeaks[k][i] = m_lBytes[k][i].load(std::memory_order_relaxed);
+		}
+		m_lTotalPeaks[k] = m_lTotals[k].load(std::memory_order_relaxed);
+	}
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag a_eTag)
+{
+	switch (a_eTag)
+	{
+	case MEMORY_MESHES: return "meshes";
+	case MEMORY_TEXTURES: return "textures";
+	case MEMORY_ENTITIES: return "entities";
+	case MEMORY_UI: return "ui";
+	case MEMORY_RENDER_TARGETS: return "render_targets";
+	case MEMORY_STREAMING: return "streaming";
+	default: return "unknown";
+	}
+}
+
+void* MemoryTracker::AllocateUI(size_t a_uBytes, void*)
+{
+	unsigned char* pMemory = (unsigned char*)malloc(a_uBytes + MEMORY_UI_HEADER);
+	if (pMemory == nullptr) return nullptr;
+
+	*(size_t*)pMemory = a_uBytes;
+	Add(MEMORY_CPU, MEMORY_UI, a_uBytes);
+	AllocationCounter::Count(a_uBytes);
+	return pMemory + MEMORY_UI_HEADER;
+}
+
+void MemoryTracker::FreeUI(void* a_pMemory, void*)
+{
+	if (a_pMemory == nullptr) return;
+
+	unsigned char* pMemory = (unsigned char*)a_pMemory - MEMORY_UI_HEADER;
+	Remove(MEMORY_CPU, MEMORY_UI, *(size_t*)pMemory);
+	free(pMemory);
+}
@@ -0,0 +1,136 @@
+#ifndef __MEMORYTRACKER_H_
+#define __MEMORYTRACKER_H_
+
+#include <GL/glew.h>
+#include <atomic>
+#include <cstddef>
+
+/// <summary>
+/// The subsystems memory is accounted to.
+/// </summary>
+enum MemoryTag
+{
+	MEMORY_MESHES = 0,		// Vertex copies and vertex buffers.
+	MEMORY_TEXTURES,		// Material textures, texture arrays and the slot table.
+	MEMORY_ENTITIES,		// Entities and their transforms.
+	MEMORY_UI,				// Everything ImGui allocates.
+	MEMORY_RENDER_TARGETS,	// The frame graph's transient textures and buffers.
+	MEMORY_STREAMING,		// Decoded images waiting for upload and the pixel buffers.
+	MEMORY_TAG_COUNT
+};
+
+/// <summary>
+/// Where the memory lives.
+/// </summary>
+enum MemoryKind
+{
+	MEMORY_CPU = 0,
+	MEMORY_GPU,
+	MEMORY_KIND_COUNT
+};
+
+/// <summary>
+/// Live and high-water bytes of a tag or a total.
+/// </summary>
+struct MemoryUsage
+{
+	long long Bytes;
+	long long PeakBytes;
+	long long Allocations;	// Live allocations or GL objects.
+};
+
+/// <summary>
+/// Accounts the engine's own CPU allocations and the GPU textures and buffers it
+/// creates to the subsystem that owns them.  GPU sizes are what the engine asked
+/// for, drivers may pad them.  Counters are atomic, so any thread may report.
+/// </summary>
+class MemoryTracker
+{
+private:
+	static std::atomic<long long> m_lBytes[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+	static std::atomic<long long> m_lPeaks[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+	static std::atomic<long long> m_lCounts[MEMORY_KIND_COUNT][MEMORY_TAG_COUNT];
+	static std::atomic<long long> m_lTotals[MEMORY_KIND_COUNT];
+	static std::atomic<long long> m_lTotalPeaks[MEMORY_KIND_COUNT];
+
+public:
+	/// <summary>
+	/// Accounts an allocation.
+	/// </summary>
+	/// <param name="a_dAllocations">Number of allocations the bytes are spread over.</param>
+	static void Add(MemoryKind a_eKind, MemoryTag a_eTag, size_t a_uBytes, int a_dAllocations = 1);
+
+	/// <summary>
+	/// Accounts a release.  Must match earlier Adds.
+	/// </summary>
+	/// <param name="a_dAllocations">Number of allocations the bytes were spread over.</param>
+	static void Remove(MemoryKind a_eKind, MemoryTag a_eTag, size_t a_uBytes, int a_dAllocations = 1);
+
+	/// <summary>
+	/// Accounts the storage of a texture.  Calling it again for the same name replaces its size.
+	/// </summary>
+	static void AddTexture(GLuint a_uTexture, MemoryTag a_eTag, size_t a_uBytes);
+
+	/// <summary>
+	/// Releases a texture's storage.  Names that were never added are ignored.
+	/// </summary>
+	static void RemoveTexture(GLuint a_uTexture);
+
+	/// <summary>
+	/// Accounts the storage of a buffer.  Calling it again for the same name replaces its size.
+	/// </summary>
+	static void AddBuffer(GLuint a_uBuffer, MemoryTag a_eTag, size_t a_uBytes);
+
+	/// <summary>
+	/// Releases a buffer's storage.  Names that were never added are ignored.
+	/// </summary>
+	static void RemoveBuffer(GLuint a_uBuffer);
+
+	/// <summary>
+	/// Gets the bytes accounted to a texture, or 0 if it was never added.
+	/// </summary>
+	static size_t GetTextureBytes(GLuint a_uTexture);
+
+	/// <summary>
+	/// Gets the usage of one subsystem.
+	/// </summary>
+	static MemoryUsage GetUsage(MemoryKind a_eKind, MemoryTag a_eTag);
+
+	/// <summary>
+	/// Gets the usage of every subsystem together.  The peak is of the total, not the sum of peaks.
+	/// </summary>
+	static MemoryUsage GetTotal(MemoryKind a_eKind);
+
+	/// <summary>
+	/// Lowers every high-water mark to the current usage.
+	/// </summary>
+	static void ResetPeaks(void);
+
+	/// <summary>
+	/// Gets the display name of a tag.
+	/// </summary>
+	static const char* GetTagName(MemoryTag a_eTag);
+
+	/// <summary>
+	/// Allocator handed to ImGui so its memory is accounted to MEMORY_UI.
+	/// </summary>
+	static void* AllocateUI(size_t a_uBytes, void* a_pUserData);
+
+	/// <summary>
+	/// Frees memory from AllocateUI.
+	/// </summary>
+	static void FreeUI(void* a_pMemory, void* a_pUserData);
+
+private:
+	/// <summary>
+	/// Accounts a GL object, replacing its previous size if it was already known.
+	/// </summary>
+	static void AddObject(unsigned long long a_uKey, MemoryTag a_eTag, size_t a_uBytes);
+
+	/// <summary>
+	/// Releases a GL object if it is known.
+	/// </summary>
+	static void RemoveObject(unsigned long long a_uKey);
+};
+
+#endif //__MEMORYTRACKER_H_
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "Shader.h"
+#include "Bounds.h"
 
 /// <summary>
 /// Container struct to hold data for individual vertices.
@@ -29,6 +30,8 @@ private:
 	GLuint m_VAO;
 	std::vector<Vertex> m_lVertices;
 	int m_dVertexCount;
+	AABB m_aBounds;
+	size_t m_uCPUBytes = 0;		// Accounted to MEMORY_MESHES.
 
 public:
 	/// <summary>
@@ -99,12 +102,35 @@ public:
 	/// </summary>
 	int GetVertexCount();
 
+	/// <summary>
+	/// Gets the CPU side copy of the vertices.  Used for software occlusion.
+	/// </summary>
+	const std::vector<Vertex>& GetVertices();
+
+	/// <summary>
+	/// Gets the local space bounds of the Mesh.  Calculated when the Mesh is compiled.
+	/// </summary>
+	AABB GetBounds();
+
+	/// <summary>
+	/// Parses a graphics_obj file into triangle list vertices.  Makes no GL calls.
+	/// </summary>
+	/// <param name="a_sFilePath">Path to the model.</param>
+	/// <param name="a_lVertices">Receives the vertices, three per triangle.</param>
+	/// <returns>False if the file could not be opened.</returns>
+	static bool LoadObj(const char* a_sFilePath, std::vector<Vertex>& a_lVertices);
+
 private:
 
 	/// <summary>
 	/// Resets the vbo and vao objects in addition to the enum flag.
 	/// </summary>
 	void Reset(void);
+
+	/// <summary>
+	/// Re-accounts the CPU copy of the vertices after it changed size.
+	/// </summary>
+	void UpdateMemory(void);
 };
 
 #endif //__MESH_H_
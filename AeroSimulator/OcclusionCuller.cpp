@@ -0,0 +1,401 @@
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstring>
+
+// SSE2 is guaranteed on every x64 target and on x86 builds using /arch:SSE2.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_SIMD
+#include <emmintrin.h>
+#endif
+
+typedef std::chrono::high_resolution_clock OcclusionClock;
+
+/// <summary>
+/// Gets the milliseconds elapsed since the passed in time point.
+/// </summary>
+static float MillisecondsSince(OcclusionClock::time_point a_tStart)
+{
+	return std::chrono::duration<float, std::milli>(OcclusionClock::now() - a_tStart).count();
+}
+
+float OcclusionStats::GetCulledPercent(void) const
+{
+	if (Tested == 0) return 0.0f;
+
+	return 100.0f * Culled / Tested;
+}
+
+// - - Construction - -
+OcclusionCuller::OcclusionCuller(void)
+{
+	m_pDepth = new float[OCCLUSION_WIDTH * OCCLUSION_HEIGHT];
+	m_pHiZ = new float[OCCLUSION_TILES_X * OCCLUSION_TILES_Y];
+	m_m4ViewProjection = glm::mat4(1.0f);
+
+	BeginFrame(m_m4ViewProjection);
+}
+
+OcclusionCuller::~OcclusionCuller(void)
+{
+	delete[] m_pDepth;
+	delete[] m_pHiZ;
+}
+
+OcclusionCuller::OcclusionCuller(const OcclusionCuller& a_pOther)
+{
+	m_pDepth = new float[OCCLUSION_WIDTH * OCCLUSION_HEIGHT];
+	m_pHiZ = new float[OCCLUSION_TILES_X * OCCLUSION_TILES_Y];
+	*this = a_pOther;
+}
+
+OcclusionCuller& OcclusionCuller::operator=(const OcclusionCuller& a_pOther)
+{
+	if (this == &a_pOther) return *this;
+
+	// Copying the buffers over, the queued occluders are frame local.
+	std::memcpy(m_pDepth, a_pOther.m_pDepth, sizeof(float) * OCCLUSION_WIDTH * OCCLUSION_HEIGHT);
+	std::memcpy(m_pHiZ, a_pOther.m_pHiZ, sizeof(float) * OCCLUSION_TILES_X * OCCLUSION_TILES_Y);
+	m_m4ViewProjection = a_pOther.m_m4ViewProjection;
+	m_sStats = a_pOther.m_sStats;
+	m_lOccluders.clear();
+
+	return *this;
+}
+
+// - - Frame - -
+void OcclusionCuller::BeginFrame(const glm::mat4& a_m4ViewProjection)
+{
+	m_m4ViewProjection = a_m4ViewProjection;
+	m_lOccluders.clear();
+	m_sStats = OcclusionStats();
+
+	// Nothing drawn yet, so everything is at the far plane.
+	std::fill(m_pDepth, m_pDepth + OCCLUSION_WIDTH * OCCLUSION_HEIGHT, 1.0f);
+	std::fill(m_pHiZ, m_pHiZ + OCCLUSION_TILES_X * OCCLUSION_TILES_Y, 1.0f);
+}
+
+void OcclusionCuller::AddOccluder(const std::vector<Vertex>& a_lVertices, const glm::mat4& a_m4World)
+{
+	Occluder occluder;
+	occluder.Vertices = &a_lVertices;
+	occluder.World = a_m4World;
+	m_lOccluders.push_back(occluder);
+}
+
+void OcclusionCuller::RasterizeOccluders(void)
+{
+	ThreadPool* pPool = ThreadPool::GetInstance();
+	m_sStats.Occluders = (int)m_lOccluders.size();
+
+	// Growing the per occluder output lists.  Old lists keep their capacity between frames.
+	if (m_lTriangles.size() < m_lOccluders.size())
+	{
+		m_lTriangles.resize(m_lOccluders.size());
+	}
+
+	// Stage one: every occluder is projected on its own job.
+	OcclusionClock::time_point start = OcclusionClock::now();
+	pPool->ParallelFor((unsigned int)m_lOccluders.size(), [this](unsigned int i) { TransformOccluder(i); });
+	m_sStats.TransformMS = MillisecondsSince(start);
+
+	for (int i = 0; i < m_lOccluders.size(); i++)
+	{
+		m_sStats.Triangles += (int)m_lTriangles[i].size();
+	}
+
+	// Stage two: every tile row is rasterized on its own job, so no two jobs touch the same pixels.
+	start = OcclusionClock::now();
+	pPool->ParallelFor(OCCLUSION_TILES_Y, [this](unsigned int i) { RasterizeTileRow(i); });
+	m_sStats.RasterMS = MillisecondsSince(start);
+}
+
+bool OcclusionCuller::IsVisible(const AABB& a_aBounds)
+{
+	m_sStats.Tested++;
+
+	glm::vec2 v2Min = glm::vec2(FLT_MAX);
+	glm::vec2 v2Max = glm::vec2(-FLT_MAX);
+	float fNearestDepth = 1.0f;
+
+	// Projecting the eight corners of the box.
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 v3Corner = glm::vec3(
+			(i & 1) ? a_aBounds.Max.x : a_aBounds.Min.x,
+			(i & 2) ? a_aBounds.Max.y : a_aBounds.Min.y,
+			(i & 4) ? a_aBounds.Max.z : a_aBounds.Min.z);
+		glm::vec4 v4Clip = m_m4ViewProjection * glm::vec4(v3Corner, 1.0f);
+
+		// Crossing the near plane, so it can't be hidden.
+		if (v4Clip.z < -v4Clip.w || v4Clip.w <= 0.0f) return true;
+
+		glm::vec3 v3NDC = glm::vec3(v4Clip) / v4Clip.w;
+		v2Min = glm::min(v2Min, glm::vec2(v3NDC));
+		v2Max = glm::max(v2Max, glm::vec2(v3NDC));
+		fNearestDepth = std::min(fNearestDepth, v3NDC.z * 0.5f + 0.5f);
+	}
+
+	// Finding the covered tiles.
+	int dMinX = (int)((v2Min.x * 0.5f + 0.5f) * OCCLUSION_WIDTH) / OCCLUSION_TILE;
+	int dMaxX = (int)((v2Max.x * 0.5f + 0.5f) * OCCLUSION_WIDTH) / OCCLUSION_TILE;
+	int dMinY = (int)((v2Min.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT) / OCCLUSION_TILE;
+	int dMaxY = (int)((v2Max.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT) / OCCLUSION_TILE;
+	dMinX = std::max(dMinX, 0);
+	dMinY = std::max(dMinY, 0);
+	dMaxX = std::min(dMaxX, OCCLUSION_TILES_X - 1);
+	dMaxY = std::min(dMaxY, OCCLUSION_TILES_Y - 1);
+
+	// Entirely off screen is for the frustum test to decide.
+	if (dMinX > dMaxX || dMinY > dMaxY) return true;
+
+	// Visible as soon as a single tile has something farther than the box.
+	for (int y = dMinY; y <= dMaxY; y++)
+	{
+		for (int x = dMinX; x <= dMaxX; x++)
+		{
+			if (fNearestDepth <= m_pHiZ[y * OCCLUSION_TILES_X + x]) return true;
+		}
+	}
+
+	m_sStats.Culled++;
+	return false;
+}
+
+void OcclusionCuller::AddTestTime(float a_fMilliseconds) { m_sStats.TestMS += a_fMilliseconds; }
+const OcclusionStats& OcclusionCuller::GetStats(void) { return m_sStats; }
+const float* OcclusionCuller::GetDepthBuffer(void) { return m_pDepth; }
+
+// - - Private Methods - -
+void OcclusionCuller::TransformOccluder(unsigned int a_uIndex)
+{
+	const Occluder& occluder = m_lOccluders[a_uIndex];
+	const std::vector<Vertex>& lVertices = *occluder.Vertices;
+	std::vector<ScreenTriangle>& lOut = m_lTriangles[a_uIndex];
+	lOut.clear();
+
+	glm::mat4 m4MVP = m_m4ViewProjection * occluder.World;
+	for (size_t i = 0; i + 2 < lVertices.size(); i += 3)
+	{
+		glm::vec4 v4Clip[3];
+		float fNearDistance[3];
+		int dInside = 0;
+		for (int j = 0; j < 3; j++)
+		{
+			v4Clip[j] = m4MVP * glm::vec4(lVertices[i + j].Position, 1.0f);
+			fNearDistance[j] = v4Clip[j].z + v4Clip[j].w;
+			if (fNearDistance[j] >= 0.0f) dInside++;
+		}
+
+		// Entirely behind the near plane.
+		if (dInside == 0) continue;
+
+		// Trivially rejecting triangles fully outside of a side plane.
+		bool bOutside = false;
+		for (int axis = 0; axis < 2 && !bOutside; axis++)
+		{
+			bOutside =
+				(v4Clip[0][axis] > v4Clip[0].w && v4Clip[1][axis] > v4Clip[1].w && v4Clip[2][axis] > v4Clip[2].w) ||
+				(v4Clip[0][axis] < -v4Clip[0].w && v4Clip[1][axis] < -v4Clip[1].w && v4Clip[2][axis] < -v4Clip[2].w);
+		}
+		if (bOutside) continue;
+
+		if (dInside == 3)
+		{
+			EmitTriangle(lOut, v4Clip[0], v4Clip[1], v4Clip[2]);
+			continue;
+		}
+
+		// Sutherland-Hodgman against the near plane leaves three or four points.
+		glm::vec4 v4Polygon[4];
+		int dPoints = 0;
+		for (int j = 0; j < 3; j++)
+		{
+			int k = (j + 1) % 3;
+			if (fNearDistance[j] >= 0.0f)
+			{
+				v4Polygon[dPoints++] = v4Clip[j];
+			}
+			if ((fNearDistance[j] >= 0.0f) != (fNearDistance[k] >= 0.0f))
+			{
+				float fT = fNearDistance[j] / (fNearDistance[j] - fNearDistance[k]);
+				v4Polygon[dPoints++] = v4Clip[j] + (v4Clip[k] - v4Clip[j]) * fT;
+			}
+		}
+
+		EmitTriangle(lOut, v4Polygon[0], v4Polygon[1], v4Polygon[2]);
+		if (dPoints == 4)
+		{
+			EmitTriangle(lOut, v4Polygon[0], v4Polygon[2], v4Polygon[3]);
+		}
+	}
+}
+
+void OcclusionCuller::EmitTriangle(std::vector<ScreenTriangle>& a_lOut, glm::vec4 a_v4A, glm::vec4 a_v4B, glm::vec4 a_v4C)
+{
+	glm::vec4 v4Clip[3] = { a_v4A, a_v4B, a_v4C };
+	glm::vec3 v3Screen[3];
+
+	// Perspective divide and viewport transform.  Depth is remapped to 0 near and 1 far.
+	for (int i = 0; i < 3; i++)
+	{
+		glm::vec3 v3NDC = glm::vec3(v4Clip[i]) / v4Clip[i].w;
+		v3Screen[i] = glm::vec3(
+			(v3NDC.x * 0.5f + 0.5f) * OCCLUSION_WIDTH,
+			(v3NDC.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT,
+			v3NDC.z * 0.5f + 0.5f);
+	}
+
+	ScreenTriangle triangle;
+	triangle.V0 = v3Screen[0];
+	triangle.V1 = v3Screen[1];
+	triangle.V2 = v3Screen[2];
+
+	// Both windings are drawn, so the edges are flipped to make the area positive.
+	float fArea =
+		(triangle.V1.x - triangle.V0.x) * (triangle.V2.y - triangle.V0.y) -
+		(triangle.V1.y - triangle.V0.y) * (triangle.V2.x - triangle.V0.x);
+	if (fArea < 0.0f)
+	{
+		std::swap(triangle.V1, triangle.V2);
+	}
+	else if (fArea == 0.0f)
+	{
+		return;
+	}
+
+	float fMinY = std::min(triangle.V0.y, std::min(triangle.V1.y, triangle.V2.y));
+	float fMaxY = std::max(triangle.V0.y, std::max(triangle.V1.y, triangle.V2.y));
+	triangle.MinY = std::max(0, (int)fMinY);
+	triangle.MaxY = std::min(OCCLUSION_HEIGHT - 1, (int)fMaxY);
+	if (triangle.MinY > triangle.MaxY) return;
+
+	a_lOut.push_back(triangle);
+}
+
+void OcclusionCuller::RasterizeTileRow(unsigned int a_uRow)
+{
+	int dMinY = a_uRow * OCCLUSION_TILE;
+	int dMaxY = dMinY + OCCLUSION_TILE - 1;
+
+	// Drawing every triangle that overlaps this row of tiles.
+	for (int i = 0; i < m_lOccluders.size(); i++)
+	{
+		const std::vector<ScreenTriangle>& lTriangles = m_lTriangles[i];
+		for (int j = 0; j < lTriangles.size(); j++)
+		{
+			const ScreenTriangle& triangle = lTriangles[j];
+			if (triangle.MaxY < dMinY || triangle.MinY > dMaxY) continue;
+
+			RasterizeTriangle(triangle, dMinY, dMaxY);
+		}
+	}
+
+	// Reducing each tile down to its farthest depth.
+	for (int tile = 0; tile < OCCLUSION_TILES_X; tile++)
+	{
+		float fFarthest = 0.0f;
+		for (int y = dMinY; y <= dMaxY; y++)
+		{
+			const float* pRow = m_pDepth + y * OCCLUSION_WIDTH + tile * OCCLUSION_TILE;
+			for (int x = 0; x < OCCLUSION_TILE; x++)
+			{
+				fFarthest = std::max(fFarthest, pRow[x]);
+			}
+		}
+		m_pHiZ[a_uRow * OCCLUSION_TILES_X + tile] = fFarthest;
+	}
+}
+
+void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& a_tTriangle, int a_dMinY, int a_dMaxY)
+{
+	const glm::vec3& v0 = a_tTriangle.V0;
+	const glm::vec3& v1 = a_tTriangle.V1;
+	const glm::vec3& v2 = a_tTriangle.V2;
+
+	// Clamping the bounding rectangle to the screen and the rows being drawn.
+	int dMinX = std::max(0, (int)std::min(v0.x, std::min(v1.x, v2.x)));
+	int dMaxX = std::min(OCCLUSION_WIDTH - 1, (int)std::max(v0.x, std::max(v1.x, v2.x)));
+	int dMinY = std::max(a_dMinY, a_tTriangle.MinY);
+	int dMaxY = std::min(a_dMaxY, a_tTriangle.MaxY);
+	if (dMinX > dMaxX) return;
+
+	// Edge function steps per pixel in x.  Edge n is opposite of vertex n.
+	float fStepX[3] = { v1.y - v2.y, v2.y - v0.y, v0.y - v1.y };
+	float fArea = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+
+	// Depth is interpolated as z0 + w1 * dz1 + w2 * dz2.
+	float fDepthStep1 = (v1.z - v0.z) / fArea;
+	float fDepthStep2 = (v2.z - v0.z) / fArea;
+
+	// Starting on a four pixel boundary so each row is processed in whole SIMD lanes.
+	dMinX &= ~3;
+	float fStartX = dMinX + 0.5f;
+
+	for (int y = dMinY; y <= dMaxY; y++)
+	{
+		float fY = y + 0.5f;
+		float fEdge[3] =
+		{
+			(v2.x - v1.x) * (fY - v1.y) - (v2.y - v1.y) * (fStartX - v1.x),
+			(v0.x - v2.x) * (fY - v2.y) - (v0.y - v2.y) * (fStartX - v2.x),
+			(v1.x - v0.x) * (fY - v0.y) - (v1.y - v0.y) * (fStartX - v0.x)
+		};
+		float* pRow = m_pDepth + y * OCCLUSION_WIDTH;
+
+#ifdef OCCLUSION_SIMD
+		const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+		const __m128 zero = _mm_setzero_ps();
+		__m128 edge0 = _mm_add_ps(_mm_set1_ps(fEdge[0]), _mm_mul_ps(lanes, _mm_set1_ps(fStepX[0])));
+		__m128 edge1 = _mm_add_ps(_mm_set1_ps(fEdge[1]), _mm_mul_ps(lanes, _mm_set1_ps(fStepX[1])));
+		__m128 edge2 = _mm_add_ps(_mm_set1_ps(fEdge[2]), _mm_mul_ps(lanes, _mm_set1_ps(fStepX[2])));
+		const __m128 step0 = _mm_set1_ps(fStepX[0] * 4.0f);
+		const __m128 step1 = _mm_set1_ps(fStepX[1] * 4.0f);
+		const __m128 step2 = _mm_set1_ps(fStepX[2] * 4.0f);
+		const __m128 depth0 = _mm_set1_ps(v0.z);
+		const __m128 depthStep1 = _mm_set1_ps(fDepthStep1);
+		const __m128 depthStep2 = _mm_set1_ps(fDepthStep2);
+
+		for (int x = dMinX; x <= dMaxX; x += 4)
+		{
+			// Inside when all three edge functions are non-negative.
+			__m128 inside = _mm_and_ps(
+				_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+				_mm_cmpge_ps(edge2, zero));
+
+			if (_mm_movemask_ps(inside) != 0)
+			{
+				__m128 depth = _mm_add_ps(depth0,
+					_mm_add_ps(_mm_mul_ps(edge1, depthStep1), _mm_mul_ps(edge2, depthStep2)));
+				__m128 previous = _mm_loadu_ps(pRow + x);
+				__m128 nearest = _mm_min_ps(previous, depth);
+
+				// Only writing the covered lanes.
+				__m128 result = _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous));
+				_mm_storeu_ps(pRow + x, result);
+			}
+
+			edge0 = _mm_add_ps(edge0, step0);
+			edge1 = _mm_add_ps(edge1, step1);
+			edge2 = _mm_add_ps(edge2, step2);
+		}
+#else
+		for (int x = dMinX; x <= dMaxX; x++)
+		{
+			if (fEdge[0] >= 0.0f && fEdge[1] >= 0.0f && fEdge[2] >= 0.0f)
+			{
+				float fDepth = v0.z + fEdge[1] * fDepthStep1 + fEdge[2] * fDepthStep2;
+				pRow[x] = std::min(pRow[x], fDepth);
+			}
+
+			fEdge[0] += fStepX[0];
+			fEdge[1] += fStepX[1];
+			fEdge[2] += fStepX[2];
+		}
+#endif
+	}
+}
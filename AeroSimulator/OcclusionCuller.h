@@ -0,0 +1,157 @@
+#ifndef __OCCLUSIONCULLER_H_
+#define __OCCLUSIONCULLER_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+#include "Mesh.h"
+
+// Resolution of the software depth buffer.
+#define OCCLUSION_WIDTH 256
+#define OCCLUSION_HEIGHT 128
+
+// Size of a single hierarchical depth tile in pixels.  Each tile row is rasterized as one job.
+#define OCCLUSION_TILE 8
+#define OCCLUSION_TILES_X (OCCLUSION_WIDTH / OCCLUSION_TILE)
+#define OCCLUSION_TILES_Y (OCCLUSION_HEIGHT / OCCLUSION_TILE)
+
+/// <summary>
+/// Counters and per stage timings for the last culled frame.
+/// </summary>
+struct OcclusionStats
+{
+	int Occluders;
+	int Triangles;
+	int Tested;
+	int Culled;
+	float TransformMS;
+	float RasterMS;
+	float TestMS;
+
+	/// <summary>
+	/// Gets the percentage of tested bounds that were found hidden.
+	/// </summary>
+	float GetCulledPercent(void) const;
+};
+
+/// <summary>
+/// Rasterizes selected occluder meshes into a low resolution depth buffer on the CPU
+/// and tests bounds against its hierarchical (per tile farthest depth) version.
+/// </summary>
+class OcclusionCuller
+{
+private:
+	/// <summary>
+	/// Occluder triangle after projection into depth buffer pixel space.
+	/// </summary>
+	struct ScreenTriangle
+	{
+		glm::vec3 V0;
+		glm::vec3 V1;
+		glm::vec3 V2;
+		int MinY;
+		int MaxY;
+	};
+
+	/// <summary>
+	/// An occluder queued for this frame.
+	/// </summary>
+	struct Occluder
+	{
+		const std::vector<Vertex>* Vertices;
+		glm::mat4 World;
+	};
+
+	glm::mat4 m_m4ViewProjection;
+	std::vector<Occluder> m_lOccluders;
+	std::vector<std::vector<ScreenTriangle>> m_lTriangles;	// One list per occluder.
+
+	float* m_pDepth = nullptr;		// Nearest depth per pixel, 0 near to 1 far.
+	float* m_pHiZ = nullptr;		// Farthest depth per tile.
+	OcclusionStats m_sStats;
+
+public:
+	/// <summary>
+	/// Constructs the culler and allocates its depth buffers.
+	/// </summary>
+	OcclusionCuller(void);
+
+	/// <summary>
+	/// Frees the depth buffers.
+	/// </summary>
+	~OcclusionCuller(void);
+
+	/// <summary>
+	/// Copy constructor for the OcclusionCuller.
+	/// </summary>
+	OcclusionCuller(const OcclusionCuller& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the OcclusionCuller.
+	/// </summary>
+	OcclusionCuller& operator=(const OcclusionCuller& a_pOther);
+
+	/// <summary>
+	/// Clears the occluders and statistics for a new frame.
+	/// </summary>
+	/// <param name="a_m4ViewProjection">Projection * view matrix of the active Camera.</param>
+	void BeginFrame(const glm::mat4& a_m4ViewProjection);
+
+	/// <summary>
+	/// Queues a triangle list to be drawn into the depth buffer.  The list must outlive the frame.
+	/// </summary>
+	/// <param name="a_lVertices">Vertices of the occluder, three per triangle.</param>
+	/// <param name="a_m4World">World matrix of the occluder.</param>
+	void AddOccluder(const std::vector<Vertex>& a_lVertices, const glm::mat4& a_m4World);
+
+	/// <summary>
+	/// Transforms and rasterizes every queued occluder across the ThreadPool
+	/// and builds the hierarchical depth buffer.
+	/// </summary>
+	void RasterizeOccluders(void);
+
+	/// <summary>
+	/// Tests world space bounds against the hierarchical depth buffer.
+	/// </summary>
+	/// <returns>False only if the bounds are completely hidden.</returns>
+	bool IsVisible(const AABB& a_aBounds);
+
+	/// <summary>
+	/// Adds to the statistics the time spent testing this frame.
+	/// </summary>
+	void AddTestTime(float a_fMilliseconds);
+
+	/// <summary>
+	/// Gets the statistics of the current frame.
+	/// </summary>
+	const OcclusionStats& GetStats(void);
+
+	/// <summary>
+	/// Gets the full resolution depth buffer.  Primarily for debugging.
+	/// </summary>
+	const float* GetDepthBuffer(void);
+
+private:
+	/// <summary>
+	/// Projects and near clips the triangles of one occluder.
+	/// </summary>
+	void TransformOccluder(unsigned int a_uIndex);
+
+	/// <summary>
+	/// Rasterizes every triangle touching one row of tiles and updates the tile depths.
+	/// </summary>
+	void RasterizeTileRow(unsigned int a_uRow);
+
+	/// <summary>
+	/// Rasterizes a single triangle clipped to the passed in pixel rows.
+	/// </summary>
+	void RasterizeTriangle(const ScreenTriangle& a_tTriangle, int a_dMinY, int a_dMaxY);
+
+	/// <summary>
+	/// Converts a clip space triangle to pixel space and stores it.
+	/// </summary>
+	void EmitTriangle(std::vector<ScreenTriangle>& a_lOut, glm::vec4 a_v4A, glm::vec4 a_v4B, glm::vec4 a_v4C);
+};
+
+#endif //__OCCLUSIONCULLER_H_
@@ -0,0 +1,80 @@
+#include "OverdrawCounter.h"
+#include "Debug.h"
+
+OverdrawCounter::OverdrawCounter(void)
+{
+	GLCall(glGenQueries(OVERDRAW_LATENCY * OVERDRAW_MAX_SCOPES, &m_lQueries[0][0]));
+	for (int i = 0; i < OVERDRAW_LATENCY; i++)
+	{
+		m_lScopeCount[i] = 0;
+	}
+}
+
+OverdrawCounter::~OverdrawCounter(void)
+{
+	glDeleteQueries(OVERDRAW_LATENCY * OVERDRAW_MAX_SCOPES, &m_lQueries[0][0]);
+}
+
+OverdrawCounter::OverdrawCounter(const OverdrawCounter& a_pOther)
+{
+	// Queries cannot be shared, so only the last result is copied.
+	GLCall(glGenQueries(OVERDRAW_LATENCY * OVERDRAW_MAX_SCOPES, &m_lQueries[0][0]));
+	for (int i = 0; i < OVERDRAW_LATENCY; i++)
+	{
+		m_lScopeCount[i] = 0;
+	}
+	m_uShadedSamples = a_pOther.m_uShadedSamples;
+}
+
+OverdrawCounter& OverdrawCounter::operator=(const OverdrawCounter& a_pOther)
+{
+	// Queries cannot be shared, so only the last result is copied.
+	m_uShadedSamples = a_pOther.m_uShadedSamples;
+	return *this;
+}
+
+void OverdrawCounter::BeginFrame(void)
+{
+	// The slot about to be reused holds the oldest frame in flight.
+	m_dFrame = (m_dFrame + 1) % OVERDRAW_LATENCY;
+	int dScopes = m_lScopeCount[m_dFrame];
+	if (dScopes > 0)
+	{
+		GLuint64 uTotal = 0;
+		for (int i = 0; i < dScopes; i++)
+		{
+			GLuint64 uSamples = 0;
+			GLCall(glGetQueryObjectui64v(m_lQueries[m_dFrame][i], GL_QUERY_RESULT, &uSamples));
+			uTotal += uSamples;
+		}
+		m_uShadedSamples = uTotal;
+	}
+	m_lScopeCount[m_dFrame] = 0;
+}
+
+void OverdrawCounter::Begin(void)
+{
+	int& dScopes = m_lScopeCount[m_dFrame];
+	if (m_bIsScopeOpen || dScopes == OVERDRAW_MAX_SCOPES) return;
+
+	GLCall(glBeginQuery(GL_SAMPLES_PASSED, m_lQueries[m_dFrame][dScopes]));
+	dScopes++;
+	m_bIsScopeOpen = true;
+}
+
+void OverdrawCounter::End(void)
+{
+	if (!m_bIsScopeOpen) return;
+
+	GLCall(glEndQuery(GL_SAMPLES_PASSED));
+	m_bIsScopeOpen = false;
+}
+
+GLuint64 OverdrawCounter::GetShadedSamples(void) { return m_uShadedSamples; }
+
+float OverdrawCounter::GetOverdraw(int a_dWidth, int a_dHeight)
+{
+	if (a_dWidth <= 0 || a_dHeight <= 0) return 0.0f;
+
+	return (float)m_uShadedSamples / ((float)a_dWidth * a_dHeight);
+}
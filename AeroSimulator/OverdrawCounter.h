@@ -0,0 +1,74 @@
+#ifndef __OVERDRAWCOUNTER_H_
+#define __OVERDRAWCOUNTER_H_
+
+#include <GL/glew.h>
+
+// Frames a query result is left in flight before it is read, so reading never stalls.
+#define OVERDRAW_LATENCY 3
+
+// Maximum number of measured scopes in a single frame.
+#define OVERDRAW_MAX_SCOPES 8
+
+/// <summary>
+/// Counts the fragments shaded each frame with GL_SAMPLES_PASSED queries.
+/// Divided by the screen size this is the average overdraw per pixel.
+/// </summary>
+class OverdrawCounter
+{
+private:
+	GLuint m_lQueries[OVERDRAW_LATENCY][OVERDRAW_MAX_SCOPES];
+	int m_lScopeCount[OVERDRAW_LATENCY];
+	int m_dFrame = 0;
+	bool m_bIsScopeOpen = false;
+	GLuint64 m_uShadedSamples = 0;
+
+public:
+	/// <summary>
+	/// Creates the query objects.  Requires a current GL context.
+	/// </summary>
+	OverdrawCounter(void);
+
+	/// <summary>
+	/// Deletes the query objects.
+	/// </summary>
+	~OverdrawCounter(void);
+
+	/// <summary>
+	/// Copy constructor for the OverdrawCounter.  Creates its own queries.
+	/// </summary>
+	OverdrawCounter(const OverdrawCounter& a_pOther);
+
+	/// <summary>
+	/// Copy operator for the OverdrawCounter.  Keeps its own queries.
+	/// </summary>
+	OverdrawCounter& operator=(const OverdrawCounter& a_pOther);
+
+	/// <summary>
+	/// Reads back the oldest frame in flight and starts recording a new one.
+	/// </summary>
+	void BeginFrame(void);
+
+	/// <summary>
+	/// Starts counting the fragments of the following draws.  Scopes may not nest.
+	/// </summary>
+	void Begin(void);
+
+	/// <summary>
+	/// Stops counting fragments.
+	/// </summary>
+	void End(void);
+
+	/// <summary>
+	/// Gets the fragments shaded in the last resolved frame.
+	/// </summary>
+	GLuint64 GetShadedSamples(void);
+
+	/// <summary>
+	/// Gets the shaded fragments per pixel of the last resolved frame.
+	/// </summary>
+	/// <param name="a_dWidth">Width of the measured render target.</param>
+	/// <param name="a_dHeight">Height of the measured render target.</param>
+	float GetOverdraw(int a_dWidth, int a_dHeight);
+};
+
+#endif //__OVERDRAWCOUNTER_H_
@@ -0,0 +1,173 @@
+#include "PerfCounters.h"
+#include <cstring>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// Why the last thread that tried could not open its counters.  Only ever written with literals.
+static const char* s_sError = "";
+
+#ifdef __linux__
+
+/// <summary>
+/// The calling thread's counter group.  Closed when the thread exits.
+/// </summary>
+struct ThreadCounters
+{
+	int Files[PERF_COUNTER_COUNT];
+	uint64_t IDs[PERF_COUNTER_COUNT];
+	bool HasTried;
+	bool IsOpen;
+
+	ThreadCounters(void)
+	{
+		for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+		{
+			Files[i] = -1;
+			IDs[i] = 0;
+		}
+		HasTried = false;
+		IsOpen = false;
+	}
+
+	~ThreadCounters(void)
+	{
+		for (int i = PERF_COUNTER_COUNT - 1; i >= 0; i--)
+		{
+			if (Files[i] != -1) close(Files[i]);
+		}
+	}
+};
+static thread_local ThreadCounters t_counters;
+
+/// <summary>
+/// Opens one counter of the calling thread, joining the group led by a_dLeader.
+/// </summary>
+static int OpenCounter(uint32_t a_uType, uint64_t a_uConfig, int a_dLeader)
+{
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = a_uType;
+	attr.config = a_uConfig;
+	attr.disabled = a_dLeader == -1 ? 1 : 0;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	// The calling thread on any CPU.
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, a_dLeader, 0);
+}
+
+/// <summary>
+/// Opens the calling thread's group, once.
+/// </summary>
+static bool OpenThreadCounters(void)
+{
+	ThreadCounters& counters = t_counters;
+	if (counters.HasTried) return counters.IsOpen;
+	counters.HasTried = true;
+
+	// Cycles lead the group.  Without them nothing else is worth counting.
+	counters.Files[PERF_CYCLES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+	if (counters.Files[PERF_CYCLES] == -1)
+	{
+		s_sError = errno == EACCES || errno == EPERM ? "perf_event_open was denied, lower kernel.perf_event_paranoid" :
+			errno == ENOENT || errno == EOPNOTSUPP ? "This CPU or virtual machine exposes no hardware counters" :
+			"perf_event_open failed";
+		return false;
+	}
+
+	// The rest are optional, a missing one just reads as 0.
+	int dLeader = counters.Files[PERF_CYCLES];
+	counters.Files[PERF_INSTRUCTIONS] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, dLeader);
+	counters.Files[PERF_L1D_MISSES] = OpenCounter(PERF_TYPE_HW_CACHE,
+		PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), dLeader);
+	counters.Files[PERF_LLC_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, dLeader);
+	counters.Files[PERF_BRANCH_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, dLeader);
+
+	// Reads come back tagged with these IDs.
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+	{
+		if (counters.Files[i] != -1)
+		{
+			ioctl(counters.Files[i], PERF_EVENT_IOC_ID, &counters.IDs[i]);
+		}
+	}
+
+	ioctl(dLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(dLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	counters.IsOpen = true;
+	return true;
+}
+
+bool PerfCounters::IsAvailable(void)
+{
+	return OpenThreadCounters();
+}
+
+bool PerfCounters::Read(PerfCounterValues& a_values)
+{
+	memset(&a_values, 0, sizeof(a_values));
+	if (!OpenThreadCounters()) return false;
+
+	// Group layout: count, time enabled, time running, then a value and ID per counter.
+	uint64_t lData[3 + 2 * PERF_COUNTER_COUNT];
+	ThreadCounters& counters = t_counters;
+	if (read(counters.Files[PERF_CYCLES], lData, sizeof(lData)) <= 0) return false;
+
+	// Scaling up if the group had to share the PMU with other groups.
+	uint64_t uCount = lData[0];
+	double dScale = lData[2] > 0 ? (double)lData[1] / lData[2] : 1.0;
+	for (uint64_t i = 0; i < uCount && i < PERF_COUNTER_COUNT; i++)
+	{
+		uint64_t uValue = lData[3 + 2 * i];
+		uint64_t uID = lData[4 + 2 * i];
+		for (int c = 0; c < PERF_COUNTER_COUNT; c++)
+		{
+			if (counters.Files[c] != -1 && counters.IDs[c] == uID)
+			{
+				a_values.Values[c] = (uint64_t)(uValue * dScale);
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+#else
+
+bool PerfCounters::IsAvailable(void)
+{
+	s_sError = "Hardware counters need Linux perf_event_open";
+	return false;
+}
+
+bool PerfCounters::Read(PerfCounterValues& a_values)
+{
+	memset(&a_values, 0, sizeof(a_values));
+	return false;
+}
+
+#endif
+
+const char* PerfCounters::GetError(void) { return s_sError; }
+
+const char* PerfCounters::GetCounterName(PerfCounter a_eCounter)
+{
+	switch (a_eCounter)
+	{
+	case PERF_CYCLES: return "cycles";
+	case PERF_INSTRUCTIONS: return "instructions";
+	case PERF_L1D_MISSES: return "l1d_misses";
+	case PERF_LLC_MISSES: return "llc_misses";
+	case PERF_BRANCH_MISSES: return "branch_misses";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef __PERFCOUNTERS_H_
+#define __PERFCOUNTERS_H_
+
+#include <cstdint>
+
+/// <summary>
+/// Hardware events counted per thread.
+/// </summary>
+enum PerfCounter
+{
+	PERF_CYCLES = 0,
+	PERF_INSTRUCTIONS,
+	PERF_L1D_MISSES,		// L1 data cache read misses.
+	PERF_LLC_MISSES,		// Last level cache misses.
+	PERF_BRANCH_MISSES,
+	PERF_COUNTER_COUNT
+};
+
+/// <summary>
+/// Counter values of the calling thread, or the difference between two readings.
+/// </summary>
+struct PerfCounterValues
+{
+	uint64_t Values[PERF_COUNTER_COUNT];
+};
+
+/// <summary>
+/// Reads hardware performance counters of the calling thread through Linux's
+/// perf_event_open.  Every thread opens its own counter group the first time it
+/// reads, and one read returns every counter.  Where counters cannot be opened,
+/// because of the platform, a virtual machine or perf_event_paranoid, reads
+/// simply fail and the reason is kept for display.
+/// </summary>
+class PerfCounters
+{
+public:
+	/// <summary>
+	/// Gets whether the calling thread could open its counters.  Opens them if it has not tried yet.
+	/// </summary>
+	static bool IsAvailable(void);
+
+	/// <summary>
+	/// Reads every counter of the calling thread.  Counters a CPU lacks read as 0.
+	/// </summary>
+	/// <param name="a_values">Receives the counts since the thread opened its counters.</param>
+	/// <returns>False if the thread has no counters.</returns>
+	static bool Read(PerfCounterValues& a_values);
+
+	/// <summary>
+	/// Gets why counters are unavailable, or an empty string if they are.
+	/// </summary>
+	static const char* GetError(void);
+
+	/// <summary>
+	/// Gets the display name of a counter.
+	/// </summary>
+	static const char* GetCounterName(PerfCounter a_eCounter);
+};
+
+#endif //__PERFCOUNTERS_H_
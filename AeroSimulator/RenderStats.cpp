@@ -0,0 +1,74 @@
+#include "RenderStats.h"
+#include <iostream>
+#include <fstream>
+
+RenderCounters RenderStats::m_current = RenderCounters();
+RenderCounters RenderStats::m_lastFrame = RenderCounters();
+RenderCounters RenderStats::m_totals = RenderCounters();
+RenderCounters RenderStats::m_peaks = RenderCounters();
+int RenderStats::m_dFrames = 0;
+
+void RenderStats::BeginFrame(void)
+{
+	m_lastFrame = m_current;
+	for (int i = 0; i < RS_COUNTER_COUNT; i++)
+	{
+		m_totals.Values[i] += m_current.Values[i];
+		m_peaks.Values[i] = m_current.Values[i] > m_peaks.Values[i] ? m_current.Values[i] : m_peaks.Values[i];
+		m_current.Values[i] = 0;
+	}
+	m_dFrames++;
+}
+
+const RenderCounters& RenderStats::GetLastFrame(void) { return m_lastFrame; }
+const RenderCounters& RenderStats::GetTotals(void) { return m_totals; }
+const RenderCounters& RenderStats::GetPeaks(void) { return m_peaks; }
+int RenderStats::GetFrameCount(void) { return m_dFrames; }
+
+void RenderStats::ResetTotals(void)
+{
+	m_totals = RenderCounters();
+	m_peaks = RenderCounters();
+	m_dFrames = 0;
+}
+
+bool RenderStats::Export(const std::string& a_sFilepath)
+{
+	std::ofstream writer(a_sFilepath, std::ios::out | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the render statistics to " << a_sFilepath << std::endl;
+		return false;
+	}
+
+	double dFrames = m_dFrames > 0 ? (double)m_dFrames : 1.0;
+	writer << "{\n\t\"frames\": " << m_dFrames << ",\n\t\"counters\": {";
+	for (int i = 0; i < RS_COUNTER_COUNT; i++)
+	{
+		writer << (i == 0 ? "\n" : ",\n") << "\t\t\"" << GetCounterName((RenderCounter)i) << "\": {"
+			<< " \"mean\": " << m_totals.Values[i] / dFrames
+			<< ", \"max\": " << m_peaks.Values[i] << " }";
+	}
+	writer << "\n\t}\n}\n";
+	return true;
+}
+
+const char* RenderStats::GetCounterName(RenderCounter a_eCounter)
+{
+	switch (a_eCounter)
+	{
+	case RS_DRAW_CALLS: return "draw_calls";
+	case RS_TRIANGLES: return "triangles";
+	case RS_VERTICES: return "vertices";
+	case RS_PROGRAM_BINDS: return "program_binds";
+	case RS_VAO_BINDS: return "vao_binds";
+	case RS_TEXTURE_BINDS: return "texture_binds";
+	case RS_UNIFORM_UPLOADS: return "uniform_uploads";
+	case RS_BUFFER_BYTES: return "buffer_bytes";
+	case RS_ENTITIES: return "entities";
+	case RS_VISIBLE_ENTITIES: return "visible_entities";
+	case RS_CULLED_ENTITIES: return "culled_entities";
+	case RS_OCCLUDED_ENTITIES: return "occluded_entities";
+	default: return "unknown";
+	}
+}
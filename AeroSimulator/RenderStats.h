@@ -0,0 +1,106 @@
+#ifndef __RENDERSTATS_H_
+#define __RENDERSTATS_H_
+
+#include <string>
+
+/// <summary>
+/// What is counted every frame.
+/// </summary>
+enum RenderCounter
+{
+	RS_DRAW_CALLS = 0,
+	RS_TRIANGLES,
+	RS_VERTICES,
+	RS_PROGRAM_BINDS,
+	RS_VAO_BINDS,
+	RS_TEXTURE_BINDS,
+	RS_UNIFORM_UPLOADS,
+	RS_BUFFER_BYTES,		// Bytes uploaded into buffers, including pixel buffers.
+	RS_ENTITIES,
+	RS_VISIBLE_ENTITIES,	// Entities drawn.
+	RS_CULLED_ENTITIES,		// Outside of the view.
+	RS_OCCLUDED_ENTITIES,	// Inside the view but hidden by occluders.
+	RS_COUNTER_COUNT
+};
+
+/// <summary>
+/// One value per RenderCounter.
+/// </summary>
+struct RenderCounters
+{
+	long long Values[RS_COUNTER_COUNT];
+};
+
+/// <summary>
+/// Counts the GL work of every frame where it is issued, so regressions like
+/// doubled state changes show up as numbers.  Only the thread owning the GL
+/// context counts, so the counters are plain integers.
+/// </summary>
+class RenderStats
+{
+private:
+	static RenderCounters m_current;
+	static RenderCounters m_lastFrame;
+	static RenderCounters m_totals;
+	static RenderCounters m_peaks;
+	static int m_dFrames;
+
+public:
+	/// <summary>
+	/// Adds to a counter of the frame being drawn.
+	/// </summary>
+	static void Add(RenderCounter a_eCounter, long long a_lAmount = 1) { m_current.Values[a_eCounter] += a_lAmount; }
+
+	/// <summary>
+	/// Counts a draw of triangles.
+	/// </summary>
+	static void AddDraw(long long a_lVertices)
+	{
+		m_current.Values[RS_DRAW_CALLS]++;
+		m_current.Values[RS_VERTICES] += a_lVertices;
+		m_current.Values[RS_TRIANGLES] += a_lVertices / 3;
+	}
+
+	/// <summary>
+	/// Finishes the frame being drawn and starts counting the next one.
+	/// </summary>
+	static void BeginFrame(void);
+
+	/// <summary>
+	/// Gets the counters of the last finished frame.
+	/// </summary>
+	static const RenderCounters& GetLastFrame(void);
+
+	/// <summary>
+	/// Gets the counters of every frame since the last reset added up.
+	/// </summary>
+	static const RenderCounters& GetTotals(void);
+
+	/// <summary>
+	/// Gets the highest value of every counter in a frame since the last reset.
+	/// </summary>
+	static const RenderCounters& GetPeaks(void);
+
+	/// <summary>
+	/// Gets the number of frames finished since the last reset.
+	/// </summary>
+	static int GetFrameCount(void);
+
+	/// <summary>
+	/// Clears the totals and peaks.
+	/// </summary>
+	static void ResetTotals(void);
+
+	/// <summary>
+	/// Writes the per frame mean and peak of every counter.
+	/// </summary>
+	/// <returns>False if the file cannot be written.</returns>
+	static bool Export(const std::string& a_sFilepath);
+
+	/// <summary>
+	/// Gets the display name of a counter.
+	/// </summary>
+	static const char* GetCounterName(RenderCounter a_eCounter);
+};
+
+#endif //__RENDERSTATS_H_
@@ -0,0 +1,85 @@
+// Replays a file written with the engine's --gl-capture option on a headless
+// context and times every captured frame:
+//   Replayer <capture.aeroglc> [--backend egl|osmesa] [--repeat 1] [--output replay.json]
+// The replayer only depends on GLEW and the headless context, so it can be built
+// on the machine reproducing the capture from this folder with:
+//   g++ -std=c++17 -O2 -DAERO_HEADLESS_EGL -I../include -I.. -o Replayer Main.cpp
+//       ../GLReplay.cpp ../GLCapture.cpp ../HeadlessContext.cpp ../Debug.cpp -lGLEW -lEGL -lGL
+#include "../GLReplay.h"
+#include "../HeadlessContext.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: Replayer <capture> [--backend egl|osmesa] [--repeat 1] [--output replay.json]" << std::endl;
+		return 1;
+	}
+
+	std::string sCapture = argv[1];
+	HeadlessBackend eBackend = HEADLESS_EGL;
+	int dRepeat = 1;
+	std::string sOutput = "replay.json";
+	for (int i = 2; i < argc; i++)
+	{
+		std::string sArg = argv[i];
+		bool bHasValue = i + 1 < argc;
+		if (sArg == "--backend" && bHasValue)
+		{
+			if (!HeadlessContext::ParseBackend(argv[++i], eBackend))
+			{
+				std::cout << "Unknown backend " << argv[i] << ", expected egl or osmesa." << std::endl;
+				return 1;
+			}
+		}
+		else if (sArg == "--repeat" && bHasValue) dRepeat = std::atoi(argv[++i]);
+		else if (sArg == "--output" && bHasValue) sOutput = argv[++i];
+		else
+		{
+			std::cout << "Unknown option " << sArg << std::endl;
+			return 1;
+		}
+	}
+
+	GLReplayer replayer;
+	if (!replayer.Load(sCapture)) return 1;
+
+	const GLCaptureHeader& header = replayer.GetHeader();
+	HeadlessContext context;
+	if (!context.Create(eBackend, (int)header.Width, (int)header.Height)) return 1;
+
+	std::cout << "Replaying " << header.Frames << " frames and " << header.Calls << " calls captured on "
+		<< replayer.GetDriver() << std::endl;
+	std::cout << "Replaying on " << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION) << std::endl;
+
+	// Every repeat rebuilds the scene from the capture, so the last one runs with warm driver caches.
+	for (int i = 0; i < dRepeat || i == 0; i++)
+	{
+		if (!replayer.Replay(context.GetFramebuffer())) return 1;
+	}
+
+	const std::vector<GLReplayFrame>& lFrames = replayer.GetFrames();
+	float fFrameMean = 0.0f;
+	float fIssueMean = 0.0f;
+	int dErrors = 0;
+	for (int i = 0; i < lFrames.size(); i++)
+	{
+		fFrameMean += lFrames[i].FrameMS;
+		fIssueMean += lFrames[i].IssueMS;
+		dErrors += lFrames[i].Errors;
+	}
+	if (!lFrames.empty())
+	{
+		fFrameMean /= lFrames.size();
+		fIssueMean /= lFrames.size();
+	}
+	std::cout << lFrames.size() << " frames, " << fFrameMean << " ms per frame, "
+		<< fIssueMean << " ms issuing calls, " << dErrors << " GL errors" << std::endl;
+
+	if (!replayer.Export(sOutput)) return 1;
+	std::cout << "Wrote " << sOutput << std::endl;
+	return 0;
+}
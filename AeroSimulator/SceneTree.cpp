@@ -0,0 +1,368 @@
+#include "SceneTree.h"
+#include <algorithm>
+#include <cassert>
+
+SceneTree::SceneTree(float a_fMargin)
+{
+	m_fMargin = a_fMargin;
+}
+
+// - - Proxies - -
+int SceneTree::CreateProxy(const AABB& a_aBox, void* a_pUserData)
+{
+	int dLeaf = AllocateNode();
+
+	// Fattening the box so the leaf survives small movements.
+	m_lNodes[dLeaf].Box = a_aBox.Expanded(m_fMargin);
+	m_lNodes[dLeaf].UserData = a_pUserData;
+	m_lNodes[dLeaf].Height = 0;
+
+	InsertLeaf(dLeaf);
+	m_dProxyCount++;
+
+	return dLeaf;
+}
+
+void SceneTree::DestroyProxy(int a_dProxyID)
+{
+	assert(a_dProxyID >= 0 && a_dProxyID < (int)m_lNodes.size());
+	assert(m_lNodes[a_dProxyID].IsLeaf());
+
+	RemoveLeaf(a_dProxyID);
+	FreeNode(a_dProxyID);
+	m_dProxyCount--;
+}
+
+bool SceneTree::MoveProxy(int a_dProxyID, const AABB& a_aBox)
+{
+	assert(a_dProxyID >= 0 && a_dProxyID < (int)m_lNodes.size());
+	assert(m_lNodes[a_dProxyID].IsLeaf());
+
+	// Still inside of the fat box, nothing to restructure.
+	if (m_lNodes[a_dProxyID].Box.Contains(a_aBox))
+	{
+		return false;
+	}
+
+	RemoveLeaf(a_dProxyID);
+	m_lNodes[a_dProxyID].Box = a_aBox.Expanded(m_fMargin);
+	InsertLeaf(a_dProxyID);
+
+	return true;
+}
+
+void* SceneTree::GetUserData(int a_dProxyID) const { return m_lNodes[a_dProxyID].UserData; }
+const AABB& SceneTree::GetFatBox(int a_dProxyID) const { return m_lNodes[a_dProxyID].Box; }
+int SceneTree::GetProxyCount(void) const { return m_dProxyCount; }
+
+int SceneTree::GetHeight(void) const
+{
+	if (m_dRoot == NULL_NODE) return 0;
+
+	return m_lNodes[m_dRoot].Height;
+}
+
+// - - Output List Queries - -
+void SceneTree::QueryAABB(const AABB& a_aBox, std::vector<void*>& a_lOut) const
+{
+	QueryAABB(a_aBox, [&](int a_dProxy) { a_lOut.push_back(m_lNodes[a_dProxy].UserData); return true; });
+}
+
+void SceneTree::QuerySphere(const Sphere& a_sSphere, std::vector<void*>& a_lOut) const
+{
+	QuerySphere(a_sSphere, [&](int a_dProxy) { a_lOut.push_back(m_lNodes[a_dProxy].UserData); return true; });
+}
+
+void SceneTree::QueryFrustum(const Frustum& a_fFrustum, std::vector<void*>& a_lOut) const
+{
+	QueryFrustum(a_fFrustum, [&](int a_dProxy) { a_lOut.push_back(m_lNodes[a_dProxy].UserData); return true; });
+}
+
+void SceneTree::QueryRay(const Ray& a_rRay, std::vector<void*>& a_lOut) const
+{
+	QueryRay(a_rRay, [&](int a_dProxy, float) { a_lOut.push_back(m_lNodes[a_dProxy].UserData); return true; });
+}
+
+// - - Private Methods - -
+int SceneTree::AllocateNode(void)
+{
+	// Growing the pool and threading the new nodes onto the free list.
+	if (m_dFreeList == NULL_NODE)
+	{
+		int dOldSize = (int)m_lNodes.size();
+		int dNewSize = std::max(16, dOldSize * 2);
+		m_lNodes.resize(dNewSize);
+
+		for (int i = dOldSize; i < dNewSize; i++)
+		{
+			m_lNodes[i].Parent = (i + 1 < dNewSize) ? i + 1 : NULL_NODE;
+			m_lNodes[i].Height = -1;
+		}
+		m_dFreeList = dOldSize;
+	}
+
+	int dNode = m_dFreeList;
+	m_dFreeList = m_lNodes[dNode].Parent;
+
+	Node& node = m_lNodes[dNode];
+	node.Parent = NULL_NODE;
+	node.Left = NULL_NODE;
+	node.Right = NULL_NODE;
+	node.Height = 0;
+	node.UserData = nullptr;
+
+	return dNode;
+}
+
+void SceneTree::FreeNode(int a_dNode)
+{
+	m_lNodes[a_dNode].Parent = m_dFreeList;
+	m_lNodes[a_dNode].Height = -1;
+	m_dFreeList = a_dNode;
+}
+
+void SceneTree::InsertLeaf(int a_dLeaf)
+{
+	if (m_dRoot == NULL_NODE)
+	{
+		m_dRoot = a_dLeaf;
+		m_lNodes[m_dRoot].Parent = NULL_NODE;
+		return;
+	}
+
+	// Descending the tree to find the cheapest sibling using the surface area heuristic.
+	AABB leafBox = m_lNodes[a_dLeaf].Box;
+	int dIndex = m_dRoot;
+	while (!m_lNodes[dIndex].IsLeaf())
+	{
+		const Node& node = m_lNodes[dIndex];
+		float fArea = node.Box.GetSurfaceArea();
+		float fCombinedArea = AABB::Merge(node.Box, leafBox).GetSurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf.
+		float fCost = 2.0f * fCombinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		float fInheritance = 2.0f * (fCombinedArea - fArea);
+
+		// Cost of descending into either child.
+		float fChildCost[2];
+		int dChildren[2] = { node.Left, node.Right };
+		for (int i = 0; i < 2; i++)
+		{
+			const Node& child = m_lNodes[dChildren[i]];
+			float fMerged = AABB::Merge(leafBox, child.Box).GetSurfaceArea();
+			fChildCost[i] = child.IsLeaf() ? fMerged + fInheritance :
+				(fMerged - child.Box.GetSurfaceArea()) + fInheritance;
+		}
+
+		// Stopping here if neither child is cheaper.
+		if (fCost < fChildCost[0] && fCost < fChildCost[1]) break;
+
+		dIndex = (fChildCost[0] < fChildCost[1]) ? node.Left : node.Right;
+	}
+	int dSibling = dIndex;
+
+	// Creating a new parent for the sibling and the leaf.
+	int dOldParent = m_lNodes[dSibling].Parent;
+	int dNewParent = AllocateNode();
+	m_lNodes[dNewParent].Parent = dOldParent;
+	m_lNodes[dNewParent].Box = AABB::Merge(leafBox, m_lNodes[dSibling].Box);
+	m_lNodes[dNewParent].Height = m_lNodes[dSibling].Height + 1;
+	m_lNodes[dNewParent].Left = dSibling;
+	m_lNodes[dNewParent].Right = a_dLeaf;
+	m_lNodes[dSibling].Parent = dNewParent;
+	m_lNodes[a_dLeaf].Parent = dNewParent;
+
+	if (dOldParent == NULL_NODE)
+	{
+		// The sibling was the root.
+		m_dRoot = dNewParent;
+	}
+	else if (m_lNodes[dOldParent].Left == dSibling)
+	{
+		m_lNodes[dOldParent].Left = dNewParent;
+	}
+	else
+	{
+		m_lNodes[dOldParent].Right = dNewParent;
+	}
+
+	// Walking back up the tree fixing boxes and heights.
+	Refit(m_lNodes[a_dLeaf].Parent);
+}
+
+void SceneTree::RemoveLeaf(int a_dLeaf)
+{
+	if (a_dLeaf == m_dRoot)
+	{
+		m_dRoot = NULL_NODE;
+		return;
+	}
+
+	int dParent = m_lNodes[a_dLeaf].Parent;
+	int dGrandParent = m_lNodes[dParent].Parent;
+	int dSibling = (m_lNodes[dParent].Left == a_dLeaf) ? m_lNodes[dParent].Right : m_lNodes[dParent].Left;
+
+	// Replacing the parent with the sibling and freeing the parent.
+	if (dGrandParent != NULL_NODE)
+	{
+		if (m_lNodes[dGrandParent].Left == dParent)
+		{
+			m_lNodes[dGrandParent].Left = dSibling;
+		}
+		else
+		{
+			m_lNodes[dGrandParent].Right = dSibling;
+		}
+		m_lNodes[dSibling].Parent = dGrandParent;
+		FreeNode(dParent);
+
+		Refit(dGrandParent);
+	}
+	else
+	{
+		m_dRoot = dSibling;
+		m_lNodes[dSibling].Parent = NULL_NODE;
+		FreeNode(dParent);
+	}
+}
+
+void SceneTree::Refit(int a_dNode)
+{
+	int dIndex = a_dNode;
+	while (dIndex != NULL_NODE)
+	{
+		dIndex = Balance(dIndex);
+
+		Node& node = m_lNodes[dIndex];
+		const Node& left = m_lNodes[node.Left];
+		const Node& right = m_lNodes[node.Right];
+		node.Height = 1 + std::max(left.Height, right.Height);
+		node.Box = AABB::Merge(left.Box, right.Box);
+
+		dIndex = node.Parent;
+	}
+}
+
+int SceneTree::Balance(int a_dNode)
+{
+	// Rotation scheme from Erin Catto's Box2D dynamic tree.
+	// A is the node being balanced with children B and C,
+	// B has children D and E, and C has children F and G.
+	int iA = a_dNode;
+	Node& A = m_lNodes[iA];
+	if (A.IsLeaf() || A.Height < 2) return iA;
+
+	int iB = A.Left;
+	int iC = A.Right;
+	Node& B = m_lNodes[iB];
+	Node& C = m_lNodes[iC];
+	int dBalance = C.Height - B.Height;
+
+	// Rotating C up.
+	if (dBalance > 1)
+	{
+		int iF = C.Left;
+		int iG = C.Right;
+		Node& F = m_lNodes[iF];
+		Node& G = m_lNodes[iG];
+
+		// Swapping A and C.
+		C.Left = iA;
+		C.Parent = A.Parent;
+		A.Parent = iC;
+
+		// A's old parent should point to C.
+		if (C.Parent != NULL_NODE)
+		{
+			if (m_lNodes[C.Parent].Left == iA) m_lNodes[C.Parent].Left = iC;
+			else m_lNodes[C.Parent].Right = iC;
+		}
+		else
+		{
+			m_dRoot = iC;
+		}
+
+		// Keeping the taller of F and G under C.
+		if (F.Height > G.Height)
+		{
+			C.Right = iF;
+			A.Right = iG;
+			G.Parent = iA;
+			A.Box = AABB::Merge(B.Box, G.Box);
+			C.Box = AABB::Merge(A.Box, F.Box);
+			A.Height = 1 + std::max(B.Height, G.Height);
+			C.Height = 1 + std::max(A.Height, F.Height);
+		}
+		else
+		{
+			C.Right = iG;
+			A.Right = iF;
+			F.Parent = iA;
+			A.Box = AABB::Merge(B.Box, F.Box);
+			C.Box = AABB::Merge(A.Box, G.Box);
+			A.Height = 1 + std::max(B.Height, F.Height);
+			C.Height = 1 + std::max(A.Height, G.Height);
+		}
+
+		return iC;
+	}
+
+	// Rotating B up.
+	if (dBalance < -1)
+	{
+		int iD = B.Left;
+		int iE = B.Right;
+		Node& D = m_lNodes[iD];
+		Node& E = m_lNodes[iE];
+
+		// Swapping A and B.
+		B.Left = iA;
+		B.Parent = A.Parent;
+		A.Parent = iB;
+
+		// A's old parent should point to B.
+		if (B.Parent != NULL_NODE)
+		{
+			if (m_lNodes[B.Parent].Left == iA) m_lNodes[B.Parent].Left = iB;
+			else m_lNodes[B.Parent].Right = iB;
+		}
+		else
+		{
+			m_dRoot = iB;
+		}
+
+		// Keeping the taller of D and E under B.
+		if (D.Height > E.Height)
+		{
+			B.Right = iD;
+			A.Left = iE;
+			E.Parent = iA;
+			A.Box = AABB::Merge(C.Box, E.Box);
+			B.Box = AABB::Merge(A.Box, D.Box);
+			A.Height = 1 + std::max(C.Height, E.Height);
+			B.Height = 1 + std::max(A.Height, D.Height);
+		}
+		else
+		{
+			B.Right = iE;
+			A.Left = iD;
+			D.Parent = iA;
+			A.Box = AABB::Merge(C.Box, D.Box);
+			B.Box = AABB::Merge(A.Box, E.Box);
+			A.Height = 1 + std::max(C.Height, D.Height);
+			B.Height = 1 + std::max(A.Height, E.Height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+std::vector<int>& SceneTree::GetStack(void)
+{
+	static thread_local std::vector<int> t_lStack;
+	return t_lStack;
+}
@@ -0,0 +1,329 @@
+#ifndef __SCENETREE_H_
+#define __SCENETREE_H_
+
+#include <vector>
+
+#include "Bounds.h"
+
+#define NULL_NODE -1
+
+/// <summary>
+/// Dynamic AABB tree over the scene used for culling and proximity queries.
+/// Leaves store a fattened box so small movements do not touch the tree.
+/// </summary>
+class SceneTree
+{
+private:
+	/// <summary>
+	/// A single node of the tree.  Leaves carry the user's data.
+	/// </summary>
+	struct Node
+	{
+		AABB Box;
+		void* UserData;
+		int Parent;		// Doubles as the next free node while in the free list.
+		int Left;
+		int Right;
+		int Height;		// Leaves are 0 and free nodes are -1.
+
+		bool IsLeaf(void) const { return Left == NULL_NODE; }
+	};
+
+	std::vector<Node> m_lNodes;
+	int m_dRoot = NULL_NODE;
+	int m_dFreeList = NULL_NODE;
+	int m_dProxyCount = 0;
+	float m_fMargin;
+
+public:
+	/// <summary>
+	/// Constructs an empty tree.
+	/// </summary>
+	/// <param name="a_fMargin">How far leaf boxes are fattened on every side.</param>
+	SceneTree(float a_fMargin = 0.1f);
+
+	/// <summary>
+	/// Inserts a new object into the tree.
+	/// </summary>
+	/// <param name="a_aBox">Tight world bounds of the object.</param>
+	/// <param name="a_pUserData">Pointer handed back by queries.</param>
+	/// <returns>The proxy ID used to move or remove the object.</returns>
+	int CreateProxy(const AABB& a_aBox, void* a_pUserData);
+
+	/// <summary>
+	/// Removes an object from the tree.
+	/// </summary>
+	void DestroyProxy(int a_dProxyID);
+
+	/// <summary>
+	/// Updates the bounds of an object.  The tree is only restructured if
+	/// the new bounds escape the fattened box stored in the leaf.
+	/// </summary>
+	/// <param name="a_dProxyID">The proxy being moved.</param>
+	/// <param name="a_aBox">The new tight world bounds.</param>
+	/// <returns>True if the leaf was reinserted.</returns>
+	bool MoveProxy(int a_dProxyID, const AABB& a_aBox);
+
+	/// <summary>
+	/// Gets the user data stored with a proxy.
+	/// </summary>
+	void* GetUserData(int a_dProxyID) const;
+
+	/// <summary>
+	/// Gets the fattened box stored with a proxy.
+	/// </summary>
+	const AABB& GetFatBox(int a_dProxyID) const;
+
+	/// <summary>
+	/// Gets the number of objects in the tree.
+	/// </summary>
+	int GetProxyCount(void) const;
+
+	/// <summary>
+	/// Gets the height of the tree.  Zero when empty or a single leaf.
+	/// </summary>
+	int GetHeight(void) const;
+
+	/// <summary>
+	/// Calls a_Callback(proxyID) for every leaf overlapping the box.
+	/// Returning false from the callback stops the query.
+	/// </summary>
+	template <typename T>
+	void QueryAABB(const AABB& a_aBox, T a_Callback) const;
+
+	/// <summary>
+	/// Calls a_Callback(proxyID) for every leaf overlapping the sphere.
+	/// Returning false from the callback stops the query.
+	/// </summary>
+	template <typename T>
+	void QuerySphere(const Sphere& a_sSphere, T a_Callback) const;
+
+	/// <summary>
+	/// Calls a_Callback(proxyID) for every leaf inside of or touching the frustum.
+	/// Subtrees fully inside of the frustum are reported without further tests.
+	/// Returning false from the callback stops the query.
+	/// </summary>
+	template <typename T>
+	void QueryFrustum(const Frustum& a_fFrustum, T a_Callback) const;
+
+	/// <summary>
+	/// Calls a_Callback(proxyID, distance) for every leaf hit by the ray.
+	/// Returning false from the callback stops the query.
+	/// </summary>
+	template <typename T>
+	void QueryRay(const Ray& a_rRay, T a_Callback) const;
+
+	/// <summary>
+	/// Appends the user data of every leaf overlapping the box to the output list.
+	/// </summary>
+	void QueryAABB(const AABB& a_aBox, std::vector<void*>& a_lOut) const;
+
+	/// <summary>
+	/// Appends the user data of every leaf overlapping the sphere to the output list.
+	/// </summary>
+	void QuerySphere(const Sphere& a_sSphere, std::vector<void*>& a_lOut) const;
+
+	/// <summary>
+	/// Appends the user data of every leaf touching the frustum to the output list.
+	/// </summary>
+	void QueryFrustum(const Frustum& a_fFrustum, std::vector<void*>& a_lOut) const;
+
+	/// <summary>
+	/// Appends the user data of every leaf hit by the ray to the output list.
+	/// </summary>
+	void QueryRay(const Ray& a_rRay, std::vector<void*>& a_lOut) const;
+
+private:
+	/// <summary>
+	/// Pops a node off of the free list, growing the pool when it is empty.
+	/// </summary>
+	int AllocateNode(void);
+
+	/// <summary>
+	/// Returns a node to the free list.
+	/// </summary>
+	void FreeNode(int a_dNode);
+
+	/// <summary>
+	/// Links a leaf into the tree next to the cheapest sibling.
+	/// </summary>
+	void InsertLeaf(int a_dLeaf);
+
+	/// <summary>
+	/// Unlinks a leaf from the tree without freeing it.
+	/// </summary>
+	void RemoveLeaf(int a_dLeaf);
+
+	/// <summary>
+	/// Walks from the passed in node to the root refitting boxes and heights.
+	/// </summary>
+	void Refit(int a_dNode);
+
+	/// <summary>
+	/// Performs a rotation if the passed in node is out of balance.
+	/// </summary>
+	/// <returns>The node now occupying the passed in node's position.</returns>
+	int Balance(int a_dNode);
+
+	/// <summary>
+	/// Gets the traversal stack of the calling thread.  It is reused so queries do not
+	/// allocate once warmed up, and is per thread so const queries can run concurrently.
+	/// </summary>
+	static std::vector<int>& GetStack(void);
+
+	/// <summary>
+	/// Pushes every leaf under the passed in node to the callback.
+	/// </summary>
+	template <typename T>
+	bool ReportSubtree(int a_dNode, T& a_Callback) const;
+};
+
+// - - Template Definitions - -
+template <typename T>
+void SceneTree::QueryAABB(const AABB& a_aBox, T a_Callback) const
+{
+	std::vector<int>& lStack = GetStack();
+	lStack.clear();
+	if (m_dRoot != NULL_NODE) lStack.push_back(m_dRoot);
+
+	while (!lStack.empty())
+	{
+		int dNode = lStack.back();
+		lStack.pop_back();
+
+		const Node& node = m_lNodes[dNode];
+		if (!node.Box.Overlaps(a_aBox)) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!a_Callback(dNode)) return;
+		}
+		else
+		{
+			lStack.push_back(node.Left);
+			lStack.push_back(node.Right);
+		}
+	}
+}
+
+template <typename T>
+void SceneTree::QuerySphere(const Sphere& a_sSphere, T a_Callback) const
+{
+	std::vector<int>& lStack = GetStack();
+	lStack.clear();
+	if (m_dRoot != NULL_NODE) lStack.push_back(m_dRoot);
+
+	while (!lStack.empty())
+	{
+		int dNode = lStack.back();
+		lStack.pop_back();
+
+		const Node& node = m_lNodes[dNode];
+		if (!a_sSphere.Overlaps(node.Box)) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!a_Callback(dNode)) return;
+		}
+		else
+		{
+			lStack.push_back(node.Left);
+			lStack.push_back(node.Right);
+		}
+	}
+}
+
+template <typename T>
+void SceneTree::QueryFrustum(const Frustum& a_fFrustum, T a_Callback) const
+{
+	std::vector<int>& lStack = GetStack();
+	lStack.clear();
+	if (m_dRoot != NULL_NODE) lStack.push_back(m_dRoot);
+
+	while (!lStack.empty())
+	{
+		int dNode = lStack.back();
+		lStack.pop_back();
+
+		const Node& node = m_lNodes[dNode];
+		Frustum::Result result = a_fFrustum.Classify(node.Box);
+		if (result == Frustum::Outside) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!a_Callback(dNode)) return;
+		}
+		else if (result == Frustum::Inside)
+		{
+			// Everything below is visible, skip the plane tests.
+			if (!ReportSubtree(dNode, a_Callback)) return;
+		}
+		else
+		{
+			lStack.push_back(node.Left);
+			lStack.push_back(node.Right);
+		}
+	}
+}
+
+template <typename T>
+void SceneTree::QueryRay(const Ray& a_rRay, T a_Callback) const
+{
+	std::vector<int>& lStack = GetStack();
+	lStack.clear();
+	if (m_dRoot != NULL_NODE) lStack.push_back(m_dRoot);
+
+	while (!lStack.empty())
+	{
+		int dNode = lStack.back();
+		lStack.pop_back();
+
+		const Node& node = m_lNodes[dNode];
+		float fDistance = 0.0f;
+		if (!a_rRay.Intersects(node.Box, fDistance)) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!a_Callback(dNode, fDistance)) return;
+		}
+		else
+		{
+			lStack.push_back(node.Left);
+			lStack.push_back(node.Right);
+		}
+	}
+}
+
+template <typename T>
+bool SceneTree::ReportSubtree(int a_dNode, T& a_Callback) const
+{
+	// Leaves are pushed onto the end of the thread's stack and popped
+	// back off so the caller's pending nodes are left untouched.
+	std::vector<int>& lStack = GetStack();
+	size_t uBase = lStack.size();
+	lStack.push_back(a_dNode);
+
+	while (lStack.size() > uBase)
+	{
+		int dNode = lStack.back();
+		lStack.pop_back();
+
+		const Node& node = m_lNodes[dNode];
+		if (node.IsLeaf())
+		{
+			if (!a_Callback(dNode))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			lStack.push_back(node.Left);
+			lStack.push_back(node.Right);
+		}
+	}
+
+	return true;
+}
+
+#endif //__SCENETREE_H_
@@ -1,7 +1,10 @@
 #include "Shader.h"
 #include "Debug.h"
 #include "FileReader.h"
+#include "ShaderCache.h"
 #include <iostream>
+#include <chrono>
+#include <cstring>
 
 #define NULL_STR ""
 #define ERROR 0
@@ -19,6 +22,7 @@ Shader::Shader(const Shader& a_pOther)
 	m_sFragmentShaderFile = a_pOther.m_sFragmentShaderFile;
 	m_sVertexShaderFile = a_pOther.m_sVertexShaderFile;
 	m_uProgramID = a_pOther.m_uProgramID;
+	m_lDefines = a_pOther.m_lDefines;
 	
 	// Explicitly not copying the compiled bool.
 	//m_bIsCompiled = a_pOther.m_bIsCompiled;
@@ -26,6 +30,13 @@ Shader::Shader(const Shader& a_pOther)
 
 Shader::~Shader(void)
 {
+	// Dropping a compile that never finished.
+	if (m_bIsPending)
+	{
+		GLCall(glDeleteShader(m_uFragmentID));
+		GLCall(glDeleteShader(m_uVertexID));
+	}
+
 	if (glIsProgram(m_uProgramID))
 	{
 		// Deleting the shader.
@@ -45,6 +56,7 @@ Shader& Shader::operator=(const Shader& a_pOther)
 	m_sFragmentShaderFile = a_pOther.m_sFragmentShaderFile;
 	m_sVertexShaderFile = a_pOther.m_sVertexShaderFile;
 	m_uProgramID = a_pOther.m_uProgramID;
+	m_lDefines = a_pOther.m_lDefines;
 
 	// Explicitly not copying the compiled bool.
 	//m_bIsCompiled = a_pOther.m_bIsCompiled;
@@ -59,21 +71,128 @@ GLuint Shader::CompileShader(
 	// If it's already compiled, just return the program ID.
 	if (m_bIsCompiled) return m_uProgramID;
 
+	// Starting the compile and waiting on it right away.
+	BeginCompile(a_sVertexShaderFile, a_sFragmentShaderFile);
+	FinishCompile();
+
+	// Returning the program ID.
+	return m_uProgramID;
+}
+
+void Shader::BeginCompile(
+	std::string a_sVertexShaderFile,
+	std::string a_sFragmentShaderFile)
+{
+	if (m_bIsCompiled || m_bIsPending) return;
+
 	// Setting the shader file addresses.
 	m_sVertexShaderFile = a_sVertexShaderFile;
 	m_sFragmentShaderFile = a_sFragmentShaderFile;
 
+	auto start = std::chrono::high_resolution_clock::now();
+
 	// Loading the shaders and getting their program ID
 	m_uProgramID = LoadShaders(
 		m_sVertexShaderFile.c_str(),
 		m_sFragmentShaderFile.c_str()
 	);
 
+	m_fSetupMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Cache hits and missing files are done already.
+	if (!m_bIsPending)
+	{
+		FinishCompile();
+	}
+}
+
+bool Shader::IsCompileDone(void)
+{
+	if (!m_bIsPending) return true;
+
+	// Without the extension asking would wait for the compile, so it is reported as done.
+	if (!SupportsParallelCompile()) return true;
+
+	GLint dIsDone = GL_FALSE;
+	GLCall(glGetProgramiv(m_uProgramID, GL_COMPLETION_STATUS_KHR, &dIsDone));
+	return dIsDone == GL_TRUE;
+}
+
+void Shader::FinishCompile(void)
+{
+	if (m_bIsCompiled) return;
+
+	// A file could not be read, there is nothing to wait on.
+	if (m_uProgramID == ERROR)
+	{
+		std::cout << "Shader " << m_sVertexShaderFile << " + " << m_sFragmentShaderFile << " could not be read." << std::endl;
+		m_bIsCompiled = true;
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	bool bWasCached = !m_bIsPending;
+
+	if (m_bIsPending)
+	{
+		// Reading the results blocks until the driver is done with them.
+		PrintLog(m_uVertexID, m_sVertexShaderFile.c_str(), false);
+		PrintLog(m_uFragmentID, m_sFragmentShaderFile.c_str(), false);
+		bool bIsLinked = PrintLog(m_uProgramID, m_sFragmentShaderFile.c_str(), true);
+
+		GLCall(glDetachShader(m_uProgramID, m_uFragmentID));
+		GLCall(glDetachShader(m_uProgramID, m_uVertexID));
+		GLCall(glDeleteShader(m_uFragmentID));
+		GLCall(glDeleteShader(m_uVertexID));
+		m_uFragmentID = 0;
+		m_uVertexID = 0;
+
+		// Only programs that linked are worth keeping.
+		if (bIsLinked)
+		{
+			ShaderCache::GetInstance()->Store(m_sCacheKey, m_uProgramID);
+		}
+		m_bIsPending = false;
+	}
+
 	// The shader has finished compilation.
 	m_bIsCompiled = true;
 
-	// Returning the program ID.
-	return m_uProgramID;
+	// Only the time spent on this thread counts, not the time the driver worked in the background.
+	m_fSetupMS += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	ShaderCache::GetInstance()->AddSetupTime(m_fSetupMS, bWasCached);
+	std::cout << "Shader " << m_sVertexShaderFile << " + " << m_sFragmentShaderFile << ": "
+		<< (bWasCached ? "cached" : "compiled") << " in " << m_fSetupMS << " ms" << std::endl;
+}
+
+bool Shader::SupportsParallelCompile(void)
+{
+	// GLEW 2.1 predates the extension, so the extension strings are searched directly.
+	static int dIsSupported = -1;
+	if (dIsSupported == -1)
+	{
+		dIsSupported = 0;
+		GLint dCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &dCount);
+		for (int i = 0; i < dCount; i++)
+		{
+			const char* sName = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (sName == nullptr) continue;
+			if (strcmp(sName, "GL_KHR_parallel_shader_compile") == 0 ||
+				strcmp(sName, "GL_ARB_parallel_shader_compile") == 0)
+			{
+				dIsSupported = 1;
+				break;
+			}
+		}
+	}
+
+	return dIsSupported == 1;
+}
+
+void Shader::AddDefine(std::string a_sDefine)
+{
+	m_lDefines.push_back(a_sDefine);
 }
 
 // - - Accessors - -
@@ -86,9 +205,6 @@ bool Shader::IsCompiled() { return m_bIsCompiled; }
 // - - Private Methods - -
 GLuint Shader::LoadShaders(const char* a_sVertexShader, const char* a_sFragmentShader)
 {
-	// Creating the shaders.
-	GLuint uVertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-	GLuint uFragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
 	std::string sVertexCode, sFragmentCode;
 
 	// Getting a pointer to the FileReader singleton.
@@ -104,26 +220,138 @@ GLuint Shader::LoadShaders(const char* a_sVertexShader, const char* a_sFragmentS
 		return ERROR;
 	}
 
+	// Pasting in the shared files before the defines, so both the cache key and the features see them.
+	if (!ResolveIncludes(sVertexCode, a_sVertexShader) || !ResolveIncludes(sFragmentCode, a_sFragmentShader))
+	{
+		return ERROR;
+	}
+
+	// Adding the feature defines to both stages.
+	InsertDefines(sVertexCode);
+	InsertDefines(sFragmentCode);
+
+	// Restoring the program from the cache if this driver has seen these sources before.
+	ShaderCache* pCache = ShaderCache::GetInstance();
+	m_sCacheKey = pCache->MakeKey(sVertexCode, sFragmentCode);
+	GLuint uProgramID = pCache->Load(m_sCacheKey);
+	if (uProgramID != 0)
+	{
+		return uProgramID;
+	}
+
+	// Creating the shaders.
+	m_uVertexID = glCreateShader(GL_VERTEX_SHADER);
+	m_uFragmentID = glCreateShader(GL_FRAGMENT_SHADER);
+
 	// Compiling the vertex shader:
-	std::cout << "\n\tVertex: " << a_sVertexShader << ":\n" << sVertexCode << std::endl;
 	char const* sVertexSource = sVertexCode.c_str();
-	GLCall(glShaderSource(uVertexShaderID, 1, &sVertexSource, NULL));
-	GLCall(glCompileShader(uVertexShaderID));
+	GLCall(glShaderSource(m_uVertexID, 1, &sVertexSource, NULL));
+	GLCall(glCompileShader(m_uVertexID));
 
 	// Compiling the fragment shader:
-	std::cout << "\n\tFragment: " << a_sFragmentShader << ":\n" << sFragmentCode << std::endl;
 	char const* sFragmentSource = sFragmentCode.c_str();
-	GLCall(glShaderSource(uFragmentShaderID, 1, &sFragmentSource, NULL));
-	GLCall(glCompileShader(uFragmentShaderID));
+	GLCall(glShaderSource(m_uFragmentID, 1, &sFragmentSource, NULL));
+	GLCall(glCompileShader(m_uFragmentID));
 
-	// Linking the shaders to the program.
-	GLuint uProgramID = glCreateProgram();
-	GLCall(glAttachShader(uProgramID, uVertexShaderID));
-	GLCall(glAttachShader(uProgramID, uFragmentShaderID));
+	// Linking the shaders to the program.  Nothing is queried here, so the driver can keep working.
+	uProgramID = glCreateProgram();
+	GLCall(glAttachShader(uProgramID, m_uVertexID));
+	GLCall(glAttachShader(uProgramID, m_uFragmentID));
+	if (pCache->IsSupported())
+	{
+		GLCall(glProgramParameteri(uProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+	}
 	GLCall(glLinkProgram(uProgramID));
-
-	GLCall(glDeleteShader(uFragmentShaderID));
-	GLCall(glDeleteShader(uVertexShaderID));
+	m_bIsPending = true;
 
 	return uProgramID;
 }
+
+bool Shader::PrintLog(GLuint a_uObject, const char* a_sName, bool a_bIsProgram)
+{
+	GLint dStatus = GL_FALSE;
+	GLint dLength = 0;
+	if (a_bIsProgram)
+	{
+		GLCall(glGetProgramiv(a_uObject, GL_LINK_STATUS, &dStatus));
+		GLCall(glGetProgramiv(a_uObject, GL_INFO_LOG_LENGTH, &dLength));
+	}
+	else
+	{
+		GLCall(glGetShaderiv(a_uObject, GL_COMPILE_STATUS, &dStatus));
+		GLCall(glGetShaderiv(a_uObject, GL_INFO_LOG_LENGTH, &dLength));
+	}
+
+	if (dStatus != GL_TRUE && dLength > 1)
+	{
+		std::string sLog(dLength, '\0');
+		if (a_bIsProgram)
+		{
+			GLCall(glGetProgramInfoLog(a_uObject, dLength, nullptr, &sLog[0]));
+		}
+		else
+		{
+			GLCall(glGetShaderInfoLog(a_uObject, dLength, nullptr, &sLog[0]));
+		}
+		std::cout << (a_bIsProgram ? "Link" : "Compile") << " error in " << a_sName << ":\n" << sLog << std::endl;
+	}
+
+	return dStatus == GL_TRUE;
+}
+
+bool Shader::ResolveIncludes(std::string& a_sCode, const std::string& a_sShaderFile)
+{
+	size_t uSlash = a_sShaderFile.find_last_of("/\\");
+	std::string sFolder = uSlash == std::string::npos ? NULL_STR : a_sShaderFile.substr(0, uSlash + 1);
+
+	size_t uInclude = a_sCode.find("#include");
+	while (uInclude != std::string::npos)
+	{
+		size_t uLineEnd = a_sCode.find('\n', uInclude);
+		size_t uLength = (uLineEnd == std::string::npos ? a_sCode.size() : uLineEnd) - uInclude;
+		std::string sLine = a_sCode.substr(uInclude, uLength);
+
+		size_t uOpen = sLine.find('"');
+		size_t uClose = uOpen == std::string::npos ? std::string::npos : sLine.find('"', uOpen + 1);
+		if (uClose == std::string::npos)
+		{
+			std::cout << "Malformed " << sLine << " in " << a_sShaderFile << std::endl;
+			return false;
+		}
+
+		std::string sIncluded = FileReader::GetInstance()->ReadFile(sFolder + sLine.substr(uOpen + 1, uClose - uOpen - 1));
+		if (sIncluded == NULL_STR)
+		{
+			std::cout << "Could not include " << sLine << " in " << a_sShaderFile << std::endl;
+			return false;
+		}
+
+		a_sCode.replace(uInclude, uLength, sIncluded);
+		uInclude = a_sCode.find("#include", uInclude + sIncluded.size());
+	}
+
+	return true;
+}
+
+void Shader::InsertDefines(std::string& a_sCode)
+{
+	if (m_lDefines.empty()) return;
+
+	std::string sDefines = "";
+	for (int i = 0; i < m_lDefines.size(); i++)
+	{
+		sDefines += "#define " + m_lDefines[i] + "\n";
+	}
+
+	// #version has to stay the first statement, so the defines go on the line after it.
+	size_t uVersion = a_sCode.find("#version");
+	size_t uLineEnd = uVersion == std::string::npos ? std::string::npos : a_sCode.find('\n', uVersion);
+	if (uLineEnd == std::string::npos)
+	{
+		a_sCode = sDefines + a_sCode;
+	}
+	else
+	{
+		a_sCode.insert(uLineEnd + 1, sDefines);
+	}
+}
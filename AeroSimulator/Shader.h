@@ -2,8 +2,14 @@
 #define __SHADER_H_
 
 #include <string>
+#include <vector>
 #include <GL/glew.h>
 
+// KHR_parallel_shader_compile token.  GLEW 2.1 predates the extension.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 /// <summary>
 /// Holds data for a set of Vertex and Fragment shaders in the program.
 /// </summary>
@@ -14,6 +20,14 @@ private:
 	std::string m_sFragmentShaderFile = "";		// Equivalent to a pixel shader.
 	GLuint m_uProgramID = -1;
 	bool m_bIsCompiled = false;
+	std::vector<std::string> m_lDefines;		// Inserted after the #version line of both stages.
+
+	// State of a compile that was started but not finished.
+	bool m_bIsPending = false;
+	GLuint m_uVertexID = 0;
+	GLuint m_uFragmentID = 0;
+	std::string m_sCacheKey = "";
+	float m_fSetupMS = 0.0f;
 
 public:
 	/// <summary>
@@ -48,6 +62,37 @@ public:
 	/// <returns>The Program ID.</returns>
 	GLuint CompileShader(std::string a_sVertexShaderFile, std::string a_sFragmentShaderFile);
 
+	/// <summary>
+	/// Starts compiling the Shader without waiting for the driver.  Programs restored
+	/// from the ShaderCache are compiled immediately.
+	/// </summary>
+	/// <param name="a_sVertexShaderFile">The file path to the vertex shader.</param>
+	/// <param name="a_sFragmentShaderFile">The file path to the fragmemt shader.</param>
+	void BeginCompile(std::string a_sVertexShaderFile, std::string a_sFragmentShaderFile);
+
+	/// <summary>
+	/// Gets whether FinishCompile can run without waiting.  Always true when the driver
+	/// lacks KHR_parallel_shader_compile, as there is no way to ask.
+	/// </summary>
+	bool IsCompileDone(void);
+
+	/// <summary>
+	/// Checks the results of BeginCompile and stores the program in the ShaderCache.
+	/// Waits for the driver if it is not done yet.
+	/// </summary>
+	void FinishCompile(void);
+
+	/// <summary>
+	/// Gets whether the driver compiles on its own threads and can report when it is done.
+	/// </summary>
+	static bool SupportsParallelCompile(void);
+
+	/// <summary>
+	/// Adds a #define to both stages.  Must be called before CompileShader.
+	/// </summary>
+	/// <param name="a_sDefine">The define, optionally followed by a value, e.g. "MAX_LIGHTS 4".</param>
+	void AddDefine(std::string a_sDefine);
+
 	/// <summary>
 	/// Vertex shader field accessor.
 	/// </summary>
@@ -73,13 +118,38 @@ public:
 
 private:
 	/// <summary>
-	/// Loads in the shaders from the files and compiles them into usable programs.
+	/// Loads in the shaders from the files and starts compiling them into a program.
+	/// Restores the program from the ShaderCache instead when the sources are unchanged.
 	/// </summary>
 	/// <param name="a_sVertexShader">Filepath to the vertex shader being used.</param>
 	/// <param name="a_sFragmentShader">Filepath to the fragment shader being used.</param>
 	/// <returns>The program ID of the shaders.</returns>
 	GLuint LoadShaders(const char* a_sVertexShader, const char* a_sFragmentShader);
 
+	/// <summary>
+	/// Replaces every #include "File.glsl" line with that file, read from the
+	/// folder of the shader including it.  Included files are not searched again.
+	/// </summary>
+	/// <param name="a_sCode">Shader source being altered.</param>
+	/// <param name="a_sShaderFile">Filepath of the shader the source was read from.</param>
+	/// <returns>False if an included file could not be read.</returns>
+	bool ResolveIncludes(std::string& a_sCode, const std::string& a_sShaderFile);
+
+	/// <summary>
+	/// Inserts the defines right after the #version line of the passed in source.
+	/// </summary>
+	/// <param name="a_sCode">Shader source being altered.</param>
+	void InsertDefines(std::string& a_sCode);
+
+	/// <summary>
+	/// Prints the info log of a shader or program that failed to compile or link.
+	/// </summary>
+	/// <param name="a_uObject">The shader or program.</param>
+	/// <param name="a_sName">Name printed with the log.</param>
+	/// <param name="a_bIsProgram">Whether the object is a program rather than a shader.</param>
+	/// <returns>Whether compiling or linking succeeded.</returns>
+	bool PrintLog(GLuint a_uObject, const char* a_sName, bool a_bIsProgram);
+
 };
 
 #endif //__SHADER_H_
@@ -0,0 +1,181 @@
+#include "ShaderCache.h"
+#include "Debug.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MAKE_DIRECTORY(p) _mkdir(p)
+#else
+#include <sys/stat.h>
+#define MAKE_DIRECTORY(p) mkdir(p, 0755)
+#endif
+
+// Tag at the start of every cache entry.
+#define SHADER_CACHE_MAGIC 0x43534541
+
+/// <summary>
+/// Header written in front of the program binary.
+/// </summary>
+struct CacheHeader
+{
+	unsigned int Magic;
+	GLenum Format;
+	GLint Length;
+};
+
+/// <summary>
+/// 64 bit FNV-1a hash, continued from a previous value.
+/// </summary>
+static unsigned long long HashString(const std::string& a_sText, unsigned long long a_uHash)
+{
+	for (int i = 0; i < a_sText.size(); i++)
+	{
+		a_uHash ^= (unsigned char)a_sText[i];
+		a_uHash *= 1099511628211ull;
+	}
+	return a_uHash;
+}
+
+ShaderCache* ShaderCache::m_pInstance = nullptr;
+
+ShaderCache::ShaderCache(void)
+{
+	// Some drivers expose the entry points but no binary formats at all.
+	GLint dFormats = 0;
+	if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+	{
+		GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &dFormats));
+	}
+	// Captures are replayed on other drivers, so they always compile from source.
+	m_bIsSupported = dFormats > 0 && !GLCapture::IsCapturing();
+
+	// A binary is only valid for the exact driver that produced it.
+	const char* sVendor = (const char*)glGetString(GL_VENDOR);
+	const char* sRenderer = (const char*)glGetString(GL_RENDERER);
+	const char* sVersion = (const char*)glGetString(GL_VERSION);
+	m_sDriver = std::string(sVendor ? sVendor : "") + "|" + (sRenderer ? sRenderer : "") + "|" + (sVersion ? sVersion : "");
+
+	if (m_bIsSupported)
+	{
+		MAKE_DIRECTORY(SHADER_CACHE_DIRECTORY);
+	}
+	else
+	{
+		std::cout << "Program binaries are not supported, shaders will always compile from source." << std::endl;
+	}
+}
+
+ShaderCache::~ShaderCache(void) {}
+
+ShaderCache* ShaderCache::GetInstance(void)
+{
+	// Instantiating the single instance of the ShaderCache.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new ShaderCache();
+	}
+
+	return m_pInstance;
+}
+
+void ShaderCache::ReleaseInstance(void)
+{
+	// If there is an instance of the ShaderCache:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		Realloc(m_pInstance);
+	}
+}
+
+std::string ShaderCache::MakeKey(const std::string& a_sVertexCode, const std::string& a_sFragmentCode)
+{
+	// Separating the parts so moving text between stages changes the key.
+	unsigned long long uHash = 14695981039346656037ull;
+	uHash = HashString(m_sDriver, uHash);
+	uHash = HashString("|vs|", uHash);
+	uHash = HashString(a_sVertexCode, uHash);
+	uHash = HashString("|fs|", uHash);
+	uHash = HashString(a_sFragmentCode, uHash);
+
+	char sKey[17];
+	snprintf(sKey, sizeof(sKey), "%016llx", uHash);
+	return std::string(sKey);
+}
+
+GLuint ShaderCache::Load(const std::string& a_sKey)
+{
+	if (!m_bIsSupported) return 0;
+
+	std::ifstream reader(GetPath(a_sKey), std::ios::in | std::ios::binary);
+	if (!reader.is_open()) return 0;
+
+	CacheHeader header = CacheHeader();
+	reader.read((char*)&header, sizeof(header));
+	if (!reader || header.Magic != SHADER_CACHE_MAGIC || header.Length <= 0) return 0;
+
+	std::vector<char> lBinary(header.Length);
+	reader.read(lBinary.data(), header.Length);
+	if (!reader) return 0;
+
+	// The driver may still refuse a binary, e.g. after an update that kept the version string.
+	GLuint uProgram = glCreateProgram();
+	GLCall(glProgramBinary(uProgram, header.Format, lBinary.data(), header.Length));
+	GLint dStatus = GL_FALSE;
+	GLCall(glGetProgramiv(uProgram, GL_LINK_STATUS, &dStatus));
+	if (dStatus != GL_TRUE)
+	{
+		GLCall(glDeleteProgram(uProgram));
+		return 0;
+	}
+
+	return uProgram;
+}
+
+void ShaderCache::Store(const std::string& a_sKey, GLuint a_uProgram)
+{
+	if (!m_bIsSupported) return;
+
+	CacheHeader header = CacheHeader();
+	header.Magic = SHADER_CACHE_MAGIC;
+	GLCall(glGetProgramiv(a_uProgram, GL_PROGRAM_BINARY_LENGTH, &header.Length));
+	if (header.Length <= 0) return;
+
+	std::vector<char> lBinary(header.Length);
+	GLCall(glGetProgramBinary(a_uProgram, header.Length, nullptr, &header.Format, lBinary.data()));
+
+	std::ofstream writer(GetPath(a_sKey), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		std::cout << "Could not write the shader cache entry " << a_sKey << std::endl;
+		return;
+	}
+	writer.write((const char*)&header, sizeof(header));
+	writer.write(lBinary.data(), header.Length);
+}
+
+bool ShaderCache::IsSupported(void) { return m_bIsSupported; }
+int ShaderCache::GetHits(void) { return m_dHits; }
+int ShaderCache::GetMisses(void) { return m_dMisses; }
+float ShaderCache::GetSetupTime(void) { return m_fSetupMS; }
+
+void ShaderCache::AddSetupTime(float a_fMilliseconds, bool a_bWasCached)
+{
+	m_fSetupMS += a_fMilliseconds;
+	if (a_bWasCached)
+	{
+		m_dHits++;
+	}
+	else
+	{
+		m_dMisses++;
+	}
+}
+
+std::string ShaderCache::GetPath(const std::string& a_sKey)
+{
+	return std::string(SHADER_CACHE_DIRECTORY) + "/" + a_sKey + ".bin";
+}
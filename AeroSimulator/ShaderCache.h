@@ -0,0 +1,107 @@
+#ifndef __SHADERCACHE_H_
+#define __SHADERCACHE_H_
+
+#include <string>
+#include <GL/glew.h>
+
+// Directory the program binaries are written to, relative to the working directory.
+#define SHADER_CACHE_DIRECTORY "shadercache"
+
+/// <summary>
+/// Stores linked programs with glGetProgramBinary and restores them with glProgramBinary.
+/// Entries are keyed by a hash of the sources and the driver, so editing a shader or
+/// updating the driver simply misses the cache.
+/// </summary>
+class ShaderCache
+{
+private:
+	static ShaderCache* m_pInstance;
+
+	bool m_bIsSupported = false;
+	std::string m_sDriver;		// Vendor, renderer and version strings of the context.
+
+	// Setup statistics since startup.
+	int m_dHits = 0;
+	int m_dMisses = 0;
+	float m_fSetupMS = 0.0f;
+
+public:
+	/// <summary>
+	/// Retrieves the instance of the ShaderCache.  Requires a current GL context.
+	/// </summary>
+	/// <returns>The single instance of the ShaderCache.</returns>
+	static ShaderCache* GetInstance(void);
+
+	/// <summary>
+	/// Removes the single instance of the ShaderCache from memory.
+	/// </summary>
+	static void ReleaseInstance(void);
+
+	/// <summary>
+	/// Builds the cache key of a program from its final sources.
+	/// </summary>
+	/// <param name="a_sVertexCode">Vertex source with every define inserted.</param>
+	/// <param name="a_sFragmentCode">Fragment source with every define inserted.</param>
+	/// <returns>Hexadecimal hash used as the file name.</returns>
+	std::string MakeKey(const std::string& a_sVertexCode, const std::string& a_sFragmentCode);
+
+	/// <summary>
+	/// Creates a program from a cached binary.
+	/// </summary>
+	/// <param name="a_sKey">Key from MakeKey.</param>
+	/// <returns>The linked program, or 0 if there is no entry or the driver rejected it.</returns>
+	GLuint Load(const std::string& a_sKey);
+
+	/// <summary>
+	/// Writes a linked program to the cache.  The program should have been linked
+	/// with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+	/// </summary>
+	/// <param name="a_sKey">Key from MakeKey.</param>
+	/// <param name="a_uProgram">The linked program.</param>
+	void Store(const std::string& a_sKey, GLuint a_uProgram);
+
+	/// <summary>
+	/// Gets whether the driver can save and restore program binaries.
+	/// </summary>
+	bool IsSupported(void);
+
+	/// <summary>
+	/// Adds a program's setup time to the statistics.
+	/// </summary>
+	/// <param name="a_fMilliseconds">Time spent reading, compiling or restoring the program.</param>
+	/// <param name="a_bWasCached">Whether the program came from the cache.</param>
+	void AddSetupTime(float a_fMilliseconds, bool a_bWasCached);
+
+	/// <summary>
+	/// Gets the number of programs restored from the cache.
+	/// </summary>
+	int GetHits(void);
+
+	/// <summary>
+	/// Gets the number of programs compiled from source.
+	/// </summary>
+	int GetMisses(void);
+
+	/// <summary>
+	/// Gets the total time spent setting up programs.
+	/// </summary>
+	float GetSetupTime(void);
+
+private:
+	/// <summary>
+	/// Checks for program binary support and reads the driver strings.
+	/// </summary>
+	ShaderCache(void);
+
+	/// <summary>
+	/// Destructs the ShaderCache.
+	/// </summary>
+	~ShaderCache(void);
+
+	/// <summary>
+	/// Gets the path of a cache entry.
+	/// </summary>
+	std::string GetPath(const std::string& a_sKey);
+};
+
+#endif //__SHADERCACHE_H_
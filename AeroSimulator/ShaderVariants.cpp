@@ -0,0 +1,145 @@
+#include "ShaderVariants.h"
+#include <algorithm>
+
+// Define turned on by each ShaderFeature bit, in bit order.
+static const char* FEATURE_DEFINES[SHADER_FEATURE_COUNT] =
+{
+	"FEATURE_NORMAL_MAP",
+	"FEATURE_ALPHA_TEST",
+	"FEATURE_FOG",
+	"FEATURE_DEBUG_VIEW"
+};
+
+ShaderVariants::ShaderVariants(std::string a_sVertexShaderFile, std::string a_sFragmentShaderFile)
+{
+	m_sVertexShaderFile = a_sVertexShaderFile;
+	m_sFragmentShaderFile = a_sFragmentShaderFile;
+}
+
+void ShaderVariants::AddDefine(std::string a_sDefine)
+{
+	m_lDefines.push_back(a_sDefine);
+}
+
+void ShaderVariants::SetReadyCallback(std::function<void(GLuint)> a_fOnReady)
+{
+	m_fOnReady = a_fOnReady;
+}
+
+void ShaderVariants::SetFallback(unsigned int a_uFeatures)
+{
+	// Requesting a known mask again would replace a Shader that may already be bound.
+	auto it = m_mVariants.find(a_uFeatures);
+	Variant& variant = it != m_mVariants.end() ? it->second : Request(a_uFeatures);
+	if (!variant.Program->IsCompiled())
+	{
+		auto pending = std::find(m_lPending.begin(), m_lPending.end(), a_uFeatures);
+		if (pending != m_lPending.end())
+		{
+			m_lPending.erase(pending);
+		}
+		Finish(variant);
+	}
+	m_pFallback = variant.Program;
+}
+
+std::shared_ptr<Shader> ShaderVariants::GetShader(unsigned int a_uFeatures)
+{
+	auto it = m_mVariants.find(a_uFeatures);
+	Variant& variant = it != m_mVariants.end() ? it->second : Request(a_uFeatures);
+	if (variant.Program->IsCompiled())
+	{
+		return variant.Program;
+	}
+
+	// Without a fallback the variant is finished right away rather than handing out nothing.
+	if (m_pFallback == nullptr)
+	{
+		SetFallback(a_uFeatures);
+	}
+	return m_pFallback;
+}
+
+bool ShaderVariants::IsReady(unsigned int a_uFeatures)
+{
+	auto it = m_mVariants.find(a_uFeatures);
+	return it != m_mVariants.end() && it->second.Program->IsCompiled();
+}
+
+void ShaderVariants::Update(void)
+{
+	if (m_lPending.empty()) return;
+
+	// The driver reports progress, so every finished variant can be picked up.
+	if (Shader::SupportsParallelCompile())
+	{
+		for (int i = 0; i < m_lPending.size();)
+		{
+			Variant& variant = m_mVariants[m_lPending[i]];
+			if (variant.Program->IsCompileDone())
+			{
+				Finish(variant);
+				m_lPending.erase(m_lPending.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+		return;
+	}
+
+	// Otherwise the oldest variant gets a few frames of driver threading, then finishes alone
+	// so that at most one compile can land on a frame.
+	for (int i = 0; i < m_lPending.size(); i++)
+	{
+		m_mVariants[m_lPending[i]].Frames++;
+	}
+	Variant& oldest = m_mVariants[m_lPending.front()];
+	if (oldest.Frames >= SHADER_VARIANT_DELAY)
+	{
+		Finish(oldest);
+		m_lPending.erase(m_lPending.begin());
+	}
+}
+
+int ShaderVariants::GetVariantCount(void) { return (int)m_mVariants.size(); }
+int ShaderVariants::GetPendingCount(void) { return (int)m_lPending.size(); }
+
+ShaderVariants::Variant& ShaderVariants::Request(unsigned int a_uFeatures)
+{
+	Variant& variant = m_mVariants[a_uFeatures];
+	variant.Program = std::make_shared<Shader>();
+	variant.Frames = 0;
+
+	for (int i = 0; i < m_lDefines.size(); i++)
+	{
+		variant.Program->AddDefine(m_lDefines[i]);
+	}
+	for (int i = 0; i < SHADER_FEATURE_COUNT; i++)
+	{
+		if (a_uFeatures & (1u << i))
+		{
+			variant.Program->AddDefine(FEATURE_DEFINES[i]);
+		}
+	}
+
+	variant.Program->BeginCompile(m_sVertexShaderFile, m_sFragmentShaderFile);
+	if (variant.Program->IsCompiled())
+	{
+		// Restored from the ShaderCache.
+		if (m_fOnReady) m_fOnReady(variant.Program->GetProgramID());
+	}
+	else
+	{
+		m_lPending.push_back(a_uFeatures);
+	}
+
+	return variant;
+}
+
+void ShaderVariants::Finish(Variant& a_variant)
+{
+	a_variant.Program->FinishCompile();
+	if (m_fOnReady) m_fOnReady(a_variant.Program->GetProgramID());
+}
@@ -0,0 +1,118 @@
+#ifndef __SHADERVARIANTS_H_
+#define __SHADERVARIANTS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include "Shader.h"
+
+// Number of feature bits a variant mask can hold.
+#define SHADER_FEATURE_COUNT 4
+
+// Frames a variant is given before it is finished when the driver cannot report progress.
+#define SHADER_VARIANT_DELAY 3
+
+/// <summary>
+/// Optional shader features.  Each one turns on a FEATURE_ define in both stages.
+/// </summary>
+enum ShaderFeature
+{
+	SHADER_NORMAL_MAP = 1 << 0,		// Perturbs the normal with the NormalMap texture.
+	SHADER_ALPHA_TEST = 1 << 1,		// Discards texels below AlphaCutoff.
+	SHADER_FOG = 1 << 2,			// Blends towards FogColor with view depth.
+	SHADER_DEBUG_VIEW = 1 << 3		// Replaces the shaded color with DebugColor for the debug views.
+};
+
+/// <summary>
+/// Compiles the permutations of one vertex and fragment pair on demand.  A requested
+/// variant is compiled in the background and the fallback variant is handed out
+/// until it is ready, so new permutations never stall a frame.
+/// </summary>
+class ShaderVariants
+{
+private:
+	/// <summary>
+	/// A permutation and how long it has been compiling.
+	/// </summary>
+	struct Variant
+	{
+		std::shared_ptr<Shader> Program;
+		int Frames;
+	};
+
+	std::string m_sVertexShaderFile = "";
+	std::string m_sFragmentShaderFile = "";
+	std::vector<std::string> m_lDefines;				// Shared by every variant.
+	std::unordered_map<unsigned int, Variant> m_mVariants;
+	std::vector<unsigned int> m_lPending;				// Masks still compiling, oldest first.
+	std::shared_ptr<Shader> m_pFallback = nullptr;
+	std::function<void(GLuint)> m_fOnReady;
+
+public:
+	/// <summary>
+	/// Constructs the ShaderVariants of a vertex and fragment pair.  Nothing is compiled yet.
+	/// </summary>
+	/// <param name="a_sVertexShaderFile">The file path to the vertex shader.</param>
+	/// <param name="a_sFragmentShaderFile">The file path to the fragment shader.</param>
+	ShaderVariants(std::string a_sVertexShaderFile, std::string a_sFragmentShaderFile);
+
+	/// <summary>
+	/// Adds a #define to every variant.  Must be called before any variant is compiled.
+	/// </summary>
+	void AddDefine(std::string a_sDefine);
+
+	/// <summary>
+	/// Sets a function called with the program of every variant once it is ready.
+	/// </summary>
+	void SetReadyCallback(std::function<void(GLuint)> a_fOnReady);
+
+	/// <summary>
+	/// Compiles a variant right away and draws it while others compile.
+	/// </summary>
+	/// <param name="a_uFeatures">Mask of ShaderFeature bits.</param>
+	void SetFallback(unsigned int a_uFeatures);
+
+	/// <summary>
+	/// Gets the Shader of a variant, starting its compile if it was never requested.
+	/// </summary>
+	/// <param name="a_uFeatures">Mask of ShaderFeature bits.</param>
+	/// <returns>The variant once it is ready, the fallback until then.  Without a fallback
+	/// the variant is finished right away and becomes the fallback.</returns>
+	std::shared_ptr<Shader> GetShader(unsigned int a_uFeatures);
+
+	/// <summary>
+	/// Gets whether a variant has finished compiling.
+	/// </summary>
+	bool IsReady(unsigned int a_uFeatures);
+
+	/// <summary>
+	/// Finishes the variants the driver is done with.  Called once a frame on the render thread.
+	/// </summary>
+	void Update(void);
+
+	/// <summary>
+	/// Gets the number of variants requested so far.
+	/// </summary>
+	int GetVariantCount(void);
+
+	/// <summary>
+	/// Gets the number of variants still compiling.
+	/// </summary>
+	int GetPendingCount(void);
+
+private:
+	/// <summary>
+	/// Creates the Shader of a variant and starts compiling it.
+	/// </summary>
+	Variant& Request(unsigned int a_uFeatures);
+
+	/// <summary>
+	/// Finishes a variant and hands its program to the ready callback.
+	/// </summary>
+	void Finish(Variant& a_variant);
+};
+
+#endif //__SHADERVARIANTS_H_
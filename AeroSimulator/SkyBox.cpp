@@ -1,10 +1,12 @@
 #include "SkyBox.h"
 
-#include <FreeImage/FreeImage.h>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Debug.h"
+#include "TextureStreamer.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
 
 SkyBox::SkyBox(std::shared_ptr<Mesh> a_pCube)
 {
@@ -12,6 +14,8 @@ SkyBox::SkyBox(std::shared_ptr<Mesh> a_pCube)
     m_pShader->CompileShader(
         "shaders/SkyVertex.glsl",
         "shaders/SkyFrag.glsl");
+    m_dProjectionLocation = glGetUniformLocation(m_pShader->GetProgramID(), "projection");
+    m_dViewLocation = glGetUniformLocation(m_pShader->GetProgramID(), "view");
     m_pCube = std::make_shared<Mesh>(Mesh("models/cube.graphics_obj"));
     m_pCube->CompileMesh();
 
@@ -29,6 +33,7 @@ SkyBox::SkyBox(std::shared_ptr<Mesh> a_pCube)
     glBindVertexArray(skyboxVAO);
     glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
+    MemoryTracker::AddBuffer(skyboxVBO, MEMORY_MESHES, sizeof(skyboxVertices));
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     // ------------------------------------------------------------------------------------------
@@ -38,62 +43,11 @@ SkyBox::SkyBox(std::shared_ptr<Mesh> a_pCube)
 
 void SkyBox::LoadCubeMap()
 {
-    // Generating texture IDs and binding the texture.
-    glGenTextures(1, &m_dCubeMap);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_dCubeMap);
-
-    // For each filepath to the faces of the cube map,
-    for (GLuint i = 0; i < m_lFaces.size(); i++)
-    {
-        // Load in the texture with FreeImage.
-        FIBITMAP* bitmap = FreeImage_Load(FreeImage_GetFileType(m_lFaces[i].c_str(), 0), m_lFaces[i].c_str());
-
-        // Checking if we found the image.
-        if (!bitmap) 
-        {
-            std::cout << "Failed to load image: " << m_lFaces[i] << std::endl;
-            continue;
-        }
-
-        // Flipping the images because FreeImage assumes to flip for some reason.
-        FreeImage_FlipVertical(bitmap);
-
-        // Saving the image as a 32bit image.
-        FIBITMAP* bitmap32 = FreeImage_ConvertTo32Bits(bitmap);
-
-        // Unloading the originally loaded image since we don't need it anymore.
-        FreeImage_Unload(bitmap);
-
-        // Pulling some data from the loaded image for OpenGL.
-        int width = FreeImage_GetWidth(bitmap32);
-        int height = FreeImage_GetHeight(bitmap32);
-        BYTE* data = FreeImage_GetBits(bitmap32);
-
-        // Generating the 2D texture.
-        glTexImage2D(
-            GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-            0, 
-            GL_RGBA,
-            width, 
-            height, 
-            0, 
-            GL_BGRA, 
-            GL_UNSIGNED_BYTE,
-            data);
-
-        // Unloading the 32bit image.
-        FreeImage_Unload(bitmap32);
-    }
-
-    // OpenGL black magic cube map texture loading.
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    // Streaming the faces in over the first frames instead of decoding them here.
+    m_dCubeMap = TextureStreamer::GetInstance()->RequestCubeMap(m_lFaces);
 }
 
-void SkyBox::Render(Camera* a_Camera)
+void SkyBox::Render(const glm::mat4& a_m4View, const glm::mat4& a_m4Projection)
 {
     // Altering the depth function so depth test passes when 
     // values are equal to the depth buffer's content.
@@ -101,23 +55,24 @@ void SkyBox::Render(Camera* a_Camera)
 
     // Assigning the program to use the skybox shaders.
     GLCall(glUseProgram(m_pShader->GetProgramID()));
+    RenderStats::Add(RS_PROGRAM_BINDS);
 
     // Removing the translation aspect of the view matrix.
-    glm::mat4 m4View = glm::mat4(glm::mat3(a_Camera->GetView()));
-
-    // Reading the uniforms from the shader and geting their IDs.
-    GLuint projection = glGetUniformLocation(m_pShader->GetProgramID(), "projection");
-    GLuint view = glGetUniformLocation(m_pShader->GetProgramID(), "view");
+    glm::mat4 m4View = glm::mat4(glm::mat3(a_m4View));
 
     // Sending the uniforms data from the camera.
-    GLCall(glUniformMatrix4fv(projection, 1, GL_FALSE, glm::value_ptr(a_Camera->GetProjection())));
-    GLCall(glUniformMatrix4fv(view, 1, GL_FALSE, glm::value_ptr(m4View)));
+    GLCall(glUniformMatrix4fv(m_dProjectionLocation, 1, GL_FALSE, glm::value_ptr(a_m4Projection)));
+    GLCall(glUniformMatrix4fv(m_dViewLocation, 1, GL_FALSE, glm::value_ptr(m4View)));
+    RenderStats::Add(RS_UNIFORM_UPLOADS, 2);
     
     // Binding the skybox VAO and rendering the cubemap with it.
     GLCall(glBindVertexArray(skyboxVAO));
     GLCall(glActiveTexture(GL_TEXTURE0));
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_dCubeMap);
     glDrawArrays(GL_TRIANGLES, 0, m_pCube->GetVertexCount());
+    RenderStats::Add(RS_VAO_BINDS);
+    RenderStats::Add(RS_TEXTURE_BINDS);
+    RenderStats::AddDraw(m_pCube->GetVertexCount());
 
     // Reseting values.
     glBindVertexArray(0);
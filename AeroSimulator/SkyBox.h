@@ -2,7 +2,9 @@
 #define __SKYBOX_H_
 
 #include <GL/glew.h>
+#ifdef _WIN32
 #include <GL/wglew.h>
+#endif
 #include <vector>
 #include <memory>
 
@@ -20,6 +22,8 @@ private:
 	std::shared_ptr<Shader> m_pShader = nullptr;
 	std::vector<std::string> m_lFaces;
 	GLuint m_dCubeMap;
+	GLint m_dProjectionLocation = -1;
+	GLint m_dViewLocation = -1;
 
 #pragma region Debug while figuring out Mesh class issues.
     float skyboxVertices[108] = {        
@@ -79,8 +83,9 @@ public:
 	/// <summary>
 	/// Renders the SkyBox to the game world.
 	/// </summary>
-	/// <param name="a_Camera">Active Camera being used for view and projection matrices.</param>
-	void Render(Camera* a_Camera);
+	/// <param name="a_m4View">View matrix of the frame's Camera.</param>
+	/// <param name="a_m4Projection">Projection matrix of the frame's Camera.</param>
+	void Render(const glm::mat4& a_m4View, const glm::mat4& a_m4Projection);
 
 private:
 	/// <summary>
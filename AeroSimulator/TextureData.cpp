@@ -0,0 +1,96 @@
+#include "TextureData.h"
+#include <cmath>
+#include <algorithm>
+
+// Resolution of the linear to gamma lookup table.
+#define LINEAR_TABLE_SIZE 4096
+
+/// <summary>
+/// Lookup tables between gamma encoded bytes and linear intensities.
+/// </summary>
+struct GammaTables
+{
+	float ToLinear[256];
+	unsigned char ToGamma[LINEAR_TABLE_SIZE];
+
+	GammaTables(void)
+	{
+		// Using the exact sRGB transfer functions.
+		for (int i = 0; i < 256; i++)
+		{
+			float c = i / 255.0f;
+			ToLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+		}
+		for (int i = 0; i < LINEAR_TABLE_SIZE; i++)
+		{
+			float l = i / (float)(LINEAR_TABLE_SIZE - 1);
+			float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+			ToGamma[i] = (unsigned char)(c * 255.0f + 0.5f);
+		}
+	}
+};
+
+size_t TextureData::GetByteSize(void) const
+{
+	size_t uBytes = 0;
+	for (int i = 0; i < Levels.size(); i++)
+	{
+		uBytes += Levels[i].Data.size();
+	}
+	return uBytes;
+}
+
+void TextureData::GenerateMipmaps(void)
+{
+	if (IsCompressed || Levels.empty()) return;
+
+	static const GammaTables tables = GammaTables();
+	Levels.resize(1);
+
+	while (Levels.back().Width > 1 || Levels.back().Height > 1)
+	{
+		const TextureLevel& source = Levels.back();
+		TextureLevel level = TextureLevel();
+		level.Width = std::max(1, source.Width / 2);
+		level.Height = std::max(1, source.Height / 2);
+		level.Data.resize(level.Width * level.Height * 4);
+
+		// 2x2 box filter.  Odd edges reuse their last texel.
+		for (int y = 0; y < level.Height; y++)
+		{
+			int y0 = std::min(y * 2, source.Height - 1);
+			int y1 = std::min(y * 2 + 1, source.Height - 1);
+			for (int x = 0; x < level.Width; x++)
+			{
+				int x0 = std::min(x * 2, source.Width - 1);
+				int x1 = std::min(x * 2 + 1, source.Width - 1);
+				const unsigned char* pTexels[4] =
+				{
+					&source.Data[(y0 * source.Width + x0) * 4],
+					&source.Data[(y0 * source.Width + x1) * 4],
+					&source.Data[(y1 * source.Width + x0) * 4],
+					&source.Data[(y1 * source.Width + x1) * 4]
+				};
+				unsigned char* pOut = &level.Data[(y * level.Width + x) * 4];
+
+				for (int c = 0; c < 4; c++)
+				{
+					// Alpha and non color data are already linear.
+					if (c == 3 || !IsSRGB)
+					{
+						int dSum = pTexels[0][c] + pTexels[1][c] + pTexels[2][c] + pTexels[3][c];
+						pOut[c] = (unsigned char)((dSum + 2) / 4);
+					}
+					else
+					{
+						float fSum = tables.ToLinear[pTexels[0][c]] + tables.ToLinear[pTexels[1][c]] +
+							tables.ToLinear[pTexels[2][c]] + tables.ToLinear[pTexels[3][c]];
+						pOut[c] = tables.ToGamma[(int)(fSum * 0.25f * (LINEAR_TABLE_SIZE - 1) + 0.5f)];
+					}
+				}
+			}
+		}
+
+		Levels.push_back(std::move(level));
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef __TEXTUREDATA_H_
+#define __TEXTUREDATA_H_
+
+#include <GL/glew.h>
+#include <vector>
+
+/// <summary>
+/// A single mip level of a decoded image.
+/// </summary>
+struct TextureLevel
+{
+	int Width;
+	int Height;
+	std::vector<unsigned char> Data;
+};
+
+/// <summary>
+/// A decoded image and its mip chain in CPU memory, ready to be uploaded.
+/// Decoding only touches this structure, so it is safe to do off of the render thread.
+/// </summary>
+struct TextureData
+{
+	GLenum InternalFormat = GL_RGBA8;	// Sized or compressed GL format.
+	GLenum PixelFormat = GL_BGRA;		// Layout of uncompressed data.  Unused when compressed.
+	GLenum PixelType = GL_UNSIGNED_BYTE;
+	bool IsCompressed = false;
+	bool IsSRGB = true;					// Whether the texels are gamma encoded color.
+	std::vector<TextureLevel> Levels;	// Largest level first.
+
+	/// <summary>
+	/// Gets the size in bytes of every level together.
+	/// </summary>
+	size_t GetByteSize(void) const;
+
+	/// <summary>
+	/// Builds the rest of the mip chain from the first level of uncompressed 8 bit RGBA data.
+	/// Color data is averaged in linear space so the smaller levels keep their brightness.
+	/// </summary>
+	void GenerateMipmaps(void);
+};
+
+#endif //__TEXTUREDATA_H_
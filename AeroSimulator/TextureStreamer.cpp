@@ -0,0 +1,437 @@
+#include "TextureStreamer.h"
+#include "CPUProfiler.h"
+#include "FileReader.h"
+#include "ThreadPool.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "Debug.h"
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
+// Smallest per frame budget, so a single row of any level always fits.
+#define STREAM_MIN_BUDGET (256 * 1024)
+
+TextureStreamer* TextureStreamer::m_pInstance = nullptr;
+
+TextureStreamer::TextureStreamer(void)
+{
+	m_dPendingDecodes = 0;
+	for (int i = 0; i < STREAM_PBO_COUNT; i++)
+	{
+		m_lPBOs[i] = 0;
+		m_lFences[i] = nullptr;
+	}
+}
+
+TextureStreamer::~TextureStreamer(void)
+{
+	// The decode jobs write into the requests, so they have to finish first.
+	while (m_dPendingDecodes > 0)
+	{
+		std::this_thread::yield();
+	}
+
+	// The textures belong to whoever requested them, only the staging data is freed.
+	for (int i = 0; i < m_lRequests.size(); i++)
+	{
+		ReleaseRequest(m_lRequests[i]);
+	}
+	m_lRequests.clear();
+
+	ReleaseBuffers();
+}
+
+TextureStreamer* TextureStreamer::GetInstance(void)
+{
+	// Instantiating the single instance of the TextureStreamer.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new TextureStreamer();
+	}
+
+	return m_pInstance;
+}
+
+void TextureStreamer::ReleaseInstance(void)
+{
+	// If there is an instance of the TextureStreamer:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		Realloc(m_pInstance);
+	}
+}
+
+GLuint TextureStreamer::RequestTexture(std::string a_sFilepath, bool a_bIsSRGB)
+{
+	return AddRequest(GL_TEXTURE_2D, std::vector<std::string>(1, a_sFilepath), a_bIsSRGB);
+}
+
+GLuint TextureStreamer::RequestCubeMap(const std::vector<std::string>& a_lFaces)
+{
+	return AddRequest(GL_TEXTURE_CUBE_MAP, a_lFaces, true);
+}
+
+GLuint TextureStreamer::AddRequest(GLenum a_eTarget, const std::vector<std::string>& a_lPaths, bool a_bIsSRGB)
+{
+	// The name exists right away.  Without storage it samples as black until allocated.
+	Request* pRequest = new Request();
+	GLCall(glGenTextures(1, &pRequest->Texture));
+	pRequest->Target = a_eTarget;
+	pRequest->Paths = a_lPaths;
+	pRequest->Faces.resize(a_lPaths.size());
+	pRequest->DecodedFaces = 0;
+	pRequest->HasFailed = false;
+	pRequest->StagedBytes = 0;
+	pRequest->StagedFaces = 0;
+	pRequest->IsAllocated = false;
+	m_lRequests.push_back(pRequest);
+
+	// Cube map faces are stored top row first, unlike regular textures.
+	bool bFlipVertical = a_eTarget == GL_TEXTURE_CUBE_MAP;
+
+	// Decoding every face on the workers.  Each job only touches its own face.
+	FileReader* pReader = FileReader::GetInstance();
+	for (int i = 0; i < a_lPaths.size(); i++)
+	{
+		m_dPendingDecodes++;
+		ThreadPool::GetInstance()->Submit([this, pReader, pRequest, i, a_bIsSRGB, bFlipVertical]()
+		{
+			if (!pReader->DecodeImage(pRequest->Paths[i], pRequest->Faces[i], a_bIsSRGB, bFlipVertical))
+			{
+				std::cout << "Failed to load image: " << pRequest->Paths[i] << std::endl;
+				pRequest->HasFailed = true;
+			}
+			else
+			{
+				size_t uBytes = pRequest->Faces[i].GetByteSize();
+				MemoryTracker::Add(MEMORY_CPU, MEMORY_STREAMING, uBytes);
+				pRequest->StagedBytes += uBytes;
+				pRequest->StagedFaces++;
+			}
+			pRequest->DecodedFaces++;
+			m_dPendingDecodes--;
+		});
+	}
+
+	return pRequest->Texture;
+}
+
+void TextureStreamer::Update(void)
+{
+	PROFILE_ZONE("TextureStreamer::Update");
+	m_uUploadedBytes = 0;
+	if (m_lRequests.empty()) return;
+
+	if (m_uPBOSize != m_uBudget)
+	{
+		CreateBuffers();
+	}
+
+	// Skipping this frame if the GPU is still reading the next pixel buffer.
+	GLsync& fence = m_lFences[m_dPBO];
+	if (fence != nullptr)
+	{
+		if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) return;
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_lPBOs[m_dPBO]));
+	unsigned char* pMapped = nullptr;
+	size_t uUsed = 0;
+	for (int i = 0; i < m_lRequests.size(); i++)
+	{
+		Request* pRequest = m_lRequests[i];
+		if (pRequest->DecodedFaces < (int)pRequest->Paths.size() || pRequest->HasFailed) continue;
+
+		if (!pRequest->IsAllocated && !Allocate(pRequest))
+		{
+			pRequest->HasFailed = true;
+			continue;
+		}
+
+		// Orphaning the previous contents so mapping never waits on the GPU.
+		if (pMapped == nullptr)
+		{
+			pMapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_uPBOSize,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+			if (pMapped == nullptr) break;
+		}
+
+		// Stopping at the first request that no longer fits.
+		if (!RecordUploads(pRequest, pMapped, uUsed)) break;
+	}
+
+	if (pMapped != nullptr)
+	{
+		// Only the written part has to reach the GPU, and only it is captured.
+		GLCall(glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, uUsed));
+		GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+		IssueUploads();
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_dPBO = (m_dPBO + 1) % STREAM_PBO_COUNT;
+		m_uUploadedBytes = uUsed;
+		RenderStats::Add(RS_BUFFER_BYTES, uUsed);
+	}
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+	// Dropping the staging data of finished and failed requests.
+	for (int i = (int)m_lRequests.size() - 1; i >= 0; i--)
+	{
+		Request* pRequest = m_lRequests[i];
+		bool bIsDecoded = pRequest->DecodedFaces == (int)pRequest->Paths.size();
+		if (bIsDecoded && (pRequest->HasFailed || (pRequest->IsAllocated && pRequest->Level < 0)))
+		{
+			if (pRequest->HasFailed)
+			{
+				m_lFailed.push_back(pRequest->Texture);
+			}
+			ReleaseRequest(pRequest);
+			m_lRequests.erase(m_lRequests.begin() + i);
+		}
+	}
+}
+
+void TextureStreamer::Flush(void)
+{
+	while (!m_lRequests.empty())
+	{
+		// Pushing the fences through so the next pixel buffer frees up.
+		GLCall(glFlush());
+		std::this_thread::yield();
+		Update();
+	}
+}
+
+void TextureStreamer::SetUploadBudget(size_t a_uBytes) { m_uBudget = std::max((size_t)STREAM_MIN_BUDGET, a_uBytes); }
+size_t TextureStreamer::GetUploadBudget(void) { return m_uBudget; }
+size_t TextureStreamer::GetUploadedBytes(void) { return m_uUploadedBytes; }
+int TextureStreamer::GetPendingCount(void) { return (int)m_lRequests.size(); }
+
+bool TextureStreamer::IsResident(GLuint a_uTexture)
+{
+	for (int i = 0; i < m_lRequests.size(); i++)
+	{
+		if (m_lRequests[i]->Texture == a_uTexture) return false;
+	}
+	return !IsFailed(a_uTexture);
+}
+
+bool TextureStreamer::IsFailed(GLuint a_uTexture)
+{
+	return std::find(m_lFailed.begin(), m_lFailed.end(), a_uTexture) != m_lFailed.end();
+}
+
+void TextureStreamer::ReleaseRequest(Request* a_pRequest)
+{
+	if (a_pRequest->StagedFaces > 0)
+	{
+		MemoryTracker::Remove(MEMORY_CPU, MEMORY_STREAMING, a_pRequest->StagedBytes, a_pRequest->StagedFaces);
+	}
+	Realloc(a_pRequest);
+}
+
+bool TextureStreamer::Allocate(Request* a_pRequest)
+{
+	// Every face has to share the size, format and mip count of the first.
+	const TextureData& first = a_pRequest->Faces[0];
+	if (first.Levels.empty()) return false;
+	for (int i = 1; i < a_pRequest->Faces.size(); i++)
+	{
+		const TextureData& face = a_pRequest->Faces[i];
+		if (face.Levels.size() != first.Levels.size() || face.InternalFormat != first.InternalFormat ||
+			face.Levels[0].Width != first.Levels[0].Width || face.Levels[0].Height != first.Levels[0].Height)
+		{
+			std::cout << "Mismatched faces in " << a_pRequest->Paths[i] << std::endl;
+			return false;
+		}
+	}
+
+	FileReader* pReader = FileReader::GetInstance();
+	if (first.IsCompressed && !pReader->IsFormatSupported(first.InternalFormat))
+	{
+		std::cout << "Unsupported compressed texture format in " << a_pRequest->Paths[0] << std::endl;
+		return false;
+	}
+
+	// Allocating every level up front, the contents arrive over the next frames.
+	int dLevels = (int)first.Levels.size();
+	GLCall(glBindTexture(a_pRequest->Target, a_pRequest->Texture));
+	if (glTexStorage2D != nullptr)
+	{
+		GLCall(glTexStorage2D(a_pRequest->Target, dLevels, first.InternalFormat, first.Levels[0].Width, first.Levels[0].Height));
+	}
+	else
+	{
+		for (int f = 0; f < a_pRequest->Faces.size(); f++)
+		{
+			GLenum eTarget = a_pRequest->Target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + f : GL_TEXTURE_2D;
+			for (int i = 0; i < dLevels; i++)
+			{
+				const TextureLevel& level = first.Levels[i];
+				if (first.IsCompressed)
+				{
+					GLCall(glCompressedTexImage2D(eTarget, i, first.InternalFormat, level.Width, level.Height, 0, (GLsizei)level.Data.size(), nullptr));
+				}
+				else
+				{
+					GLCall(glTexImage2D(eTarget, i, first.InternalFormat, level.Width, level.Height, 0, first.PixelFormat, first.PixelType, nullptr));
+				}
+			}
+		}
+	}
+
+	pReader->ApplySampling(a_pRequest->Target, dLevels);
+
+	// The decoded levels are exactly what the GPU stores.
+	size_t uBytes = 0;
+	for (int f = 0; f < a_pRequest->Faces.size(); f++)
+	{
+		uBytes += a_pRequest->Faces[f].GetByteSize();
+	}
+	MemoryTracker::AddTexture(a_pRequest->Texture, MEMORY_TEXTURES, uBytes);
+	if (a_pRequest->Target == GL_TEXTURE_CUBE_MAP)
+	{
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+		GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+	}
+
+	// Only sampling the levels that have arrived, starting with the smallest.
+	GLCall(glTexParameteri(a_pRequest->Target, GL_TEXTURE_BASE_LEVEL, dLevels - 1));
+
+	a_pRequest->IsAllocated = true;
+	a_pRequest->Level = dLevels - 1;
+	a_pRequest->Face = 0;
+	a_pRequest->Row = 0;
+	return true;
+}
+
+bool TextureStreamer::RecordUploads(Request* a_pRequest, unsigned char* a_pMapped, size_t& a_uUsed)
+{
+	while (a_pRequest->Level >= 0)
+	{
+		const TextureData& face = a_pRequest->Faces[a_pRequest->Face];
+		const TextureLevel& level = face.Levels[a_pRequest->Level];
+
+		// Compressed data can only be split on whole rows of 4x4 blocks.
+		int dUnitRows = face.IsCompressed ? 4 : 1;
+		int dUnits = (level.Height + dUnitRows - 1) / dUnitRows;
+		size_t uUnitBytes = level.Data.size() / dUnits;
+		int dDoneUnits = a_pRequest->Row / dUnitRows;
+
+		size_t uStart = (a_uUsed + STREAM_UPLOAD_ALIGNMENT - 1) / STREAM_UPLOAD_ALIGNMENT * STREAM_UPLOAD_ALIGNMENT;
+		int dFitUnits = uStart < m_uPBOSize ? (int)((m_uPBOSize - uStart) / uUnitBytes) : 0;
+		if (dFitUnits == 0)
+		{
+			if (uStart == 0)
+			{
+				std::cout << "Texture rows larger than the upload budget: " << a_pRequest->Paths[0] << std::endl;
+				a_pRequest->HasFailed = true;
+				return true;
+			}
+			return false;
+		}
+
+		int dCount = std::min(dFitUnits, dUnits - dDoneUnits);
+		Upload upload = Upload();
+		upload.Owner = a_pRequest;
+		upload.Face = a_pRequest->Face;
+		upload.Level = a_pRequest->Level;
+		upload.Row = a_pRequest->Row;
+		upload.Rows = std::min(dCount * dUnitRows, level.Height - a_pRequest->Row);
+		upload.Offset = uStart;
+		upload.Size = dCount * uUnitBytes;
+		memcpy(a_pMapped + uStart, level.Data.data() + dDoneUnits * uUnitBytes, upload.Size);
+		a_uUsed = uStart + upload.Size;
+
+		// Moving on to the next face, and once every face is done, the next larger level.
+		a_pRequest->Row += upload.Rows;
+		if (a_pRequest->Row >= level.Height)
+		{
+			a_pRequest->Row = 0;
+			a_pRequest->Face++;
+			if (a_pRequest->Face == (int)a_pRequest->Faces.size())
+			{
+				a_pRequest->Face = 0;
+				a_pRequest->Level--;
+				upload.CompletesLevel = true;
+			}
+		}
+		m_lUploads.push_back(upload);
+	}
+
+	return true;
+}
+
+void TextureStreamer::IssueUploads(void)
+{
+	for (int i = 0; i < m_lUploads.size(); i++)
+	{
+		const Upload& upload = m_lUploads[i];
+		const TextureData& face = upload.Owner->Faces[upload.Face];
+		const TextureLevel& level = face.Levels[upload.Level];
+		GLenum eTarget = upload.Owner->Target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + upload.Face : GL_TEXTURE_2D;
+
+		// The data pointer is an offset into the bound pixel buffer.
+		GLCall(glBindTexture(upload.Owner->Target, upload.Owner->Texture));
+		if (face.IsCompressed)
+		{
+			GLCall(glCompressedTexSubImage2D(eTarget, upload.Level, 0, upload.Row, level.Width, upload.Rows,
+				face.InternalFormat, (GLsizei)upload.Size, (const void*)upload.Offset));
+		}
+		else
+		{
+			GLCall(glTexSubImage2D(eTarget, upload.Level, 0, upload.Row, level.Width, upload.Rows,
+				face.PixelFormat, face.PixelType, (const void*)upload.Offset));
+		}
+
+		// Letting the sampler see the level now that every face of it is queued.
+		if (upload.CompletesLevel)
+		{
+			GLCall(glTexParameteri(upload.Owner->Target, GL_TEXTURE_BASE_LEVEL, upload.Level));
+		}
+	}
+	m_lUploads.clear();
+}
+
+void TextureStreamer::CreateBuffers(void)
+{
+	ReleaseBuffers();
+
+	m_uPBOSize = m_uBudget;
+	GLCall(glGenBuffers(STREAM_PBO_COUNT, m_lPBOs));
+	for (int i = 0; i < STREAM_PBO_COUNT; i++)
+	{
+		GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_lPBOs[i]));
+		GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, m_uPBOSize, nullptr, GL_STREAM_DRAW));
+		MemoryTracker::AddBuffer(m_lPBOs[i], MEMORY_STREAMING, m_uPBOSize);
+	}
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+}
+
+void TextureStreamer::ReleaseBuffers(void)
+{
+	for (int i = 0; i < STREAM_PBO_COUNT; i++)
+	{
+		if (m_lFences[i] != nullptr)
+		{
+			glDeleteSync(m_lFences[i]);
+			m_lFences[i] = nullptr;
+		}
+	}
+	if (m_lPBOs[0] != 0)
+	{
+		glDeleteBuffers(STREAM_PBO_COUNT, m_lPBOs);
+		for (int i = 0; i < STREAM_PBO_COUNT; i++)
+		{
+			MemoryTracker::RemoveBuffer(m_lPBOs[i]);
+			m_lPBOs[i] = 0;
+		}
+	}
+	m_uPBOSize = 0;
+}
@@ -0,0 +1,197 @@
+#ifndef __TEXTURESTREAMER_H_
+#define __TEXTURESTREAMER_H_
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "TextureData.h"
+
+// Bytes of texel data uploaded per frame by default.
+#define STREAM_UPLOAD_BUDGET (4 * 1024 * 1024)
+
+// Number of pixel buffer objects cycled through so the CPU never writes one the GPU is reading.
+#define STREAM_PBO_COUNT 3
+
+// Alignment of every upload inside a pixel buffer object.
+#define STREAM_UPLOAD_ALIGNMENT 16
+
+/// <summary>
+/// Loads textures without stalling the render thread.  Files are decoded on the
+/// ThreadPool, then copied through pixel buffer objects under a per frame byte
+/// budget, smallest mip first, so a blurry version is available almost immediately.
+/// </summary>
+class TextureStreamer
+{
+private:
+	/// <summary>
+	/// A texture being decoded or uploaded.
+	/// </summary>
+	struct Request
+	{
+		GLuint Texture;
+		GLenum Target;					// GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+		std::vector<std::string> Paths;	// One per face.
+		std::vector<TextureData> Faces;
+		std::atomic<int> DecodedFaces;
+		std::atomic<bool> HasFailed;
+		std::atomic<size_t> StagedBytes;	// Decoded bytes accounted to MEMORY_STREAMING.
+		std::atomic<int> StagedFaces;
+		bool IsAllocated;
+		int Level;						// Level being uploaded, counting down to 0.
+		int Face;
+		int Row;
+	};
+
+	/// <summary>
+	/// A copy recorded into the mapped pixel buffer, issued once it is unmapped.
+	/// </summary>
+	struct Upload
+	{
+		Request* Owner;
+		int Face;
+		int Level;
+		int Row;
+		int Rows;
+		size_t Offset;
+		size_t Size;
+		bool CompletesLevel;
+	};
+
+	static TextureStreamer* m_pInstance;
+
+	std::vector<Request*> m_lRequests;
+	std::vector<GLuint> m_lFailed;		// Textures whose request was dropped before they became complete.
+	std::vector<Upload> m_lUploads;
+	std::atomic<int> m_dPendingDecodes;
+
+	GLuint m_lPBOs[STREAM_PBO_COUNT];
+	GLsync m_lFences[STREAM_PBO_COUNT];
+	size_t m_uPBOSize = 0;
+	int m_dPBO = 0;
+
+	size_t m_uBudget = STREAM_UPLOAD_BUDGET;
+	size_t m_uUploadedBytes = 0;
+
+public:
+	/// <summary>
+	/// Retrieves the instance of the TextureStreamer.
+	/// </summary>
+	/// <returns>The single instance of the TextureStreamer.</returns>
+	static TextureStreamer* GetInstance(void);
+
+	/// <summary>
+	/// Removes the single instance of the TextureStreamer from memory.
+	/// Must be called while the GL context is alive and before the ThreadPool is released.
+	/// </summary>
+	static void ReleaseInstance(void);
+
+	/// <summary>
+	/// Starts streaming a 2D texture.  The returned ID samples as black until its first levels arrive.
+	/// </summary>
+	/// <param name="a_sFilepath">Filepath to the texture.</param>
+	/// <param name="a_bIsSRGB">Whether the texture holds color rather than data like normals.</param>
+	/// <returns>The GLuint ID the texture will be streamed into.</returns>
+	GLuint RequestTexture(std::string a_sFilepath, bool a_bIsSRGB = true);
+
+	/// <summary>
+	/// Starts streaming a cube map.  The returned ID samples as black until its first levels arrive.
+	/// </summary>
+	/// <param name="a_lFaces">Filepaths to the +X, -X, +Y, -Y, +Z and -Z faces.</param>
+	/// <returns>The GLuint ID the cube map will be streamed into.</returns>
+	GLuint RequestCubeMap(const std::vector<std::string>& a_lFaces);
+
+	/// <summary>
+	/// Allocates the decoded textures and uploads as much as the budget allows.
+	/// Called once a frame on the render thread.
+	/// </summary>
+	void Update(void);
+
+	/// <summary>
+	/// Blocks until every request is fully resident.
+	/// </summary>
+	void Flush(void);
+
+	/// <summary>
+	/// Sets how many bytes may be uploaded per frame.
+	/// </summary>
+	void SetUploadBudget(size_t a_uBytes);
+
+	/// <summary>
+	/// Gets how many bytes may be uploaded per frame.
+	/// </summary>
+	size_t GetUploadBudget(void);
+
+	/// <summary>
+	/// Gets the bytes uploaded by the last Update.
+	/// </summary>
+	size_t GetUploadedBytes(void);
+
+	/// <summary>
+	/// Gets the number of textures not yet fully resident.
+	/// </summary>
+	int GetPendingCount(void);
+
+	/// <summary>
+	/// Gets whether every level of a texture has been uploaded.  Textures the
+	/// streamer never saw count as resident, failed ones never do.
+	/// </summary>
+	bool IsResident(GLuint a_uTexture);
+
+	/// <summary>
+	/// Gets whether a texture's request failed, leaving it without storage or with
+	/// only some levels.  Such a texture must not be sampled or copied.
+	/// </summary>
+	bool IsFailed(GLuint a_uTexture);
+
+private:
+	/// <summary>
+	/// Constructs the TextureStreamer.
+	/// </summary>
+	TextureStreamer(void);
+
+	/// <summary>
+	/// Waits for outstanding decodes and frees the pixel buffers.
+	/// </summary>
+	~TextureStreamer(void);
+
+	/// <summary>
+	/// Creates a request and queues its faces for decoding.
+	/// </summary>
+	GLuint AddRequest(GLenum a_eTarget, const std::vector<std::string>& a_lPaths, bool a_bIsSRGB);
+
+	/// <summary>
+	/// Frees a request's staging data.
+	/// </summary>
+	void ReleaseRequest(Request* a_pRequest);
+
+	/// <summary>
+	/// Allocates the immutable storage of a fully decoded request.
+	/// </summary>
+	/// <returns>False if the faces cannot form a texture.</returns>
+	bool Allocate(Request* a_pRequest);
+
+	/// <summary>
+	/// Copies as many rows of a request as fit into the mapped pixel buffer.
+	/// </summary>
+	/// <returns>True once every level of the request has been recorded.</returns>
+	bool RecordUploads(Request* a_pRequest, unsigned char* a_pMapped, size_t& a_uUsed);
+
+	/// <summary>
+	/// Issues the recorded copies out of the unmapped pixel buffer.
+	/// </summary>
+	void IssueUploads(void);
+
+	/// <summary>
+	/// (Re)creates the pixel buffers to match the budget.
+	/// </summary>
+	void CreateBuffers(void);
+
+	/// <summary>
+	/// Frees the pixel buffers and their fences.
+	/// </summary>
+	void ReleaseBuffers(void);
+};
+
+#endif //__TEXTURESTREAMER_H_
@@ -0,0 +1,293 @@
+#include "TextureTable.h"
+#include "TextureStreamer.h"
+#include "FileReader.h"
+#include "Debug.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include <iostream>
+#include <string>
+
+TextureTable* TextureTable::m_pInstance = nullptr;
+
+TextureTable::TextureTable(void)
+{
+	// Preferring bindless, then arrays, then plain binds.
+	bool bHasStorageBuffers = GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object;
+	// Bindless handles end up in buffer contents, where a replay cannot remap them.
+	if (GLEW_ARB_bindless_texture && bHasStorageBuffers && !GLCapture::IsCapturing())
+	{
+		m_eBackend = TEXTURES_BINDLESS;
+	}
+	else if (GLEW_VERSION_4_3)
+	{
+		m_eBackend = TEXTURES_ARRAY;
+	}
+	std::cout << "Texture backend: " << GetBackendName() << std::endl;
+
+	if (m_eBackend == TEXTURES_BOUND) return;
+
+	GLCall(glGenBuffers(1, &m_uBuffer));
+
+	// A mid grey texel standing in for textures that are still streaming.
+	unsigned char uGrey[4] = { 128, 128, 128, 255 };
+	GLuint uPlaceholder;
+	GLCall(glGenTextures(1, &uPlaceholder));
+	GLCall(glBindTexture(GL_TEXTURE_2D, uPlaceholder));
+	GLCall(glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1));
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, uGrey));
+	MemoryTracker::AddTexture(uPlaceholder, MEMORY_TEXTURES, sizeof(uGrey));
+	FileReader::GetInstance()->ApplySampling(GL_TEXTURE_2D, 1);
+	Register(uPlaceholder, true);
+	Update();
+}
+
+TextureTable::~TextureTable(void)
+{
+	for (int i = 0; i < m_lSlots.size(); i++)
+	{
+		if (m_eBackend == TEXTURES_BINDLESS && m_lSlots[i].IsReady)
+		{
+			glMakeTextureHandleNonResidentARB(m_lSlotData[i].Handle);
+		}
+		if (m_lSlots[i].OwnsTexture && m_lSlots[i].Texture != 0)
+		{
+			MemoryTracker::RemoveTexture(m_lSlots[i].Texture);
+			glDeleteTextures(1, &m_lSlots[i].Texture);
+		}
+	}
+	for (int i = 0; i < m_lArrays.size(); i++)
+	{
+		MemoryTracker::RemoveTexture(m_lArrays[i].ID);
+		glDeleteTextures(1, &m_lArrays[i].ID);
+	}
+	if (m_uBuffer != 0)
+	{
+		MemoryTracker::RemoveBuffer(m_uBuffer);
+		glDeleteBuffers(1, &m_uBuffer);
+	}
+}
+
+TextureTable* TextureTable::GetInstance(void)
+{
+	// Instantiating the single instance of the TextureTable.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new TextureTable();
+	}
+
+	return m_pInstance;
+}
+
+void TextureTable::ReleaseInstance(void)
+{
+	// If there is an instance of the TextureTable:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		Realloc(m_pInstance);
+	}
+}
+
+TextureBackend TextureTable::GetBackend(void) { return m_eBackend; }
+int TextureTable::GetSlotCount(void) { return (int)m_lSlots.size(); }
+int TextureTable::GetArrayCount(void) { return (int)m_lArrays.size(); }
+
+const char* TextureTable::GetBackendName(void)
+{
+	switch (m_eBackend)
+	{
+	case TEXTURES_BINDLESS: return "bindless";
+	case TEXTURES_ARRAY: return "texture arrays";
+	default: return "bound per draw";
+	}
+}
+
+int TextureTable::Register(GLuint a_uTexture, bool a_bTakeOwnership)
+{
+	// Sharing the slot of a texture that was already added.
+	for (int i = 0; i < m_lSlots.size(); i++)
+	{
+		if (m_lSlots[i].Texture == a_uTexture && a_uTexture != 0) return i;
+	}
+
+	Slot slot = Slot();
+	slot.Texture = a_uTexture;
+	slot.OwnsTexture = a_bTakeOwnership;
+	slot.IsReady = false;
+	slot.IsFailed = false;
+	m_lSlots.push_back(slot);
+
+	SlotData data = SlotData();
+	m_lSlotData.push_back(data);
+	m_dPendingSlots++;
+
+	return (int)m_lSlots.size() - 1;
+}
+
+bool TextureTable::IsReady(int a_dSlot) { return m_lSlots[a_dSlot].IsReady; }
+
+void TextureTable::Update(void)
+{
+	if (m_eBackend == TEXTURES_BOUND) return;
+
+	// Handles and array copies need the full mip chain, so streamed textures wait until resident.
+	if (m_dPendingSlots > 0)
+	{
+		TextureStreamer* pStreamer = TextureStreamer::GetInstance();
+		for (int i = 0; i < m_lSlots.size(); i++)
+		{
+			if (m_lSlots[i].IsReady || m_lSlots[i].IsFailed) continue;
+
+			// A texture without complete storage can get neither a handle nor an array layer.
+			if (pStreamer->IsFailed(m_lSlots[i].Texture))
+			{
+				std::cout << "Texture " << m_lSlots[i].Texture << " failed to stream in and will not be shown." << std::endl;
+				m_lSlots[i].IsFailed = true;
+				m_dPendingSlots--;
+				continue;
+			}
+			if (!pStreamer->IsResident(m_lSlots[i].Texture)) continue;
+
+			if (m_eBackend == TEXTURES_BINDLESS)
+			{
+				MakeBindless(i);
+			}
+			else
+			{
+				CopyToArray(i);
+			}
+			m_lSlots[i].IsReady = true;
+			m_dPendingSlots--;
+			m_bIsDirty = true;
+		}
+	}
+
+	// Re-uploading the whole table.  It only changes while textures load.
+	if (m_bIsDirty)
+	{
+		GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uBuffer));
+		GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, m_lSlotData.size() * sizeof(SlotData), m_lSlotData.data(), GL_STATIC_DRAW));
+		MemoryTracker::AddBuffer(m_uBuffer, MEMORY_TEXTURES, m_lSlotData.size() * sizeof(SlotData));
+		RenderStats::Add(RS_BUFFER_BYTES, m_lSlotData.size() * sizeof(SlotData));
+		GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+		m_bIsDirty = false;
+	}
+}
+
+void TextureTable::Bind(void)
+{
+	if (m_eBackend == TEXTURES_BOUND) return;
+
+	GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TEXTURE_TABLE_BINDING, m_uBuffer));
+	for (int i = 0; i < m_lArrays.size(); i++)
+	{
+		GLCall(glActiveTexture(GL_TEXTURE0 + TEXTURE_TABLE_FIRST_UNIT + i));
+		GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, m_lArrays[i].ID));
+	}
+	RenderStats::Add(RS_TEXTURE_BINDS, m_lArrays.size());
+	GLCall(glActiveTexture(GL_TEXTURE0));
+}
+
+void TextureTable::SetupProgram(GLuint a_uProgram)
+{
+	if (m_eBackend != TEXTURES_ARRAY) return;
+
+	GLint lUnits[TEXTURE_TABLE_MAX_ARRAYS];
+	for (int i = 0; i < TEXTURE_TABLE_MAX_ARRAYS; i++)
+	{
+		lUnits[i] = TEXTURE_TABLE_FIRST_UNIT + i;
+	}
+	GLCall(glUseProgram(a_uProgram));
+	GLCall(glUniform1iv(glGetUniformLocation(a_uProgram, "TextureArrays"), TEXTURE_TABLE_MAX_ARRAYS, lUnits));
+	GLCall(glUseProgram(0));
+}
+
+void TextureTable::MakeBindless(int a_dSlot)
+{
+	// The texture's state is frozen from here on, which is fine now that every level is in.
+	GLuint64 uHandle = glGetTextureHandleARB(m_lSlots[a_dSlot].Texture);
+	GLCall(glMakeTextureHandleResidentARB(uHandle));
+	m_lSlotData[a_dSlot].Handle = uHandle;
+}
+
+void TextureTable::CopyToArray(int a_dSlot)
+{
+	Slot& slot = m_lSlots[a_dSlot];
+
+	// Reading back the shape of the texture.  Only happens once per texture.
+	GLint dWidth = 0;
+	GLint dHeight = 0;
+	GLint dFormat = 0;
+	GLint dLevels = 0;
+	GLCall(glBindTexture(GL_TEXTURE_2D, slot.Texture));
+	GLCall(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &dWidth));
+	GLCall(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &dHeight));
+	GLCall(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &dFormat));
+	GLCall(glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_LEVELS, &dLevels));
+	dLevels = dLevels > 0 ? dLevels : 1;
+
+	// Finding an array with the same shape and a free layer.
+	int dArray = -1;
+	for (int i = 0; i < m_lArrays.size(); i++)
+	{
+		const TextureArray& array = m_lArrays[i];
+		if (array.Width == dWidth && array.Height == dHeight && array.Levels == dLevels &&
+			array.Format == (GLenum)dFormat && array.UsedLayers < TEXTURE_TABLE_LAYERS)
+		{
+			dArray = i;
+			break;
+		}
+	}
+
+	if (dArray == -1)
+	{
+		// Out of sampler slots, so the texture keeps showing the placeholder.
+		if (m_lArrays.size() == TEXTURE_TABLE_MAX_ARRAYS)
+		{
+			std::cout << "Out of texture arrays, texture " << slot.Texture << " will not be shown." << std::endl;
+			m_lSlotData[a_dSlot] = m_lSlotData[TEXTURE_TABLE_PLACEHOLDER];
+			return;
+		}
+
+		TextureArray array = TextureArray();
+		array.Width = dWidth;
+		array.Height = dHeight;
+		array.Levels = dLevels;
+		array.Format = (GLenum)dFormat;
+		GLCall(glGenTextures(1, &array.ID));
+		GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, array.ID));
+		GLCall(glTexStorage3D(GL_TEXTURE_2D_ARRAY, dLevels, array.Format, dWidth, dHeight, TEXTURE_TABLE_LAYERS));
+
+		// Every layer holds as much as the texture that caused the array.
+		MemoryTracker::AddTexture(array.ID, MEMORY_TEXTURES, MemoryTracker::GetTextureBytes(slot.Texture) * TEXTURE_TABLE_LAYERS);
+		FileReader::GetInstance()->ApplySampling(GL_TEXTURE_2D_ARRAY, dLevels);
+		GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+		dArray = (int)m_lArrays.size();
+		m_lArrays.push_back(array);
+	}
+
+	// Copying every level on the GPU.
+	TextureArray& array = m_lArrays[dArray];
+	int dLayer = array.UsedLayers++;
+	for (int i = 0; i < dLevels; i++)
+	{
+		int dLevelWidth = dWidth >> i > 0 ? dWidth >> i : 1;
+		int dLevelHeight = dHeight >> i > 0 ? dHeight >> i : 1;
+		GLCall(glCopyImageSubData(
+			slot.Texture, GL_TEXTURE_2D, i, 0, 0, 0,
+			array.ID, GL_TEXTURE_2D_ARRAY, i, 0, 0, dLayer,
+			dLevelWidth, dLevelHeight, 1));
+	}
+
+	m_lSlotData[a_dSlot].Array = dArray;
+	m_lSlotData[a_dSlot].Layer = dLayer;
+
+	// The array now holds the only copy that is sampled.
+	if (slot.OwnsTexture)
+	{
+		MemoryTracker::RemoveTexture(slot.Texture);
+		GLCall(glDeleteTextures(1, &slot.Texture));
+		slot.Texture = 0;
+	}
+}
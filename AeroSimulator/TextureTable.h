@@ -0,0 +1,167 @@
+#ifndef __TEXTURETABLE_H_
+#define __TEXTURETABLE_H_
+
+#include <GL/glew.h>
+#include <vector>
+
+// Shader storage binding of the slot table.  Must match TableFrag.glsl.
+#define TEXTURE_TABLE_BINDING 3
+
+// First texture unit used for the texture arrays, above the units materials bind to.
+#define TEXTURE_TABLE_FIRST_UNIT 8
+
+// Maximum number of texture arrays.  Must match TableFrag.glsl.
+#define TEXTURE_TABLE_MAX_ARRAYS 8
+
+// Layers allocated per texture array.
+#define TEXTURE_TABLE_LAYERS 16
+
+// Slot of the grey texture sampled while a texture is still streaming in.
+#define TEXTURE_TABLE_PLACEHOLDER 0
+
+/// <summary>
+/// How material textures reach the shaders.
+/// </summary>
+enum TextureBackend
+{
+	TEXTURES_BOUND = 0,		// Every draw binds its textures to units.  Always available.
+	TEXTURES_ARRAY,			// Same shaped textures share GL_TEXTURE_2D_ARRAY layers.  Needs GL 4.3.
+	TEXTURES_BINDLESS		// Resident 64 bit handles.  Needs ARB_bindless_texture.
+};
+
+/// <summary>
+/// Gives every material texture a slot in a shader storage buffer, so a draw only
+/// sets an integer instead of binding textures.  The slots either hold bindless
+/// handles or the array and layer the texture was copied into.
+/// </summary>
+class TextureTable
+{
+private:
+	/// <summary>
+	/// One slot as laid out in the std430 shader storage buffer.
+	/// </summary>
+	struct SlotData
+	{
+		GLuint64 Handle;
+		GLint Array;
+		GLint Layer;
+	};
+
+	/// <summary>
+	/// CPU side bookkeeping of a slot.
+	/// </summary>
+	struct Slot
+	{
+		GLuint Texture;
+		bool OwnsTexture;
+		bool IsReady;
+		bool IsFailed;		// Never streamed in, so it keeps the placeholder.
+	};
+
+	/// <summary>
+	/// A texture array holding textures of one size, format and mip count.
+	/// </summary>
+	struct TextureArray
+	{
+		GLuint ID;
+		int Width;
+		int Height;
+		int Levels;
+		GLenum Format;
+		int UsedLayers;
+	};
+
+	static TextureTable* m_pInstance;
+
+	TextureBackend m_eBackend = TEXTURES_BOUND;
+	std::vector<Slot> m_lSlots;
+	std::vector<SlotData> m_lSlotData;
+	std::vector<TextureArray> m_lArrays;
+	GLuint m_uBuffer = 0;
+	bool m_bIsDirty = false;
+	int m_dPendingSlots = 0;
+
+public:
+	/// <summary>
+	/// Retrieves the instance of the TextureTable.  Requires a current GL context.
+	/// </summary>
+	/// <returns>The single instance of the TextureTable.</returns>
+	static TextureTable* GetInstance(void);
+
+	/// <summary>
+	/// Removes the single instance of the TextureTable from memory.
+	/// </summary>
+	static void ReleaseInstance(void);
+
+	/// <summary>
+	/// Gets the backend picked for this driver.
+	/// </summary>
+	TextureBackend GetBackend(void);
+
+	/// <summary>
+	/// Gives a texture a slot.  It becomes ready once it is fully streamed in.
+	/// </summary>
+	/// <param name="a_uTexture">The texture being added.</param>
+	/// <param name="a_bTakeOwnership">Whether the table may delete the texture after copying it into an array.</param>
+	/// <returns>The slot index shaders use to sample the texture.</returns>
+	int Register(GLuint a_uTexture, bool a_bTakeOwnership);
+
+	/// <summary>
+	/// Gets whether a slot can be sampled yet.
+	/// </summary>
+	bool IsReady(int a_dSlot);
+
+	/// <summary>
+	/// Moves finished textures into the table.  Called once a frame on the render thread.
+	/// </summary>
+	void Update(void);
+
+	/// <summary>
+	/// Binds the slot table and texture arrays.  Called once before the draws that sample them.
+	/// </summary>
+	void Bind(void);
+
+	/// <summary>
+	/// Points the texture array samplers of a program at their units.
+	/// </summary>
+	/// <param name="a_uProgram">A program compiled from TableFrag.glsl.</param>
+	void SetupProgram(GLuint a_uProgram);
+
+	/// <summary>
+	/// Gets the number of slots in use.
+	/// </summary>
+	int GetSlotCount(void);
+
+	/// <summary>
+	/// Gets the number of texture arrays created.
+	/// </summary>
+	int GetArrayCount(void);
+
+	/// <summary>
+	/// Gets the name of the backend for display.
+	/// </summary>
+	const char* GetBackendName(void);
+
+private:
+	/// <summary>
+	/// Picks the backend and creates the placeholder slot.
+	/// </summary>
+	TextureTable(void);
+
+	/// <summary>
+	/// Releases the handles, arrays and buffer.
+	/// </summary>
+	~TextureTable(void);
+
+	/// <summary>
+	/// Makes a bindless handle resident for the slot.
+	/// </summary>
+	void MakeBindless(int a_dSlot);
+
+	/// <summary>
+	/// Copies the slot's texture into a layer of a matching array.
+	/// </summary>
+	void CopyToArray(int a_dSlot);
+};
+
+#endif //__TEXTURETABLE_H_
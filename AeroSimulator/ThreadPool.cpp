@@ -0,0 +1,207 @@
+#include "ThreadPool.h"
+#include "Debug.h"
+#include "CPUProfiler.h"
+#include <atomic>
+#include <algorithm>
+
+ThreadPool* ThreadPool::m_pInstance = nullptr;
+
+ThreadPool::ThreadPool(void)
+{
+	// Leaving one hardware thread for the caller.
+	unsigned int uThreads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	uThreads = std::max(1u, uThreads);
+
+	for (unsigned int i = 0; i < uThreads; i++)
+	{
+		m_lWorkers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool(void)
+{
+	// Waking every worker so they can see the stop flag.
+	{
+		std::lock_guard<std::mutex> lock(m_mJobLock);
+		m_bIsStopping = true;
+	}
+	m_cvJobReady.notify_all();
+
+	for (int i = 0; i < m_lWorkers.size(); i++)
+	{
+		m_lWorkers[i].join();
+	}
+
+	// Every ParallelFor has returned, so all of their states are free.
+	for (int i = 0; i < m_lFreeStates.size(); i++)
+	{
+		delete m_lFreeStates[i];
+	}
+}
+
+ThreadPool* ThreadPool::GetInstance(void)
+{
+	// Instantiating the single instance of the ThreadPool.
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new ThreadPool();
+	}
+
+	return m_pInstance;
+}
+
+void ThreadPool::ReleaseInstance(void)
+{
+	// If there is an instance of the ThreadPool:
+	if (m_pInstance != nullptr)
+	{
+		// Reallocate the memory.
+		Realloc(m_pInstance);
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> a_Job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mJobLock);
+		m_lJobs.push_back(std::move(a_Job));
+	}
+	m_cvJobReady.notify_one();
+}
+
+void ThreadPool::ParallelFor(unsigned int a_uCount, const std::function<void(unsigned int)>& a_Job)
+{
+	if (a_uCount == 0) return;
+
+	// Only waking as many helpers as there are spare indices.
+	unsigned int uHelpers = std::min(GetWorkerCount(), a_uCount - 1);
+	ParallelState* pState = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_mJobLock);
+		if (m_lFreeStates.empty())
+		{
+			pState = new ParallelState();
+		}
+		else
+		{
+			pState = m_lFreeStates.back();
+			m_lFreeStates.pop_back();
+		}
+		pState->Next = 0;
+		pState->Count = a_uCount;
+		pState->Job = &a_Job;
+		pState->ActiveHelpers = 0;
+		pState->IsClosed = false;
+		pState->References = 1 + (int)uHelpers;
+		for (unsigned int i = 0; i < uHelpers; i++)
+		{
+			m_lHelpers.push_back(pState);
+		}
+	}
+	if (uHelpers == 1)
+	{
+		m_cvJobReady.notify_one();
+	}
+	else if (uHelpers > 1)
+	{
+		m_cvJobReady.notify_all();
+	}
+
+	// The calling thread helps out instead of idling.
+	RunIndices(pState);
+
+	{
+		std::unique_lock<std::mutex> lock(pState->Lock);
+		pState->IsClosed = true;
+		pState->Finished.wait(lock, [pState]() { return pState->ActiveHelpers == 0; });
+	}
+	ReleaseState(pState);
+}
+
+void ThreadPool::RunIndices(ParallelState* a_pState)
+{
+	for (unsigned int i = a_pState->Next++; i < a_pState->Count; i = a_pState->Next++)
+	{
+		(*a_pState->Job)(i);
+	}
+}
+
+void ThreadPool::HelpParallelFor(ParallelState* a_pState)
+{
+	// Joining only while the caller is still waiting on the job.
+	bool bHasJoined = false;
+	{
+		std::lock_guard<std::mutex> lock(a_pState->Lock);
+		if (!a_pState->IsClosed)
+		{
+			a_pState->ActiveHelpers++;
+			bHasJoined = true;
+		}
+	}
+
+	if (bHasJoined)
+	{
+		RunIndices(a_pState);
+
+		// Notifying under the lock so the caller cannot miss it and return early.
+		std::lock_guard<std::mutex> lock(a_pState->Lock);
+		if (--a_pState->ActiveHelpers == 0)
+		{
+			a_pState->Finished.notify_one();
+		}
+	}
+	ReleaseState(a_pState);
+}
+
+void ThreadPool::ReleaseState(ParallelState* a_pState)
+{
+	std::lock_guard<std::mutex> lock(m_mJobLock);
+	if (--a_pState->References == 0)
+	{
+		m_lFreeStates.push_back(a_pState);
+	}
+}
+
+unsigned int ThreadPool::GetWorkerCount(void) { return (unsigned int)m_lWorkers.size(); }
+
+void ThreadPool::WorkerLoop(void)
+{
+	CPUProfiler::SetThreadName("Worker");
+
+	while (true)
+	{
+		std::function<void()> job;
+		ParallelState* pState = nullptr;
+
+		// Sleeping until there is a job or the pool is shutting down.  Helpers go first,
+		// since a thread is blocked on them.
+		{
+			std::unique_lock<std::mutex> lock(m_mJobLock);
+			m_cvJobReady.wait(lock, [this]() { return m_bIsStopping || !m_lJobs.empty() || !m_lHelpers.empty(); });
+
+			if (!m_lHelpers.empty())
+			{
+				pState = m_lHelpers.back();
+				m_lHelpers.pop_back();
+			}
+			else if (m_bIsStopping && m_lJobs.empty())
+			{
+				return;
+			}
+			else
+			{
+				job = std::move(m_lJobs.front());
+				m_lJobs.pop_front();
+			}
+		}
+
+		if (pState != nullptr)
+		{
+			HelpParallelFor(pState);
+		}
+		else
+		{
+			job();
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef __THREADPOOL_H_
+#define __THREADPOOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+/// <summary>
+/// Pool of persistent worker threads shared by the engine's parallel systems.
+/// </summary>
+class ThreadPool
+{
+private:
+	/// <summary>
+	/// Shared between a ParallelFor's caller and its helpers.  Helpers may only start
+	/// after long running jobs like texture decodes, so the caller closes the state once
+	/// it runs out of indices and only waits for the helpers that already joined.
+	/// </summary>
+	struct ParallelState
+	{
+		std::atomic<unsigned int> Next;
+		unsigned int Count;
+		const std::function<void(unsigned int)>* Job;
+		unsigned int ActiveHelpers;
+		bool IsClosed;
+		int References;		// The caller and every queued helper.  Guarded by m_mJobLock.
+		std::mutex Lock;
+		std::condition_variable Finished;
+	};
+
+	static ThreadPool* m_pInstance;
+
+	std::vector<std::thread> m_lWorkers;
+	std::deque<std::function<void()>> m_lJobs;
+	std::vector<ParallelState*> m_lHelpers;		// One entry per helper a ParallelFor asked for.
+	std::vector<ParallelState*> m_lFreeStates;	// Reused, so a warmed up ParallelFor never allocates.
+	std::mutex m_mJobLock;
+	std::condition_variable m_cvJobReady;
+	bool m_bIsStopping = false;
+
+public:
+	/// <summary>
+	/// Retrieves the instance of the ThreadPool.
+	/// </summary>
+	/// <returns>The single instance of the ThreadPool.</returns>
+	static ThreadPool* GetInstance(void);
+
+	/// <summary>
+	/// Joins the workers and removes the single instance of the ThreadPool from memory.
+	/// </summary>
+	static void ReleaseInstance(void);
+
+	/// <summary>
+	/// Queues a job to be ran on the next free worker.
+	/// </summary>
+	void Submit(std::function<void()> a_Job);
+
+	/// <summary>
+	/// Runs a_Job(index) for every index in [0, a_uCount) across the workers
+	/// and the calling thread.  Returns once every index has finished.  Does not
+	/// allocate once as many calls as overlap have run.
+	/// </summary>
+	/// <param name="a_uCount">Number of indices to process.</param>
+	/// <param name="a_Job">The work done for a single index.</param>
+	void ParallelFor(unsigned int a_uCount, const std::function<void(unsigned int)>& a_Job);
+
+	/// <summary>
+	/// Gets the number of worker threads, not counting the calling thread.
+	/// </summary>
+	unsigned int GetWorkerCount(void);
+
+private:
+	/// <summary>
+	/// Constructs the pool with one worker per hardware thread minus the main thread.
+	/// </summary>
+	ThreadPool(void);
+
+	/// <summary>
+	/// Stops and joins every worker.
+	/// </summary>
+	~ThreadPool(void);
+
+	/// <summary>
+	/// Loop ran by every worker thread.
+	/// </summary>
+	void WorkerLoop(void);
+
+	/// <summary>
+	/// Runs indices of a ParallelFor until there are none left.
+	/// </summary>
+	void RunIndices(ParallelState* a_pState);
+
+	/// <summary>
+	/// Joins a ParallelFor as a helper, unless its caller already finished every index.
+	/// </summary>
+	void HelpParallelFor(ParallelState* a_pState);
+
+	/// <summary>
+	/// Drops one reference to a ParallelFor's state, putting it back on the free list after the last.
+	/// </summary>
+	void ReleaseState(ParallelState* a_pState);
+};
+
+#endif //__THREADPOOL_H_
@@ -7,26 +7,39 @@
 Transform::Transform()
 {
 	m_bIsDirty = false;
+	m_uVersion = 0;
 	m_v3Position = VECTOR3_ZERO;
 	m_v3Rotation = VECTOR3_ZERO;
 	m_v3Scale = glm::vec3(1.0f);
 	m_m4World = IDENTITY_M4;
+	m_m4InverseTranspose = IDENTITY_M4;
+	SavePrevious();
 }
 Transform::Transform(Transform const& a_pOther)
 {
 	m_bIsDirty = a_pOther.m_bIsDirty;
+	m_uVersion = a_pOther.m_uVersion;
 	m_v3Position = a_pOther.m_v3Position;
 	m_v3Rotation = a_pOther.m_v3Rotation;
 	m_v3Scale = a_pOther.m_v3Scale;
 	m_m4World = a_pOther.m_m4World;
+	m_m4InverseTranspose = a_pOther.m_m4InverseTranspose;
+	m_v3PreviousPosition = a_pOther.m_v3PreviousPosition;
+	m_v3PreviousRotation = a_pOther.m_v3PreviousRotation;
+	m_v3PreviousScale = a_pOther.m_v3PreviousScale;
 }
 Transform& Transform::operator=(Transform const& a_pOther)
 {
 	m_bIsDirty = a_pOther.m_bIsDirty;
+	m_uVersion = a_pOther.m_uVersion;
 	m_v3Position = a_pOther.m_v3Position;
 	m_v3Rotation = a_pOther.m_v3Rotation;
 	m_v3Scale = a_pOther.m_v3Scale;
 	m_m4World = a_pOther.m_m4World;
+	m_m4InverseTranspose = a_pOther.m_m4InverseTranspose;
+	m_v3PreviousPosition = a_pOther.m_v3PreviousPosition;
+	m_v3PreviousRotation = a_pOther.m_v3PreviousRotation;
+	m_v3PreviousScale = a_pOther.m_v3PreviousScale;
 
 	return *this;
 }
@@ -34,6 +47,35 @@ Transform& Transform::operator=(Transform const& a_pOther)
 glm::vec3 Transform::GetRotation() { return m_v3Rotation; }
 glm::vec3 Transform::GetPosition() { return m_v3Position; }
 glm::vec3 Transform::GetScale() { return m_v3Scale; }
+unsigned int Transform::GetVersion() { return m_uVersion; }
+
+void Transform::GetInterpolatedMatrices(float a_fAlpha, glm::mat4& a_m4World, glm::mat4& a_m4InverseTranspose)
+{
+	// Resting Transforms reuse the cached matrices.
+	bool bHasMoved = m_v3PreviousPosition != m_v3Position ||
+		m_v3PreviousRotation != m_v3Rotation ||
+		m_v3PreviousScale != m_v3Scale;
+	if (!bHasMoved || a_fAlpha >= 1.0f)
+	{
+		a_m4World = GetWorld();
+		a_m4InverseTranspose = GetInverseTranspose();
+		return;
+	}
+
+	// Steps are short, so blending the euler angles directly stays close to a slerp.
+	a_m4World = BuildWorld(
+		glm::mix(m_v3PreviousPosition, m_v3Position, a_fAlpha),
+		glm::mix(m_v3PreviousRotation, m_v3Rotation, a_fAlpha),
+		glm::mix(m_v3PreviousScale, m_v3Scale, a_fAlpha));
+	a_m4InverseTranspose = glm::transpose(glm::inverse(a_m4World));
+}
+
+void Transform::SavePrevious(void)
+{
+	m_v3PreviousPosition = m_v3Position;
+	m_v3PreviousRotation = m_v3Rotation;
+	m_v3PreviousScale = m_v3Scale;
+}
 
 glm::vec3 Transform::GetUp()
 {
@@ -117,32 +159,38 @@ glm::vec3 Transform::GetForward()
 void Transform::SetRotation(glm::vec3 a_v3Rotation) 
 { 
 	m_v3Rotation = a_v3Rotation; 
-	m_bIsDirty = true; 
+	m_bIsDirty = true;
+	m_uVersion++;
 }
 void Transform::SetPosition(glm::vec3 a_v3Position)
 { 
 	m_v3Position = a_v3Position;
 	m_bIsDirty = true;
+	m_uVersion++;
 }
 void Transform::SetScale(glm::vec3 a_v3Scale) 
 { 
 	m_v3Scale = a_v3Scale;
 	m_bIsDirty = true;
+	m_uVersion++;
 }
 
 void Transform::Rotate(glm::vec3 a_v3Offset)
 {
 	m_v3Rotation += a_v3Offset;
 	m_bIsDirty = true;
+	m_uVersion++;
 }
 void Transform::MoveGlobal(glm::vec3 a_v3Offset)
 {
 	m_v3Position += a_v3Offset;
 	m_bIsDirty = true;
+	m_uVersion++;
 }
 void Transform::MoveLocal(glm::vec3 a_v3Offset)
 {
 	m_bIsDirty = true;
+	m_uVersion++;
 
 	// Constructing the rotation matrix.
 	glm::mat4 ro = IDENTITY_M4;
@@ -163,6 +211,7 @@ void Transform::Scale(glm::vec3 a_v3Offset)
 {
 	m_v3Scale *= a_v3Offset;
 	m_bIsDirty = true;
+	m_uVersion++;
 }
 
 glm::mat4 Transform::GetWorld()
@@ -184,32 +233,37 @@ glm::mat4 Transform::GetInverseTranspose()
 }
 
 void Transform::CalculateMatrices(void)
+{
+	// Calculating the world matrix.
+	m_m4World = BuildWorld(m_v3Position, m_v3Rotation, m_v3Scale);
+
+	// Calculating the transpose inverse matrix.
+	m_m4InverseTranspose = glm::transpose(glm::inverse(m_m4World));
+
+	m_bIsDirty = false;
+}
+
+glm::mat4 Transform::BuildWorld(glm::vec3 a_v3Position, glm::vec3 a_v3Rotation, glm::vec3 a_v3Scale)
 {
 	// Constructing the scale and translation matrices.
-	glm::mat4 sc = glm::scale(IDENTITY_M4, m_v3Scale);
-	glm::mat4 tr = glm::translate(IDENTITY_M4, m_v3Position);
+	glm::mat4 sc = glm::scale(IDENTITY_M4, a_v3Scale);
+	glm::mat4 tr = glm::translate(IDENTITY_M4, a_v3Position);
 	glm::mat4 ro;
 
 	// Constructing the rotation matrix.
 	//		Only do so if the value is non-zero.
-	if (m_v3Rotation.x > 0.0f || m_v3Rotation.x < 0.0f)
+	if (a_v3Rotation.x > 0.0f || a_v3Rotation.x < 0.0f)
 	{
-		ro *= glm::rotate(IDENTITY_M4, m_v3Rotation.x, AXIS_X);
+		ro *= glm::rotate(IDENTITY_M4, a_v3Rotation.x, AXIS_X);
 	}
-	if (m_v3Rotation.y > 0.0f || m_v3Rotation.y < 0.0f)
+	if (a_v3Rotation.y > 0.0f || a_v3Rotation.y < 0.0f)
 	{
-		ro *= glm::rotate(IDENTITY_M4, m_v3Rotation.y, AXIS_Y);
+		ro *= glm::rotate(IDENTITY_M4, a_v3Rotation.y, AXIS_Y);
 	}
-	if (m_v3Rotation.z > 0.0f || m_v3Rotation.z < 0.0f)
+	if (a_v3Rotation.z > 0.0f || a_v3Rotation.z < 0.0f)
 	{
-		ro *= glm::rotate(IDENTITY_M4, m_v3Rotation.z, AXIS_Z);
+		ro *= glm::rotate(IDENTITY_M4, a_v3Rotation.z, AXIS_Z);
 	}
 
-	// Calculating the world matrix.
-	m_m4World = sc * tr * ro;
-
-	// Calculating the transpose inverse matrix.
-	m_m4InverseTranspose = glm::transpose(glm::inverse(m_m4World));
-
-	m_bIsDirty = false;
-}
+	return sc * tr * ro;
+}
\ No newline at end of file
@@ -10,12 +10,18 @@ struct Transform
 {
 private:
 	bool m_bIsDirty;
+	unsigned int m_uVersion;
 	glm::vec3 m_v3Rotation;
 	glm::vec3 m_v3Position;
 	glm::vec3 m_v3Scale;
 	glm::mat4 m_m4World;
 	glm::mat4 m_m4InverseTranspose;
 
+	// State at the start of the last simulation step, for interpolated rendering.
+	glm::vec3 m_v3PreviousRotation;
+	glm::vec3 m_v3PreviousPosition;
+	glm::vec3 m_v3PreviousScale;
+
 public:
 	// - - Construction - -	
 	/// <summary>
@@ -79,6 +85,26 @@ public:
 	/// <returns></returns>
 	glm::vec3 GetForward();
 
+	/// <summary>
+	/// Gets a counter that increases every time the Transform is altered.
+	/// Lets other systems notice changes after the dirty flag has been consumed.
+	/// </summary>
+	unsigned int GetVersion();
+
+	/// <summary>
+	/// Gets the world matrix and its inverse transpose blended between the previous
+	/// simulation state and the current one.
+	/// </summary>
+	/// <param name="a_fAlpha">0 for the previous state, 1 for the current one.</param>
+	/// <param name="a_m4World">Receives the blended world matrix.</param>
+	/// <param name="a_m4InverseTranspose">Receives the inverse transpose of it.</param>
+	void GetInterpolatedMatrices(float a_fAlpha, glm::mat4& a_m4World, glm::mat4& a_m4InverseTranspose);
+
+	/// <summary>
+	/// Remembers the current state as the one the next simulation step starts from.
+	/// </summary>
+	void SavePrevious(void);
+
 	// - - Set Accessors - -
 	/// <summary>
 	/// Sets the rotation to the passed in Vector3.
@@ -121,6 +147,11 @@ private:
 	/// Calculates the world and inverse transposes for this Transform.
 	/// </summary>
 	void CalculateMatrices(void);
+
+	/// <summary>
+	/// Builds a world matrix the same way CalculateMatrices does.
+	/// </summary>
+	static glm::mat4 BuildWorld(glm::vec3 a_v3Position, glm::vec3 a_v3Rotation, glm::vec3 a_v3Scale);
 };
 
 #endif //__TRANSFORM_H_
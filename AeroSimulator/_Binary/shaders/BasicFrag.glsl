@@ -9,7 +9,18 @@ out vec4 Fragment;
 uniform sampler2D Texture;
 uniform sampler2D NormalMap;
 
+#include "Features.glsl"
+
 void main()
 {
-    Fragment = texture(Texture, UV);
+#ifdef FEATURE_NORMAL_MAP
+    Fragment = ApplyFeatures(texture(Texture, UV), texture(NormalMap, UV).rgb);
+#else
+    Fragment = ApplyFeatures(texture(Texture, UV), vec3(0.5f, 0.5f, 1.0f));
+#endif
+
+#ifdef FEATURE_DEBUG_VIEW
+    // Still after ApplyFeatures, so alpha tested texels are discarded as in the normal view.
+    Fragment = DebugColor;
+#endif
 }
\ No newline at end of file
@@ -8,16 +8,37 @@ layout (location = 3) in vec3 Normal_b;
 uniform mat4 WVP;
 uniform mat4 InverseTransposeWorld;
 
+#ifdef FEATURE_NORMAL_MAP
+uniform mat4 World;
+out vec3 WorldPosition;
+#endif
+
+#ifdef FEATURE_FOG
+out float FogDepth;
+#endif
+
 out vec3 Color;
 out vec3 Normal;
 out vec2 UV;
 
+// Must match DepthVertex.glsl exactly so the depth prepass can be tested with GL_EQUAL.
+invariant gl_Position;
+
 void main()
 {
     gl_Position = WVP * vec4(Position_b, 1.0f);
+    Normal = normalize(mat3(InverseTransposeWorld) * Normal_b);
 	
+#ifdef FEATURE_NORMAL_MAP
+    WorldPosition = (World * vec4(Position_b, 1.0f)).xyz;
+#endif
+
+#ifdef FEATURE_FOG
+    // With a perspective projection w is the distance along the view direction.
+    FogDepth = gl_Position.w;
+#endif
+
     Color = Color_b;
-    Normal = normalize(mat3(InverseTransposeWorld) * Normal_b);
     //Normal = Normal_b;
     UV = UV_b;
 }
\ No newline at end of file
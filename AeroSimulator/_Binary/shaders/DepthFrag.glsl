@@ -0,0 +1,6 @@
+#version 330
+
+// Depth only, the fixed function depth write is all that is needed.
+void main()
+{
+}
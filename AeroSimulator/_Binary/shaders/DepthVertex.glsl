@@ -0,0 +1,13 @@
+#version 330
+
+layout (location = 0) in vec3 Position_b;
+
+uniform mat4 WVP;
+
+// Must match BasicVertex.glsl exactly so the shading pass can test with GL_EQUAL.
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = WVP * vec4(Position_b, 1.0f);
+}
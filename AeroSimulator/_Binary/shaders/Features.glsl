@@ -0,0 +1,64 @@
+// Declarations and code of the optional ShaderFeatures, shared by every entity
+// fragment shader through #include.  The including shader declares Normal and UV
+// and samples the textures, ApplyFeatures does the rest.
+
+#ifdef FEATURE_NORMAL_MAP
+in vec3 WorldPosition;
+uniform vec3 LightDirection = vec3(-0.4f, -1.0f, -0.3f);
+#endif
+
+#ifdef FEATURE_ALPHA_TEST
+uniform float AlphaCutoff = 0.5f;
+#endif
+
+#ifdef FEATURE_FOG
+in float FogDepth;
+uniform vec3 FogColor = vec3(0.55f, 0.6f, 0.65f);
+uniform float FogDensity = 0.04f;
+#endif
+
+#ifdef FEATURE_DEBUG_VIEW
+// Flat color of the draw, set per draw by the debug view modes.
+uniform vec4 DebugColor = vec4(1.0f);
+#endif
+
+#ifdef FEATURE_NORMAL_MAP
+// Builds a tangent frame from screen space derivatives, so meshes need no tangents.
+mat3 CotangentFrame(vec3 normal, vec3 position, vec2 uv)
+{
+    vec3 dp1 = dFdx(position);
+    vec3 dp2 = dFdy(position);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, normal);
+    vec3 dp1perp = cross(normal, dp1);
+    vec3 tangent = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 bitangent = dp2perp * duv1.y + dp1perp * duv2.y;
+
+    float invmax = inversesqrt(max(dot(tangent, tangent), dot(bitangent, bitangent)));
+    return mat3(tangent * invmax, bitangent * invmax, normal);
+}
+#endif
+
+// Applies every enabled feature to the sampled color.
+vec4 ApplyFeatures(vec4 color, vec3 mapped)
+{
+#ifdef FEATURE_ALPHA_TEST
+    if (color.a < AlphaCutoff)
+    {
+        discard;
+    }
+#endif
+
+#ifdef FEATURE_NORMAL_MAP
+    vec3 normal = CotangentFrame(normalize(Normal), WorldPosition, UV) * normalize(mapped * 2.0f - 1.0f);
+    color.rgb *= max(dot(normalize(normal), -normalize(LightDirection)), 0.0f) * 0.8f + 0.2f;
+#endif
+
+#ifdef FEATURE_FOG
+    color.rgb = mix(FogColor, color.rgb, clamp(exp(-FogDensity * FogDepth), 0.0f, 1.0f));
+#endif
+
+    return color;
+}
@@ -0,0 +1,56 @@
+#version 430
+#ifdef TEXTURE_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+in vec3 Color;
+in vec3 Normal;
+in vec2 UV;
+
+out vec4 Fragment;
+
+// Mirrors TextureTable::SlotData.
+struct SlotData
+{
+    uvec2 Handle;
+    int Array;
+    int Layer;
+};
+
+layout (std430, binding = 3) readonly buffer TextureTable
+{
+    SlotData Slots[];
+};
+
+#ifndef TEXTURE_BINDLESS
+uniform sampler2DArray TextureArrays[8];
+#endif
+
+// Slot of the material's texture, set per draw instead of binding it.
+uniform int TextureSlot;
+uniform int NormalMapSlot;
+
+vec4 SampleSlot(int slot, vec2 uv)
+{
+#ifdef TEXTURE_BINDLESS
+    return texture(sampler2D(Slots[slot].Handle), uv);
+#else
+    return texture(TextureArrays[Slots[slot].Array], vec3(uv, Slots[slot].Layer));
+#endif
+}
+
+#include "Features.glsl"
+
+void main()
+{
+#ifdef FEATURE_NORMAL_MAP
+    Fragment = ApplyFeatures(SampleSlot(TextureSlot, UV), SampleSlot(NormalMapSlot, UV).rgb);
+#else
+    Fragment = ApplyFeatures(SampleSlot(TextureSlot, UV), vec3(0.5f, 0.5f, 1.0f));
+#endif
+
+#ifdef FEATURE_DEBUG_VIEW
+    // Still after ApplyFeatures, so alpha tested texels are discarded as in the normal view.
+    Fragment = DebugColor;
+#endif
+}